@@ -12,16 +12,21 @@
 #include <viskores/TypeTraits.h>
 
 #include <viskores/cont/ArrayHandle.h>
+#include <viskores/cont/EnvironmentTracker.h>
 #include <viskores/cont/Initialize.h>
 #include <viskores/cont/Timer.h>
 
+#include <viskores/filter/geometry_refinement/Tetrahedralize.h>
 #include <viskores/source/Tangle.h>
 
 #include <viskores/rendering/Camera.h>
 #include <viskores/rendering/CanvasRayTracer.h>
+#include <viskores/rendering/Compositor.h>
+#include <viskores/rendering/MapperConnectivity.h>
 #include <viskores/rendering/raytracing/Ray.h>
 #include <viskores/rendering/raytracing/RayTracer.h>
 #include <viskores/rendering/raytracing/TriangleExtractor.h>
+#include <viskores/rendering/raytracing/VolumeRendererStructured.h>
 
 #include <sstream>
 #include <string>
@@ -33,6 +38,12 @@ namespace
 // Hold configuration state (e.g. active device)
 viskores::cont::InitializeResult Config;
 
+viskores::rendering::raytracing::BVHBuilderType BuilderArg(std::int64_t arg)
+{
+  return arg == 0 ? viskores::rendering::raytracing::BVHBuilderType::Morton
+                  : viskores::rendering::raytracing::BVHBuilderType::SAH;
+}
+
 void BenchRayTracing(::benchmark::State& state)
 {
   viskores::source::Tangle maker;
@@ -51,6 +62,7 @@ void BenchRayTracing(::benchmark::State& state)
 
   auto triIntersector = std::make_shared<viskores::rendering::raytracing::TriangleIntersector>(
     viskores::rendering::raytracing::TriangleIntersector());
+  triIntersector->SetBVHBuilder(BuilderArg(state.range(0)));
 
   viskores::rendering::raytracing::RayTracer tracer;
   triIntersector->SetData(coords, triExtractor.GetTriangles());
@@ -102,9 +114,322 @@ void BenchRayTracing(::benchmark::State& state)
 
     state.SetIterationTime(timer.GetElapsedTime());
   }
+  state.SetItemsProcessed(state.iterations() * rays.NumRays);
+}
+
+VISKORES_BENCHMARK_OPTS(BenchRayTracing, ->ArgName("SAH")->DenseRange(0, 1));
+
+// Shaded rendering with shadows and ambient occlusion samples. The accumulation is reset
+// every iteration, so each frame traces all of its secondary rays.
+void BenchOcclusion(::benchmark::State& state)
+{
+  viskores::source::Tangle maker;
+  maker.SetPointDimensions({ 128, 128, 128 });
+  viskores::cont::DataSet dataset = maker.Execute();
+  viskores::cont::CoordinateSystem coords = dataset.GetCoordinateSystem();
+
+  viskores::rendering::raytracing::TriangleExtractor triExtractor;
+  triExtractor.ExtractCells(dataset.GetCellSet());
+  auto triIntersector = std::make_shared<viskores::rendering::raytracing::TriangleIntersector>();
+  triIntersector->SetData(coords, triExtractor.GetTriangles());
+
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(coords.GetBounds());
+  viskores::rendering::raytracing::RayTracer tracer;
+  tracer.AddShapeIntersector(triIntersector);
+  tracer.GetCamera() = camera.CreateRaytracingCamera(1920, 1080);
+  tracer.SetAmbientOcclusionSamples(static_cast<viskores::IdComponent>(state.range(0)));
+  tracer.SetShadowsOn(state.range(1) != 0);
+
+  viskores::cont::Field field = dataset.GetField("tangle");
+  tracer.SetField(field, field.GetRange().ReadPortal().Get(0));
+  viskores::cont::ArrayHandle<viskores::Vec4f_32> colors;
+  colors.AllocateAndFill(100, viskores::Vec4f_32(1.f, 1.f, 1.f, 1.f));
+  tracer.SetColorMap(colors);
+
+  viskores::rendering::raytracing::Ray<viskores::Float32> rays;
+  viskores::cont::Timer timer{ Config.Device };
+  for (auto _ : state)
+  {
+    (void)_;
+    tracer.GetCamera().CreateRays(rays, coords.GetBounds());
+    tracer.ResetAccumulation();
+    timer.Start();
+    tracer.Render(rays);
+    timer.Stop();
+
+    state.SetIterationTime(timer.GetElapsedTime());
+  }
+  state.SetItemsProcessed(state.iterations() * rays.NumRays);
+}
+
+VISKORES_BENCHMARK_OPTS(BenchOcclusion,
+                          ->ArgNames({ "AOSamples", "Shadows" })
+                          ->Args({ 0, 0 })
+                          ->Args({ 0, 1 })
+                          ->Args({ 1, 0 })
+                          ->Args({ 1, 1 })
+                          ->Args({ 4, 1 }));
+
+// Time to build the BVH from scratch or, with Refit, to update it for moved points.
+void BenchBVHBuild(::benchmark::State& state)
+{
+  const bool refit = state.range(1) != 0;
+
+  viskores::source::Tangle maker;
+  maker.SetPointDimensions({ 128, 128, 128 });
+  viskores::cont::DataSet dataset = maker.Execute();
+  viskores::cont::CoordinateSystem coords = dataset.GetCoordinateSystem();
+
+  viskores::rendering::raytracing::TriangleExtractor triExtractor;
+  triExtractor.ExtractCells(dataset.GetCellSet());
+
+  viskores::rendering::raytracing::TriangleIntersector triIntersector;
+  triIntersector.SetBVHBuilder(BuilderArg(state.range(0)));
+  triIntersector.SetData(coords, triExtractor.GetTriangles());
+
+  viskores::cont::Timer timer{ Config.Device };
+  for (auto _ : state)
+  {
+    (void)_;
+    timer.Start();
+    if (refit)
+    {
+      triIntersector.SetCoordinates(coords);
+    }
+    else
+    {
+      triIntersector.SetData(coords, triExtractor.GetTriangles());
+    }
+    timer.Stop();
+
+    state.SetIterationTime(timer.GetElapsedTime());
+  }
+  state.SetItemsProcessed(state.iterations() * triIntersector.GetNumberOfShapes());
+}
+
+VISKORES_BENCHMARK_OPTS(BenchBVHBuild,
+                          ->ArgNames({ "SAH", "Refit" })
+                          ->Args({ 0, 0 })
+                          ->Args({ 1, 0 })
+                          ->Args({ 0, 1 })
+                          ->Args({ 1, 1 }));
+
+// Primary ray intersection alone, tracing the rays one at a time or in packets of 4 or 8
+// rays that share the walk through the BVH.
+void BenchRayPackets(::benchmark::State& state)
+{
+  viskores::source::Tangle maker;
+  maker.SetPointDimensions({ 128, 128, 128 });
+  viskores::cont::DataSet dataset = maker.Execute();
+  viskores::cont::CoordinateSystem coords = dataset.GetCoordinateSystem();
+
+  viskores::rendering::raytracing::TriangleExtractor triExtractor;
+  triExtractor.ExtractCells(dataset.GetCellSet());
+
+  viskores::rendering::raytracing::TriangleIntersector triIntersector;
+  triIntersector.SetRayPacketSize(static_cast<viskores::IdComponent>(state.range(0)));
+  triIntersector.SetData(coords, triExtractor.GetTriangles());
+
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(coords.GetBounds());
+  viskores::rendering::raytracing::Camera rayCamera = camera.CreateRaytracingCamera(1920, 1080);
+  viskores::rendering::raytracing::Ray<viskores::Float32> rays;
+
+  viskores::cont::Timer timer{ Config.Device };
+  for (auto _ : state)
+  {
+    (void)_;
+    rayCamera.CreateRays(rays, coords.GetBounds());
+    timer.Start();
+    triIntersector.IntersectRays(rays);
+    timer.Stop();
+
+    state.SetIterationTime(timer.GetElapsedTime());
+  }
+  state.SetItemsProcessed(state.iterations() * rays.NumRays);
+}
+
+VISKORES_BENCHMARK_OPTS(BenchRayPackets, ->ArgName("PacketSize")->Arg(1)->Arg(4)->Arg(8));
+
+// Volume rendering of a field that is mostly transparent under the color map, with and
+// without skipping the empty space and stopping rays once they are 95% opaque.
+void BenchVolumeRendering(::benchmark::State& state)
+{
+  const bool skipping = state.range(0) != 0;
+  const bool earlyTermination = state.range(1) != 0;
+
+  viskores::source::Tangle maker;
+  maker.SetPointDimensions({ 128, 128, 128 });
+  viskores::cont::DataSet dataset = maker.Execute();
+  viskores::cont::CoordinateSystem coords = dataset.GetCoordinateSystem();
+  viskores::cont::Field field = dataset.GetField("tangle");
+  viskores::Range range = field.GetRange().ReadPortal().Get(0);
+
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(coords.GetBounds());
+  camera.Azimuth(30.0f);
+  camera.Elevation(20.0f);
+
+  // Only the top quarter of the scalar range is visible.
+  viskores::cont::ArrayHandle<viskores::Vec4f_32> colors;
+  colors.Allocate(256);
+  {
+    auto portal = colors.WritePortal();
+    for (viskores::Id i = 0; i < 256; ++i)
+    {
+      const viskores::Float32 t = static_cast<viskores::Float32>(i) / 255.f;
+      portal.Set(i, viskores::Vec4f_32(t, 0.5f, 1.f - t, t < 0.75f ? 0.f : 4.f * (t - 0.75f)));
+    }
+  }
+
+  viskores::rendering::raytracing::VolumeRendererStructured tracer;
+  tracer.SetEmptySpaceSkipping(skipping);
+  tracer.SetRayTerminationOpacity(earlyTermination ? 0.95f : 1.f);
+  tracer.SetData(
+    coords, field, dataset.GetCellSet().AsCellSet<viskores::cont::CellSetStructured<3>>(), range);
+  tracer.SetColorMap(colors);
+
+  viskores::rendering::CanvasRayTracer canvas(1920, 1080);
+  viskores::rendering::raytracing::Camera rayCamera = camera.CreateRaytracingCamera(
+    viskores::Int32(canvas.GetWidth()), viskores::Int32(canvas.GetHeight()));
+  viskores::rendering::raytracing::Ray<viskores::Float32> rays;
+
+  viskores::cont::Timer timer{ Config.Device };
+  for (auto _ : state)
+  {
+    (void)_;
+    timer.Start();
+    rayCamera.CreateRays(rays, coords.GetBounds());
+    rays.Buffers.at(0).InitConst(0.f);
+    tracer.Render(rays);
+    timer.Stop();
+
+    state.SetIterationTime(timer.GetElapsedTime());
+  }
+  state.SetItemsProcessed(state.iterations() * rays.NumRays);
+}
+
+VISKORES_BENCHMARK_OPTS(BenchVolumeRendering,
+                          ->ArgNames({ "Skipping", "EarlyTermination" })
+                          ->Args({ 0, 0 })
+                          ->Args({ 1, 0 })
+                          ->Args({ 0, 1 })
+                          ->Args({ 1, 1 }));
+
+// Per-frame cost of a 360-frame camera orbit around a tetrahedral mesh, after the first
+// frame, when one mapper renders the orbit and so reuses the mesh connectivity, and when
+// each frame uses a new mapper.
+void BenchConnectivityOrbit(::benchmark::State& state)
+{
+  const bool reuse = state.range(0) != 0;
+
+  viskores::source::Tangle maker;
+  maker.SetPointDimensions({ 32, 32, 32 });
+  viskores::filter::geometry_refinement::Tetrahedralize tetrahedralize;
+  viskores::cont::DataSet dataset = tetrahedralize.Execute(maker.Execute());
+  viskores::cont::CoordinateSystem coords = dataset.GetCoordinateSystem();
+  viskores::cont::Field field = dataset.GetField("tangle");
+  viskores::Range range = field.GetRange().ReadPortal().Get(0);
+  viskores::cont::ColorTable colorTable(viskores::cont::ColorTable::Preset::Inferno);
+
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(coords.GetBounds());
+  viskores::rendering::CanvasRayTracer canvas(512, 512);
+
+  viskores::rendering::MapperConnectivity mapper;
+  auto renderFrame = [&](viskores::rendering::MapperConnectivity& frameMapper)
+  {
+    canvas.Clear();
+    frameMapper.SetCanvas(&canvas);
+    frameMapper.SetActiveColorTable(colorTable);
+    frameMapper.RenderCells(dataset.GetCellSet(), coords, field, colorTable, camera, range);
+    camera.Azimuth(1.f);
+  };
+
+  viskores::cont::Timer timer{ Config.Device };
+  timer.Start();
+  renderFrame(mapper);
+  timer.Stop();
+  state.counters["FirstFrame"] = timer.GetElapsedTime();
+
+  for (auto _ : state)
+  {
+    (void)_;
+    timer.Start();
+    if (reuse)
+    {
+      renderFrame(mapper);
+    }
+    else
+    {
+      viskores::rendering::MapperConnectivity frameMapper;
+      renderFrame(frameMapper);
+    }
+    timer.Stop();
+
+    state.SetIterationTime(timer.GetElapsedTime());
+  }
+  state.SetItemsProcessed(state.iterations() * canvas.GetWidth() * canvas.GetHeight());
+}
+
+VISKORES_BENCHMARK_OPTS(BenchConnectivityOrbit,
+                          ->ArgName("ReuseMesh")
+                          ->DenseRange(0, 1)
+                          ->Iterations(359));
+
+// Time to composite a full HD image over the ranks of the job (run with mpirun). The
+// iterations are fixed so that every rank takes part in the same number of composites.
+void BenchCompositing(::benchmark::State& state)
+{
+  using Compositor = viskores::rendering::Compositor;
+  const auto algorithm = state.range(0) == 0 ? Compositor::CompositeAlgorithm::BinarySwap
+                                             : Compositor::CompositeAlgorithm::RadixK;
+  const auto mode = state.range(1) == 0 ? Compositor::BlendMode::Depth
+                                        : Compositor::BlendMode::Ordered;
+
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  const viskores::Id width = 1920;
+  const viskores::Id height = 1080;
+  viskores::rendering::Canvas canvas(width, height);
+  {
+    // Each rank covers a vertical band of the image in front of the others.
+    auto colorPortal = canvas.GetColorBuffer().WritePortal();
+    auto depthPortal = canvas.GetDepthBuffer().WritePortal();
+    for (viskores::Id i = 0; i < width * height; i++)
+    {
+      const bool inBand = (i % width) * comm.size() / width == comm.rank();
+      colorPortal.Set(i, viskores::Vec4f_32(0.2f, 0.1f, 0.f, 0.5f));
+      const viskores::Float32 behind = 0.001f * static_cast<viskores::Float32>(comm.rank() + 1);
+      depthPortal.Set(i, inBand ? 0.5f : 0.5f + behind);
+    }
+  }
+
+  Compositor compositor;
+  compositor.SetAlgorithm(algorithm);
+  compositor.SetBlendMode(mode);
+
+  viskores::cont::Timer timer{ Config.Device };
+  for (auto _ : state)
+  {
+    (void)_;
+    comm.barrier();
+    timer.Start();
+    compositor.Composite(canvas);
+    timer.Stop();
+
+    state.SetIterationTime(timer.GetElapsedTime());
+  }
+  state.SetItemsProcessed(state.iterations() * width * height);
 }
 
-VISKORES_BENCHMARK(BenchRayTracing);
+VISKORES_BENCHMARK_OPTS(BenchCompositing,
+                          ->ArgNames({ "RadixK", "Ordered" })
+                          ->Args({ 0, 0 })
+                          ->Args({ 1, 0 })
+                          ->Args({ 0, 1 })
+                          ->Args({ 1, 1 })
+                          ->Iterations(20));
 
 } // end namespace viskores::benchmarking
 
@@ -7,8 +7,21 @@
 //============================================================================
 
 
+#include <viskores/cont/Algorithm.h>
+#include <viskores/cont/EnvironmentTracker.h>
+#include <viskores/cont/ErrorFilterExecution.h>
 #include <viskores/filter/connected_components/CellSetConnectivity.h>
+#include <viskores/filter/connected_components/internal/MergeComponents.h>
 #include <viskores/filter/connected_components/worklet/CellSetConnectivity.h>
+#include <viskores/filter/connected_components/worklet/ComponentStatistics.h>
+
+VISKORES_THIRDPARTY_PRE_INCLUDE
+#include <viskores/thirdparty/diy/diy.h>
+VISKORES_THIRDPARTY_POST_INCLUDE
+
+#include <algorithm>
+#include <functional>
+#include <limits>
 
 namespace viskores
 {
@@ -16,6 +29,171 @@ namespace filter
 {
 namespace connected_components
 {
+
+namespace
+{
+
+// Statistics of the components, collected from one or more partitions. The sums, minima,
+// and maxima can be combined over partitions and ranks before the final values are made.
+class StatisticsTable
+{
+public:
+  StatisticsTable(viskores::Id numComponents, std::size_t numIntegrals)
+    : NumberOfComponents(static_cast<std::size_t>(numComponents))
+    , SumsPerComponent(NumberOfGeometrySums + numIntegrals)
+    , Sums(this->NumberOfComponents * this->SumsPerComponent, 0)
+    , Mins(this->NumberOfComponents * 3, std::numeric_limits<viskores::Float64>::infinity())
+    , Maxs(this->NumberOfComponents * 3, -std::numeric_limits<viskores::Float64>::infinity())
+  {
+  }
+
+  void Add(const viskores::cont::DataSet& input,
+           const viskores::cont::ArrayHandle<viskores::Id>& components,
+           const std::vector<std::string>& integratedFields)
+  {
+    viskores::worklet::connectivity::ComponentStatistics statistics;
+    statistics.Run(
+      input.GetCellSet(), input.GetCoordinateSystem().GetDataAsMultiplexer(), components);
+
+    std::vector<viskores::cont::ArrayHandle<viskores::Float64>> integrals;
+    for (const std::string& fieldName : integratedFields)
+    {
+      const viskores::cont::Field& field = input.GetField(fieldName);
+      if (!field.IsCellField() && !field.IsPointField())
+      {
+        throw viskores::cont::ErrorFilterExecution("Integrated field " + fieldName +
+                                                   " must be a point or cell field.");
+      }
+      auto integrate = [&](const auto& values)
+      {
+        integrals.push_back(field.IsCellField() ? statistics.IntegrateCellField(values)
+                                                : statistics.IntegratePointField(values));
+      };
+      field.GetData()
+        .CastAndCallForTypesWithFloatFallback<viskores::TypeListFieldScalar,
+                                              VISKORES_DEFAULT_STORAGE_LIST>(integrate);
+    }
+
+    auto componentPortal = statistics.GetComponents().ReadPortal();
+    auto numCellsPortal = statistics.GetNumberOfCells().ReadPortal();
+    auto measurePortal = statistics.GetMeasure().ReadPortal();
+    auto weightedCenterPortal = statistics.GetWeightedCenterSum().ReadPortal();
+    auto centerPortal = statistics.GetCenterSum().ReadPortal();
+    auto minPortal = statistics.GetMinCorner().ReadPortal();
+    auto maxPortal = statistics.GetMaxCorner().ReadPortal();
+    std::vector<viskores::cont::ArrayHandle<viskores::Float64>::ReadPortalType> integralPortals;
+    for (const auto& integral : integrals)
+    {
+      integralPortals.push_back(integral.ReadPortal());
+    }
+    for (viskores::Id i = 0; i < componentPortal.GetNumberOfValues(); ++i)
+    {
+      const std::size_t component = static_cast<std::size_t>(componentPortal.Get(i));
+      viskores::Float64* sums = &this->Sums[component * this->SumsPerComponent];
+      sums[0] += static_cast<viskores::Float64>(numCellsPortal.Get(i));
+      sums[1] += measurePortal.Get(i);
+      for (viskores::IdComponent d = 0; d < 3; ++d)
+      {
+        sums[2 + d] += weightedCenterPortal.Get(i)[d];
+        sums[5 + d] += centerPortal.Get(i)[d];
+        viskores::Float64& componentMin = this->Mins[component * 3 + d];
+        viskores::Float64& componentMax = this->Maxs[component * 3 + d];
+        componentMin = std::min(componentMin, minPortal.Get(i)[d]);
+        componentMax = std::max(componentMax, maxPortal.Get(i)[d]);
+      }
+      for (std::size_t f = 0; f < integralPortals.size(); ++f)
+      {
+        sums[NumberOfGeometrySums + f] += integralPortals[f].Get(i);
+      }
+    }
+  }
+
+  // Combine the statistics of all ranks. This is a collective operation.
+  void Reduce()
+  {
+    auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+    if (comm.size() > 1)
+    {
+      std::vector<viskores::Float64> result;
+      viskoresdiy::mpi::all_reduce(comm, this->Sums, result, std::plus<viskores::Float64>());
+      this->Sums.swap(result);
+      viskoresdiy::mpi::all_reduce(
+        comm, this->Mins, result, viskoresdiy::mpi::minimum<viskores::Float64>());
+      this->Mins.swap(result);
+      viskoresdiy::mpi::all_reduce(
+        comm, this->Maxs, result, viskoresdiy::mpi::maximum<viskores::Float64>());
+      this->Maxs.swap(result);
+    }
+  }
+
+  std::vector<viskores::cont::Field> MakeFields(const std::string& prefix,
+                                                const std::vector<std::string>& integratedFields,
+                                                viskores::cont::Field::Association association)
+  {
+    const std::size_t numComponents = this->NumberOfComponents;
+    std::vector<viskores::Id> numCells(numComponents);
+    std::vector<viskores::Float64> measure(numComponents);
+    std::vector<viskores::Vec3f_64> centroid(numComponents);
+    std::vector<viskores::Vec3f_64> boundsMin(numComponents);
+    std::vector<viskores::Vec3f_64> boundsMax(numComponents);
+    std::vector<std::vector<viskores::Float64>> integrals(
+      integratedFields.size(), std::vector<viskores::Float64>(numComponents));
+    for (std::size_t component = 0; component < numComponents; ++component)
+    {
+      const viskores::Float64* sums = &this->Sums[component * this->SumsPerComponent];
+      numCells[component] = static_cast<viskores::Id>(sums[0]);
+      measure[component] = sums[1];
+      for (viskores::IdComponent d = 0; d < 3; ++d)
+      {
+        // components of cells without measure (e.g., vertices) use the mean of the centers
+        centroid[component][d] = (sums[1] > 0) ? sums[2 + d] / sums[1] : sums[5 + d] / sums[0];
+        boundsMin[component][d] = this->Mins[component * 3 + d];
+        boundsMax[component][d] = this->Maxs[component * 3 + d];
+      }
+      for (std::size_t f = 0; f < integratedFields.size(); ++f)
+      {
+        integrals[f][component] = sums[NumberOfGeometrySums + f];
+      }
+    }
+
+    std::vector<viskores::cont::Field> fields;
+    fields.push_back(
+      viskores::cont::make_FieldMove(prefix + "_cell_count", association, std::move(numCells)));
+    fields.push_back(
+      viskores::cont::make_FieldMove(prefix + "_measure", association, std::move(measure)));
+    fields.push_back(
+      viskores::cont::make_FieldMove(prefix + "_centroid", association, std::move(centroid)));
+    fields.push_back(
+      viskores::cont::make_FieldMove(prefix + "_bounds_min", association, std::move(boundsMin)));
+    fields.push_back(
+      viskores::cont::make_FieldMove(prefix + "_bounds_max", association, std::move(boundsMax)));
+    for (std::size_t f = 0; f < integratedFields.size(); ++f)
+    {
+      fields.push_back(viskores::cont::make_FieldMove(
+        prefix + "_" + integratedFields[f] + "_integral", association, std::move(integrals[f])));
+    }
+    return fields;
+  }
+
+private:
+  // number of cells, measure, weighted center sum, and center sum
+  static constexpr std::size_t NumberOfGeometrySums = 8;
+
+  std::size_t NumberOfComponents;
+  std::size_t SumsPerComponent;
+  std::vector<viskores::Float64> Sums;
+  std::vector<viskores::Float64> Mins;
+  std::vector<viskores::Float64> Maxs;
+};
+
+viskores::Id NumberOfComponents(const viskores::cont::ArrayHandle<viskores::Id>& components)
+{
+  return viskores::cont::Algorithm::Reduce(components, viskores::Id{ -1 }, viskores::Maximum()) +
+    1;
+}
+
+} // anonymous namespace
+
 VISKORES_CONT viskores::cont::DataSet CellSetConnectivity::DoExecute(
   const viskores::cont::DataSet& input)
 {
@@ -23,7 +201,81 @@ VISKORES_CONT viskores::cont::DataSet CellSetConnectivity::DoExecute(
 
   viskores::worklet::connectivity::CellSetConnectivity::Run(input.GetCellSet(), component);
 
-  return this->CreateResultFieldCell(input, this->GetOutputFieldName(), component);
+  viskores::cont::DataSet output =
+    this->CreateResultFieldCell(input, this->GetOutputFieldName(), component);
+  if (this->ComputeComponentStatistics)
+  {
+    StatisticsTable table(NumberOfComponents(component), this->IntegratedFields.size());
+    table.Add(input, component, this->IntegratedFields);
+    for (const auto& field : table.MakeFields(this->GetOutputFieldName(),
+                                              this->IntegratedFields,
+                                              viskores::cont::Field::Association::WholeDataSet))
+    {
+      output.AddField(field);
+    }
+  }
+  return output;
+}
+
+VISKORES_CONT viskores::cont::PartitionedDataSet CellSetConnectivity::DoExecutePartitions(
+  const viskores::cont::PartitionedDataSet& input)
+{
+  if (!this->MergeAcrossPartitions)
+  {
+    return this->Filter::DoExecutePartitions(input);
+  }
+
+  std::vector<viskores::cont::ArrayHandle<viskores::Id>> components;
+  for (const auto& partition : input)
+  {
+    components.emplace_back();
+    viskores::worklet::connectivity::CellSetConnectivity::Run(partition.GetCellSet(),
+                                                              components.back());
+  }
+
+  internal::MergeComponentsAcrossPartitions(
+    input, viskores::cont::Field::Association::Cells, components);
+
+  viskores::cont::PartitionedDataSet output;
+  for (std::size_t i = 0; i < components.size(); ++i)
+  {
+    output.AppendPartition(this->CreateResultFieldCell(
+      input.GetPartition(static_cast<viskores::Id>(i)), this->GetOutputFieldName(), components[i]));
+  }
+  output = this->CreateResult(input, output);
+
+  if (this->ComputeComponentStatistics)
+  {
+    viskores::Id numComponents = 0;
+    for (const auto& partitionComponents : components)
+    {
+      numComponents = std::max(numComponents, NumberOfComponents(partitionComponents));
+    }
+    auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+    if (comm.size() > 1)
+    {
+      viskores::Id globalNumComponents;
+      viskoresdiy::mpi::all_reduce(
+        comm, numComponents, globalNumComponents, viskoresdiy::mpi::maximum<viskores::Id>());
+      numComponents = globalNumComponents;
+    }
+
+    StatisticsTable table(numComponents, this->IntegratedFields.size());
+    for (std::size_t i = 0; i < components.size(); ++i)
+    {
+      table.Add(input.GetPartition(static_cast<viskores::Id>(i)),
+                components[i],
+                this->IntegratedFields);
+    }
+    table.Reduce();
+    for (const auto& field : table.MakeFields(this->GetOutputFieldName(),
+                                              this->IntegratedFields,
+                                              viskores::cont::Field::Association::Global))
+    {
+      output.AddField(field);
+    }
+  }
+  return output;
 }
 } // namespace connected_components
 } // namespace filter
@@ -13,6 +13,9 @@
 #include <viskores/filter/Filter.h>
 #include <viskores/filter/connected_components/viskores_filter_connected_components_export.h>
 
+#include <string>
+#include <vector>
+
 namespace viskores
 {
 namespace filter
@@ -34,9 +37,63 @@ class VISKORES_FILTER_CONNECTED_COMPONENTS_EXPORT CellSetConnectivity
 public:
   VISKORES_CONT CellSetConnectivity() { this->SetOutputFieldName("component"); }
 
+  /// @brief Specify whether components are merged across the partitions of the input.
+  ///
+  /// By default, each partition of a `viskores::cont::PartitionedDataSet` is labeled on its own, so
+  /// a component that crosses a partition boundary gets a different id in each partition. When this
+  /// option is on, components of different partitions (on this or other ranks) that share a cell
+  /// edge are given the same id, and the ids are unique across all partitions. Partitions are
+  /// expected to duplicate the points on their shared boundaries. Executing on a partitioned data
+  /// set is then a collective operation.
+  VISKORES_CONT void SetMergeAcrossPartitions(bool merge) { this->MergeAcrossPartitions = merge; }
+  VISKORES_CONT bool GetMergeAcrossPartitions() const { return this->MergeAcrossPartitions; }
+
+  /// @brief Specify whether a table of statistics is computed for the components.
+  ///
+  /// The table is added to the output as fields associated with the whole data set (or,
+  /// for merged partitions, as global fields of the partitioned data set). Entry `i` of
+  /// each field describes component `i`. The fields are named after the output field:
+  ///
+  /// - `<output>_cell_count`: the number of cells.
+  /// - `<output>_measure`: the sum of the length, area, or volume of the cells.
+  /// - `<output>_centroid`: the center of the cells, weighted by their measure.
+  /// - `<output>_bounds_min` and `<output>_bounds_max`: the axis aligned bounding box.
+  /// - `<output>_<field>_integral`: the integral of each field given to
+  ///   `SetIntegratedFields`.
+  ///
+  /// All statistics come from a single grouping of the cells by component.
+  VISKORES_CONT void SetComputeComponentStatistics(bool compute)
+  {
+    this->ComputeComponentStatistics = compute;
+  }
+  VISKORES_CONT bool GetComputeComponentStatistics() const
+  {
+    return this->ComputeComponentStatistics;
+  }
+
+  /// @brief Specify the scalar fields that are integrated over each component.
+  ///
+  /// Cell fields are integrated as constant over each cell. Point fields use the average
+  /// of the values at the points of each cell. The integrals are only computed when
+  /// `SetComputeComponentStatistics` is on.
+  VISKORES_CONT void SetIntegratedFields(const std::vector<std::string>& fieldNames)
+  {
+    this->IntegratedFields = fieldNames;
+  }
+  VISKORES_CONT const std::vector<std::string>& GetIntegratedFields() const
+  {
+    return this->IntegratedFields;
+  }
+
 private:
   VISKORES_CONT
   viskores::cont::DataSet DoExecute(const viskores::cont::DataSet& input) override;
+  VISKORES_CONT viskores::cont::PartitionedDataSet DoExecutePartitions(
+    const viskores::cont::PartitionedDataSet& input) override;
+
+  bool MergeAcrossPartitions = false;
+  bool ComputeComponentStatistics = false;
+  std::vector<std::string> IntegratedFields;
 };
 
 } // namespace connected_components
@@ -8,6 +8,7 @@
 
 
 #include <viskores/filter/connected_components/ImageConnectivity.h>
+#include <viskores/filter/connected_components/internal/MergeComponents.h>
 #include <viskores/filter/connected_components/worklet/ImageConnectivity.h>
 
 namespace viskores
@@ -38,6 +39,37 @@ VISKORES_CONT viskores::cont::DataSet ImageConnectivity::DoExecute(
 
   return this->CreateResultFieldPoint(input, this->GetOutputFieldName(), component);
 }
+
+VISKORES_CONT viskores::cont::PartitionedDataSet ImageConnectivity::DoExecutePartitions(
+  const viskores::cont::PartitionedDataSet& input)
+{
+  if (!this->MergeAcrossPartitions)
+  {
+    return this->Filter::DoExecutePartitions(input);
+  }
+
+  std::vector<viskores::cont::DataSet> results;
+  std::vector<viskores::cont::ArrayHandle<viskores::Id>> components;
+  for (const auto& partition : input)
+  {
+    results.push_back(this->DoExecute(partition));
+    components.push_back(results.back()
+                           .GetField(this->GetOutputFieldName())
+                           .GetData()
+                           .AsArrayHandle<viskores::cont::ArrayHandle<viskores::Id>>());
+  }
+
+  internal::MergeComponentsAcrossPartitions(
+    input, viskores::cont::Field::Association::Points, components);
+
+  viskores::cont::PartitionedDataSet output;
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    results[i].AddPointField(this->GetOutputFieldName(), components[i]);
+    output.AppendPartition(results[i]);
+  }
+  return this->CreateResult(input, output);
+}
 } // namespace connected_components
 } // namespace filter
 } // namespace viskores
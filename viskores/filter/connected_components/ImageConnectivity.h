@@ -37,9 +37,24 @@ class VISKORES_FILTER_CONNECTED_COMPONENTS_EXPORT ImageConnectivity
 public:
   VISKORES_CONT ImageConnectivity() { this->SetOutputFieldName("component"); }
 
+  /// @brief Specify whether components are merged across the partitions of the input.
+  ///
+  /// By default, each partition of a `viskores::cont::PartitionedDataSet` is labeled on its own, so
+  /// a component that crosses a partition boundary gets a different id in each partition. When this
+  /// option is on, components of different partitions (on this or other ranks) that share a point
+  /// with the same field value are given the same id, and the ids are unique across all partitions.
+  /// Partitions are expected to duplicate the points on their shared boundaries. Executing on a
+  /// partitioned data set is then a collective operation.
+  VISKORES_CONT void SetMergeAcrossPartitions(bool merge) { this->MergeAcrossPartitions = merge; }
+  VISKORES_CONT bool GetMergeAcrossPartitions() const { return this->MergeAcrossPartitions; }
+
 private:
   VISKORES_CONT
   viskores::cont::DataSet DoExecute(const viskores::cont::DataSet& input) override;
+  VISKORES_CONT viskores::cont::PartitionedDataSet DoExecutePartitions(
+    const viskores::cont::PartitionedDataSet& input) override;
+
+  bool MergeAcrossPartitions = false;
 };
 } // namespace connected_components
 
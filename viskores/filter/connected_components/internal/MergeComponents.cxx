@@ -0,0 +1,427 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#include <viskores/cont/Algorithm.h>
+#include <viskores/cont/ArrayHandleConstant.h>
+#include <viskores/cont/ArrayHandleGroupVec.h>
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/ArrayHandlePermutation.h>
+#include <viskores/cont/AssignerPartitionedDataSet.h>
+#include <viskores/cont/BoundsCompute.h>
+#include <viskores/cont/BoundsGlobalCompute.h>
+#include <viskores/cont/DIYMemoryManagement.h>
+#include <viskores/cont/EnvironmentTracker.h>
+#include <viskores/cont/Invoker.h>
+#include <viskores/filter/connected_components/internal/MergeComponents.h>
+#include <viskores/filter/connected_components/worklet/CellSetDualGraph.h>
+#include <viskores/filter/connected_components/worklet/InnerJoin.h>
+#include <viskores/filter/connected_components/worklet/UnionFind.h>
+#include <viskores/worklet/WorkletMapField.h>
+
+VISKORES_THIRDPARTY_PRE_INCLUDE
+#include <viskores/thirdparty/diy/diy.h>
+VISKORES_THIRDPARTY_POST_INCLUDE
+
+namespace viskores
+{
+namespace filter
+{
+namespace connected_components
+{
+namespace internal
+{
+
+namespace
+{
+
+// A point is identified by its quantized coordinates and an edge by the quantized
+// coordinates of its two end points (in lexicographic order). A point uses the same
+// coordinates twice, so that points and edges can share the code below.
+using KeyType = viskores::Vec<viskores::Id, 6>;
+
+struct Quantizer
+{
+  viskores::Vec3f_64 Origin;
+  viskores::Float64 InverseSpacing;
+
+  template <typename PointType>
+  VISKORES_EXEC_CONT viskores::Id3 operator()(const PointType& point) const
+  {
+    viskores::Id3 result;
+    for (viskores::IdComponent d = 0; d < 3; ++d)
+    {
+      result[d] = static_cast<viskores::Id>(viskores::Round(
+        (static_cast<viskores::Float64>(point[d]) - this->Origin[d]) * this->InverseSpacing));
+    }
+    return result;
+  }
+};
+
+VISKORES_EXEC_CONT inline KeyType MakeKey(const viskores::Id3& a, const viskores::Id3& b)
+{
+  return KeyType(a[0], a[1], a[2], b[0], b[1], b[2]);
+}
+
+class PointKeys : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn point, FieldOut key);
+
+  VISKORES_CONT explicit PointKeys(const Quantizer& quantizer)
+    : Quantize(quantizer)
+  {
+  }
+
+  template <typename PointType>
+  VISKORES_EXEC void operator()(const PointType& point, KeyType& key) const
+  {
+    viskores::Id3 q = this->Quantize(point);
+    key = MakeKey(q, q);
+  }
+
+private:
+  Quantizer Quantize;
+};
+
+class EdgeKeys : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn edge, WholeArrayIn points, FieldOut key);
+
+  VISKORES_CONT explicit EdgeKeys(const Quantizer& quantizer)
+    : Quantize(quantizer)
+  {
+  }
+
+  template <typename PointPortalType>
+  VISKORES_EXEC void operator()(const viskores::Id2& edge,
+                                const PointPortalType& points,
+                                KeyType& key) const
+  {
+    // the point ids of an edge differ between partitions, so order the end points by
+    // their coordinates instead
+    viskores::Id3 a = this->Quantize(points.Get(edge[0]));
+    viskores::Id3 b = this->Quantize(points.Get(edge[1]));
+    key = (b < a) ? MakeKey(b, a) : MakeKey(a, b);
+  }
+
+private:
+  Quantizer Quantize;
+};
+
+// Whether both points of a key lie in a box given as (min x, min y, min z, max x, ...)
+struct KeyInBox
+{
+  KeyType Box;
+
+  VISKORES_EXEC_CONT bool operator()(const KeyType& key) const
+  {
+    for (viskores::IdComponent d = 0; d < 3; ++d)
+    {
+      if (key[d] < this->Box[d] || key[d] > this->Box[d + 3] || key[d + 3] < this->Box[d] ||
+          key[d + 3] > this->Box[d + 3])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+struct IsLink
+{
+  VISKORES_EXEC_CONT bool operator()(const viskores::Id2& pair) const { return pair[0] != pair[1]; }
+};
+
+class MakePair : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn first, FieldIn second, FieldOut pair);
+  using ExecutionSignature = _3(_1, _2);
+
+  VISKORES_EXEC viskores::Id2 operator()(viskores::Id first, viskores::Id second) const
+  {
+    return viskores::Id2(first, second);
+  }
+};
+
+class GraftPairs : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn pair, AtomicArrayInOut comp);
+
+  template <typename PairType, typename AtomicCompInOut>
+  VISKORES_EXEC void operator()(const PairType& pair, AtomicCompInOut& comp) const
+  {
+    viskores::worklet::connectivity::UnionFind::Unite(comp, pair[0], pair[1]);
+  }
+};
+
+class Relabel : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn local, WholeArrayIn global, FieldOut label);
+  using ExecutionSignature = _3(_1, _2);
+
+  VISKORES_CONT explicit Relabel(viskores::Id offset)
+    : Offset(offset)
+  {
+  }
+
+  template <typename GlobalPortalType>
+  VISKORES_EXEC viskores::Id operator()(viskores::Id local, const GlobalPortalType& global) const
+  {
+    return global.Get(local + this->Offset);
+  }
+
+private:
+  viskores::Id Offset;
+};
+
+template <typename T>
+void Append(const viskores::cont::ArrayHandle<T>& values, viskores::cont::ArrayHandle<T>& result)
+{
+  viskores::cont::Algorithm::CopySubRange(
+    values, 0, values.GetNumberOfValues(), result, result.GetNumberOfValues());
+}
+
+// Append the values of all ranks to the values of this rank
+template <typename T>
+void AllGatherValues(std::vector<T>& values)
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  if (comm.size() > 1)
+  {
+    std::vector<std::vector<T>> gathered;
+    viskoresdiy::mpi::all_gather(comm, values, gathered);
+    values.clear();
+    for (const auto& rankValues : gathered)
+    {
+      values.insert(values.end(), rankValues.begin(), rankValues.end());
+    }
+  }
+}
+
+// The points or cell edges of a partition that may be shared with other partitions
+struct BoundaryBlock
+{
+  viskores::cont::ArrayHandle<KeyType> Keys;
+  viskores::cont::ArrayHandle<viskores::Id> Labels;
+  viskores::cont::ArrayHandle<viskores::Id2> Links;
+};
+
+} // anonymous namespace
+
+void MergeComponentsAcrossPartitions(
+  const viskores::cont::PartitionedDataSet& input,
+  viskores::cont::Field::Association association,
+  std::vector<viskores::cont::ArrayHandle<viskores::Id>>& components)
+{
+  using Algorithm = viskores::cont::Algorithm;
+  viskores::cont::Invoker invoke;
+
+  const viskores::Id numLocalPartitions = input.GetNumberOfPartitions();
+  viskores::cont::AssignerPartitionedDataSet assigner(numLocalPartitions);
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  std::vector<int> localGids;
+  assigner.local_gids(comm.rank(), localGids);
+
+  // global labels are the local labels shifted by the components of the previous partitions
+  std::vector<viskores::Id> numComponents;
+  for (const auto& partitionComponents : components)
+  {
+    numComponents.push_back(
+      Algorithm::Reduce(partitionComponents, viskores::Id{ -1 }, viskores::Maximum()) + 1);
+  }
+  AllGatherValues(numComponents);
+  std::vector<viskores::Id> offsets(numComponents.size() + 1, 0);
+  for (std::size_t gid = 0; gid < numComponents.size(); ++gid)
+  {
+    offsets[gid + 1] = offsets[gid] + numComponents[gid];
+  }
+
+  // quantize the coordinates relative to the global bounds, so that coincident points of
+  // different partitions get the same key
+  viskores::Bounds globalBounds = viskores::cont::BoundsGlobalCompute(input);
+  Quantizer quantize{ viskores::Vec3f_64(0), 1.0 };
+  viskores::Float64 extent = 0;
+  if (globalBounds.IsNonEmpty())
+  {
+    quantize.Origin = globalBounds.MinCorner();
+    extent = viskores::Max(
+      globalBounds.X.Length(), viskores::Max(globalBounds.Y.Length(), globalBounds.Z.Length()));
+  }
+  quantize.InverseSpacing = (extent > 0) ? 1.0e6 / extent : 1.0;
+
+  // quantized bounds of each partition, enlarged by one step to allow for round off
+  std::vector<viskores::Id> boxes;
+  for (viskores::Id partitionId = 0; partitionId < numLocalPartitions; ++partitionId)
+  {
+    viskores::Bounds bounds = viskores::cont::BoundsCompute(input.GetPartition(partitionId));
+    KeyType box(1, 1, 1, 0, 0, 0);
+    if (bounds.IsNonEmpty())
+    {
+      box = MakeKey(quantize(bounds.MinCorner()) - viskores::Id3(1),
+                    quantize(bounds.MaxCorner()) + viskores::Id3(1));
+    }
+    boxes.insert(boxes.end(), &box[0], &box[0] + 6);
+  }
+  AllGatherValues(boxes);
+  auto getBox = [&](int gid)
+  {
+    KeyType box;
+    std::copy_n(boxes.begin() + 6 * gid, 6, &box[0]);
+    return box;
+  };
+  auto intersect = [](const KeyType& a, const KeyType& b)
+  {
+    for (viskores::IdComponent d = 0; d < 3; ++d)
+    {
+      if (viskores::Max(a[d], b[d]) > viskores::Min(a[d + 3], b[d + 3]))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  viskoresdiy::Master master(
+    comm,
+    /*threads*/ 1,
+    /*limit*/ -1,
+    []() -> void* { return new BoundaryBlock(); },
+    [](void* ptr) { delete static_cast<BoundaryBlock*>(ptr); });
+  for (viskores::Id partitionId = 0; partitionId < numLocalPartitions; ++partitionId)
+  {
+    const int gid = localGids[static_cast<std::size_t>(partitionId)];
+    const viskores::cont::DataSet& partition = input.GetPartition(partitionId);
+    const auto& partitionComponents = components[static_cast<std::size_t>(partitionId)];
+    auto points = partition.GetCoordinateSystem().GetDataAsMultiplexer();
+
+    BoundaryBlock* block = new BoundaryBlock();
+    viskores::cont::ArrayHandle<viskores::Id> labels;
+    if (association == viskores::cont::Field::Association::Points)
+    {
+      invoke(PointKeys{ quantize }, points, block->Keys);
+      labels = partitionComponents;
+    }
+    else
+    {
+      viskores::cont::ArrayHandle<viskores::Id> cellIds;
+      viskores::cont::ArrayHandle<viskores::Id2> cellEdges;
+      viskores::worklet::connectivity::CellSetDualGraph::EdgeToCellConnectivity(
+        partition.GetCellSet(), cellIds, cellEdges);
+      invoke(EdgeKeys{ quantize }, cellEdges, points, block->Keys);
+      Algorithm::Copy(viskores::cont::make_ArrayHandlePermutation(cellIds, partitionComponents),
+                      labels);
+    }
+    Algorithm::Transform(labels,
+                         viskores::cont::make_ArrayHandleConstant(
+                           offsets[static_cast<std::size_t>(gid)], labels.GetNumberOfValues()),
+                         block->Labels,
+                         viskores::Add());
+
+    viskoresdiy::Link* link = new viskoresdiy::Link();
+    for (int neighbor = 0; neighbor < assigner.nblocks(); ++neighbor)
+    {
+      if (neighbor != gid && intersect(getBox(gid), getBox(neighbor)))
+      {
+        link->add_neighbor(viskoresdiy::BlockID{ neighbor, assigner.rank(neighbor) });
+      }
+    }
+    master.add(gid, block, link);
+  }
+
+  // send the keys inside the bounds of each neighbor to that neighbor
+  master.foreach (
+    [&](BoundaryBlock* block, const viskoresdiy::Master::ProxyWithLink& cp)
+    {
+      viskores::cont::ArrayHandle<KeyType> boundaryKeys;
+      viskores::cont::ArrayHandle<viskores::Id> boundaryLabels;
+      for (int i = 0; i < cp.link()->size(); ++i)
+      {
+        const viskoresdiy::BlockID target = cp.link()->target(i);
+        KeyInBox inBox{ getBox(target.gid) };
+        viskores::cont::ArrayHandle<KeyType> keys;
+        viskores::cont::ArrayHandle<viskores::Id> labels;
+        Algorithm::CopyIf(block->Keys, block->Keys, keys, inBox);
+        Algorithm::CopyIf(block->Labels, block->Keys, labels, inBox);
+        cp.enqueue(target, keys);
+        cp.enqueue(target, labels);
+        Append(keys, boundaryKeys);
+        Append(labels, boundaryLabels);
+      }
+      block->Keys = boundaryKeys;
+      block->Labels = boundaryLabels;
+    });
+  viskores::cont::DIYMasterExchange(master);
+
+  // link the labels of all copies of a key to the smallest of these labels
+  master.foreach (
+    [&](BoundaryBlock* block, const viskoresdiy::Master::ProxyWithLink& cp)
+    {
+      for (int i = 0; i < cp.link()->size(); ++i)
+      {
+        const int sender = cp.link()->target(i).gid;
+        viskores::cont::ArrayHandle<KeyType> keys;
+        viskores::cont::ArrayHandle<viskores::Id> labels;
+        cp.dequeue(sender, keys);
+        cp.dequeue(sender, labels);
+        Append(keys, block->Keys);
+        Append(labels, block->Labels);
+      }
+      Algorithm::SortByKey(block->Keys, block->Labels);
+      viskores::cont::ArrayHandle<viskores::Id> smallestLabels;
+      Algorithm::ScanInclusiveByKey(
+        block->Keys, block->Labels, smallestLabels, viskores::Minimum());
+      viskores::cont::ArrayHandle<viskores::Id2> pairs;
+      invoke(MakePair{}, block->Labels, smallestLabels, pairs);
+      Algorithm::CopyIf(pairs, pairs, block->Links, IsLink{});
+    });
+
+  // The links only involve components on partition boundaries, so there are few of them
+  // and every rank can resolve all of them.
+  std::vector<viskores::Id> links;
+  master.foreach (
+    [&](BoundaryBlock* block, const viskoresdiy::Master::ProxyWithLink&)
+    {
+      auto portal = block->Links.ReadPortal();
+      for (viskores::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+      {
+        links.push_back(portal.Get(i)[0]);
+        links.push_back(portal.Get(i)[1]);
+      }
+    });
+  AllGatherValues(links);
+
+  viskores::cont::ArrayHandle<viskores::Id> globalComponents;
+  Algorithm::Copy(viskores::cont::ArrayHandleIndex(offsets.back()), globalComponents);
+  invoke(GraftPairs{},
+         viskores::cont::make_ArrayHandleGroupVec<2>(
+           viskores::cont::make_ArrayHandle(links, viskores::CopyFlag::Off)),
+         globalComponents);
+  invoke(viskores::worklet::connectivity::PointerJumping{}, globalComponents);
+  viskores::worklet::connectivity::Renumber::Run(globalComponents);
+
+  for (viskores::Id partitionId = 0; partitionId < numLocalPartitions; ++partitionId)
+  {
+    auto& partitionComponents = components[static_cast<std::size_t>(partitionId)];
+    const int gid = localGids[static_cast<std::size_t>(partitionId)];
+    viskores::cont::ArrayHandle<viskores::Id> merged;
+    invoke(Relabel{ offsets[static_cast<std::size_t>(gid)] },
+           partitionComponents,
+           globalComponents,
+           merged);
+    partitionComponents = merged;
+  }
+}
+
+} // namespace internal
+} // namespace connected_components
+} // namespace filter
+} // namespace viskores
@@ -0,0 +1,55 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_filter_connected_components_internal_MergeComponents_h
+#define viskores_filter_connected_components_internal_MergeComponents_h
+
+#include <viskores/cont/ArrayHandle.h>
+#include <viskores/cont/Field.h>
+#include <viskores/cont/PartitionedDataSet.h>
+
+#include <vector>
+
+namespace viskores
+{
+namespace filter
+{
+namespace connected_components
+{
+namespace internal
+{
+
+/// \brief Relabel the components of the partitions so that they are consistent globally.
+///
+/// `components` holds one array of component labels per partition of `input`, where
+/// the labels of each partition are in the range [0, number of components of the
+/// partition). On return, the labels are in the range [0, number of global components),
+/// and components of different partitions (on this or other ranks) that touch each other
+/// have the same label.
+///
+/// For point components (`Association::Points`), two components touch if they contain
+/// points with the same coordinates. For cell components (`Association::Cells`), two
+/// components touch if they contain cells that have an edge with the same end point
+/// coordinates, which matches the edge connectivity used within a partition.
+///
+/// Only the points and edges that lie inside the bounds of a neighboring partition are
+/// exchanged, and only with that neighbor. The resulting label equivalences are merged
+/// with a union-find over the components of all partitions.
+///
+/// This is a collective operation when there is more than one rank.
+void MergeComponentsAcrossPartitions(
+  const viskores::cont::PartitionedDataSet& input,
+  viskores::cont::Field::Association association,
+  std::vector<viskores::cont::ArrayHandle<viskores::Id>>& components);
+
+} // namespace internal
+} // namespace connected_components
+} // namespace filter
+} // namespace viskores
+
+#endif
@@ -8,6 +8,9 @@
 
 
 #include <viskores/cont/Algorithm.h>
+#include <viskores/cont/ArrayGetValues.h>
+#include <viskores/cont/DataSetBuilderUniform.h>
+#include <viskores/cont/PartitionedDataSet.h>
 #include <viskores/cont/testing/MakeTestDataSet.h>
 #include <viskores/cont/testing/Testing.h>
 #include <viskores/filter/connected_components/CellSetConnectivity.h>
@@ -85,11 +88,120 @@ public:
                          "Wrong number of connected components");
   }
 
+  static void TestMergeAcrossPartitions()
+  {
+    // the first two partitions share a column of points, the third one is separate
+    viskores::cont::PartitionedDataSet input;
+    for (viskores::FloatDefault x : { 0.0f, 2.0f, 10.0f })
+    {
+      input.AppendPartition(viskores::cont::DataSetBuilderUniform::Create(
+        viskores::Id2(3, 3), viskores::Vec2f(x, 0), viskores::Vec2f(1, 1)));
+    }
+
+    viskores::filter::connected_components::CellSetConnectivity connectivity;
+    VISKORES_TEST_ASSERT(!connectivity.GetMergeAcrossPartitions(), "Merge should be off");
+    connectivity.SetMergeAcrossPartitions(true);
+    const viskores::cont::PartitionedDataSet output = connectivity.Execute(input);
+
+    std::vector<viskores::Id> labels;
+    for (viskores::Id i = 0; i < output.GetNumberOfPartitions(); ++i)
+    {
+      viskores::cont::ArrayHandle<viskores::Id> componentArray;
+      output.GetPartition(i).GetField("component").GetData().AsArrayHandle(componentArray);
+      auto portal = componentArray.ReadPortal();
+      VISKORES_TEST_ASSERT(portal.GetNumberOfValues() == 4, "Wrong number of cells");
+      for (viskores::Id cell = 1; cell < portal.GetNumberOfValues(); ++cell)
+      {
+        VISKORES_TEST_ASSERT(portal.Get(cell) == portal.Get(0), "Partition was split");
+      }
+      labels.push_back(portal.Get(0));
+    }
+    VISKORES_TEST_ASSERT(labels[0] == labels[1], "Touching partitions were not merged");
+    VISKORES_TEST_ASSERT(labels[0] != labels[2], "Separate partitions were merged");
+    VISKORES_TEST_ASSERT(labels[0] + labels[2] == 1, "Components are not numbered from 0");
+  }
+
+  template <typename T, typename DataType>
+  static T GetStatistic(const DataType& output, const std::string& name, viskores::Id component)
+  {
+    viskores::cont::ArrayHandle<T> values;
+    output.GetField(name).GetData().AsArrayHandle(values);
+    return viskores::cont::ArrayGetValue(component, values);
+  }
+
+  template <typename DataType>
+  static void CheckStatistics(const DataType& output,
+                              viskores::Id component,
+                              viskores::Id numCells,
+                              viskores::Float64 centerX,
+                              const viskores::Vec3f_64& boundsMin,
+                              const viskores::Vec3f_64& boundsMax)
+  {
+    using viskores::Float64;
+    using viskores::Vec3f_64;
+    const Float64 area = static_cast<Float64>(numCells);
+    VISKORES_TEST_ASSERT(
+      GetStatistic<viskores::Id>(output, "component_cell_count", component) == numCells,
+      "Wrong number of cells");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Float64>(output, "component_measure", component), area),
+      "Wrong measure");
+    VISKORES_TEST_ASSERT(test_equal(GetStatistic<Vec3f_64>(output, "component_centroid", component),
+                                    Vec3f_64(centerX, 1, 0)),
+                         "Wrong centroid");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Vec3f_64>(output, "component_bounds_min", component), boundsMin),
+      "Wrong minimum bounds");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Vec3f_64>(output, "component_bounds_max", component), boundsMax),
+      "Wrong maximum bounds");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Float64>(output, "component_x_integral", component), area * centerX),
+      "Wrong integral of point field");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Float64>(output, "component_density_integral", component), 2 * area),
+      "Wrong integral of cell field");
+  }
+
+  static void TestComponentStatistics()
+  {
+    // two touching partitions of 2x2 unit squares and a separate one
+    viskores::cont::PartitionedDataSet input;
+    for (viskores::FloatDefault x : { 0.0f, 2.0f, 10.0f })
+    {
+      viskores::cont::DataSet partition = viskores::cont::DataSetBuilderUniform::Create(
+        viskores::Id2(3, 3), viskores::Vec2f(x, 0), viskores::Vec2f(1, 1));
+      partition.AddPointField("x", std::vector<viskores::Float64>{ x, x + 1, x + 2, x, x + 1,
+                                                                   x + 2, x, x + 1, x + 2 });
+      partition.AddCellField("density", std::vector<viskores::Float32>(4, 2.0f));
+      input.AppendPartition(partition);
+    }
+
+    viskores::filter::connected_components::CellSetConnectivity connectivity;
+    connectivity.SetComputeComponentStatistics(true);
+    connectivity.SetIntegratedFields({ "x", "density" });
+
+    const viskores::cont::DataSet single = connectivity.Execute(input.GetPartition(0));
+    VISKORES_TEST_ASSERT(single.GetField("component_measure").GetNumberOfValues() == 1,
+                         "Wrong number of component statistics");
+    CheckStatistics(single, 0, 4, 1, { 0, 0, 0 }, { 2, 2, 0 });
+
+    connectivity.SetMergeAcrossPartitions(true);
+    const viskores::cont::PartitionedDataSet merged = connectivity.Execute(input);
+    viskores::cont::ArrayHandle<viskores::Id> componentArray;
+    merged.GetPartition(2).GetField("component").GetData().AsArrayHandle(componentArray);
+    const viskores::Id separate = viskores::cont::ArrayGetValue(0, componentArray);
+    CheckStatistics(merged, 1 - separate, 8, 2, { 0, 0, 0 }, { 4, 2, 0 });
+    CheckStatistics(merged, separate, 4, 11, { 10, 0, 0 }, { 12, 2, 0 });
+  }
+
   void operator()() const
   {
     TestCellSetConnectivity::TestTangleIsosurface();
     TestCellSetConnectivity::TestExplicitDataSet();
     TestCellSetConnectivity::TestUniformDataSet();
+    TestCellSetConnectivity::TestMergeAcrossPartitions();
+    TestCellSetConnectivity::TestComponentStatistics();
   }
 };
 }
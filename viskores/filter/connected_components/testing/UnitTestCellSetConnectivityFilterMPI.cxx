@@ -0,0 +1,184 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#include <viskores/cont/ArrayGetValues.h>
+#include <viskores/cont/DataSetBuilderUniform.h>
+#include <viskores/cont/EnvironmentTracker.h>
+#include <viskores/cont/testing/Testing.h>
+#include <viskores/filter/connected_components/CellSetConnectivity.h>
+#include <viskores/thirdparty/diy/diy.h>
+#include <viskores/thirdparty/diy/environment.h>
+
+#include <algorithm>
+#include <set>
+
+namespace
+{
+
+// Each rank has two partitions of 2x2 unit squares in a row along x. Every three consecutive
+// partitions touch and form a component, so the components span ranks.
+constexpr viskores::Id PartitionsPerRank = 2;
+constexpr viskores::Id PartitionsPerComponent = 3;
+
+viskores::Float64 PartitionOrigin(viskores::Id gid)
+{
+  return static_cast<viskores::Float64>(2 * gid + 10 * (gid / PartitionsPerComponent));
+}
+
+viskores::cont::PartitionedDataSet MakeInput()
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  viskores::cont::PartitionedDataSet input;
+  for (viskores::Id i = 0; i < PartitionsPerRank; ++i)
+  {
+    const viskores::Id gid = PartitionsPerRank * comm.rank() + i;
+    const viskores::Float64 x = PartitionOrigin(gid);
+    viskores::cont::DataSet partition = viskores::cont::DataSetBuilderUniform::Create(
+      viskores::Id2(3, 3),
+      viskores::Vec2f(static_cast<viskores::FloatDefault>(x), 0),
+      viskores::Vec2f(1, 1));
+    partition.AddPointField("x", std::vector<viskores::Float64>{ x, x + 1, x + 2, x, x + 1,
+                                                                 x + 2, x, x + 1, x + 2 });
+    partition.AddCellField("density", std::vector<viskores::Float32>(4, 2.0f));
+    input.AppendPartition(partition);
+  }
+  return input;
+}
+
+// Returns the component of each partition of all ranks, ordered by partition id.
+std::vector<viskores::Id> GatherLabels(const viskores::cont::PartitionedDataSet& output)
+{
+  std::vector<viskores::Id> labels;
+  for (viskores::Id i = 0; i < output.GetNumberOfPartitions(); ++i)
+  {
+    viskores::cont::ArrayHandle<viskores::Id> componentArray;
+    output.GetPartition(i).GetField("component").GetData().AsArrayHandle(componentArray);
+    auto portal = componentArray.ReadPortal();
+    VISKORES_TEST_ASSERT(portal.GetNumberOfValues() == 4, "Wrong number of cells");
+    for (viskores::Id cell = 1; cell < portal.GetNumberOfValues(); ++cell)
+    {
+      VISKORES_TEST_ASSERT(portal.Get(cell) == portal.Get(0), "Partition was split");
+    }
+    labels.push_back(portal.Get(0));
+  }
+
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  std::vector<std::vector<viskores::Id>> gathered;
+  viskoresdiy::mpi::all_gather(comm, labels, gathered);
+  std::vector<viskores::Id> allLabels;
+  for (const auto& rankLabels : gathered)
+  {
+    allLabels.insert(allLabels.end(), rankLabels.begin(), rankLabels.end());
+  }
+  return allLabels;
+}
+
+void CheckLabels(const std::vector<viskores::Id>& labels)
+{
+  const viskores::Id numPartitions = static_cast<viskores::Id>(labels.size());
+  const viskores::Id numComponents =
+    (numPartitions + PartitionsPerComponent - 1) / PartitionsPerComponent;
+  std::set<viskores::Id> components;
+  for (viskores::Id gid = 0; gid < numPartitions; ++gid)
+  {
+    const viskores::Id label = labels[static_cast<std::size_t>(gid)];
+    VISKORES_TEST_ASSERT(label >= 0 && label < numComponents, "Components are not numbered from 0");
+    if (gid % PartitionsPerComponent != 0)
+    {
+      VISKORES_TEST_ASSERT(label == labels[static_cast<std::size_t>(gid - 1)],
+                           "Touching partitions were not merged");
+    }
+    components.insert(label);
+  }
+  VISKORES_TEST_ASSERT(static_cast<viskores::Id>(components.size()) == numComponents,
+                       "Separate partitions were merged");
+}
+
+void TestMergeAcrossRanks()
+{
+  std::cout << "Merge components across ranks" << std::endl;
+  viskores::filter::connected_components::CellSetConnectivity connectivity;
+  connectivity.SetMergeAcrossPartitions(true);
+  CheckLabels(GatherLabels(connectivity.Execute(MakeInput())));
+}
+
+template <typename T>
+T GetStatistic(const viskores::cont::PartitionedDataSet& output,
+               const std::string& name,
+               viskores::Id component)
+{
+  viskores::cont::ArrayHandle<T> values;
+  output.GetField(name).GetData().AsArrayHandle(values);
+  return viskores::cont::ArrayGetValue(component, values);
+}
+
+void TestStatisticsAcrossRanks()
+{
+  std::cout << "Component statistics across ranks" << std::endl;
+  viskores::filter::connected_components::CellSetConnectivity connectivity;
+  connectivity.SetMergeAcrossPartitions(true);
+  connectivity.SetComputeComponentStatistics(true);
+  connectivity.SetIntegratedFields({ "x", "density" });
+  const viskores::cont::PartitionedDataSet output = connectivity.Execute(MakeInput());
+  const std::vector<viskores::Id> labels = GatherLabels(output);
+  CheckLabels(labels);
+
+  // the statistics are global, so every rank checks all components
+  using viskores::Float64;
+  using viskores::Vec3f_64;
+  const viskores::Id numPartitions = static_cast<viskores::Id>(labels.size());
+  VISKORES_TEST_ASSERT(output.GetField("component_measure").GetNumberOfValues() ==
+                         (numPartitions + PartitionsPerComponent - 1) / PartitionsPerComponent,
+                       "Wrong number of component statistics");
+  for (viskores::Id first = 0; first < numPartitions; first += PartitionsPerComponent)
+  {
+    const viskores::Id last = std::min(first + PartitionsPerComponent, numPartitions) - 1;
+    const viskores::Id component = labels[static_cast<std::size_t>(first)];
+    const viskores::Id numCells = 4 * (last - first + 1);
+    const Float64 area = static_cast<Float64>(numCells);
+    const Float64 centerX = (PartitionOrigin(first) + PartitionOrigin(last)) / 2 + 1;
+    VISKORES_TEST_ASSERT(
+      GetStatistic<viskores::Id>(output, "component_cell_count", component) == numCells,
+      "Wrong number of cells");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Float64>(output, "component_measure", component), area),
+      "Wrong measure");
+    VISKORES_TEST_ASSERT(test_equal(GetStatistic<Vec3f_64>(output, "component_centroid", component),
+                                    Vec3f_64(centerX, 1, 0)),
+                         "Wrong centroid");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Vec3f_64>(output, "component_bounds_min", component),
+                 Vec3f_64(PartitionOrigin(first), 0, 0)),
+      "Wrong minimum bounds");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Vec3f_64>(output, "component_bounds_max", component),
+                 Vec3f_64(PartitionOrigin(last) + 2, 2, 0)),
+      "Wrong maximum bounds");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Float64>(output, "component_x_integral", component), area * centerX),
+      "Wrong integral of point field");
+    VISKORES_TEST_ASSERT(
+      test_equal(GetStatistic<Float64>(output, "component_density_integral", component), 2 * area),
+      "Wrong integral of cell field");
+  }
+}
+
+void TestConnectivityMPI()
+{
+  TestMergeAcrossRanks();
+  TestStatisticsAcrossRanks();
+}
+
+} // anonymous namespace
+
+int UnitTestCellSetConnectivityFilterMPI(int argc, char* argv[])
+{
+  viskoresdiy::mpi::environment env(argc, argv);
+  viskoresdiy::mpi::communicator world;
+  return viskores::cont::testing::Testing::Run(TestConnectivityMPI, argc, argv);
+}
@@ -12,8 +12,11 @@
 #include <viskores/cont/DataSet.h>
 
 #include <viskores/cont/DataSetBuilderUniform.h>
+#include <viskores/cont/PartitionedDataSet.h>
 #include <viskores/cont/testing/Testing.h>
 
+#include <map>
+
 namespace
 {
 
@@ -59,9 +62,78 @@ void TestImageConnectivity()
       "Wrong result for ImageConnectivity");
   }
 }
+
+void TestMergeAcrossPartitions()
+{
+  viskores::cont::DataSet dataSet = MakeTestDataSet();
+  viskores::cont::ArrayHandle<viskores::UInt8> pixels;
+  dataSet.GetField("color").GetData().AsArrayHandle(pixels);
+  auto pixelPortal = pixels.ReadPortal();
+
+  // split the image into two partitions that share column 4
+  viskores::cont::PartitionedDataSet input;
+  for (viskores::Id2 columns : { viskores::Id2(0, 4), viskores::Id2(4, 7) })
+  {
+    const viskores::Id width = columns[1] - columns[0] + 1;
+    viskores::cont::DataSet partition = viskores::cont::DataSetBuilderUniform::Create(
+      viskores::Id3(width, 8, 1),
+      viskores::Vec3f(static_cast<viskores::FloatDefault>(columns[0]), 0, 0),
+      viskores::Vec3f(1, 1, 1));
+    std::vector<viskores::UInt8> partitionPixels;
+    for (viskores::Id y = 0; y < 8; ++y)
+    {
+      for (viskores::Id x = columns[0]; x <= columns[1]; ++x)
+      {
+        partitionPixels.push_back(pixelPortal.Get(y * 8 + x));
+      }
+    }
+    partition.AddPointField("color", partitionPixels);
+    input.AppendPartition(partition);
+  }
+
+  viskores::filter::connected_components::ImageConnectivity connectivity;
+  connectivity.SetActiveField("color");
+  connectivity.SetMergeAcrossPartitions(true);
+  const viskores::cont::PartitionedDataSet output = connectivity.Execute(input);
+
+  // the labels must match those of the whole image up to a renumbering
+  viskores::cont::ArrayHandle<viskores::Id> expectedArray;
+  connectivity.SetMergeAcrossPartitions(false);
+  connectivity.Execute(dataSet).GetField("component").GetData().AsArrayHandle(expectedArray);
+  auto expectedPortal = expectedArray.ReadPortal();
+  std::map<viskores::Id, viskores::Id> expectedToMerged;
+  std::map<viskores::Id, viskores::Id> mergedToExpected;
+  viskores::Id columnStart = 0;
+  for (const viskores::cont::DataSet& partition : output)
+  {
+    viskores::cont::ArrayHandle<viskores::Id> componentArray;
+    partition.GetField("component").GetData().AsArrayHandle(componentArray);
+    auto portal = componentArray.ReadPortal();
+    const viskores::Id width = portal.GetNumberOfValues() / 8;
+    for (viskores::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+    {
+      viskores::Id expected = expectedPortal.Get((i / width) * 8 + columnStart + i % width);
+      viskores::Id merged = portal.Get(i);
+      expectedToMerged.emplace(expected, merged);
+      mergedToExpected.emplace(merged, expected);
+      VISKORES_TEST_ASSERT(expectedToMerged[expected] == merged &&
+                             mergedToExpected[merged] == expected,
+                           "Wrong merged components for ImageConnectivity");
+    }
+    columnStart = 4;
+  }
+  VISKORES_TEST_ASSERT(mergedToExpected.size() == 4, "Wrong number of merged components");
+  VISKORES_TEST_ASSERT(mergedToExpected.rbegin()->first == 3, "Components are not numbered from 0");
+}
+
+void TestImageConnectivityFilter()
+{
+  TestImageConnectivity();
+  TestMergeAcrossPartitions();
+}
 }
 
 int UnitTestImageConnectivityFilter(int argc, char* argv[])
 {
-  return viskores::cont::testing::Testing::Run(TestImageConnectivity, argc, argv);
+  return viskores::cont::testing::Testing::Run(TestImageConnectivityFilter, argc, argv);
 }
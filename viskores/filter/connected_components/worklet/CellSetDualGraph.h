@@ -100,6 +100,8 @@ class CellSetDualGraph
 {
   using Algorithm = viskores::cont::Algorithm;
 
+public:
+  /// Edges of all cells (as pairs of point ids) and the cell each edge belongs to.
   static void EdgeToCellConnectivity(const viskores::cont::UnknownCellSet& cellSet,
                                      viskores::cont::ArrayHandle<viskores::Id>& cellIds,
                                      viskores::cont::ArrayHandle<viskores::Id2>& cellEdges)
@@ -115,7 +117,6 @@ class CellSetDualGraph
     edgeExtractDisp.Invoke(cellSet, cellIds, cellEdges);
   }
 
-public:
   struct degree2
   {
     VISKORES_EXEC
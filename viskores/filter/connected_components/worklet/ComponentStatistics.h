@@ -0,0 +1,274 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_worklet_connectivity_ComponentStatistics_h
+#define viskores_worklet_connectivity_ComponentStatistics_h
+
+#include <viskores/CellShape.h>
+#include <viskores/cont/ArrayHandle.h>
+#include <viskores/cont/Invoker.h>
+#include <viskores/cont/UnknownCellSet.h>
+#include <viskores/exec/CellMeasure.h>
+#include <viskores/worklet/Keys.h>
+#include <viskores/worklet/WorkletMapTopology.h>
+#include <viskores/worklet/WorkletReduceByKey.h>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace connectivity
+{
+namespace detail
+{
+
+struct CellGeometry : public viskores::worklet::WorkletVisitCellsWithPoints
+{
+  using ControlSignature = void(CellSetIn cellSet,
+                                FieldInPoint coords,
+                                FieldOutCell measure,
+                                FieldOutCell center,
+                                FieldOutCell minCorner,
+                                FieldOutCell maxCorner);
+  using ExecutionSignature = void(CellShape, PointCount, _2, _3, _4, _5, _6);
+  using InputDomain = _1;
+
+  template <typename CellShapeType, typename PointVecType>
+  VISKORES_EXEC void operator()(CellShapeType cellShape,
+                                viskores::IdComponent numPoints,
+                                const PointVecType& points,
+                                viskores::Float64& measure,
+                                viskores::Vec3f_64& center,
+                                viskores::Vec3f_64& minCorner,
+                                viskores::Vec3f_64& maxCorner) const
+  {
+    viskores::ErrorCode ec;
+    switch (cellShape.Id)
+    {
+      viskoresGenericCellShapeMacro(
+        measure = viskores::exec::CellMeasure<viskores::Float64>(
+          numPoints, points, CellShapeTag(), ec));
+      default:
+        measure = 0;
+    }
+    // inverted cells have a negative measure, but still add to the size of the component
+    measure = viskores::Abs(measure);
+
+    center = viskores::Vec3f_64(0);
+    minCorner = viskores::Vec3f_64(viskores::Infinity64());
+    maxCorner = viskores::Vec3f_64(viskores::NegativeInfinity64());
+    for (viskores::IdComponent i = 0; i < numPoints; ++i)
+    {
+      viskores::Vec3f_64 point(points[i]);
+      center += point;
+      minCorner = viskores::Min(minCorner, point);
+      maxCorner = viskores::Max(maxCorner, point);
+    }
+    if (numPoints > 0)
+    {
+      center = center / static_cast<viskores::Float64>(numPoints);
+    }
+  }
+};
+
+struct ReduceCellGeometry : public viskores::worklet::WorkletReduceByKey
+{
+  using ControlSignature = void(KeysIn components,
+                                ValuesIn measure,
+                                ValuesIn center,
+                                ValuesIn minCorner,
+                                ValuesIn maxCorner,
+                                ReducedValuesOut numberOfCells,
+                                ReducedValuesOut measureSum,
+                                ReducedValuesOut weightedCenterSum,
+                                ReducedValuesOut centerSum,
+                                ReducedValuesOut componentMinCorner,
+                                ReducedValuesOut componentMaxCorner);
+  using ExecutionSignature = void(_2, _3, _4, _5, _6, _7, _8, _9, _10, _11);
+  using InputDomain = _1;
+
+  template <typename MeasureVecType, typename PointVecType>
+  VISKORES_EXEC void operator()(const MeasureVecType& measure,
+                                const PointVecType& center,
+                                const PointVecType& minCorner,
+                                const PointVecType& maxCorner,
+                                viskores::Id& numberOfCells,
+                                viskores::Float64& measureSum,
+                                viskores::Vec3f_64& weightedCenterSum,
+                                viskores::Vec3f_64& centerSum,
+                                viskores::Vec3f_64& componentMinCorner,
+                                viskores::Vec3f_64& componentMaxCorner) const
+  {
+    numberOfCells = measure.GetNumberOfComponents();
+    measureSum = 0;
+    weightedCenterSum = viskores::Vec3f_64(0);
+    centerSum = viskores::Vec3f_64(0);
+    componentMinCorner = minCorner[0];
+    componentMaxCorner = maxCorner[0];
+    for (viskores::IdComponent i = 0; i < measure.GetNumberOfComponents(); ++i)
+    {
+      measureSum += measure[i];
+      weightedCenterSum += measure[i] * center[i];
+      centerSum += center[i];
+      componentMinCorner = viskores::Min(componentMinCorner, viskores::Vec3f_64(minCorner[i]));
+      componentMaxCorner = viskores::Max(componentMaxCorner, viskores::Vec3f_64(maxCorner[i]));
+    }
+  }
+};
+
+struct AveragePointsToCell : public viskores::worklet::WorkletVisitCellsWithPoints
+{
+  using ControlSignature = void(CellSetIn cellSet, FieldInPoint values, FieldOutCell average);
+  using ExecutionSignature = void(PointCount, _2, _3);
+  using InputDomain = _1;
+
+  template <typename ValueVecType>
+  VISKORES_EXEC void operator()(viskores::IdComponent numPoints,
+                                const ValueVecType& values,
+                                viskores::Float64& average) const
+  {
+    average = 0;
+    for (viskores::IdComponent i = 0; i < numPoints; ++i)
+    {
+      average += static_cast<viskores::Float64>(values[i]);
+    }
+    if (numPoints > 0)
+    {
+      average /= static_cast<viskores::Float64>(numPoints);
+    }
+  }
+};
+
+struct IntegrateByComponent : public viskores::worklet::WorkletReduceByKey
+{
+  using ControlSignature = void(KeysIn components,
+                                ValuesIn measure,
+                                ValuesIn values,
+                                ReducedValuesOut integral);
+  using ExecutionSignature = void(_2, _3, _4);
+  using InputDomain = _1;
+
+  template <typename MeasureVecType, typename ValueVecType>
+  VISKORES_EXEC void operator()(const MeasureVecType& measure,
+                                const ValueVecType& values,
+                                viskores::Float64& integral) const
+  {
+    integral = 0;
+    for (viskores::IdComponent i = 0; i < measure.GetNumberOfComponents(); ++i)
+    {
+      integral += measure[i] * static_cast<viskores::Float64>(values[i]);
+    }
+  }
+};
+} // viskores::worklet::connectivity::detail
+
+/// Computes the size, position, and field integrals of the components of a cell set.
+///
+/// `Run` groups the cells by component once. The statistics of the geometry and any
+/// number of field integrals then reduce over these groups without sorting again. All
+/// results are ordered like `GetComponents()`, which lists the components that have at
+/// least one cell in increasing order.
+class ComponentStatistics
+{
+public:
+  template <typename CoordsArrayType>
+  void Run(const viskores::cont::UnknownCellSet& cellSet,
+           const CoordsArrayType& coords,
+           const viskores::cont::ArrayHandle<viskores::Id>& components)
+  {
+    this->CellSet = cellSet;
+
+    viskores::cont::ArrayHandle<viskores::Vec3f_64> centers;
+    viskores::cont::ArrayHandle<viskores::Vec3f_64> minCorners;
+    viskores::cont::ArrayHandle<viskores::Vec3f_64> maxCorners;
+    this->Invoke(
+      detail::CellGeometry{}, cellSet, coords, this->CellMeasure, centers, minCorners, maxCorners);
+
+    this->Keys.BuildArrays(components, viskores::worklet::KeysSortType::Unstable);
+    this->Invoke(detail::ReduceCellGeometry{},
+                 this->Keys,
+                 this->CellMeasure,
+                 centers,
+                 minCorners,
+                 maxCorners,
+                 this->NumberOfCells,
+                 this->Measure,
+                 this->WeightedCenterSum,
+                 this->CenterSum,
+                 this->MinCorner,
+                 this->MaxCorner);
+  }
+
+  /// Integral of a cell field over each component
+  template <typename T, typename S>
+  viskores::cont::ArrayHandle<viskores::Float64> IntegrateCellField(
+    const viskores::cont::ArrayHandle<T, S>& values) const
+  {
+    viskores::cont::ArrayHandle<viskores::Float64> integral;
+    this->Invoke(detail::IntegrateByComponent{}, this->Keys, this->CellMeasure, values, integral);
+    return integral;
+  }
+
+  /// Integral of a point field over each component. The value in a cell is the average of
+  /// the values at its points.
+  template <typename T, typename S>
+  viskores::cont::ArrayHandle<viskores::Float64> IntegratePointField(
+    const viskores::cont::ArrayHandle<T, S>& values) const
+  {
+    viskores::cont::ArrayHandle<viskores::Float64> cellValues;
+    this->Invoke(detail::AveragePointsToCell{}, this->CellSet, values, cellValues);
+    return this->IntegrateCellField(cellValues);
+  }
+
+  viskores::cont::ArrayHandle<viskores::Id> GetComponents() const
+  {
+    return this->Keys.GetUniqueKeys();
+  }
+  const viskores::cont::ArrayHandle<viskores::Id>& GetNumberOfCells() const
+  {
+    return this->NumberOfCells;
+  }
+  /// Sum of the length, area, or volume of the cells of each component
+  const viskores::cont::ArrayHandle<viskores::Float64>& GetMeasure() const { return this->Measure; }
+  /// Sum of the cell centers weighted by the cell measure
+  const viskores::cont::ArrayHandle<viskores::Vec3f_64>& GetWeightedCenterSum() const
+  {
+    return this->WeightedCenterSum;
+  }
+  /// Sum of the cell centers, which locates components of cells without measure
+  const viskores::cont::ArrayHandle<viskores::Vec3f_64>& GetCenterSum() const
+  {
+    return this->CenterSum;
+  }
+  const viskores::cont::ArrayHandle<viskores::Vec3f_64>& GetMinCorner() const
+  {
+    return this->MinCorner;
+  }
+  const viskores::cont::ArrayHandle<viskores::Vec3f_64>& GetMaxCorner() const
+  {
+    return this->MaxCorner;
+  }
+
+private:
+  viskores::cont::Invoker Invoke;
+  viskores::cont::UnknownCellSet CellSet;
+  viskores::worklet::Keys<viskores::Id> Keys;
+  viskores::cont::ArrayHandle<viskores::Float64> CellMeasure;
+
+  viskores::cont::ArrayHandle<viskores::Id> NumberOfCells;
+  viskores::cont::ArrayHandle<viskores::Float64> Measure;
+  viskores::cont::ArrayHandle<viskores::Vec3f_64> WeightedCenterSum;
+  viskores::cont::ArrayHandle<viskores::Vec3f_64> CenterSum;
+  viskores::cont::ArrayHandle<viskores::Vec3f_64> MinCorner;
+  viskores::cont::ArrayHandle<viskores::Vec3f_64> MaxCorner;
+};
+}
+}
+} // viskores::worklet::connectivity
+
+#endif //viskores_worklet_connectivity_ComponentStatistics_h
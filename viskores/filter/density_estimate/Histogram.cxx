@@ -8,6 +8,7 @@
 
 
 #include <viskores/filter/density_estimate/Histogram.h>
+#include <viskores/filter/density_estimate/worklet/AdaptiveHistogram.h>
 #include <viskores/filter/density_estimate/worklet/FieldHistogram.h>
 
 #include <viskores/cont/Algorithm.h>
@@ -19,6 +20,7 @@
 
 #include <viskores/thirdparty/diy/diy.h>
 
+#include <functional>
 #include <type_traits>
 
 namespace viskores
@@ -162,6 +164,157 @@ private:
   }
 };
 
+
+// The fine bins are at least 1/32 of the requested bins.
+inline viskores::Id NumberOfFineBins(viskores::Id numBins)
+{
+  return std::max(viskores::Id{ 1024 }, 64 * numBins);
+}
+
+inline std::vector<viskores::Float64> UniformBinEdges(viskores::Float64 min,
+                                                      viskores::Float64 max,
+                                                      viskores::Id numBins)
+{
+  std::vector<viskores::Float64> edges(static_cast<std::size_t>(numBins + 1));
+  for (viskores::Id i = 0; i < numBins; ++i)
+  {
+    edges[static_cast<std::size_t>(i)] = min +
+      (max - min) * static_cast<viskores::Float64>(i) / static_cast<viskores::Float64>(numBins);
+  }
+  edges.back() = max;
+  return edges;
+}
+
+// The fine bins of a partition are passed from DoExecute to PostExecute in its output.
+inline void SaveFineBins(const viskores::worklet::AdaptiveHistogram& fineBins,
+                         const std::string& name,
+                         viskores::cont::DataSet& output)
+{
+  const auto association = viskores::cont::Field::Association::WholeDataSet;
+  output.AddField(viskores::cont::make_Field(
+    name, association, fineBins.GetCounts(), viskores::CopyFlag::On));
+  std::vector<viskores::Float64> state{ static_cast<viskores::Float64>(fineBins.GetExponent()),
+                                        static_cast<viskores::Float64>(fineBins.GetOrigin()),
+                                        fineBins.GetMin(),
+                                        fineBins.GetMax(),
+                                        static_cast<viskores::Float64>(
+                                          fineBins.GetNumberOfSkippedValues()) };
+  output.AddField(
+    viskores::cont::make_FieldMove(name + "_fine_state", association, std::move(state)));
+}
+
+inline void LoadFineBins(const viskores::cont::DataSet& input,
+                         const std::string& name,
+                         viskores::worklet::AdaptiveHistogram& fineBins)
+{
+  viskores::cont::ArrayHandle<viskores::Id> counts;
+  input.GetField(name).GetData().AsArrayHandle(counts);
+  viskores::cont::ArrayHandle<viskores::Float64> state;
+  input.GetField(name + "_fine_state").GetData().AsArrayHandle(state);
+  auto countsPortal = counts.ReadPortal();
+  std::vector<viskores::Id> countsVector;
+  for (viskores::Id i = 0; i < countsPortal.GetNumberOfValues(); ++i)
+  {
+    countsVector.push_back(countsPortal.Get(i));
+  }
+  auto statePortal = state.ReadPortal();
+  fineBins.SetState(static_cast<viskores::Int32>(statePortal.Get(0)),
+                    static_cast<viskores::Id>(statePortal.Get(1)),
+                    statePortal.Get(2),
+                    statePortal.Get(3),
+                    static_cast<viskores::Id>(statePortal.Get(4)),
+                    countsVector);
+}
+
+// Merges the fine bins of all ranks, so that every rank gets the same fine bins.
+inline void ReduceFineBins(viskores::worklet::AdaptiveHistogram& fineBins)
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  if (comm.size() == 1)
+  {
+    return;
+  }
+
+  // first agree on common fine bins, which then add up
+  std::vector<viskores::Float64> range{ -fineBins.GetMin(), fineBins.GetMax() };
+  std::vector<viskores::Float64> globalRange;
+  viskoresdiy::mpi::all_reduce(
+    comm, range, globalRange, viskoresdiy::mpi::maximum<viskores::Float64>());
+  viskores::Int32 exponent;
+  viskoresdiy::mpi::all_reduce(
+    comm, fineBins.GetExponent(), exponent, viskoresdiy::mpi::maximum<viskores::Int32>());
+  viskores::Id numSkipped;
+  viskoresdiy::mpi::all_reduce(
+    comm, fineBins.GetNumberOfSkippedValues(), numSkipped, std::plus<viskores::Id>());
+
+  const viskores::Float64 min = -globalRange[0];
+  const viskores::Float64 max = globalRange[1];
+  viskores::Id origin = 0;
+  if (min <= max)
+  {
+    const viskores::Id numFineBins = fineBins.GetNumberOfFineBins();
+    exponent = viskores::worklet::adaptive_histogram::FitExponent(exponent, min, max, numFineBins);
+    origin = viskores::worklet::adaptive_histogram::CenterOrigin(exponent, min, max, numFineBins);
+    fineBins.Rebin(exponent, origin);
+  }
+  std::vector<viskores::Id> counts;
+  viskoresdiy::mpi::all_reduce(comm, fineBins.GetCounts(), counts, std::plus<viskores::Id>());
+  fineBins.SetState(exponent, origin, min, max, numSkipped, counts);
+}
+
+// Combine the fine bins into the bins of the histogram.
+inline viskores::cont::ArrayHandle<viskores::Id> BinFineBins(
+  const viskores::worklet::AdaptiveHistogram& fineBins,
+  viskores::Id numBins,
+  Histogram::BinningMode binning,
+  const viskores::Range& range,
+  std::vector<viskores::Float64>& edges,
+  viskores::Range& computedRange,
+  viskores::Float64& binDelta)
+{
+  const bool logarithmic = binning == Histogram::BinningMode::Logarithmic;
+  if (logarithmic && fineBins.GetNumberOfSkippedValues() > 0)
+  {
+    throw viskores::cont::ErrorFilterExecution("Logarithmic bins need positive values.");
+  }
+
+  const std::size_t numEdges = static_cast<std::size_t>(numBins + 1);
+  if (binning == Histogram::BinningMode::EqualPopulation)
+  {
+    edges = fineBins.IsEmpty() ? std::vector<viskores::Float64>(numEdges, 0)
+                               : fineBins.QuantileEdges(numBins);
+  }
+  else if (range.IsNonEmpty())
+  {
+    if (logarithmic && range.Min <= 0)
+    {
+      throw viskores::cont::ErrorFilterExecution("Logarithmic bins need a positive range.");
+    }
+    edges = logarithmic
+      ? UniformBinEdges(viskores::Log2(range.Min), viskores::Log2(range.Max), numBins)
+      : UniformBinEdges(range.Min, range.Max, numBins);
+  }
+  else
+  {
+    edges = fineBins.IsEmpty() ? std::vector<viskores::Float64>(numEdges, 0)
+                               : UniformBinEdges(fineBins.GetMin(), fineBins.GetMax(), numBins);
+  }
+  std::vector<viskores::Id> counts = fineBins.CountBins(edges);
+
+  if (logarithmic)
+  {
+    for (viskores::Float64& edge : edges)
+    {
+      edge = viskores::Pow(viskores::Float64{ 2 }, edge);
+    }
+  }
+  computedRange = viskores::Range(edges.front(), edges.back());
+  binDelta = (binning == Histogram::BinningMode::Uniform)
+    ? (edges.back() - edges.front()) / static_cast<viskores::Float64>(numBins)
+    : 0;
+  return viskores::cont::make_ArrayHandleMove(std::move(counts));
+}
+
 } // namespace detail
 
 //-----------------------------------------------------------------------------
@@ -170,10 +323,46 @@ VISKORES_CONT Histogram::Histogram()
   this->SetOutputFieldName("histogram");
 }
 
+VISKORES_CONT bool Histogram::UseFineBins() const
+{
+  return this->Binning != BinningMode::Uniform ||
+    (this->AdaptiveRange && !this->Range.IsNonEmpty());
+}
+
 VISKORES_CONT viskores::cont::DataSet Histogram::DoExecute(const viskores::cont::DataSet& input)
 {
   const auto& fieldArray = this->GetFieldFromDataSet(input).GetData();
 
+  if (this->UseFineBins())
+  {
+    // a single pass finds the range and counts the values
+    viskores::worklet::AdaptiveHistogram fineBins(detail::NumberOfFineBins(this->NumberOfBins),
+                                                  this->Binning == BinningMode::Logarithmic);
+    fieldArray.CastAndCallForTypesWithFloatFallback<viskores::TypeListFieldScalar,
+                                                    VISKORES_DEFAULT_STORAGE_LIST>(
+      [&](const auto& concrete) { fineBins.Run(concrete); });
+
+    viskores::cont::DataSet output;
+    if (this->InExecutePartitions)
+    {
+      detail::SaveFineBins(fineBins, this->GetOutputFieldName(), output);
+    }
+    else
+    {
+      detail::ReduceFineBins(fineBins);
+      output.AddField({ this->GetOutputFieldName(),
+                        viskores::cont::Field::Association::WholeDataSet,
+                        detail::BinFineBins(fineBins,
+                                            this->NumberOfBins,
+                                            this->Binning,
+                                            this->Range,
+                                            this->BinEdges,
+                                            this->ComputedRange,
+                                            this->BinDelta) });
+    }
+    return output;
+  }
+
   if (!this->InExecutePartitions)
   {
     // Handle initialization that would be done in PreExecute if the data set had partitions.
@@ -191,6 +380,8 @@ VISKORES_CONT viskores::cont::DataSet Histogram::DoExecute(const viskores::cont:
       }
       this->ComputedRange = handle.ReadPortal().Get(0);
     }
+    this->BinEdges = detail::UniformBinEdges(
+      this->ComputedRange.Min, this->ComputedRange.Max, this->NumberOfBins);
   }
 
   viskores::cont::ArrayHandle<viskores::Id> binArray;
@@ -237,6 +428,13 @@ VISKORES_CONT viskores::cont::PartitionedDataSet Histogram::DoExecutePartitions(
 //-----------------------------------------------------------------------------
 VISKORES_CONT void Histogram::PreExecute(const viskores::cont::PartitionedDataSet& input)
 {
+  if (this->UseFineBins())
+  {
+    // the range is found while counting
+    this->InExecutePartitions = true;
+    return;
+  }
+
   if (this->Range.IsNonEmpty())
   {
     this->ComputedRange = this->Range;
@@ -253,6 +451,8 @@ VISKORES_CONT void Histogram::PreExecute(const viskores::cont::PartitionedDataSe
     }
     this->ComputedRange = handle.ReadPortal().Get(0);
   }
+  this->BinEdges = detail::UniformBinEdges(
+    this->ComputedRange.Min, this->ComputedRange.Max, this->NumberOfBins);
 
   if (input.GetNumberOfPartitions() > 0)
   {
@@ -276,6 +476,33 @@ VISKORES_CONT void Histogram::PostExecute(const viskores::cont::PartitionedDataS
                                           viskores::cont::PartitionedDataSet& result)
 {
   this->InExecutePartitions = false;
+  if (this->UseFineBins())
+  {
+    viskores::worklet::AdaptiveHistogram fineBins(detail::NumberOfFineBins(this->NumberOfBins),
+                                                  this->Binning == BinningMode::Logarithmic);
+    for (viskores::Id cc = 0; cc < result.GetNumberOfPartitions(); ++cc)
+    {
+      viskores::worklet::AdaptiveHistogram partitionFineBins(fineBins.GetNumberOfFineBins(),
+                                                             fineBins.GetLogarithmic());
+      detail::LoadFineBins(result.GetPartition(cc), this->GetOutputFieldName(), partitionFineBins);
+      fineBins.Merge(partitionFineBins);
+    }
+    detail::ReduceFineBins(fineBins);
+
+    viskores::cont::DataSet output;
+    output.AddField({ this->GetOutputFieldName(),
+                      viskores::cont::Field::Association::WholeDataSet,
+                      detail::BinFineBins(fineBins,
+                                          this->NumberOfBins,
+                                          this->Binning,
+                                          this->Range,
+                                          this->BinEdges,
+                                          this->ComputedRange,
+                                          this->BinDelta) });
+    result = viskores::cont::PartitionedDataSet(output);
+    return;
+  }
+
   // iterate and compute histogram for each local block.
   detail::DistributedHistogram helper(result.GetNumberOfPartitions());
   for (viskores::Id cc = 0; cc < result.GetNumberOfPartitions(); ++cc)
@@ -13,6 +13,8 @@
 #include <viskores/filter/Filter.h>
 #include <viskores/filter/density_estimate/viskores_filter_density_estimate_export.h>
 
+#include <vector>
+
 namespace viskores
 {
 namespace filter
@@ -36,9 +38,30 @@ namespace density_estimate
 /// `viskores::cont::PartitionedDataSet` containing a single
 /// `viskores::cont::DataSet` as previously described.
 ///
+/// When no range is given, the range is normally computed in a separate pass over the
+/// field before the values are counted. With `SetAdaptiveRange(true)`, the range is instead
+/// found while counting: the values are counted in fine bins whose range grows with the
+/// values, and the fine bins are then combined into the requested bins. This reads the
+/// field only once. A fine bin is counted in the bin that contains its center, so values
+/// within a fine bin (at most 1/32 of a bin) of an edge may be counted in the neighboring
+/// bin. The bins can also be spaced logarithmically or hold about the same number of values
+/// (see `SetBinningMode`), which always uses the fine bins.
+///
 class VISKORES_FILTER_DENSITY_ESTIMATE_EXPORT Histogram : public viskores::filter::Filter
 {
 public:
+  /// @brief How the bins of the histogram are spaced.
+  enum struct BinningMode
+  {
+    /// The bins have the same width.
+    Uniform,
+    /// The bins have the same width on a logarithmic scale. All values must be positive.
+    Logarithmic,
+    /// The bin edges are chosen so that the bins hold about the same number of values.
+    /// Any range set with `SetRange` is ignored.
+    EqualPopulation
+  };
+
   VISKORES_CONT Histogram();
 
   /// @brief Set the number of bins for the resulting histogram.
@@ -60,9 +83,24 @@ public:
   /// If the returned range is empty, then the field's global range will be used.
   VISKORES_CONT const viskores::Range& GetRange() const { return this->Range; }
 
+  /// @brief Specify whether the range is found while counting the values.
+  ///
+  /// When on and no range is set, the field is read only once, and the counts near the
+  /// bin edges are approximate. This is off by default.
+  VISKORES_CONT void SetAdaptiveRange(bool adaptive) { this->AdaptiveRange = adaptive; }
+  VISKORES_CONT bool GetAdaptiveRange() const { return this->AdaptiveRange; }
+
+  /// @brief Specify how the bins are spaced.
+  ///
+  /// By default, the bins have the same width. The other modes always find the range of
+  /// the values while counting.
+  VISKORES_CONT void SetBinningMode(BinningMode mode) { this->Binning = mode; }
+  VISKORES_CONT BinningMode GetBinningMode() const { return this->Binning; }
+
   /// @brief Returns the size of bin in the computed histogram.
   ///
-  /// This value is only valid after a call to `Execute`.
+  /// This value is only valid after a call to `Execute`. It is 0 if the bins do not have
+  /// the same width (see `GetBinEdges`).
   VISKORES_CONT viskores::Float64 GetBinDelta() const { return this->BinDelta; }
 
   /// @brief Returns the range used for most recent execute.
@@ -72,6 +110,14 @@ public:
   /// This value is only valid after a call to `Execute`.
   VISKORES_CONT viskores::Range GetComputedRange() const { return this->ComputedRange; }
 
+  /// @brief Returns the `NumberOfBins` + 1 edges of the bins of the computed histogram.
+  ///
+  /// This value is only valid after a call to `Execute`.
+  VISKORES_CONT const std::vector<viskores::Float64>& GetBinEdges() const
+  {
+    return this->BinEdges;
+  }
+
 private:
   VISKORES_CONT viskores::cont::DataSet DoExecute(const viskores::cont::DataSet& input) override;
   VISKORES_CONT viskores::cont::PartitionedDataSet DoExecutePartitions(
@@ -86,10 +132,15 @@ private:
                                  viskores::cont::PartitionedDataSet& output);
   ///@}
 
+  VISKORES_CONT bool UseFineBins() const;
+
   viskores::Id NumberOfBins = 10;
   viskores::Float64 BinDelta = 0;
   viskores::Range ComputedRange;
   viskores::Range Range;
+  std::vector<viskores::Float64> BinEdges;
+  bool AdaptiveRange = false;
+  BinningMode Binning = BinningMode::Uniform;
   bool InExecutePartitions = false;
 };
 } // namespace density_estimate
@@ -25,6 +25,7 @@ VISKORES_CONT viskores::cont::DataSet NDEntropy::DoExecute(const viskores::cont:
 {
   viskores::worklet::NDimsEntropy ndEntropy;
   ndEntropy.SetNumOfDataPoints(inData.GetField(0).GetNumberOfValues());
+  ndEntropy.SetUseHashAggregation(this->UseHashAggregation);
 
   // Add field one by one
   // (By using AddFieldAndBin(), the length of FieldNames and NumOfBins must be the same)
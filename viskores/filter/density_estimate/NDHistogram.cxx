@@ -39,6 +39,7 @@ VISKORES_CONT viskores::cont::DataSet NDHistogram::DoExecute(const viskores::con
 
   // Set the number of data points
   ndHistogram.SetNumOfDataPoints(inData.GetField(0).GetNumberOfValues());
+  ndHistogram.SetUseHashAggregation(this->UseHashAggregation);
 
   // Add field one by one
   // (By using AddFieldAndBin(), the length of FieldNames and NumOfBins must be the same)
@@ -46,6 +46,17 @@ public:
   VISKORES_CONT
   viskores::Range GetDataRange(size_t fieldIdx);
 
+  /// @brief Specify whether the bins are counted with hash tables.
+  ///
+  /// By default, the bin of every value is sorted to count the bins. With hash
+  /// aggregation, the bins are counted in hash tables, and only the occupied bins are
+  /// sorted. This is much faster for many fields, when few of the bins are occupied.
+  VISKORES_CONT void SetUseHashAggregation(bool useHashAggregation)
+  {
+    this->UseHashAggregation = useHashAggregation;
+  }
+  VISKORES_CONT bool GetUseHashAggregation() const { return this->UseHashAggregation; }
+
 private:
   VISKORES_CONT viskores::cont::DataSet DoExecute(const viskores::cont::DataSet& input) override;
 
@@ -53,6 +64,7 @@ private:
   std::vector<std::string> FieldNames;
   std::vector<viskores::Float64> BinDeltas;
   std::vector<viskores::Range> DataRanges; //Min Max of the field
+  bool UseHashAggregation = false;
 };
 } // namespace density_estimate
 } // namespace filter
@@ -0,0 +1,441 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/ArrayHandleConstant.h>
+#include <viskores/cont/DataSetBuilderUniform.h>
+#include <viskores/cont/ErrorFilterExecution.h>
+#include <viskores/filter/density_estimate/ParticleDensityKernel.h>
+#include <viskores/worklet/Keys.h>
+#include <viskores/worklet/ScatterCounting.h>
+#include <viskores/worklet/WorkletMapField.h>
+#include <viskores/worklet/WorkletReduceByKey.h>
+#include <viskores/worklet/splatkernels/Gaussian.h>
+#include <viskores/worklet/splatkernels/Spline3rdOrder.h>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace particle_density
+{
+
+// The grid points are grouped into cubic tiles of this many points along each axis.
+static constexpr viskores::IdComponent TileSize = 8;
+
+// The grid the particles are deposited on, and the lattice of points it is part of.
+struct KernelGrid
+{
+  viskores::Vec3f_64 Origin;
+  viskores::Vec3f_64 Spacing;
+  viskores::Id3 PointDimensions;
+  viskores::Id3 TileDimensions;
+  viskores::Float64 MinSmoothingLength;
+
+  // The points of the lattice in the box around a sphere. The points may be outside of
+  // the grid.
+  VISKORES_EXEC_CONT void Support(const viskores::Vec3f_64& center,
+                                  viskores::Float64 radius,
+                                  viskores::Id3& lo,
+                                  viskores::Id3& hi) const
+  {
+    for (viskores::IdComponent d = 0; d < 3; ++d)
+    {
+      lo[d] = static_cast<viskores::Id>(
+        viskores::Ceil((center[d] - radius - this->Origin[d]) / this->Spacing[d]));
+      hi[d] = static_cast<viskores::Id>(
+        viskores::Floor((center[d] + radius - this->Origin[d]) / this->Spacing[d]));
+    }
+  }
+
+  // The range of tiles holding the grid points of a support. Returns false when the
+  // support does not reach the grid.
+  VISKORES_EXEC_CONT bool Tiles(const viskores::Id3& lo,
+                                const viskores::Id3& hi,
+                                viskores::Id3& tileLo,
+                                viskores::Id3& tileHi) const
+  {
+    for (viskores::IdComponent d = 0; d < 3; ++d)
+    {
+      if (hi[d] < 0 || lo[d] >= this->PointDimensions[d])
+      {
+        return false;
+      }
+      tileLo[d] = viskores::Max(lo[d], viskores::Id{ 0 }) / TileSize;
+      tileHi[d] = viskores::Min(hi[d], this->PointDimensions[d] - 1) / TileSize;
+    }
+    return true;
+  }
+
+  // Smoothing lengths are enlarged such that the kernel reaches the points around a particle.
+  VISKORES_EXEC_CONT viskores::Float64 SmoothingLength(viskores::Float64 length) const
+  {
+    return viskores::Max(length, this->MinSmoothingLength);
+  }
+
+  VISKORES_EXEC_CONT viskores::Float64 Distance2(const viskores::Vec3f_64& center,
+                                                 viskores::Id i,
+                                                 viskores::Id j,
+                                                 viskores::Id k) const
+  {
+    const viskores::Vec3f_64 index(static_cast<viskores::Float64>(i),
+                                   static_cast<viskores::Float64>(j),
+                                   static_cast<viskores::Float64>(k));
+    return viskores::MagnitudeSquared(this->Origin + index * this->Spacing - center);
+  }
+};
+
+// Computes how many tiles each particle reaches, and the factor that normalizes the
+// kernel weights of the particle over the lattice points in its support.
+template <typename KernelType>
+class KernelSupport : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn coords,
+                                FieldIn smoothingLength,
+                                FieldOut weightScale,
+                                FieldOut numberOfTiles);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  VISKORES_CONT explicit KernelSupport(const KernelGrid& grid)
+    : Grid(grid)
+    , Kernel(1.0)
+  {
+  }
+
+  template <typename Point, typename T>
+  VISKORES_EXEC void operator()(const Point& point,
+                                const T& smoothingLength,
+                                viskores::Float64& weightScale,
+                                viskores::IdComponent& numberOfTiles) const
+  {
+    const viskores::Vec3f_64 center(point);
+    const viskores::Float64 h =
+      this->Grid.SmoothingLength(static_cast<viskores::Float64>(smoothingLength));
+    viskores::Id3 lo(0), hi(0), tileLo(0), tileHi(0);
+    this->Grid.Support(center, this->Kernel.maxDistance(h), lo, hi);
+    if (!this->Grid.Tiles(lo, hi, tileLo, tileHi))
+    {
+      weightScale = 0;
+      numberOfTiles = 0;
+      return;
+    }
+    numberOfTiles = static_cast<viskores::IdComponent>((tileHi[0] - tileLo[0] + 1) *
+                                                       (tileHi[1] - tileLo[1] + 1) *
+                                                       (tileHi[2] - tileLo[2] + 1));
+
+    // the weights are summed over all lattice points in the support, including those
+    // outside of the grid, so the mass that leaves the grid is lost
+    viskores::Float64 weightSum = 0;
+    for (viskores::Id k = lo[2]; k <= hi[2]; ++k)
+    {
+      for (viskores::Id j = lo[1]; j <= hi[1]; ++j)
+      {
+        for (viskores::Id i = lo[0]; i <= hi[0]; ++i)
+        {
+          weightSum += this->Kernel.w2(h, this->Grid.Distance2(center, i, j, k));
+        }
+      }
+    }
+    weightScale = (weightSum > 0) ? 1.0 / weightSum : 0.0;
+  }
+
+private:
+  KernelGrid Grid;
+  KernelType Kernel;
+};
+
+// Lists the tiles reached by each particle.
+template <typename KernelType>
+class ListKernelTiles : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn coords,
+                                FieldIn smoothingLength,
+                                FieldOut tile,
+                                FieldOut particle);
+  using ExecutionSignature = void(_1, _2, VisitIndex, InputIndex, _3, _4);
+  using ScatterType = viskores::worklet::ScatterCounting;
+
+  VISKORES_CONT explicit ListKernelTiles(const KernelGrid& grid)
+    : Grid(grid)
+    , Kernel(1.0)
+  {
+  }
+
+  template <typename Point, typename T>
+  VISKORES_EXEC void operator()(const Point& point,
+                                const T& smoothingLength,
+                                viskores::IdComponent visitIndex,
+                                viskores::Id inputIndex,
+                                viskores::Id& tile,
+                                viskores::Id& particle) const
+  {
+    const viskores::Float64 h =
+      this->Grid.SmoothingLength(static_cast<viskores::Float64>(smoothingLength));
+    viskores::Id3 lo(0), hi(0), tileLo(0), tileHi(0);
+    this->Grid.Support(viskores::Vec3f_64(point), this->Kernel.maxDistance(h), lo, hi);
+    this->Grid.Tiles(lo, hi, tileLo, tileHi);
+
+    const viskores::Id numX = tileHi[0] - tileLo[0] + 1;
+    const viskores::Id numY = tileHi[1] - tileLo[1] + 1;
+    const viskores::Id tileX = tileLo[0] + visitIndex % numX;
+    const viskores::Id tileY = tileLo[1] + (visitIndex / numX) % numY;
+    const viskores::Id tileZ = tileLo[2] + visitIndex / (numX * numY);
+    tile = tileX + this->Grid.TileDimensions[0] * (tileY + this->Grid.TileDimensions[1] * tileZ);
+    particle = inputIndex;
+  }
+
+private:
+  KernelGrid Grid;
+  KernelType Kernel;
+};
+
+// Adds up the weighted values of the particles reaching a tile. Each tile writes only its
+// own points, so no atomic operations are needed.
+template <typename KernelType>
+class DepositKernelTile : public viskores::worklet::WorkletReduceByKey
+{
+public:
+  using ControlSignature = void(KeysIn tiles,
+                                ValuesIn particles,
+                                WholeArrayIn coords,
+                                WholeArrayIn smoothingLength,
+                                WholeArrayIn values,
+                                WholeArrayIn weightScale,
+                                WholeArrayInOut density);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+  using InputDomain = _1;
+
+  VISKORES_CONT explicit DepositKernelTile(const KernelGrid& grid)
+    : Grid(grid)
+    , Kernel(1.0)
+  {
+  }
+
+  template <typename ParticleVecType,
+            typename CoordsPortal,
+            typename SmoothingPortal,
+            typename ValuesPortal,
+            typename ScalePortal,
+            typename DensityPortal>
+  VISKORES_EXEC void operator()(viskores::Id tile,
+                                const ParticleVecType& particles,
+                                const CoordsPortal& coords,
+                                const SmoothingPortal& smoothingLength,
+                                const ValuesPortal& values,
+                                const ScalePortal& weightScale,
+                                const DensityPortal& density) const
+  {
+    const viskores::Id3& tileDims = this->Grid.TileDimensions;
+    const viskores::Id3& pointDims = this->Grid.PointDimensions;
+    const viskores::Id3 tileLo(TileSize * (tile % tileDims[0]),
+                               TileSize * ((tile / tileDims[0]) % tileDims[1]),
+                               TileSize * (tile / (tileDims[0] * tileDims[1])));
+    const viskores::Id3 tileHi(viskores::Min(tileLo[0] + TileSize, pointDims[0]) - 1,
+                               viskores::Min(tileLo[1] + TileSize, pointDims[1]) - 1,
+                               viskores::Min(tileLo[2] + TileSize, pointDims[2]) - 1);
+
+    viskores::Vec<viskores::Float64, TileSize * TileSize * TileSize> sums(0);
+    for (viskores::IdComponent p = 0; p < particles.GetNumberOfComponents(); ++p)
+    {
+      const viskores::Id particle = particles[p];
+      const viskores::Float64 scale =
+        weightScale.Get(particle) * static_cast<viskores::Float64>(values.Get(particle));
+      if (scale == 0)
+      {
+        continue;
+      }
+      const viskores::Vec3f_64 center(coords.Get(particle));
+      const viskores::Float64 h =
+        this->Grid.SmoothingLength(static_cast<viskores::Float64>(smoothingLength.Get(particle)));
+      viskores::Id3 lo, hi;
+      this->Grid.Support(center, this->Kernel.maxDistance(h), lo, hi);
+      lo = viskores::Max(lo, tileLo);
+      hi = viskores::Min(hi, tileHi);
+      for (viskores::Id k = lo[2]; k <= hi[2]; ++k)
+      {
+        for (viskores::Id j = lo[1]; j <= hi[1]; ++j)
+        {
+          for (viskores::Id i = lo[0]; i <= hi[0]; ++i)
+          {
+            const viskores::IdComponent local = static_cast<viskores::IdComponent>(
+              (i - tileLo[0]) + TileSize * ((j - tileLo[1]) + TileSize * (k - tileLo[2])));
+            sums[local] +=
+              scale * this->Kernel.w2(h, this->Grid.Distance2(center, i, j, k));
+          }
+        }
+      }
+    }
+
+    using T = typename DensityPortal::ValueType;
+    for (viskores::Id k = tileLo[2]; k <= tileHi[2]; ++k)
+    {
+      for (viskores::Id j = tileLo[1]; j <= tileHi[1]; ++j)
+      {
+        for (viskores::Id i = tileLo[0]; i <= tileHi[0]; ++i)
+        {
+          const viskores::IdComponent local = static_cast<viskores::IdComponent>(
+            (i - tileLo[0]) + TileSize * ((j - tileLo[1]) + TileSize * (k - tileLo[2])));
+          density.Set(i + pointDims[0] * (j + pointDims[1] * k), static_cast<T>(sums[local]));
+        }
+      }
+    }
+  }
+
+private:
+  KernelGrid Grid;
+  KernelType Kernel;
+};
+
+} // namespace particle_density
+} // namespace worklet
+} // namespace viskores
+
+namespace viskores
+{
+namespace filter
+{
+namespace density_estimate
+{
+
+namespace
+{
+
+template <typename KernelType,
+          typename CoordsArrayType,
+          typename SmoothingArrayType,
+          typename ValuesArrayType,
+          typename T>
+void DepositKernel(const viskores::worklet::particle_density::KernelGrid& grid,
+                   const CoordsArrayType& coords,
+                   const SmoothingArrayType& smoothingLength,
+                   const ValuesArrayType& values,
+                   viskores::cont::ArrayHandle<T>& density)
+{
+  using namespace viskores::worklet::particle_density;
+  viskores::cont::Invoker invoke;
+
+  viskores::cont::ArrayHandle<viskores::Float64> weightScale;
+  viskores::cont::ArrayHandle<viskores::IdComponent> numberOfTiles;
+  invoke(KernelSupport<KernelType>{ grid }, coords, smoothingLength, weightScale, numberOfTiles);
+
+  viskores::cont::ArrayHandle<viskores::Id> tiles;
+  viskores::cont::ArrayHandle<viskores::Id> particles;
+  invoke(ListKernelTiles<KernelType>{ grid },
+         viskores::worklet::ScatterCounting(numberOfTiles),
+         coords,
+         smoothingLength,
+         tiles,
+         particles);
+
+  density.AllocateAndFill(grid.PointDimensions[0] * grid.PointDimensions[1] *
+                            grid.PointDimensions[2],
+                          0);
+  if (tiles.GetNumberOfValues() == 0)
+  {
+    return;
+  }
+  // a stable sort keeps the particles of each tile in order, so the sums are reproducible
+  viskores::worklet::Keys<viskores::Id> keys;
+  keys.BuildArrays(tiles, viskores::worklet::KeysSortType::Stable);
+  invoke(DepositKernelTile<KernelType>{ grid },
+         keys,
+         particles,
+         coords,
+         smoothingLength,
+         values,
+         weightScale,
+         density);
+}
+
+} // anonymous namespace
+
+VISKORES_CONT viskores::cont::DataSet ParticleDensityKernel::DoExecute(
+  const viskores::cont::DataSet& input)
+{
+  using Gaussian = viskores::worklet::splatkernels::Gaussian<3>;
+  using CubicSpline = viskores::worklet::splatkernels::Spline3rdOrder<3>;
+
+  // Like ParticleDensityCloudInCell, the mass is deposited on the grid points.
+  auto uniform = viskores::cont::DataSetBuilderUniform::Create(
+    this->Dimension + viskores::Id3{ 1, 1, 1 }, this->Origin, this->Spacing);
+
+  viskores::worklet::particle_density::KernelGrid grid;
+  grid.Origin = viskores::Vec3f_64(this->Origin);
+  grid.Spacing = viskores::Vec3f_64(this->Spacing);
+  grid.PointDimensions = this->Dimension + viskores::Id3{ 1, 1, 1 };
+  grid.TileDimensions =
+    (grid.PointDimensions + viskores::Id3(viskores::worklet::particle_density::TileSize - 1)) /
+    viskores::Id3(viskores::worklet::particle_density::TileSize);
+  // the kernel radius must reach the grid points around any particle
+  const viskores::Float64 diagonal = viskores::Magnitude(grid.Spacing);
+  grid.MinSmoothingLength = (this->Kernel == KernelType::Gaussian)
+    ? diagonal / Gaussian(1.0).maxDistance(1.0)
+    : diagonal / CubicSpline(1.0).maxDistance(1.0);
+
+  auto coords = input.GetCoordinateSystem().GetDataAsMultiplexer();
+
+  auto resolveSmoothingLength = [&](const auto& smoothingLength)
+  {
+    auto resolveType = [&](const auto& concrete)
+    {
+      // use std::decay to remove const ref from the decltype of concrete.
+      using T = typename std::decay_t<decltype(concrete)>::ValueType;
+      viskores::cont::ArrayHandle<T> density;
+      if (this->Kernel == KernelType::Gaussian)
+      {
+        DepositKernel<Gaussian>(grid, coords, smoothingLength, concrete, density);
+      }
+      else
+      {
+        DepositKernel<CubicSpline>(grid, coords, smoothingLength, concrete, density);
+      }
+
+      if (DivideByVolume)
+      {
+        this->DoDivideByVolume(density);
+      }
+
+      uniform.AddField(viskores::cont::make_FieldPoint("density", density));
+    };
+
+    if (this->ComputeNumberDensity)
+    {
+      resolveType(viskores::cont::make_ArrayHandleConstant(viskores::FloatDefault{ 1 },
+                                                           input.GetNumberOfPoints()));
+    }
+    else
+    {
+      this->CastAndCallScalarField(this->GetFieldFromDataSet(input), resolveType);
+    }
+  };
+
+  if (this->SmoothingLengthField.empty())
+  {
+    resolveSmoothingLength(
+      viskores::cont::make_ArrayHandleConstant(this->SmoothingLength, coords.GetNumberOfValues()));
+  }
+  else
+  {
+    const viskores::cont::Field& field = input.GetField(this->SmoothingLengthField);
+    if (field.GetNumberOfValues() != coords.GetNumberOfValues())
+    {
+      throw viskores::cont::ErrorFilterExecution("Smoothing length field " +
+                                                 this->SmoothingLengthField +
+                                                 " must have a value for each particle.");
+    }
+    viskores::cont::ArrayHandle<viskores::FloatDefault> smoothingLength;
+    viskores::cont::ArrayCopyShallowIfPossible(field.GetDataAsDefaultFloat(), smoothingLength);
+    resolveSmoothingLength(smoothingLength);
+  }
+  return uniform;
+}
+} // namespace density_estimate
+} // namespace filter
+} // namespace viskores
@@ -0,0 +1,97 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_filter_density_estimate_ParticleDensityKernel_h
+#define viskores_filter_density_estimate_ParticleDensityKernel_h
+
+#include <viskores/filter/density_estimate/ParticleDensityBase.h>
+
+#include <string>
+
+namespace viskores
+{
+namespace filter
+{
+namespace density_estimate
+{
+/// @brief Estimate the density of particles by smoothing them with a kernel.
+///
+/// Each particle spreads its mass (or count) over the points of the grid within the
+/// support of a smoothing kernel centered at the particle, as in smoothed particle
+/// hydrodynamics (SPH). The weights of the grid points reached by a particle are
+/// normalized, so a particle whose support lies inside the grid deposits exactly its
+/// mass. The part of the support outside of the grid is lost, like particles outside of
+/// the grid are ignored by `ParticleDensityCloudInCell`. The density is returned as the
+/// point field "density" of a uniform grid with `GetDimension()` cells.
+///
+/// The grid is divided into tiles of points, and each tile adds up the particles that
+/// reach it on its own. This accumulates the density without atomic operations, and the
+/// result does not depend on the order in which tiles are processed. The work per
+/// particle grows with the cube of the ratio of the kernel radius to the grid spacing.
+class VISKORES_FILTER_DENSITY_ESTIMATE_EXPORT ParticleDensityKernel : public ParticleDensityBase
+{
+public:
+  using Superclass = ParticleDensityBase;
+
+  /// @brief The kernels available to smooth the particles.
+  ///
+  /// `Gaussian` is truncated at 5 smoothing lengths, and `CubicSpline` is the cubic
+  /// B-spline kernel of SPH with a support of 2 smoothing lengths.
+  enum struct KernelType
+  {
+    Gaussian,
+    CubicSpline
+  };
+
+  ParticleDensityKernel() = default;
+
+  /// @brief Specifies the kernel used to smooth the particles.
+  ///
+  /// The default is `KernelType::CubicSpline`.
+  VISKORES_CONT void SetKernelType(KernelType kernel) { this->Kernel = kernel; }
+  /// @copydoc SetKernelType
+  VISKORES_CONT KernelType GetKernelType() const { return this->Kernel; }
+
+  /// @brief The smoothing length used for all particles.
+  ///
+  /// The smoothing length is ignored when a smoothing length field is set. Smoothing
+  /// lengths too small to reach the grid points around a particle are enlarged such
+  /// that the kernel radius is at least the length of the diagonal of a cell.
+  VISKORES_CONT void SetSmoothingLength(viskores::FloatDefault length)
+  {
+    this->SmoothingLength = length;
+  }
+  /// @copydoc SetSmoothingLength
+  VISKORES_CONT viskores::FloatDefault GetSmoothingLength() const { return this->SmoothingLength; }
+
+  /// @brief The name of a field holding a smoothing length for each particle.
+  ///
+  /// The field must have a value for each point of the coordinate system. An empty name
+  /// (the default) selects the smoothing length given by `SetSmoothingLength`.
+  VISKORES_CONT void SetSmoothingLengthField(const std::string& name)
+  {
+    this->SmoothingLengthField = name;
+  }
+  /// @copydoc SetSmoothingLengthField
+  VISKORES_CONT const std::string& GetSmoothingLengthField() const
+  {
+    return this->SmoothingLengthField;
+  }
+
+private:
+  VISKORES_CONT viskores::cont::DataSet DoExecute(const viskores::cont::DataSet& input) override;
+
+  KernelType Kernel = KernelType::CubicSpline;
+  viskores::FloatDefault SmoothingLength = 1;
+  std::string SmoothingLengthField;
+};
+} // namespace density_estimate
+} // namespace filter
+} // namespace viskores
+
+#endif // viskores_filter_density_estimate_ParticleDensityKernel_h
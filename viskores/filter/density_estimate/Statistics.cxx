@@ -9,6 +9,7 @@
 #include <viskores/cont/EnvironmentTracker.h>
 #include <viskores/cont/ErrorFilterExecution.h>
 #include <viskores/filter/density_estimate/Statistics.h>
+#include <viskores/filter/density_estimate/worklet/QuantileSketch.h>
 #include <viskores/thirdparty/diy/diy.h>
 #include <viskores/worklet/DescriptiveStatistics.h>
 #ifdef VISKORES_ENABLE_MPI
@@ -175,6 +176,70 @@ VISKORES_CONT void SaveIntoDataSet(StatValueType& statValue,
   output.AddField({ "Kurtosis", association, SaveDataIntoArray(statValue.Kurtosis()) });
 }
 
+VISKORES_CONT viskores::worklet::QuantileSketch GetQuantileSketchFromDataSet(
+  const viskores::cont::DataSet& data)
+{
+  viskores::cont::ArrayHandle<viskores::Vec2f_64> centroids;
+  data.GetField("QuantileSketch").GetData().AsArrayHandle(centroids);
+  std::vector<viskores::Vec2f_64> centroidsVector;
+  auto portal = centroids.ReadPortal();
+  for (viskores::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+  {
+    centroidsVector.push_back(portal.Get(i));
+  }
+  return viskores::worklet::QuantileSketch(
+    centroidsVector, ExtractVariable(data, "Min"), ExtractVariable(data, "Max"));
+}
+
+// Merges the sketches of all ranks, so that every rank gets the same global sketch.
+VISKORES_CONT viskores::worklet::QuantileSketch ReduceQuantileSketch(
+  const viskores::worklet::QuantileSketch& localSketch)
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  if (comm.size() == 1)
+  {
+    return localSketch;
+  }
+
+  // flatten each sketch to (min, max, mean0, weight0, mean1, weight1, ...)
+  std::vector<viskores::Float64> localValues{ localSketch.GetMin(), localSketch.GetMax() };
+  for (const auto& centroid : localSketch.GetCentroids())
+  {
+    localValues.push_back(centroid[0]);
+    localValues.push_back(centroid[1]);
+  }
+  std::vector<std::vector<viskores::Float64>> allValues;
+  viskoresdiy::mpi::all_gather(comm, localValues, allValues);
+
+  viskores::worklet::QuantileSketch result;
+  for (const auto& values : allValues)
+  {
+    std::vector<viskores::Vec2f_64> centroids;
+    for (std::size_t i = 2; i + 1 < values.size(); i += 2)
+    {
+      centroids.emplace_back(values[i], values[i + 1]);
+    }
+    result.Merge(viskores::worklet::QuantileSketch(centroids, values[0], values[1]));
+  }
+  return result;
+}
+
+template <typename DataSetType>
+VISKORES_CONT void SaveQuantilesIntoDataSet(const viskores::worklet::QuantileSketch& sketch,
+                                            const std::vector<viskores::Float64>& probabilities,
+                                            DataSetType& output,
+                                            viskores::cont::Field::Association association)
+{
+  std::vector<viskores::FloatDefault> quantiles;
+  for (viskores::Float64 probability : probabilities)
+  {
+    quantiles.push_back(static_cast<viskores::FloatDefault>(sketch.Quantile(probability)));
+  }
+  output.AddField(viskores::cont::make_FieldMove("Quantiles", association, std::move(quantiles)));
+  output.AddField(viskores::cont::make_Field(
+    "QuantileSketch", association, sketch.GetCentroids(), viskores::CopyFlag::On));
+}
+
 VISKORES_CONT viskores::cont::DataSet Statistics::DoExecute(const viskores::cont::DataSet& inData)
 {
   viskores::worklet::DescriptiveStatistics worklet;
@@ -185,6 +250,15 @@ VISKORES_CONT viskores::cont::DataSet Statistics::DoExecute(const viskores::cont
   StatValueType result = worklet.Run(input);
   SaveIntoDataSet<viskores::cont::DataSet>(
     result, output, viskores::cont::Field::Association::WholeDataSet);
+  if (!this->QuantileProbabilities.empty())
+  {
+    viskores::worklet::QuantileSketch sketch;
+    sketch.Run(input);
+    SaveQuantilesIntoDataSet(sketch,
+                             this->QuantileProbabilities,
+                             output,
+                             viskores::cont::Field::Association::WholeDataSet);
+  }
   return output;
 }
 
@@ -207,6 +281,20 @@ VISKORES_CONT viskores::cont::PartitionedDataSet Statistics::DoExecutePartitions
   StatValueType result = helper.ReduceStatisticsDiy();
   SaveIntoDataSet<viskores::cont::PartitionedDataSet>(
     result, output, viskores::cont::Field::Association::Global);
+  if (!this->QuantileProbabilities.empty())
+  {
+    // unlike the moments, the merged sketch is available on all ranks
+    viskores::worklet::QuantileSketch sketch;
+    for (viskores::Id i = 0; i < numPartitions; ++i)
+    {
+      sketch.Merge(GetQuantileSketchFromDataSet(output.GetPartition(i)));
+    }
+    sketch = ReduceQuantileSketch(sketch);
+    SaveQuantilesIntoDataSet(sketch,
+                             this->QuantileProbabilities,
+                             output,
+                             viskores::cont::Field::Association::Global);
+  }
   return output;
 }
 } // namespace density_estimate
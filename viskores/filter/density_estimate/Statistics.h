@@ -12,6 +12,8 @@
 #include <viskores/filter/Filter.h>
 #include <viskores/filter/density_estimate/viskores_filter_density_estimate_export.h>
 
+#include <vector>
+
 namespace viskores
 {
 namespace filter
@@ -39,6 +41,17 @@ namespace density_estimate
 ///
 /// `M2`, `M3`, and `M4` are the second, third, and fourth moments, respectively.
 ///
+/// Quantiles (e.g., the median) can also be computed by giving their probabilities to
+/// `SetQuantileProbabilities`. The quantiles are approximated with a mergeable t-digest
+/// sketch, which is built in a single parallel pass over the values and needs the same
+/// small amount of memory for any number of values. The estimates are most accurate near
+/// the minimum and maximum, and the error of the median is typically well below 1% of the
+/// rank. The result then also contains the fields
+///
+/// - `Quantiles`, with one value for each requested probability, and
+/// - `QuantileSketch`, the centroids (mean, weight) of the sketch, which summarize the
+///   distribution of the values.
+///
 /// Note that this filter treats the "sample" and the "population" as the same with the
 /// same mean. The difference between the two forms of variance is how they are normalized.
 /// The population variance is normalized by dividing the second moment by `N`. The sample
@@ -66,10 +79,26 @@ namespace density_estimate
 ///
 class VISKORES_FILTER_DENSITY_ESTIMATE_EXPORT Statistics : public viskores::filter::Filter
 {
+public:
+  /// @brief Specify the quantiles that are computed.
+  ///
+  /// Each probability is in [0, 1]; 0.5 gives the median. No quantiles are computed by
+  /// default, and then no sketch is built.
+  VISKORES_CONT void SetQuantileProbabilities(const std::vector<viskores::Float64>& probabilities)
+  {
+    this->QuantileProbabilities = probabilities;
+  }
+  VISKORES_CONT const std::vector<viskores::Float64>& GetQuantileProbabilities() const
+  {
+    return this->QuantileProbabilities;
+  }
+
 private:
   VISKORES_CONT viskores::cont::DataSet DoExecute(const viskores::cont::DataSet& input) override;
   VISKORES_CONT viskores::cont::PartitionedDataSet DoExecutePartitions(
     const viskores::cont::PartitionedDataSet& inData) override;
+
+  std::vector<viskores::Float64> QuantileProbabilities;
 };
 } // namespace density_estimate
 } // namespace filter
@@ -10,6 +10,8 @@
 #include <viskores/filter/density_estimate/Histogram.h>
 
 #include <viskores/cont/DataSet.h>
+#include <viskores/cont/ErrorFilterExecution.h>
+#include <viskores/cont/PartitionedDataSet.h>
 #include <viskores/cont/testing/Testing.h>
 
 #include <viskores/thirdparty/diy/environment.h>
@@ -298,6 +300,112 @@ void VerifyHistogram(const viskores::cont::DataSet& result,
   VISKORES_TEST_ASSERT(test_equal(sum, 1000), "Histogram not full");
 }
 
+viskores::cont::ArrayHandle<viskores::Id> GetBins(const viskores::cont::DataSet& result)
+{
+  viskores::cont::ArrayHandle<viskores::Id> bins;
+  result.GetField("histogram").GetData().AsArrayHandle(bins);
+  return bins;
+}
+
+//
+// Compare the single pass modes against known distributions
+//
+void TestAdaptiveHistogram()
+{
+  std::cout << "Adaptive range" << std::endl;
+  // a permutation of 0, ..., N-1, so the range grows while counting
+  constexpr viskores::Id N = 20000;
+  std::vector<viskores::Float64> values;
+  for (viskores::Id i = 0; i < N; ++i)
+  {
+    values.push_back(static_cast<viskores::Float64>((i * 7919) % N) * 0.01 - 20);
+  }
+  viskores::cont::DataSet ds;
+  ds.AddPointField("values", values);
+
+  viskores::filter::density_estimate::Histogram histogram;
+  histogram.SetNumberOfBins(10);
+  histogram.SetActiveField("values");
+  auto exactBins = GetBins(histogram.Execute(ds));
+  histogram.SetAdaptiveRange(true);
+  auto bins = GetBins(histogram.Execute(ds));
+  VISKORES_TEST_ASSERT(test_equal(histogram.GetComputedRange(), viskores::Range(-20, 179.99)));
+  VISKORES_TEST_ASSERT(test_equal(histogram.GetBinDelta(), 19.999));
+  viskores::Id sum = 0;
+  for (viskores::Id i = 0; i < 10; ++i)
+  {
+    // only values near the edges may be counted in the neighboring bin
+    sum += bins.ReadPortal().Get(i);
+    VISKORES_TEST_ASSERT(viskores::Abs(bins.ReadPortal().Get(i) - exactBins.ReadPortal().Get(i)) <
+                         100);
+  }
+  VISKORES_TEST_ASSERT(sum == N);
+
+  // the fine bins of partitions merge into the same fine bins
+  viskores::cont::PartitionedDataSet pds;
+  for (viskores::Id p = 0; p < 3; ++p)
+  {
+    viskores::cont::DataSet partition;
+    partition.AddPointField(
+      "values",
+      std::vector<viskores::Float64>(values.begin() + p * N / 3, values.begin() + (p + 1) * N / 3));
+    pds.AppendPartition(partition);
+  }
+  auto pdsResult = histogram.Execute(pds);
+  VISKORES_TEST_ASSERT(test_equal_ArrayHandles(GetBins(pdsResult.GetPartition(0)), bins));
+
+  std::cout << "Logarithmic bins" << std::endl;
+  values.clear();
+  for (viskores::Id i = 0; i <= 600; ++i)
+  {
+    values.push_back(viskores::Pow(10.0, static_cast<viskores::Float64>(i) / 100 + 0.005));
+  }
+  ds.AddPointField("values", values);
+  histogram.SetNumberOfBins(6);
+  histogram.SetBinningMode(
+    viskores::filter::density_estimate::Histogram::BinningMode::Logarithmic);
+  bins = GetBins(histogram.Execute(ds));
+  for (viskores::Id i = 0; i < 6; ++i)
+  {
+    VISKORES_TEST_ASSERT(viskores::Abs(bins.ReadPortal().Get(i) - 100) <= 2);
+  }
+  const std::vector<viskores::Float64>& edges = histogram.GetBinEdges();
+  VISKORES_TEST_ASSERT(edges.size() == 7);
+  VISKORES_TEST_ASSERT(test_equal(edges[3], viskores::Pow(10.0, 3.005)));
+
+  values.push_back(0);
+  ds.AddPointField("values", values);
+  bool caught = false;
+  try
+  {
+    histogram.Execute(ds);
+  }
+  catch (const viskores::cont::ErrorFilterExecution&)
+  {
+    caught = true;
+  }
+  VISKORES_TEST_ASSERT(caught, "Logarithmic bins must reject values that are not positive");
+
+  std::cout << "Equal population bins" << std::endl;
+  values.clear();
+  for (viskores::Id i = 0; i < 10000; ++i)
+  {
+    values.push_back(static_cast<viskores::Float64>(i * i));
+  }
+  ds.AddPointField("values", values);
+  histogram.SetNumberOfBins(4);
+  histogram.SetBinningMode(
+    viskores::filter::density_estimate::Histogram::BinningMode::EqualPopulation);
+  bins = GetBins(histogram.Execute(ds));
+  for (viskores::Id i = 0; i < 4; ++i)
+  {
+    VISKORES_TEST_ASSERT(viskores::Abs(bins.ReadPortal().Get(i) - 2500) < 50);
+    VISKORES_TEST_ASSERT(viskores::Abs(histogram.GetBinEdges()[static_cast<std::size_t>(i)] -
+                                       2500.0 * 2500.0 * static_cast<viskores::Float64>(i * i)) <
+                         0.01 * 1e8);
+  }
+}
+
 //
 // Create a dataset with known point data and cell data (statistical distributions)
 // Extract arrays of point and cell fields
@@ -343,6 +451,8 @@ void TestHistogram()
   range = histogram.GetComputedRange();
   VerifyHistogram(result, histogram.GetNumberOfBins(), range, delta, false);
 
+
+  TestAdaptiveHistogram();
 } // TestFieldHistogram
 
 int UnitTestHistogramFilter(int argc, char* argv[])
@@ -171,11 +171,12 @@ viskores::cont::DataSet MakeTestDataSet()
   return dataSet;
 }
 
-void RunTest()
+void TestNDEntropy(bool useHashAggregation)
 {
   viskores::cont::DataSet ds = MakeTestDataSet();
 
   viskores::filter::density_estimate::NDEntropy ndEntropyFilter;
+  ndEntropyFilter.SetUseHashAggregation(useHashAggregation);
 
   ndEntropyFilter.AddFieldAndBin("fieldA", 10);
   ndEntropyFilter.AddFieldAndBin("fieldB", 10);
@@ -194,6 +195,12 @@ void RunTest()
                        "N-Dimentional entropy filter calculation is incorrect");
 }
 
+void RunTest()
+{
+  TestNDEntropy(false);
+  TestNDEntropy(true);
+}
+
 } // anonymous namespace
 
 int UnitTestNDEntropyFilter(int argc, char* argv[])
@@ -53,11 +53,13 @@ viskores::cont::DataSet MakeTestDataSet()
   return dataSet;
 }
 
-void RunTest()
+void TestNDHistogram(bool useHashAggregation)
 {
+  std::cout << "Test ND histogram, hash aggregation " << useHashAggregation << std::endl;
   viskores::cont::DataSet ds = MakeTestDataSet();
 
   viskores::filter::density_estimate::NDHistogram ndHistFilter;
+  ndHistFilter.SetUseHashAggregation(useHashAggregation);
 
   ndHistFilter.AddFieldAndBin("fieldA", 4);
   ndHistFilter.AddFieldAndBin("fieldB", 4);
@@ -111,6 +113,52 @@ void RunTest()
   }
 }
 
+void TestSparseNDHistogram()
+{
+  std::cout << "Test sparse 6D histogram" << std::endl;
+  // 6 fields with 64 bins each have 2^36 bins, of which at most 20000 are occupied
+  constexpr viskores::Id numValues = 20000;
+  viskores::cont::DataSet ds;
+  for (viskores::Id field = 0; field < 6; ++field)
+  {
+    std::vector<viskores::Float32> values;
+    for (viskores::Id i = 0; i < numValues; ++i)
+    {
+      // a few hot spots plus spread values
+      const viskores::Id v = (i % 3 == 0) ? field : (i * (field + 7) * 7919) % 641;
+      values.push_back(static_cast<viskores::Float32>(v));
+    }
+    ds.AddPointField("field" + std::to_string(field), values);
+  }
+
+  auto runHistogram = [&](bool useHashAggregation)
+  {
+    viskores::filter::density_estimate::NDHistogram ndHistFilter;
+    for (viskores::Id field = 0; field < 6; ++field)
+    {
+      ndHistFilter.AddFieldAndBin("field" + std::to_string(field), 64);
+    }
+    ndHistFilter.SetUseHashAggregation(useHashAggregation);
+    return ndHistFilter.Execute(ds);
+  };
+  viskores::cont::DataSet sorted = runHistogram(false);
+  viskores::cont::DataSet hashed = runHistogram(true);
+  for (const std::string name : { "field0", "field3", "field5", "Frequency" })
+  {
+    VISKORES_TEST_ASSERT(test_equal_ArrayHandles(sorted.GetField(name).GetData(),
+                                                 hashed.GetField(name).GetData()),
+                         "Hashed and sorted histograms differ in ",
+                         name);
+  }
+}
+
+void RunTest()
+{
+  TestNDHistogram(false);
+  TestNDHistogram(true);
+  TestSparseNDHistogram();
+}
+
 } // anonymous namespace
 
 int UnitTestNDHistogramFilter(int argc, char* argv[])
@@ -13,9 +13,12 @@
 #include <viskores/cont/DataSetBuilderExplicit.h>
 #include <viskores/cont/testing/Testing.h>
 #include <viskores/filter/density_estimate/ParticleDensityCloudInCell.h>
+#include <viskores/filter/density_estimate/ParticleDensityKernel.h>
 #include <viskores/filter/density_estimate/ParticleDensityNearestGridPoint.h>
 #include <viskores/worklet/DescriptiveStatistics.h>
 
+#include <vector>
+
 void TestNGP()
 {
   const viskores::Id N = 1000;
@@ -130,10 +133,150 @@ void TestCIC()
   VISKORES_TEST_ASSERT(test_equal(counts_result.Sum(), mass_result.N(), 0.1));
 }
 
+viskores::cont::DataSet MakeParticles(const std::vector<viskores::Vec3f>& positions,
+                                      const std::vector<viskores::FloatDefault>& mass)
+{
+  viskores::Id numParticles = static_cast<viskores::Id>(positions.size());
+  viskores::cont::ArrayHandle<viskores::Id> connectivity;
+  viskores::cont::ArrayCopy(viskores::cont::make_ArrayHandleIndex(numParticles), connectivity);
+  auto dataSet = viskores::cont::DataSetBuilderExplicit::Create(
+    viskores::cont::make_ArrayHandle(positions, viskores::CopyFlag::On),
+    viskores::CellShapeTagVertex{},
+    1,
+    connectivity);
+  dataSet.AddCellField("mass", viskores::cont::make_ArrayHandle(mass, viskores::CopyFlag::On));
+  return dataSet;
+}
+
+viskores::Float64 SumDensity(const viskores::cont::DataSet& result)
+{
+  viskores::cont::ArrayHandle<viskores::FloatDefault> field;
+  result.GetPointField("density").GetData().AsArrayHandle(field);
+  return viskores::worklet::DescriptiveStatistics::Run(field).Sum();
+}
+
+void TestKernel()
+{
+  using KernelType = viskores::filter::density_estimate::ParticleDensityKernel::KernelType;
+
+  // particles well inside of the grid, so their supports do not leave the grid
+  const viskores::Id N = 1000;
+  auto x = viskores::cont::ArrayHandleRandomUniformReal<viskores::Float32>(N, 0xceed).ReadPortal();
+  auto y = viskores::cont::ArrayHandleRandomUniformReal<viskores::Float32>(N, 0xdeed).ReadPortal();
+  auto z = viskores::cont::ArrayHandleRandomUniformReal<viskores::Float32>(N, 0xabba).ReadPortal();
+  std::vector<viskores::Vec3f> positions;
+  std::vector<viskores::FloatDefault> mass;
+  std::vector<viskores::FloatDefault> smoothingLength;
+  viskores::Float64 totalMass = 0;
+  for (viskores::Id i = 0; i < N; ++i)
+  {
+    positions.push_back(viskores::Vec3f(0.4f) +
+                        0.2f * viskores::make_Vec(x.Get(i), y.Get(i), z.Get(i)));
+    mass.push_back(static_cast<viskores::FloatDefault>(1 + i % 7));
+    smoothingLength.push_back(static_cast<viskores::FloatDefault>(0.06 + 0.0004 * (i % 50)));
+    totalMass += static_cast<viskores::Float64>(mass.back());
+  }
+  auto dataSet = MakeParticles(positions, mass);
+  dataSet.AddCellField("h",
+                       viskores::cont::make_ArrayHandle(smoothingLength, viskores::CopyFlag::On));
+
+  // 17 points in each direction make 3 tiles, so the supports cross the tiles. The
+  // smoothing lengths are above the smallest ones that reach the points around a particle,
+  // about 0.022 for the Gaussian and 0.054 for the cubic spline.
+  viskores::filter::density_estimate::ParticleDensityKernel filter;
+  filter.SetDimension({ 16, 16, 16 });
+  filter.SetBounds({ { 0, 1 }, { 0, 1 }, { 0, 1 } });
+  filter.SetActiveField("mass");
+  filter.SetSmoothingLength(0.07f);
+  filter.SetDivideByVolume(false);
+  for (KernelType kernel : { KernelType::Gaussian, KernelType::CubicSpline })
+  {
+    filter.SetKernelType(kernel);
+    filter.SetSmoothingLengthField("");
+    VISKORES_TEST_ASSERT(test_equal(SumDensity(filter.Execute(dataSet)), totalMass, 1e-4));
+    filter.SetSmoothingLengthField("h");
+    VISKORES_TEST_ASSERT(test_equal(SumDensity(filter.Execute(dataSet)), totalMass, 1e-4));
+    filter.SetComputeNumberDensity(true);
+    VISKORES_TEST_ASSERT(test_equal(SumDensity(filter.Execute(dataSet)), N, 1e-4));
+    filter.SetComputeNumberDensity(false);
+  }
+
+  // two particles on points, each spreading with its own smoothing length
+  auto pair = MakeParticles({ { 0.25f, 0.5f, 0.5f }, { 0.75f, 0.5f, 0.5f } }, { 1, 3 });
+  auto pairDensity = [&](viskores::FloatDefault h0, viskores::FloatDefault h1)
+  {
+    pair.AddCellField("h", std::vector<viskores::FloatDefault>{ h0, h1 });
+    auto output = filter.Execute(pair);
+    VISKORES_TEST_ASSERT(test_equal(SumDensity(output), 4));
+    viskores::cont::ArrayHandle<viskores::FloatDefault> result;
+    output.GetPointField("density").GetData().AsArrayHandle(result);
+    return result;
+  };
+  // the values along the line through both particles
+  auto line = [](const viskores::cont::ArrayHandle<viskores::FloatDefault>& result)
+  {
+    std::vector<viskores::Float64> values;
+    auto portal = result.ReadPortal();
+    for (viskores::Id i = 0; i < 17; ++i)
+    {
+      values.push_back(static_cast<viskores::Float64>(portal.Get(i + 17 * (8 + 17 * 8))));
+    }
+    return values;
+  };
+  filter.SetSmoothingLengthField("h");
+  filter.SetKernelType(KernelType::Gaussian);
+  const auto gaussian = line(pairDensity(0.03f, 0.045f));
+  const std::size_t centers[] = { 4, 12 };
+  const viskores::Float64 lengths[] = { 0.03, 0.045 };
+  for (std::size_t particle = 0; particle < 2; ++particle)
+  {
+    const std::size_t center = centers[particle];
+    const viskores::Float64 neighbor =
+      viskores::Exp(-0.0625 * 0.0625 / (lengths[particle] * lengths[particle]));
+    VISKORES_TEST_ASSERT(test_equal(gaussian[center + 1], neighbor * gaussian[center]));
+    VISKORES_TEST_ASSERT(test_equal(gaussian[center - 1], gaussian[center + 1]));
+  }
+  // the cubic spline reaches twice the smoothing length of each particle
+  filter.SetKernelType(KernelType::CubicSpline);
+  const auto spline = line(pairDensity(0.06f, 0.1f));
+  VISKORES_TEST_ASSERT(spline[5] > 0 && spline[6] == 0);
+  VISKORES_TEST_ASSERT(spline[15] > 0 && spline[16] == 0);
+
+  // a single particle on a point at the corner of a tile spreads like the kernel
+  filter.SetKernelType(KernelType::Gaussian);
+  filter.SetSmoothingLengthField("");
+  filter.SetSmoothingLength(0.1f);
+  filter.SetDivideByVolume(true);
+  auto single = filter.Execute(MakeParticles({ viskores::Vec3f(0.5f) }, { 2 }));
+  viskores::cont::ArrayHandle<viskores::FloatDefault> density;
+  single.GetPointField("density").GetData().AsArrayHandle(density);
+  auto portal = density.ReadPortal();
+  auto value = [&](viskores::Id i, viskores::Id j, viskores::Id k)
+  { return static_cast<viskores::Float64>(portal.Get(i + 17 * (j + 17 * k))); };
+  const viskores::Float64 neighbor = viskores::Exp(-0.0625 * 0.0625 / (0.1 * 0.1));
+  VISKORES_TEST_ASSERT(test_equal(value(9, 8, 8), neighbor * value(8, 8, 8)));
+  VISKORES_TEST_ASSERT(test_equal(value(7, 8, 8), value(9, 8, 8)));
+  VISKORES_TEST_ASSERT(test_equal(value(8, 7, 8), value(8, 8, 9)));
+  VISKORES_TEST_ASSERT(test_equal(value(9, 9, 9), neighbor * neighbor * neighbor * value(8, 8, 8)));
+  // the Gaussian with the smoothing length of the particle approximates the density
+  const viskores::Float64 peak = 2 / (viskores::Pow(viskores::Pi(), 1.5) * 0.1 * 0.1 * 0.1);
+  VISKORES_TEST_ASSERT(test_equal(value(8, 8, 8), peak, 0.01));
+
+  // the part of the support outside of the grid is lost
+  filter.SetKernelType(KernelType::CubicSpline);
+  filter.SetDivideByVolume(false);
+  viskores::Float64 boundaryMass =
+    SumDensity(filter.Execute(MakeParticles({ viskores::Vec3f(0.0f, 0.5f, 0.5f) }, { 1 })));
+  VISKORES_TEST_ASSERT(boundaryMass > 0.5 && boundaryMass < 1);
+  VISKORES_TEST_ASSERT(
+    SumDensity(filter.Execute(MakeParticles({ viskores::Vec3f(-0.5f, 0.5f, 0.5f) }, { 1 }))) == 0);
+}
+
 void TestParticleDensity()
 {
   TestNGP();
   TestCIC();
+  TestKernel();
 }
 
 int UnitTestParticleDensity(int argc, char* argv[])
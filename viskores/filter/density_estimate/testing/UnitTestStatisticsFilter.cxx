@@ -182,10 +182,72 @@ void TestStatisticsPartition()
   }
 }
 
+void TestStatisticsQuantiles()
+{
+  std::cout << "Test quantiles of the statistics filter" << std::endl;
+
+  // a permutation of 0, ..., N-1, so the values do not arrive in order
+  constexpr viskores::Id N = 100000;
+  const std::vector<viskores::Float64> probabilities{ 0, 0.01, 0.25, 0.5, 0.99, 1 };
+  auto makeDataSet = [](viskores::Id begin, viskores::Id end)
+  {
+    std::vector<viskores::FloatDefault> values;
+    for (viskores::Id i = begin; i < end; ++i)
+    {
+      values.push_back(static_cast<viskores::FloatDefault>((i * 7919) % N));
+    }
+    viskores::cont::DataSet dataSet;
+    dataSet.AddPointField("scalarField", values);
+    return dataSet;
+  };
+  auto checkQuantiles = [&](const viskores::cont::ArrayHandle<viskores::FloatDefault>& quantiles)
+  {
+    VISKORES_TEST_ASSERT(quantiles.GetNumberOfValues() ==
+                         static_cast<viskores::Id>(probabilities.size()));
+    auto portal = quantiles.ReadPortal();
+    VISKORES_TEST_ASSERT(test_equal(portal.Get(0), 0));
+    VISKORES_TEST_ASSERT(test_equal(portal.Get(5), N - 1));
+    for (std::size_t i = 1; i < 5; ++i)
+    {
+      const viskores::Float64 expected = probabilities[i] * (N - 1);
+      const viskores::Float64 quantile = portal.Get(static_cast<viskores::Id>(i));
+      VISKORES_TEST_ASSERT(viskores::Abs(quantile - expected) < 0.005 * N,
+                           "Quantile ",
+                           probabilities[i],
+                           " is ",
+                           quantile,
+                           " instead of about ",
+                           expected);
+    }
+  };
+
+  viskores::filter::density_estimate::Statistics statisticsFilter;
+  statisticsFilter.SetActiveField("scalarField", viskores::cont::Field::Association::Points);
+  statisticsFilter.SetQuantileProbabilities(probabilities);
+
+  viskores::cont::DataSet result = statisticsFilter.Execute(makeDataSet(0, N));
+  viskores::cont::ArrayHandle<viskores::FloatDefault> quantiles;
+  result.GetField("Quantiles").GetData().AsArrayHandle(quantiles);
+  checkQuantiles(quantiles);
+  VISKORES_TEST_ASSERT(result.HasField("QuantileSketch"));
+
+  // the sketches of the partitions merge into a sketch of all values
+  viskores::cont::PartitionedDataSet pds;
+  for (viskores::Id i = 0; i < 7; ++i)
+  {
+    pds.AppendPartition(makeDataSet(i * N / 7, (i + 1) * N / 7));
+  }
+  pds.AppendPartition(makeDataSet(0, 0));
+  viskores::cont::PartitionedDataSet pdsResult = statisticsFilter.Execute(pds);
+  pdsResult.GetField("Quantiles").GetData().AsArrayHandle(quantiles);
+  checkQuantiles(quantiles);
+}
+
 void TestStatistics()
 {
   TestStatisticsPartial();
   TestStatisticsPartition();
+  TestStatisticsQuantiles();
 }
 
 } // anonymous namespace
@@ -250,11 +250,41 @@ void TestStatisticsMPIDataSetEmpty()
   }
 }
 
+void TestStatisticsMPIQuantiles()
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+
+  // each rank has a part of 0, ..., N-1
+  constexpr viskores::Id N = 1000;
+  std::vector<viskores::FloatDefault> values;
+  for (viskores::Id i = N * comm.rank() / comm.size(); i < N * (comm.rank() + 1) / comm.size(); ++i)
+  {
+    values.push_back(static_cast<viskores::FloatDefault>(i));
+  }
+  viskores::cont::DataSet dataSet;
+  dataSet.AddPointField("scalarField", values);
+
+  viskores::filter::density_estimate::Statistics statisticsFilter;
+  statisticsFilter.SetActiveField("scalarField", viskores::cont::Field::Association::Points);
+  statisticsFilter.SetQuantileProbabilities({ 0, 0.5, 1 });
+  viskores::cont::PartitionedDataSet outputPDS =
+    statisticsFilter.Execute(viskores::cont::PartitionedDataSet(dataSet));
+
+  // unlike the other statistics, the quantiles are available on all ranks
+  viskores::cont::ArrayHandle<viskores::FloatDefault> quantiles;
+  outputPDS.GetField("Quantiles").GetData().AsArrayHandle(quantiles);
+  auto portal = quantiles.ReadPortal();
+  VISKORES_TEST_ASSERT(test_equal(portal.Get(0), 0));
+  VISKORES_TEST_ASSERT(viskores::Abs(portal.Get(1) - (N - 1) / 2.0) < 0.005 * N);
+  VISKORES_TEST_ASSERT(test_equal(portal.Get(2), N - 1));
+}
+
 void TestStatistics()
 {
   TestStatisticsMPISingleDataSet();
   TestStatisticsMPIPartitionDataSets();
   TestStatisticsMPIDataSetEmpty();
+  TestStatisticsMPIQuantiles();
 } // TestFieldStatistics
 }
 
@@ -0,0 +1,490 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_worklet_AdaptiveHistogram_h
+#define viskores_worklet_AdaptiveHistogram_h
+
+#include <viskores/Assert.h>
+#include <viskores/Math.h>
+#include <viskores/cont/ArrayHandle.h>
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/ErrorBadValue.h>
+#include <viskores/cont/Invoker.h>
+#include <viskores/worklet/WorkletMapField.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace adaptive_histogram
+{
+
+/// The smallest exponent of the width of the fine bins.
+static constexpr viskores::Int32 MinExponent = -1000;
+/// The fine bins are at least 2^-40 times the largest magnitude of the values. This keeps the
+/// bin indices exact in double precision.
+static constexpr viskores::Int32 RelativeResolution = 40;
+
+VISKORES_EXEC_CONT inline viskores::Float64 BinWidth(viskores::Int32 exponent)
+{
+  return viskores::Pow(viskores::Float64{ 2 }, static_cast<viskores::Float64>(exponent));
+}
+
+/// Index of the fine bin of width 2^`exponent` that contains `value`. The bins are aligned at
+/// multiples of their width, so a bin is exactly the union of two bins of the next finer
+/// width.
+VISKORES_EXEC_CONT inline viskores::Id BinIndex(viskores::Float64 value, viskores::Int32 exponent)
+{
+  return static_cast<viskores::Id>(viskores::Floor(value / BinWidth(exponent)));
+}
+
+/// The smallest exponent, not smaller than `exponent`, for which [min, max] is covered by at
+/// most `numBins` fine bins.
+VISKORES_EXEC_CONT inline viskores::Int32 FitExponent(viskores::Int32 exponent,
+                                                       viskores::Float64 min,
+                                                       viskores::Float64 max,
+                                                       viskores::Id numBins)
+{
+  const viskores::Float64 magnitude = viskores::Max(viskores::Abs(min), viskores::Abs(max));
+  if (magnitude > 0)
+  {
+    exponent = viskores::Max(
+      exponent,
+      static_cast<viskores::Int32>(viskores::Floor(viskores::Log2(magnitude))) -
+        RelativeResolution);
+  }
+  if (max > min)
+  {
+    exponent = viskores::Max(exponent,
+                             static_cast<viskores::Int32>(viskores::Ceil(viskores::Log2(
+                               (max - min) / static_cast<viskores::Float64>(numBins - 1)))));
+  }
+  while (BinIndex(max, exponent) - BinIndex(min, exponent) >= numBins)
+  {
+    ++exponent;
+  }
+  return exponent;
+}
+
+/// The first fine bin of a window of `numBins` bins that centers [min, max].
+VISKORES_EXEC_CONT inline viskores::Id CenterOrigin(viskores::Int32 exponent,
+                                                     viskores::Float64 min,
+                                                     viskores::Float64 max,
+                                                     viskores::Id numBins)
+{
+  const viskores::Id first = BinIndex(min, exponent);
+  const viskores::Id last = BinIndex(max, exponent);
+  return first - (numBins - (last - first + 1)) / 2;
+}
+
+/// Move the counts of the fine bins in `counts[offset, offset + numBins)` to a coarser or
+/// equal exponent and a new origin, in place. The new bins must cover all nonempty bins.
+VISKORES_SUPPRESS_EXEC_WARNINGS
+template <typename PortalType>
+VISKORES_EXEC_CONT void RebinInPlace(const PortalType& counts,
+                                     viskores::Id offset,
+                                     viskores::Id numBins,
+                                     viskores::Int32 oldExponent,
+                                     viskores::Id oldOrigin,
+                                     viskores::Int32 newExponent,
+                                     viskores::Id newOrigin)
+{
+  if (newExponent > oldExponent)
+  {
+    // merge the bins into the first bins of the window. The bins only move down.
+    const viskores::Float64 factor = BinWidth(oldExponent - newExponent);
+    const viskores::Id base = static_cast<viskores::Id>(
+      viskores::Floor(static_cast<viskores::Float64>(oldOrigin) * factor));
+    for (viskores::Id i = 0; i < numBins; ++i)
+    {
+      const viskores::Id count = counts.Get(offset + i);
+      if (count != 0)
+      {
+        const viskores::Id target = static_cast<viskores::Id>(viskores::Floor(
+                                      static_cast<viskores::Float64>(oldOrigin + i) * factor)) -
+          base;
+        counts.Set(offset + i, 0);
+        counts.Set(offset + target, counts.Get(offset + target) + count);
+      }
+    }
+    oldOrigin = base;
+  }
+
+  const viskores::Id shift = oldOrigin - newOrigin;
+  if (shift > 0)
+  {
+    for (viskores::Id i = numBins - 1 - shift; i >= 0; --i)
+    {
+      counts.Set(offset + i + shift, counts.Get(offset + i));
+    }
+    for (viskores::Id i = 0; i < viskores::Min(shift, numBins); ++i)
+    {
+      counts.Set(offset + i, 0);
+    }
+  }
+  else if (shift < 0)
+  {
+    for (viskores::Id i = -shift; i < numBins; ++i)
+    {
+      counts.Set(offset + i + shift, counts.Get(offset + i));
+    }
+    for (viskores::Id i = viskores::Max(numBins + shift, viskores::Id{ 0 }); i < numBins; ++i)
+    {
+      counts.Set(offset + i, 0);
+    }
+  }
+}
+
+/// Builds the fine histogram of each chunk of the values in a single pass. The window of fine
+/// bins starts around the first value and is shifted or coarsened when a value falls outside.
+class BuildChunkHistograms : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn chunk,
+                                WholeArrayIn values,
+                                WholeArrayInOut counts,
+                                FieldOut exponent,
+                                FieldOut origin,
+                                FieldOut range,
+                                FieldOut numSkipped);
+
+  VISKORES_CONT BuildChunkHistograms(viskores::Id chunkSize,
+                                     viskores::Id numFineBins,
+                                     bool logarithmic)
+    : ChunkSize(chunkSize)
+    , NumberOfFineBins(numFineBins)
+    , Logarithmic(logarithmic)
+  {
+  }
+
+  template <typename ValuesPortalType, typename CountsPortalType>
+  VISKORES_EXEC void operator()(viskores::Id chunk,
+                                const ValuesPortalType& values,
+                                const CountsPortalType& counts,
+                                viskores::Int32& exponent,
+                                viskores::Id& origin,
+                                viskores::Vec2f_64& range,
+                                viskores::Id& numSkipped) const
+  {
+    const viskores::Id begin = chunk * this->ChunkSize;
+    const viskores::Id end = viskores::Min(begin + this->ChunkSize, values.GetNumberOfValues());
+    const viskores::Id offset = chunk * this->NumberOfFineBins;
+    exponent = MinExponent;
+    origin = 0;
+    range = viskores::Vec2f_64(viskores::Infinity64(), viskores::NegativeInfinity64());
+    numSkipped = 0;
+    for (viskores::Id i = begin; i < end; ++i)
+    {
+      viskores::Float64 value = static_cast<viskores::Float64>(values.Get(i));
+      if (this->Logarithmic)
+      {
+        value = (value > 0) ? viskores::Log2(value) : viskores::Nan64();
+      }
+      if (!viskores::IsFinite(value))
+      {
+        ++numSkipped;
+        continue;
+      }
+
+      if (value < range[0] || value > range[1])
+      {
+        const bool first = range[0] > range[1];
+        range[0] = viskores::Min(range[0], value);
+        range[1] = viskores::Max(range[1], value);
+        // compare the values, as their bin index may overflow while the bins are tiny
+        const viskores::Float64 width = BinWidth(exponent);
+        if (first || range[0] < static_cast<viskores::Float64>(origin) * width ||
+            range[1] >= static_cast<viskores::Float64>(origin + this->NumberOfFineBins) * width)
+        {
+          const viskores::Int32 newExponent =
+            FitExponent(exponent, range[0], range[1], this->NumberOfFineBins);
+          const viskores::Id newOrigin =
+            CenterOrigin(newExponent, range[0], range[1], this->NumberOfFineBins);
+          if (!first)
+          {
+            RebinInPlace(counts,
+                         offset,
+                         this->NumberOfFineBins,
+                         exponent,
+                         origin,
+                         newExponent,
+                         newOrigin);
+          }
+          exponent = newExponent;
+          origin = newOrigin;
+        }
+      }
+      const viskores::Id bin = offset + BinIndex(value, exponent) - origin;
+      counts.Set(bin, counts.Get(bin) + 1);
+    }
+  }
+
+private:
+  viskores::Id ChunkSize;
+  viskores::Id NumberOfFineBins;
+  bool Logarithmic;
+};
+
+} // namespace adaptive_histogram
+
+/// \brief Histogram with fine bins whose range adapts to the values.
+///
+/// The values are counted in a fixed number of fine bins of width 2^k. The bins are aligned
+/// at multiples of their width, so when a value falls outside of the bins, the window of
+/// bins moves or each pair of bins merges into one bin of width 2^(k+1) without losing any
+/// counts. The range of the values therefore need not be known in advance, and the
+/// histogram is built in a single pass over the values. Two histograms merge exactly into
+/// the histogram of the union of their values.
+///
+/// With `logarithmic` set, the fine bins count the base 2 logarithm of the values. Values
+/// that are not positive are then skipped. Values that are not finite are always skipped.
+///
+/// `CountBins` and `QuantileEdges` then make the final bins from the fine bins. A fine bin
+/// is counted in the final bin that contains its center.
+class AdaptiveHistogram
+{
+public:
+  explicit AdaptiveHistogram(viskores::Id numFineBins = 1024, bool logarithmic = false)
+    : Counts(static_cast<std::size_t>(numFineBins), 0)
+    , Logarithmic(logarithmic)
+  {
+    if (numFineBins < 2)
+    {
+      throw viskores::cont::ErrorBadValue("An adaptive histogram needs at least 2 fine bins.");
+    }
+  }
+
+  template <typename T, typename S>
+  void Run(const viskores::cont::ArrayHandle<T, S>& values)
+  {
+    const viskores::Id numFineBins = this->GetNumberOfFineBins();
+    // a chunk is large enough to amortize its fine bins, and the fine bins of all chunks
+    // take at most 32 MB
+    constexpr viskores::Id MinChunkSize = 4096;
+    constexpr viskores::Id MaxFineCounts = 1 << 22;
+    const viskores::Id maxChunks = viskores::Max(viskores::Id{ 1 }, MaxFineCounts / numFineBins);
+    const viskores::Id numValues = values.GetNumberOfValues();
+    const viskores::Id chunkSize =
+      viskores::Max(MinChunkSize, (numValues + maxChunks - 1) / maxChunks);
+    const viskores::Id numChunks = (numValues + chunkSize - 1) / chunkSize;
+
+    viskores::cont::ArrayHandle<viskores::Id> chunkCounts;
+    chunkCounts.AllocateAndFill(numChunks * numFineBins, 0);
+    viskores::cont::ArrayHandle<viskores::Int32> chunkExponents;
+    viskores::cont::ArrayHandle<viskores::Id> chunkOrigins;
+    viskores::cont::ArrayHandle<viskores::Vec2f_64> chunkRanges;
+    viskores::cont::ArrayHandle<viskores::Id> chunkSkipped;
+    viskores::cont::Invoker invoke;
+    invoke(adaptive_histogram::BuildChunkHistograms{ chunkSize, numFineBins, this->Logarithmic },
+           viskores::cont::ArrayHandleIndex(numChunks),
+           values,
+           chunkCounts,
+           chunkExponents,
+           chunkOrigins,
+           chunkRanges,
+           chunkSkipped);
+
+    *this = AdaptiveHistogram(numFineBins, this->Logarithmic);
+    auto countsPortal = chunkCounts.ReadPortal();
+    auto exponentsPortal = chunkExponents.ReadPortal();
+    auto originsPortal = chunkOrigins.ReadPortal();
+    auto rangesPortal = chunkRanges.ReadPortal();
+    auto skippedPortal = chunkSkipped.ReadPortal();
+    for (viskores::Id chunk = 0; chunk < numChunks; ++chunk)
+    {
+      AdaptiveHistogram chunkHistogram(numFineBins, this->Logarithmic);
+      chunkHistogram.Exponent = exponentsPortal.Get(chunk);
+      chunkHistogram.Origin = originsPortal.Get(chunk);
+      chunkHistogram.Min = rangesPortal.Get(chunk)[0];
+      chunkHistogram.Max = rangesPortal.Get(chunk)[1];
+      chunkHistogram.NumberOfSkippedValues = skippedPortal.Get(chunk);
+      for (viskores::Id i = 0; i < numFineBins; ++i)
+      {
+        chunkHistogram.Counts[static_cast<std::size_t>(i)] =
+          countsPortal.Get(chunk * numFineBins + i);
+      }
+      this->Merge(chunkHistogram);
+    }
+  }
+
+  /// Add the values counted by `other`, which must have the same number of fine bins.
+  void Merge(const AdaptiveHistogram& other)
+  {
+    this->NumberOfSkippedValues += other.NumberOfSkippedValues;
+    if (other.IsEmpty())
+    {
+      return;
+    }
+    if (this->IsEmpty())
+    {
+      const viskores::Id skipped = this->NumberOfSkippedValues;
+      *this = other;
+      this->NumberOfSkippedValues = skipped;
+      return;
+    }
+
+    const viskores::Float64 min = viskores::Min(this->Min, other.Min);
+    const viskores::Float64 max = viskores::Max(this->Max, other.Max);
+    const viskores::Int32 exponent = adaptive_histogram::FitExponent(
+      viskores::Max(this->Exponent, other.Exponent), min, max, this->GetNumberOfFineBins());
+    const viskores::Id origin =
+      adaptive_histogram::CenterOrigin(exponent, min, max, this->GetNumberOfFineBins());
+    AdaptiveHistogram rebinned = other;
+    rebinned.Rebin(exponent, origin);
+    this->Rebin(exponent, origin);
+    for (std::size_t i = 0; i < this->Counts.size(); ++i)
+    {
+      this->Counts[i] += rebinned.Counts[i];
+    }
+    this->Min = min;
+    this->Max = max;
+  }
+
+  /// Move the counts to the fine bins of width 2^`exponent` starting at bin `origin`. The
+  /// exponent must not be smaller than the current one, and the bins must cover the range.
+  void Rebin(viskores::Int32 exponent, viskores::Id origin)
+  {
+    if (!this->IsEmpty())
+    {
+      struct VectorPortal
+      {
+        std::vector<viskores::Id>& Values;
+        viskores::Id Get(viskores::Id i) const { return this->Values[static_cast<std::size_t>(i)]; }
+        void Set(viskores::Id i, viskores::Id value) const
+        {
+          this->Values[static_cast<std::size_t>(i)] = value;
+        }
+      };
+      adaptive_histogram::RebinInPlace(VectorPortal{ this->Counts },
+                                       0,
+                                       this->GetNumberOfFineBins(),
+                                       this->Exponent,
+                                       this->Origin,
+                                       exponent,
+                                       origin);
+    }
+    this->Exponent = exponent;
+    this->Origin = origin;
+  }
+
+  /// Count the fine bins in the final bins between the ascending `edges`. Fine bins outside
+  /// of the edges are counted in the first or last bin.
+  std::vector<viskores::Id> CountBins(const std::vector<viskores::Float64>& edges) const
+  {
+    const std::size_t numBins = edges.size() - 1;
+    std::vector<viskores::Id> bins(numBins, 0);
+    for (std::size_t i = 0; i < this->Counts.size(); ++i)
+    {
+      if (this->Counts[i] != 0)
+      {
+        const viskores::Float64 center = this->GetFineBinCenter(static_cast<viskores::Id>(i));
+        const std::size_t bin = static_cast<std::size_t>(
+          std::upper_bound(edges.begin() + 1, edges.end() - 1, center) - edges.begin() - 1);
+        bins[bin] += this->Counts[i];
+      }
+    }
+    return bins;
+  }
+
+  /// Edges of `numBins` bins that hold about the same number of values. The edges interpolate
+  /// the cumulative counts of the fine bins and start and end at the minimum and maximum.
+  std::vector<viskores::Float64> QuantileEdges(viskores::Id numBins) const
+  {
+    std::vector<viskores::Float64> edges(static_cast<std::size_t>(numBins + 1));
+    edges.front() = this->Min;
+    edges.back() = this->Max;
+    const viskores::Float64 total = static_cast<viskores::Float64>(this->GetNumberOfValues());
+    const viskores::Float64 width = adaptive_histogram::BinWidth(this->Exponent);
+    viskores::Float64 before = 0;
+    std::size_t fineBin = 0;
+    for (viskores::Id edge = 1; edge < numBins; ++edge)
+    {
+      const viskores::Float64 target =
+        total * static_cast<viskores::Float64>(edge) / static_cast<viskores::Float64>(numBins);
+      while (fineBin + 1 < this->Counts.size() &&
+             before + static_cast<viskores::Float64>(this->Counts[fineBin]) < target)
+      {
+        before += static_cast<viskores::Float64>(this->Counts[fineBin]);
+        ++fineBin;
+      }
+      const viskores::Float64 count = static_cast<viskores::Float64>(this->Counts[fineBin]);
+      const viskores::Float64 fraction = (count > 0) ? (target - before) / count : 0;
+      const viskores::Float64 start =
+        static_cast<viskores::Float64>(this->Origin + static_cast<viskores::Id>(fineBin)) * width;
+      edges[static_cast<std::size_t>(edge)] =
+        viskores::Max(this->Min, viskores::Min(start + fraction * width, this->Max));
+    }
+    return edges;
+  }
+
+  bool IsEmpty() const { return this->Min > this->Max; }
+  viskores::Id GetNumberOfValues() const
+  {
+    viskores::Id numValues = 0;
+    for (viskores::Id count : this->Counts)
+    {
+      numValues += count;
+    }
+    return numValues;
+  }
+  /// Number of values that are not finite or, for logarithmic bins, not positive.
+  viskores::Id GetNumberOfSkippedValues() const { return this->NumberOfSkippedValues; }
+  viskores::Id GetNumberOfFineBins() const
+  {
+    return static_cast<viskores::Id>(this->Counts.size());
+  }
+  bool GetLogarithmic() const { return this->Logarithmic; }
+  /// The fine bins have a width of 2^exponent.
+  viskores::Int32 GetExponent() const { return this->Exponent; }
+  /// Index of the first fine bin. Fine bin i covers [(origin + i), (origin + i + 1)) * width.
+  viskores::Id GetOrigin() const { return this->Origin; }
+  viskores::Float64 GetFineBinCenter(viskores::Id i) const
+  {
+    return (static_cast<viskores::Float64>(this->Origin + i) + 0.5) *
+      adaptive_histogram::BinWidth(this->Exponent);
+  }
+  const std::vector<viskores::Id>& GetCounts() const { return this->Counts; }
+  /// The range of the counted values (of their logarithm for logarithmic bins).
+  viskores::Float64 GetMin() const { return this->Min; }
+  viskores::Float64 GetMax() const { return this->Max; }
+
+  /// Set the complete state, e.g., after communicating it. `counts` must have one entry for
+  /// each fine bin.
+  void SetState(viskores::Int32 exponent,
+                viskores::Id origin,
+                viskores::Float64 min,
+                viskores::Float64 max,
+                viskores::Id numSkipped,
+                const std::vector<viskores::Id>& counts)
+  {
+    VISKORES_ASSERT(counts.size() == this->Counts.size());
+    this->Exponent = exponent;
+    this->Origin = origin;
+    this->Min = min;
+    this->Max = max;
+    this->NumberOfSkippedValues = numSkipped;
+    this->Counts = counts;
+  }
+
+private:
+  std::vector<viskores::Id> Counts;
+  bool Logarithmic;
+  viskores::Int32 Exponent = adaptive_histogram::MinExponent;
+  viskores::Id Origin = 0;
+  viskores::Float64 Min = viskores::Infinity64();
+  viskores::Float64 Max = viskores::NegativeInfinity64();
+  viskores::Id NumberOfSkippedValues = 0;
+};
+
+}
+} // namespace viskores::worklet
+
+#endif // viskores_worklet_AdaptiveHistogram_h
@@ -35,6 +35,12 @@ public:
     NdHistogram.SetNumOfDataPoints(_numDataPoints);
   }
 
+  // Count the bins with a hash table instead of sorting (see NDimsHistogram)
+  void SetUseHashAggregation(bool useHashAggregation)
+  {
+    NdHistogram.SetUseHashAggregation(useHashAggregation);
+  }
+
   // Add a field and the bin for this field
   // Return: rangeOfRange is min max value of this array
   //         binDelta is delta of a bin
@@ -18,6 +18,7 @@
 #include <viskores/cont/DataSet.h>
 #include <viskores/cont/ErrorBadValue.h>
 #include <viskores/filter/density_estimate/worklet/histogram/ComputeNDHistogram.h>
+#include <viskores/filter/density_estimate/worklet/histogram/HashAggregateBins.h>
 #include <viskores/worklet/DispatcherMapField.h>
 #include <viskores/worklet/WorkletMapField.h>
 
@@ -40,6 +41,10 @@ public:
     viskores::cont::ArrayCopy(constant0Array, Bin1DIndex);
   }
 
+  // Count the bins with a hash table instead of sorting the bins of all data points.
+  // This is faster for many variables, when few of the bins are occupied.
+  void SetUseHashAggregation(bool useHashAggregation) { UseHashAggregation = useHashAggregation; }
+
   // Add a field and the bin number for this field along with specific range of the data
   // Return: binDelta is delta of a bin
   template <typename HandleType>
@@ -104,13 +109,31 @@ public:
   {
     binId.resize(NumberOfBins.size());
 
-    // Sort the resulting bin(1D) array for counting
-    viskores::cont::Algorithm::Sort(Bin1DIndex);
-
-    // Count frequency of each bin
     viskores::cont::ArrayHandleConstant<viskores::Id> constArray(1, NumDataPoints);
-    viskores::cont::Algorithm::ReduceByKey(
-      Bin1DIndex, constArray, Bin1DIndex, freqs, viskores::Add());
+    if (UseHashAggregation)
+    {
+      // Count frequency of each occupied bin
+      // (the number of data points also bounds the occupied bins and avoids an overflow)
+      viskores::Id totalBins = 1;
+      for (viskores::Id nFieldBins : NumberOfBins)
+      {
+        totalBins =
+          (totalBins > NumDataPoints / nFieldBins) ? NumDataPoints : totalBins * nFieldBins;
+      }
+      viskores::cont::ArrayHandle<viskores::Id> uniqueBins;
+      viskores::worklet::histogram::HashAggregateBins(
+        Bin1DIndex, constArray, totalBins, uniqueBins, freqs);
+      Bin1DIndex = uniqueBins;
+    }
+    else
+    {
+      // Sort the resulting bin(1D) array for counting
+      viskores::cont::Algorithm::Sort(Bin1DIndex);
+
+      // Count frequency of each bin
+      viskores::cont::Algorithm::ReduceByKey(
+        Bin1DIndex, constArray, Bin1DIndex, freqs, viskores::Add());
+    }
 
     //convert back to multi variate binId
     for (viskores::Id i = static_cast<viskores::Id>(NumberOfBins.size()) - 1; i >= 0; i--)
@@ -128,6 +151,7 @@ private:
   std::vector<viskores::Id> NumberOfBins;
   viskores::cont::ArrayHandle<viskores::Id> Bin1DIndex;
   viskores::Id NumDataPoints;
+  bool UseHashAggregation = false;
 };
 }
 } // namespace viskores::worklet
@@ -0,0 +1,363 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_worklet_QuantileSketch_h
+#define viskores_worklet_QuantileSketch_h
+
+#include <viskores/Math.h>
+#include <viskores/Swap.h>
+#include <viskores/cont/ArrayHandle.h>
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/Invoker.h>
+#include <viskores/worklet/WorkletMapField.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace quantile_sketch
+{
+
+/// The compression of the t-digest. A sketch has at most `Compression` + 1 centroids.
+static constexpr viskores::IdComponent Compression = 100;
+static constexpr viskores::IdComponent MaxCentroids = 128;
+static constexpr viskores::IdComponent BufferSize = 128;
+
+/// The largest fraction of the values, starting at quantile `q`, that one centroid may hold.
+/// This uses the scale function k1 of the t-digest, which keeps the centroids at the tails
+/// small so that extreme quantiles are accurate.
+VISKORES_EXEC_CONT inline viskores::Float64 QuantileLimit(viskores::Float64 q)
+{
+  const viskores::Float64 scale = static_cast<viskores::Float64>(Compression) / viskores::TwoPi();
+  const viskores::Float64 k = scale * viskores::ASin(2 * q - 1) + 1;
+  if (k >= scale * viskores::Pi_2())
+  {
+    return 1;
+  }
+  return (viskores::Sin(k / scale) + 1) / 2;
+}
+
+/// Merge neighboring centroids (mean, weight), which must be sorted by mean, as long as the
+/// merged centroids respect `QuantileLimit`. Returns the new number of centroids.
+VISKORES_EXEC_CONT inline viskores::Id CompressCentroids(viskores::Vec2f_64* centroids,
+                                                         viskores::Id numCentroids)
+{
+  if (numCentroids == 0)
+  {
+    return 0;
+  }
+  viskores::Float64 totalWeight = 0;
+  for (viskores::Id i = 0; i < numCentroids; ++i)
+  {
+    totalWeight += centroids[i][1];
+  }
+
+  viskores::Id last = 0;
+  viskores::Float64 weightBefore = 0;
+  viskores::Float64 weightLimit = totalWeight * QuantileLimit(0);
+  for (viskores::Id i = 1; i < numCentroids; ++i)
+  {
+    viskores::Vec2f_64& current = centroids[last];
+    const viskores::Vec2f_64 next = centroids[i];
+    if (weightBefore + current[1] + next[1] <= weightLimit)
+    {
+      current[1] += next[1];
+      current[0] += (next[0] - current[0]) * next[1] / current[1];
+    }
+    else
+    {
+      weightBefore += current[1];
+      weightLimit = totalWeight * QuantileLimit(weightBefore / totalWeight);
+      centroids[++last] = next;
+    }
+  }
+  return last + 1;
+}
+
+VISKORES_EXEC_CONT inline void SiftDown(viskores::Float64* values,
+                                        viskores::Id root,
+                                        viskores::Id end)
+{
+  while (2 * root + 1 < end)
+  {
+    viskores::Id child = 2 * root + 1;
+    if (child + 1 < end && values[child] < values[child + 1])
+    {
+      ++child;
+    }
+    if (!(values[root] < values[child]))
+    {
+      return;
+    }
+    viskores::Swap(values[root], values[child]);
+    root = child;
+  }
+}
+
+/// Sort `values` in ascending order. Heap sort needs no memory besides the values.
+VISKORES_EXEC_CONT inline void HeapSort(viskores::Float64* values, viskores::Id numValues)
+{
+  for (viskores::Id start = numValues / 2 - 1; start >= 0; --start)
+  {
+    SiftDown(values, start, numValues);
+  }
+  for (viskores::Id end = numValues - 1; end > 0; --end)
+  {
+    viskores::Swap(values[0], values[end]);
+    SiftDown(values, 0, end);
+  }
+}
+
+/// A t-digest of fixed size that is filled one value at a time. The values are buffered
+/// and merged into the centroids when the buffer is full.
+struct StreamingDigest
+{
+  viskores::Vec<viskores::Vec2f_64, MaxCentroids + BufferSize> Centroids;
+  viskores::Vec<viskores::Float64, BufferSize> Buffer;
+  viskores::IdComponent NumberOfCentroids = 0;
+  viskores::IdComponent NumberOfBuffered = 0;
+
+  VISKORES_EXEC_CONT void Add(viskores::Float64 value)
+  {
+    this->Buffer[this->NumberOfBuffered++] = value;
+    if (this->NumberOfBuffered == BufferSize)
+    {
+      this->Flush();
+    }
+  }
+
+  VISKORES_EXEC_CONT void Flush()
+  {
+    HeapSort(&this->Buffer[0], this->NumberOfBuffered);
+    // merge the sorted values into the centroids, starting at the back, which is free
+    viskores::IdComponent centroid = this->NumberOfCentroids - 1;
+    viskores::IdComponent buffered = this->NumberOfBuffered - 1;
+    viskores::IdComponent merged = this->NumberOfCentroids + this->NumberOfBuffered - 1;
+    while (buffered >= 0)
+    {
+      if (centroid >= 0 && this->Centroids[centroid][0] > this->Buffer[buffered])
+      {
+        this->Centroids[merged--] = this->Centroids[centroid--];
+      }
+      else
+      {
+        this->Centroids[merged--] = viskores::Vec2f_64(this->Buffer[buffered--], 1);
+      }
+    }
+    this->NumberOfCentroids = static_cast<viskores::IdComponent>(
+      CompressCentroids(&this->Centroids[0], this->NumberOfCentroids + this->NumberOfBuffered));
+    this->NumberOfBuffered = 0;
+  }
+};
+
+class BuildChunkDigests : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn chunk,
+                                WholeArrayIn values,
+                                WholeArrayOut centroids,
+                                FieldOut numCentroids,
+                                FieldOut range);
+
+  VISKORES_CONT explicit BuildChunkDigests(viskores::Id chunkSize)
+    : ChunkSize(chunkSize)
+  {
+  }
+
+  template <typename ValuesPortalType, typename CentroidsPortalType>
+  VISKORES_EXEC void operator()(viskores::Id chunk,
+                                const ValuesPortalType& values,
+                                CentroidsPortalType& centroids,
+                                viskores::IdComponent& numCentroids,
+                                viskores::Vec2f_64& range) const
+  {
+    const viskores::Id begin = chunk * this->ChunkSize;
+    const viskores::Id end = viskores::Min(begin + this->ChunkSize, values.GetNumberOfValues());
+    StreamingDigest digest;
+    range = viskores::Vec2f_64(viskores::Infinity64(), viskores::NegativeInfinity64());
+    for (viskores::Id i = begin; i < end; ++i)
+    {
+      const viskores::Float64 value = static_cast<viskores::Float64>(values.Get(i));
+      digest.Add(value);
+      range[0] = viskores::Min(range[0], value);
+      range[1] = viskores::Max(range[1], value);
+    }
+    digest.Flush();
+
+    numCentroids = digest.NumberOfCentroids;
+    for (viskores::IdComponent i = 0; i < numCentroids; ++i)
+    {
+      centroids.Set(chunk * MaxCentroids + i, digest.Centroids[i]);
+    }
+  }
+
+private:
+  viskores::Id ChunkSize;
+};
+
+} // namespace quantile_sketch
+
+/// \brief Mergeable sketch of the distribution of a field for approximate quantiles.
+///
+/// The sketch is a t-digest: a list of at most 101 centroids (mean, weight) that
+/// summarize the sorted values. The centroids are small near the minimum and maximum,
+/// so the quantiles near 0 and 1 are the most accurate. The memory of the sketch does not
+/// depend on the number of values, and two sketches can be merged into a sketch of the
+/// union of their values. So sketches of partitions and MPI ranks can be combined.
+///
+/// `Run` splits the values into chunks and builds a digest of each chunk in parallel, in
+/// a single pass over the values. The digests of the chunks are then merged.
+class QuantileSketch
+{
+public:
+  QuantileSketch() = default;
+
+  /// Construct a sketch from centroids (mean, weight) that are sorted by mean and the
+  /// range of the summarized values.
+  QuantileSketch(const std::vector<viskores::Vec2f_64>& centroids,
+                 viskores::Float64 min,
+                 viskores::Float64 max)
+    : Centroids(centroids)
+    , Min(min)
+    , Max(max)
+  {
+  }
+
+  template <typename T, typename S>
+  void Run(const viskores::cont::ArrayHandle<T, S>& values)
+  {
+    // a chunk is large enough to amortize its digest, and there are enough chunks to
+    // keep all threads busy
+    constexpr viskores::Id MinChunkSize = 4096;
+    constexpr viskores::Id MaxChunks = 1024;
+    const viskores::Id numValues = values.GetNumberOfValues();
+    const viskores::Id chunkSize =
+      viskores::Max(MinChunkSize, (numValues + MaxChunks - 1) / MaxChunks);
+    const viskores::Id numChunks = (numValues + chunkSize - 1) / chunkSize;
+
+    viskores::cont::ArrayHandle<viskores::Vec2f_64> chunkCentroids;
+    chunkCentroids.Allocate(numChunks * quantile_sketch::MaxCentroids);
+    viskores::cont::ArrayHandle<viskores::IdComponent> numChunkCentroids;
+    viskores::cont::ArrayHandle<viskores::Vec2f_64> chunkRanges;
+    viskores::cont::Invoker invoke;
+    invoke(quantile_sketch::BuildChunkDigests{ chunkSize },
+           viskores::cont::ArrayHandleIndex(numChunks),
+           values,
+           chunkCentroids,
+           numChunkCentroids,
+           chunkRanges);
+
+    *this = QuantileSketch();
+    auto centroidsPortal = chunkCentroids.ReadPortal();
+    auto numCentroidsPortal = numChunkCentroids.ReadPortal();
+    auto rangesPortal = chunkRanges.ReadPortal();
+    for (viskores::Id chunk = 0; chunk < numChunks; ++chunk)
+    {
+      for (viskores::IdComponent i = 0; i < numCentroidsPortal.Get(chunk); ++i)
+      {
+        this->Centroids.push_back(centroidsPortal.Get(chunk * quantile_sketch::MaxCentroids + i));
+      }
+      this->Min = viskores::Min(this->Min, rangesPortal.Get(chunk)[0]);
+      this->Max = viskores::Max(this->Max, rangesPortal.Get(chunk)[1]);
+    }
+    this->Compress();
+  }
+
+  /// Add the values summarized by `other` to this sketch.
+  void Merge(const QuantileSketch& other)
+  {
+    if (other.Centroids.empty())
+    {
+      return;
+    }
+    this->Centroids.insert(this->Centroids.end(), other.Centroids.begin(), other.Centroids.end());
+    this->Min = viskores::Min(this->Min, other.Min);
+    this->Max = viskores::Max(this->Max, other.Max);
+    this->Compress();
+  }
+
+  /// Approximate value below which the fraction `probability` of the values lies.
+  /// Returns NaN if the sketch is empty.
+  viskores::Float64 Quantile(viskores::Float64 probability) const
+  {
+    if (this->Centroids.empty())
+    {
+      return viskores::Nan64();
+    }
+    const viskores::Float64 totalWeight = this->GetNumberOfValues();
+    const viskores::Float64 target =
+      viskores::Max(viskores::Float64{ 0 }, viskores::Min(probability, viskores::Float64{ 1 })) *
+      totalWeight;
+
+    // the values of a centroid are spread around its mean, which is placed at the middle of
+    // its weight. Interpolate between the means and, at the ends, the minimum and maximum.
+    const viskores::Vec2f_64& first = this->Centroids.front();
+    if (target <= first[1] / 2)
+    {
+      return (first[1] == 1) ? first[0]
+                             : this->Min + (first[0] - this->Min) * (2 * target / first[1]);
+    }
+    viskores::Float64 weightBefore = 0;
+    for (std::size_t i = 0; i + 1 < this->Centroids.size(); ++i)
+    {
+      const viskores::Vec2f_64& left = this->Centroids[i];
+      const viskores::Vec2f_64& right = this->Centroids[i + 1];
+      const viskores::Float64 leftCenter = weightBefore + left[1] / 2;
+      const viskores::Float64 rightCenter = weightBefore + left[1] + right[1] / 2;
+      if (target <= rightCenter)
+      {
+        return left[0] + (right[0] - left[0]) * (target - leftCenter) / (rightCenter - leftCenter);
+      }
+      weightBefore += left[1];
+    }
+    const viskores::Vec2f_64& last = this->Centroids.back();
+    if (last[1] == 1)
+    {
+      return last[0];
+    }
+    const viskores::Float64 fromEnd = (totalWeight - target) / (last[1] / 2);
+    return this->Max + (last[0] - this->Max) * fromEnd;
+  }
+
+  viskores::Float64 GetNumberOfValues() const
+  {
+    viskores::Float64 totalWeight = 0;
+    for (const auto& centroid : this->Centroids)
+    {
+      totalWeight += centroid[1];
+    }
+    return totalWeight;
+  }
+
+  /// Centroids (mean, weight) of the digest, sorted by mean.
+  const std::vector<viskores::Vec2f_64>& GetCentroids() const { return this->Centroids; }
+  viskores::Float64 GetMin() const { return this->Min; }
+  viskores::Float64 GetMax() const { return this->Max; }
+
+private:
+  void Compress()
+  {
+    std::sort(this->Centroids.begin(),
+              this->Centroids.end(),
+              [](const viskores::Vec2f_64& a, const viskores::Vec2f_64& b) { return a[0] < b[0]; });
+    this->Centroids.resize(static_cast<std::size_t>(quantile_sketch::CompressCentroids(
+      this->Centroids.data(), static_cast<viskores::Id>(this->Centroids.size()))));
+  }
+
+  std::vector<viskores::Vec2f_64> Centroids;
+  viskores::Float64 Min = viskores::Infinity64();
+  viskores::Float64 Max = viskores::NegativeInfinity64();
+};
+
+}
+} // namespace viskores::worklet
+
+#endif // viskores_worklet_QuantileSketch_h
@@ -0,0 +1,183 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_worklet_HashAggregateBins_h
+#define viskores_worklet_HashAggregateBins_h
+
+#include <viskores/cont/Algorithm.h>
+#include <viskores/cont/ArrayHandle.h>
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/Invoker.h>
+#include <viskores/worklet/WorkletMapField.h>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace histogram
+{
+
+static constexpr viskores::Id EmptyBin = -1;
+
+VISKORES_EXEC_CONT inline viskores::UInt64 HashBin(viskores::Id bin)
+{
+  viskores::UInt64 hash = static_cast<viskores::UInt64>(bin) * 0x9E3779B97F4A7C15ull;
+  return hash ^ (hash >> 29);
+}
+
+// Counts the bins of a chunk of values in a small local hash table. The local table is
+// added to the global hash table when it fills up and at the end of the chunk, so bins
+// that occur often in a chunk need few atomic operations.
+class AggregateChunkBins : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn chunk,
+                                WholeArrayIn bins,
+                                WholeArrayIn weights,
+                                AtomicArrayInOut tableBins,
+                                AtomicArrayInOut tableCounts);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5);
+  using InputDomain = _1;
+
+  static constexpr viskores::IdComponent LocalTableSize = 128;
+  static constexpr viskores::IdComponent LocalTableLoad = 96;
+
+  VISKORES_CONT AggregateChunkBins(viskores::Id chunkSize, viskores::Id tableMask)
+    : ChunkSize(chunkSize)
+    , TableMask(tableMask)
+  {
+  }
+
+  template <typename BinsPortalType, typename WeightsPortalType, typename AtomicArrayType>
+  VISKORES_EXEC void operator()(viskores::Id chunk,
+                                const BinsPortalType& bins,
+                                const WeightsPortalType& weights,
+                                const AtomicArrayType& tableBins,
+                                const AtomicArrayType& tableCounts) const
+  {
+    viskores::Vec<viskores::Id, LocalTableSize> localBins(EmptyBin);
+    viskores::Vec<viskores::Id, LocalTableSize> localCounts(0);
+    viskores::IdComponent numLocalBins = 0;
+
+    const viskores::Id begin = chunk * this->ChunkSize;
+    const viskores::Id end = viskores::Min(begin + this->ChunkSize, bins.GetNumberOfValues());
+    for (viskores::Id i = begin; i < end; ++i)
+    {
+      const viskores::Id weight = static_cast<viskores::Id>(weights.Get(i));
+      if (weight == 0)
+      {
+        continue;
+      }
+      const viskores::Id bin = bins.Get(i);
+      viskores::IdComponent slot =
+        static_cast<viskores::IdComponent>(HashBin(bin) & (LocalTableSize - 1));
+      while (localBins[slot] != EmptyBin && localBins[slot] != bin)
+      {
+        slot = (slot + 1) & (LocalTableSize - 1);
+      }
+      if (localBins[slot] == EmptyBin)
+      {
+        localBins[slot] = bin;
+        localCounts[slot] = 0;
+        ++numLocalBins;
+      }
+      localCounts[slot] += weight;
+
+      if (numLocalBins == LocalTableLoad)
+      {
+        this->Flush(localBins, localCounts, tableBins, tableCounts);
+        numLocalBins = 0;
+      }
+    }
+    this->Flush(localBins, localCounts, tableBins, tableCounts);
+  }
+
+private:
+  template <typename AtomicArrayType>
+  VISKORES_EXEC void Flush(viskores::Vec<viskores::Id, LocalTableSize>& localBins,
+                           const viskores::Vec<viskores::Id, LocalTableSize>& localCounts,
+                           const AtomicArrayType& tableBins,
+                           const AtomicArrayType& tableCounts) const
+  {
+    for (viskores::IdComponent slot = 0; slot < LocalTableSize; ++slot)
+    {
+      const viskores::Id bin = localBins[slot];
+      if (bin == EmptyBin)
+      {
+        continue;
+      }
+      // linear probing in the global table. A slot is claimed by swapping in the bin.
+      viskores::Id index = static_cast<viskores::Id>(HashBin(bin)) & this->TableMask;
+      while (true)
+      {
+        viskores::Id current = EmptyBin;
+        if (tableBins.CompareExchange(index, &current, bin) || current == bin)
+        {
+          tableCounts.Add(index, localCounts[slot]);
+          break;
+        }
+        index = (index + 1) & this->TableMask;
+      }
+      localBins[slot] = EmptyBin;
+    }
+  }
+
+  viskores::Id ChunkSize;
+  viskores::Id TableMask;
+};
+
+struct IsNotEmptyBin
+{
+  VISKORES_EXEC_CONT bool operator()(viskores::Id bin) const { return bin != EmptyBin; }
+};
+
+/// Adds the `weights` of equal `bins` with a hash table instead of sorting all bins.
+/// `uniqueBins` returns the bins with a nonzero total weight in increasing order, and
+/// `counts` their total weights. This is the sparse (coordinate) form of a histogram.
+/// Only the unique bins are sorted, which is much faster than sorting all bins when few
+/// bins are occupied. `maxNumberOfBins` bounds the number of unique bins and thereby the
+/// size of the hash table.
+template <typename WeightsArrayType>
+void HashAggregateBins(const viskores::cont::ArrayHandle<viskores::Id>& bins,
+                       const WeightsArrayType& weights,
+                       viskores::Id maxNumberOfBins,
+                       viskores::cont::ArrayHandle<viskores::Id>& uniqueBins,
+                       viskores::cont::ArrayHandle<viskores::Id>& counts)
+{
+  constexpr viskores::Id ChunkSize = 1024;
+  const viskores::Id numValues = bins.GetNumberOfValues();
+  const viskores::Id bound = viskores::Min(numValues, maxNumberOfBins);
+  // keep the load of the table at 2/3 or less
+  viskores::Id capacity = 1;
+  while (capacity < bound + bound / 2 + 1)
+  {
+    capacity *= 2;
+  }
+
+  viskores::cont::ArrayHandle<viskores::Id> tableBins;
+  tableBins.AllocateAndFill(capacity, EmptyBin);
+  viskores::cont::ArrayHandle<viskores::Id> tableCounts;
+  tableCounts.AllocateAndFill(capacity, 0);
+  viskores::cont::Invoker invoke;
+  invoke(AggregateChunkBins{ ChunkSize, capacity - 1 },
+         viskores::cont::ArrayHandleIndex((numValues + ChunkSize - 1) / ChunkSize),
+         bins,
+         weights,
+         tableBins,
+         tableCounts);
+
+  viskores::cont::Algorithm::CopyIf(tableBins, tableBins, uniqueBins, IsNotEmptyBin{});
+  viskores::cont::Algorithm::CopyIf(tableCounts, tableBins, counts, IsNotEmptyBin{});
+  viskores::cont::Algorithm::SortByKey(uniqueBins, counts);
+}
+
+}
+}
+} // namespace viskores::worklet
+
+#endif // viskores_worklet_HashAggregateBins_h
@@ -93,6 +93,19 @@ public:
   VISKORES_CONT
   void SetUseThreadedAlgorithm(bool val) { this->UseThreadedAlgorithm = val; }
 
+  /// @brief Specifies how particles are aggregated and encoded when sent between ranks.
+  VISKORES_CONT void SetParticleExchangeOptions(
+    const viskores::filter::flow::ParticleExchangeOptions& options)
+  {
+    this->ExchangeOptions = options;
+  }
+
+  VISKORES_CONT const viskores::filter::flow::ParticleExchangeOptions& GetParticleExchangeOptions()
+    const
+  {
+    return this->ExchangeOptions;
+  }
+
   VISKORES_DEPRECATED(2.2, "All communication is asynchronous now.")
   VISKORES_CONT
   void SetUseAsynchronousCommunication() {}
@@ -116,6 +129,7 @@ protected:
   bool BlockIdsSet = false;
   std::vector<viskores::Id> BlockIds;
   viskores::filter::flow::internal::BoundsMap BoundsMap;
+  viskores::filter::flow::ParticleExchangeOptions ExchangeOptions;
   viskores::Id NumberOfSteps = 0;
   viskores::cont::UnknownArrayHandle Seeds;
   viskores::filter::flow::IntegrationSolverType SolverType =
@@ -13,6 +13,9 @@
 #include <viskores/filter/flow/FilterParticleAdvection.h>
 #include <viskores/filter/flow/viskores_filter_flow_export.h>
 
+#include <functional>
+#include <vector>
+
 namespace viskores
 {
 namespace filter
@@ -35,6 +38,9 @@ public:
   using TerminationType = typename FlowTraits<Derived>::TerminationType;
   using AnalysisType = typename FlowTraits<Derived>::AnalysisType;
 
+  /// @brief Callback that loads the data for a time step given its index.
+  using TimeStepReaderType = std::function<viskores::cont::PartitionedDataSet(viskores::Id)>;
+
   /// @brief Specifies time value for the input data set.
   ///
   /// This is the data set that passed into the `Execute()` method.
@@ -54,6 +60,35 @@ public:
     this->Input2 = pds;
   }
 
+  /// @brief Advects through many time steps that are loaded on demand.
+  ///
+  /// `times` holds the time value of every step in increasing order. `reader` is called
+  /// with the index of a step to load it. The data set passed into `Execute()` is used as
+  /// step 0 and is not read again, and every step must be partitioned the same way. The
+  /// particles are advected across the whole time range in a single call to `Execute()`.
+  /// When a reader is set, `SetPreviousTime()`, `SetNextTime()`, and `SetNextDataSet()`
+  /// are ignored.
+  VISKORES_CONT void SetTimeStepReader(const std::vector<viskores::FloatDefault>& times,
+                                       const TimeStepReaderType& reader)
+  {
+    this->TimeStepTimes = times;
+    this->TimeStepReader = reader;
+  }
+
+  /// @brief Specifies how many time steps may be held in memory at once.
+  ///
+  /// Two steps are needed to interpolate in time. Any additional slots are used to load
+  /// the following steps ahead of time. The default is 3.
+  VISKORES_CONT void SetNumberOfResidentTimeSteps(viskores::Id num)
+  {
+    this->NumberOfResidentTimeSteps = num;
+  }
+
+  /// @brief Specifies whether upcoming time steps are loaded on a background thread.
+  ///
+  /// On by default. Turn this off if the reader cannot be called from another thread.
+  VISKORES_CONT void SetPrefetchTimeSteps(bool val) { this->PrefetchTimeSteps = val; }
+
 private:
   VISKORES_CONT FieldType GetField(const viskores::cont::DataSet& data) const;
 
@@ -64,9 +99,16 @@ private:
   VISKORES_CONT viskores::cont::PartitionedDataSet DoExecutePartitions(
     const viskores::cont::PartitionedDataSet& input);
 
+  VISKORES_CONT viskores::cont::PartitionedDataSet DoExecuteTimeSteps(
+    const viskores::cont::PartitionedDataSet& input);
+
   viskores::cont::PartitionedDataSet Input2;
   viskores::FloatDefault Time1 = -1;
   viskores::FloatDefault Time2 = -1;
+  TimeStepReaderType TimeStepReader;
+  std::vector<viskores::FloatDefault> TimeStepTimes;
+  viskores::Id NumberOfResidentTimeSteps = 3;
+  bool PrefetchTimeSteps = true;
 };
 
 }
@@ -0,0 +1,129 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/ErrorFilterExecution.h>
+#include <viskores/cont/Invoker.h>
+#include <viskores/filter/flow/FlowMapCache.h>
+#include <viskores/filter/flow/worklet/Field.h>
+#include <viskores/filter/flow/worklet/GridEvaluators.h>
+#include <viskores/worklet/WorkletMapField.h>
+
+namespace viskores
+{
+namespace filter
+{
+namespace flow
+{
+
+namespace
+{
+
+class ApplyDisplacement : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldInOut position, ExecObject evaluator);
+  using ExecutionSignature = void(_1, _2);
+  using InputDomain = _1;
+
+  template <typename EvaluatorType>
+  VISKORES_EXEC void operator()(viskores::Vec3f& position, const EvaluatorType& evaluator) const
+  {
+    viskores::VecVariable<viskores::Vec3f, 2> displacement;
+    auto status = evaluator.Evaluate(position, 0, displacement);
+    if (status.CheckOk() && displacement.GetNumberOfComponents() > 0)
+      position = position + displacement[0];
+  }
+};
+
+} // anonymous namespace
+
+void FlowMapCache::Append(const viskores::cont::DataSet& flowMap, viskores::FloatDefault duration)
+{
+  if (!flowMap.HasPointField(this->DisplacementFieldName))
+    throw viskores::cont::ErrorFilterExecution("Flow map does not have a displacement field.");
+  if (!this->Intervals.empty() &&
+      flowMap.GetNumberOfPoints() != this->Intervals.back().FlowMap.GetNumberOfPoints())
+    throw viskores::cont::ErrorFilterExecution("Flow maps must share the same points.");
+
+  this->Intervals.push_back({ flowMap, duration, this->NextSerial++ });
+}
+
+void FlowMapCache::PopFront()
+{
+  if (!this->Intervals.empty())
+    this->Intervals.pop_front();
+}
+
+const viskores::cont::DataSet& FlowMapCache::GetFlowMap(viskores::Id index) const
+{
+  this->CheckRange(index, 1);
+  return this->Intervals[static_cast<std::size_t>(index)].FlowMap;
+}
+
+viskores::FloatDefault FlowMapCache::GetDuration(viskores::Id first, viskores::Id count) const
+{
+  this->CheckRange(first, count);
+  viskores::FloatDefault duration = 0;
+  for (viskores::Id i = first; i < first + count; i++)
+    duration += this->Intervals[static_cast<std::size_t>(i)].Duration;
+  return duration;
+}
+
+viskores::cont::ArrayHandle<viskores::Vec3f> FlowMapCache::Compose(viskores::Id first,
+                                                                   viskores::Id count)
+{
+  this->CheckRange(first, count);
+
+  using FieldType =
+    viskores::worklet::flow::VelocityField<viskores::cont::ArrayHandle<viskores::Vec3f>>;
+  using EvaluatorType = viskores::worklet::flow::GridEvaluator<FieldType>;
+
+  // Continue from the last composition when it covers a prefix of this one.
+  viskores::cont::ArrayHandle<viskores::Vec3f> positions;
+  viskores::Id applied = 0;
+  const auto firstSerial = this->Intervals[static_cast<std::size_t>(first)].Serial;
+  if (firstSerial == this->LastFirstSerial && this->LastCount <= count)
+  {
+    viskores::cont::ArrayCopy(this->LastPositions, positions);
+    applied = this->LastCount;
+  }
+  else
+  {
+    const auto& flowMap = this->Intervals[static_cast<std::size_t>(first)].FlowMap;
+    viskores::cont::ArrayCopy(flowMap.GetCoordinateSystem().GetData(), positions);
+  }
+
+  viskores::cont::Invoker invoke;
+  for (viskores::Id i = first + applied; i < first + count; i++)
+  {
+    const auto& flowMap = this->Intervals[static_cast<std::size_t>(i)].FlowMap;
+    viskores::cont::ArrayHandle<viskores::Vec3f> displacement;
+    viskores::cont::ArrayCopyShallowIfPossible(
+      flowMap.GetPointField(this->DisplacementFieldName).GetData(), displacement);
+
+    FieldType field(displacement, viskores::cont::Field::Association::Points);
+    EvaluatorType evaluator(flowMap.GetCoordinateSystem(), flowMap.GetCellSet(), field);
+    invoke(ApplyDisplacement{}, positions, evaluator);
+  }
+
+  this->LastFirstSerial = firstSerial;
+  this->LastCount = count;
+  viskores::cont::ArrayCopy(positions, this->LastPositions);
+  return positions;
+}
+
+void FlowMapCache::CheckRange(viskores::Id first, viskores::Id count) const
+{
+  if (first < 0 || count < 1 || first + count > this->GetNumberOfIntervals())
+    throw viskores::cont::ErrorFilterExecution("Flow map interval out of range.");
+}
+
+}
+}
+} // namespace viskores::filter::flow
@@ -0,0 +1,108 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_filter_flow_FlowMapCache_h
+#define viskores_filter_flow_FlowMapCache_h
+
+#include <viskores/cont/DataSet.h>
+#include <viskores/filter/flow/viskores_filter_flow_export.h>
+
+#include <deque>
+#include <string>
+
+namespace viskores
+{
+namespace filter
+{
+namespace flow
+{
+
+/// @brief Composes short-interval flow maps into flow maps over longer intervals.
+///
+/// Each interval is described by a data set whose points are the start positions of
+/// the interval and that has a point field with the displacement of each point over
+/// the interval, such as the basis flows written by `Lagrangian`. The flow map over
+/// several consecutive intervals is found by carrying the points of the first interval
+/// through the displacements of the following ones, so computing the FTLE over a
+/// sliding time window reuses the stored intervals instead of advecting again:
+///
+/// @code{.cpp}
+/// ftle.SetUseFlowMapOutput(true);
+/// ftle.SetFlowMapOutput(cache.Compose(first, count));
+/// ftle.SetAdvectionTime(cache.GetDuration(first, count));
+/// auto result = ftle.Execute(cache.GetFlowMap(first));
+/// @endcode
+///
+/// Points that leave the grid of an interval stay where they left it.
+class VISKORES_FILTER_FLOW_EXPORT FlowMapCache
+{
+public:
+  /// @brief Specifies the name of the displacement field. The default is `displacement`.
+  VISKORES_CONT void SetDisplacementFieldName(const std::string& name)
+  {
+    this->DisplacementFieldName = name;
+  }
+  /// @copydoc SetDisplacementFieldName
+  VISKORES_CONT const std::string& GetDisplacementFieldName() const
+  {
+    return this->DisplacementFieldName;
+  }
+
+  /// @brief Adds the flow map of the interval following the last one added.
+  VISKORES_CONT void Append(const viskores::cont::DataSet& flowMap,
+                            viskores::FloatDefault duration);
+
+  /// @brief Discards the oldest interval.
+  ///
+  /// Intervals are indexed from the oldest one still held, so this shifts every index by one.
+  VISKORES_CONT void PopFront();
+
+  /// @brief Returns the number of intervals held.
+  VISKORES_CONT viskores::Id GetNumberOfIntervals() const
+  {
+    return static_cast<viskores::Id>(this->Intervals.size());
+  }
+
+  /// @brief Returns the data set the flow map of an interval was given with.
+  VISKORES_CONT const viskores::cont::DataSet& GetFlowMap(viskores::Id index) const;
+
+  /// @brief Returns the total duration of `count` intervals starting at `first`.
+  VISKORES_CONT viskores::FloatDefault GetDuration(viskores::Id first, viskores::Id count) const;
+
+  /// @brief Returns where the points of interval `first` end up after `count` intervals.
+  ///
+  /// The result of the last call is kept, so extending the same window by more intervals
+  /// only applies the new ones.
+  VISKORES_CONT viskores::cont::ArrayHandle<viskores::Vec3f> Compose(viskores::Id first,
+                                                                     viskores::Id count);
+
+private:
+  struct Interval
+  {
+    viskores::cont::DataSet FlowMap;
+    viskores::FloatDefault Duration;
+    viskores::Id Serial;
+  };
+
+  VISKORES_CONT void CheckRange(viskores::Id first, viskores::Id count) const;
+
+  std::string DisplacementFieldName = "displacement";
+  std::deque<Interval> Intervals;
+  viskores::Id NextSerial = 0;
+
+  // The last composition, identified by the serial numbers of its intervals.
+  viskores::Id LastFirstSerial = -1;
+  viskores::Id LastCount = 0;
+  viskores::cont::ArrayHandle<viskores::Vec3f> LastPositions;
+};
+
+}
+}
+} // namespace viskores::filter::flow
+
+#endif // viskores_filter_flow_FlowMapCache_h
@@ -9,6 +9,8 @@
 #ifndef viskores_filter_flow_FlowTypes_h
 #define viskores_filter_flow_FlowTypes_h
 
+#include <viskores/Types.h>
+
 namespace viskores
 {
 namespace filter
@@ -34,6 +36,19 @@ enum FlowResultType
   STREAMLINE_TYPE,
 };
 
+/// @brief Controls how particles are sent between MPI ranks during advection.
+///
+/// Particles leaving the blocks of a rank are aggregated per destination rank.
+/// A message is sent once it reaches `MessageSizeThreshold` bytes or when the
+/// rank runs out of local work. Larger thresholds send fewer, larger messages.
+struct ParticleExchangeOptions
+{
+  /// Size in bytes at which an aggregated message is sent to its destination.
+  viskores::Id MessageSizeThreshold = 1 << 20;
+  /// Send `viskores::Particle` positions as 32-bit floats to reduce message size.
+  bool UseFloat32Positions = false;
+};
+
 }
 }
 }
@@ -251,7 +251,10 @@ VISKORES_CONT viskores::cont::DataSet Lagrangian::DoExecute(const viskores::cont
     basisParticlesDisplacement.Allocate(this->SeedRes[0] * this->SeedRes[1] * this->SeedRes[2]);
     DisplacementCalculation displacement;
     this->Invoke(displacement, particles, this->BasisParticlesOriginal, basisParticlesDisplacement);
-    viskores::Vec3f origin(0);
+    // The points of the output are the seed positions the displacements start from.
+    viskores::Vec3f origin(static_cast<viskores::FloatDefault>(bounds.X.Min),
+                           static_cast<viskores::FloatDefault>(bounds.Y.Min),
+                           static_cast<viskores::FloatDefault>(bounds.Z.Min));
     viskores::Vec3f spacing(0);
     if (this->SeedRes[0] > 1)
     {
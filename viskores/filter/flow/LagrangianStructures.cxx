@@ -10,10 +10,13 @@
 #include <viskores/Particle.h>
 #include <viskores/cont/Algorithm.h>
 #include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/ArrayHandleCartesianProduct.h>
+#include <viskores/cont/ArrayHandleUniformPointCoordinates.h>
 #include <viskores/cont/DataSetBuilderUniform.h>
 #include <viskores/cont/ErrorFilterExecution.h>
 #include <viskores/cont/Invoker.h>
 #include <viskores/filter/flow/LagrangianStructures.h>
+#include <viskores/filter/vector_analysis/Gradient.h>
 
 #include <viskores/filter/flow/worklet/Analysis.h>
 #include <viskores/filter/flow/worklet/Field.h>
@@ -98,7 +101,6 @@ VISKORES_CONT viskores::cont::DataSet LagrangianStructures::DoExecute(
   viskores::Id numberOfSteps = this->GetNumberOfSteps();
 
   viskores::cont::CoordinateSystem coordinates = input.GetCoordinateSystem();
-  viskores::cont::UnknownCellSet cellset = input.GetCellSet();
 
   viskores::cont::DataSet lcsInput;
   if (this->GetUseAuxiliaryGrid())
@@ -120,11 +122,6 @@ VISKORES_CONT viskores::cont::DataSet LagrangianStructures::DoExecute(
   }
   else
   {
-    // Check if input dataset is structured.
-    // If not, we cannot proceed.
-    if (!(cellset.IsType<Structured2DType>() || cellset.IsType<Structured3DType>()))
-      throw viskores::cont::ErrorFilterExecution(
-        "Provided data is not structured, provide parameters for an auxiliary grid.");
     lcsInput = input;
   }
   viskores::cont::ArrayHandle<viskores::Vec3f> lcsInputPoints, lcsOutputPoints;
@@ -161,20 +158,47 @@ VISKORES_CONT viskores::cont::DataSet LagrangianStructures::DoExecute(
   viskores::cont::ArrayHandle<viskores::FloatDefault> outputField;
   viskores::FloatDefault advectionTime = this->GetAdvectionTime();
 
+  using AxisHandle = viskores::cont::ArrayHandle<viskores::FloatDefault>;
+  using RectilinearType =
+    viskores::cont::ArrayHandleCartesianProduct<AxisHandle, AxisHandle, AxisHandle>;
+  const auto& lcsCoords = lcsInput.GetCoordinateSystem().GetData();
+  const bool axisAligned = lcsCoords.IsType<viskores::cont::ArrayHandleUniformPointCoordinates>() ||
+    lcsCoords.IsType<RectilinearType>();
+
   viskores::cont::UnknownCellSet lcsCellSet = lcsInput.GetCellSet();
-  if (lcsCellSet.IsType<Structured2DType>())
+  if (axisAligned && lcsCellSet.IsType<Structured2DType>())
   {
     using AnalysisType = viskores::worklet::flow::LagrangianStructures<2>;
     AnalysisType ftleCalculator(advectionTime, lcsCellSet);
     this->Invoke(ftleCalculator, lcsInputPoints, lcsOutputPoints, outputField);
   }
-  else if (lcsCellSet.IsType<Structured3DType>())
+  else if (axisAligned && lcsCellSet.IsType<Structured3DType>())
   {
     using AnalysisType = viskores::worklet::flow::LagrangianStructures<3>;
     AnalysisType ftleCalculator(advectionTime, lcsCellSet);
     this->Invoke(ftleCalculator, lcsInputPoints, lcsOutputPoints, outputField);
   }
-
+  else
+  {
+    // Curvilinear and unstructured grids have no axis aligned neighbors to difference,
+    // so differentiate the flow map over the cells of the mesh instead.
+    viskores::cont::DataSet flowMap;
+    flowMap.CopyStructure(lcsInput);
+    flowMap.AddPointField("FlowMap", lcsOutputPoints);
+
+    viskores::filter::vector_analysis::Gradient gradient;
+    gradient.SetComputePointGradient(true);
+    gradient.SetActiveField("FlowMap");
+    gradient.SetOutputFieldName("FlowMapGradient");
+    viskores::cont::DataSet gradientResult = gradient.Execute(flowMap);
+
+    viskores::cont::ArrayHandle<viskores::Vec<viskores::Vec3f, 3>> flowMapGradient;
+    viskores::cont::ArrayCopyShallowIfPossible(
+      gradientResult.GetPointField("FlowMapGradient").GetData(), flowMapGradient);
+
+    viskores::worklet::flow::LagrangianStructuresFromGradient ftleCalculator(advectionTime);
+    this->Invoke(ftleCalculator, flowMapGradient, outputField);
+  }
 
   auto fieldmapper = [&](viskores::cont::DataSet& dataset, const viskores::cont::Field& field)
   { MapField(dataset, field); };
@@ -26,6 +26,11 @@ namespace flow
 /// The FTLE is computed by advecting particles throughout the vector field and analyzing
 /// where they diverge or converge. By default, the points of the input `viskores::cont::DataSet`
 /// are all advected for this computation unless an auxiliary grid is established.
+/// On uniform and rectilinear grids the flow map is differenced between neighboring
+/// points. On curvilinear and unstructured grids its gradient is computed over the cells.
+///
+/// Precomputed flow maps can be used instead of advection. `FlowMapCache` composes the
+/// short-interval flow maps written by `Lagrangian` into flow maps over longer intervals.
 ///
 class VISKORES_FILTER_FLOW_EXPORT LagrangianStructures : public viskores::filter::Filter
 {
@@ -78,6 +78,15 @@ public:
 
   void SetStepSize(viskores::FloatDefault stepSize) { this->StepSize = stepSize; }
 
+  void SetExchangeOptions(const viskores::filter::flow::ParticleExchangeOptions& options)
+  {
+#ifdef VISKORES_ENABLE_MPI
+    this->Exchanger.SetOptions(options);
+#else
+    (void)options;
+#endif
+  }
+
   void SetSeeds(const viskores::cont::ArrayHandle<ParticleType>& seeds)
   {
     this->ClearParticles();
@@ -123,6 +132,8 @@ public:
 #endif
   }
 
+  virtual bool HaveActiveParticles() { return !this->Active.empty(); }
+
   virtual bool GetDone()
   {
 #ifndef VISKORES_ENABLE_MPI
@@ -250,8 +261,15 @@ public:
       std::vector<ParticleType> incoming;
       std::unordered_map<viskores::Id, std::vector<viskores::Id>> incomingBlockIDs;
 
-      this->Exchanger.Exchange(
-        outgoing, outgoingRanks, this->ParticleBlockIDsMap, incoming, incomingBlockIDs);
+      // Outgoing particles are aggregated by destination while this rank still has
+      // particles to advect. Once it runs dry, flush everything so no rank waits on
+      // a partially filled message.
+      this->Exchanger.Exchange(outgoing,
+                               outgoingRanks,
+                               this->ParticleBlockIDsMap,
+                               incoming,
+                               incomingBlockIDs,
+                               !this->HaveActiveParticles());
 
       //Cleanup what was sent.
       for (const auto& p : outgoing)
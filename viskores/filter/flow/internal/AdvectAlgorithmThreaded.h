@@ -63,6 +63,12 @@ protected:
     return this->AdvectAlgorithm<DSIType>::HaveWork() || this->WorkerActivate;
   }
 
+  bool HaveActiveParticles() override
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    return !this->Active.empty() || this->WorkerActivate;
+  }
+
   virtual bool GetDone() override
   {
     std::lock_guard<std::mutex> lock(this->Mutex);
@@ -11,9 +11,18 @@
 #define viskores_filter_flow_internal_DataSetIntegratorUnsteadyState_h
 
 #include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/ArrayHandleConstant.h>
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/CellSetExplicit.h>
+#include <viskores/cont/ConvertNumComponentsToOffsets.h>
 #include <viskores/filter/flow/internal/DataSetIntegrator.h>
+#include <viskores/filter/flow/worklet/Analysis.h>
 #include <viskores/filter/flow/worklet/TemporalGridEvaluators.h>
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 namespace viskores
 {
 namespace filter
@@ -81,6 +90,84 @@ public:
       throw viskores::cont::ErrorFilterExecution("Unsupported Integrator type");
   }
 };
+
+// Without streamlines, the results of the time windows are simply appended.
+template <typename AnalysisType>
+bool MakeWindowedDataSet(viskores::cont::DataSet& ds, const std::vector<AnalysisType>& results)
+{
+  return AnalysisType::MakeDataSet(ds, results);
+}
+
+// A particle carried into the next time window starts a new streamline where its streamline
+// of the previous window ended. These pieces are joined into one polyline per particle, and
+// the point repeated at each seam is dropped.
+template <typename ParticleType>
+bool MakeWindowedDataSet(
+  viskores::cont::DataSet& ds,
+  const std::vector<viskores::worklet::flow::StreamlineAnalysis<ParticleType>>& results)
+{
+  std::vector<std::vector<viskores::Vec3f>> lines;
+  std::unordered_map<viskores::Id, std::size_t> lastLine;
+  for (const auto& res : results)
+  {
+    auto particles = res.Particles.ReadPortal();
+    auto points = res.Streams.ReadPortal();
+    const auto& polyLines = res.PolyLines;
+    for (viskores::Id cell = 0; cell < polyLines.GetNumberOfCells(); cell++)
+    {
+      viskores::IdComponent numPoints = polyLines.GetNumberOfPointsInCell(cell);
+      if (numPoints == 0)
+        continue;
+      std::vector<viskores::Id> ids(static_cast<std::size_t>(numPoints));
+      polyLines.GetCellPointIds(cell, ids.data());
+
+      viskores::Id particleId = particles.Get(cell).GetID();
+      auto last = lastLine.find(particleId);
+      viskores::IdComponent first = 0;
+      if (last != lastLine.end() && lines[last->second].back() == points.Get(ids[0]))
+      {
+        first = 1;
+      }
+      else
+      {
+        lastLine[particleId] = lines.size();
+        lines.emplace_back();
+      }
+      auto& line = lines[lastLine[particleId]];
+      for (viskores::IdComponent i = first; i < numPoints; i++)
+        line.push_back(points.Get(ids[static_cast<std::size_t>(i)]));
+    }
+  }
+  if (lines.empty())
+    return false;
+
+  std::vector<viskores::Vec3f> allPoints;
+  std::vector<viskores::IdComponent> numPointsPerLine;
+  for (const auto& line : lines)
+  {
+    allPoints.insert(allPoints.end(), line.begin(), line.end());
+    numPointsPerLine.push_back(static_cast<viskores::IdComponent>(line.size()));
+  }
+  viskores::Id numPoints = static_cast<viskores::Id>(allPoints.size());
+  viskores::Id numLines = static_cast<viskores::Id>(lines.size());
+
+  viskores::cont::ArrayHandle<viskores::Id> connectivity;
+  viskores::cont::ArrayCopy(viskores::cont::ArrayHandleIndex(numPoints), connectivity);
+  viskores::cont::ArrayHandle<viskores::UInt8> cellTypes;
+  viskores::cont::ArrayCopy(
+    viskores::cont::make_ArrayHandleConstant<viskores::UInt8>(viskores::CELL_SHAPE_POLY_LINE,
+                                                              numLines),
+    cellTypes);
+  auto offsets = viskores::cont::ConvertNumComponentsToOffsets(
+    viskores::cont::make_ArrayHandle(numPointsPerLine, viskores::CopyFlag::Off));
+
+  viskores::cont::CellSetExplicit<> polyLines;
+  polyLines.Fill(numPoints, cellTypes, connectivity, offsets);
+  ds.AddCoordinateSystem(viskores::cont::CoordinateSystem(
+    "coordinates", viskores::cont::make_ArrayHandleMove(std::move(allPoints))));
+  ds.SetCellSet(polyLines);
+  return true;
+}
 } //namespace detail
 
 template <typename ParticleType,
@@ -149,13 +236,59 @@ public:
     this->UpdateResult(analysis, block);
   }
 
+  /// @brief Replaces the pair of time steps this block advects through.
+  ///
+  /// When `holdAtTemporalBoundary` is set, particles that run past the end of the window
+  /// are kept for the next window (see `TakeHeldParticles()`) instead of terminating.
+  VISKORES_CONT void SetTimeWindow(const FieldType& field1,
+                                   const FieldType& field2,
+                                   const viskores::cont::DataSet& ds1,
+                                   const viskores::cont::DataSet& ds2,
+                                   viskores::FloatDefault t1,
+                                   viskores::FloatDefault t2,
+                                   bool holdAtTemporalBoundary)
+  {
+    this->Field1 = field1;
+    this->Field2 = field2;
+    this->DataSet1 = ds1;
+    this->DataSet2 = ds2;
+    this->Time1 = t1;
+    this->Time2 = t2;
+    this->HoldAtTemporalBoundary = holdAtTemporalBoundary;
+    // The output joins the pieces of each particle by its id, so the results must keep
+    // their own copy of the particles.
+    this->UsedTimeWindows = true;
+    this->CopySeedArray = true;
+  }
+
+  /// @brief Returns and clears the particles held at the end of the current time window.
+  VISKORES_CONT std::vector<ParticleType> TakeHeldParticles()
+  {
+    std::vector<ParticleType> held;
+    std::swap(held, this->Held);
+    return held;
+  }
+
   VISKORES_CONT void UpdateResult(
     AnalysisType& analysis,
     viskores::filter::flow::internal::DSIHelperInfo<ParticleType>& dsiInfo)
   {
+    std::vector<bool> isHeld;
+    if (this->HoldAtTemporalBoundary)
+      this->HoldParticles(analysis.Particles, isHeld);
+
     this->ClassifyParticles(analysis.Particles, dsiInfo);
     if (std::is_same<AnalysisType, viskores::worklet::flow::NoAnalysis<ParticleType>>::value)
     {
+      // Held particles are not done yet, so they are not part of the output.
+      if (!isHeld.empty())
+      {
+        auto last = std::remove_if(dsiInfo.TermIdx.begin(),
+                                   dsiInfo.TermIdx.end(),
+                                   [&isHeld](viskores::Id idx)
+                                   { return isHeld[static_cast<std::size_t>(idx)]; });
+        dsiInfo.TermIdx.erase(last, dsiInfo.TermIdx.end());
+      }
       if (dsiInfo.TermIdx.empty())
         return;
       auto indicesAH = viskores::cont::make_ArrayHandle(dsiInfo.TermIdx, viskores::CopyFlag::Off);
@@ -176,10 +309,38 @@ public:
     std::size_t nAnalyses = this->Analyses.size();
     if (nAnalyses == 0)
       return false;
+    if (this->UsedTimeWindows)
+      return detail::MakeWindowedDataSet(ds, this->Analyses);
     return AnalysisType::MakeDataSet(ds, this->Analyses);
   }
 
 private:
+  // Particles that stopped only because they reached the end of the time window are
+  // set aside and marked terminated so that the advection of this window can finish.
+  VISKORES_CONT void HoldParticles(viskores::cont::ArrayHandle<ParticleType>& particles,
+                                   std::vector<bool>& isHeld)
+  {
+    auto portal = particles.WritePortal();
+    viskores::Id n = portal.GetNumberOfValues();
+    isHeld.assign(static_cast<std::size_t>(n), false);
+    for (viskores::Id i = 0; i < n; i++)
+    {
+      auto p = portal.Get(i);
+      const auto& status = p.GetStatus();
+      if (status.CheckTemporalBounds() && !status.CheckTerminate() &&
+          !status.CheckSpatialBounds())
+      {
+        auto next = p;
+        next.GetStatus() = viskores::ParticleStatus();
+        this->Held.emplace_back(next);
+
+        p.GetStatus().SetTerminate();
+        portal.Set(i, p);
+        isHeld[static_cast<std::size_t>(i)] = true;
+      }
+    }
+  }
+
   FieldType Field1;
   FieldType Field2;
   viskores::cont::DataSet DataSet1;
@@ -189,6 +350,9 @@ private:
   TerminationType Termination;
   AnalysisType Analysis;
   std::vector<AnalysisType> Analyses;
+  bool HoldAtTemporalBoundary = false;
+  bool UsedTimeWindows = false;
+  std::vector<ParticleType> Held;
 };
 
 }
@@ -80,7 +80,7 @@ FilterParticleAdvectionSteadyState<Derived>::DoExecutePartitions(
   }
 
   viskores::filter::flow::internal::ParticleAdvector<DSIType> pav(
-    this->BoundsMap, dsi, this->UseThreadedAlgorithm);
+    this->BoundsMap, dsi, this->UseThreadedAlgorithm, this->ExchangeOptions);
 
   viskores::cont::ArrayHandle<ParticleType> particles;
   this->Seeds.AsArrayHandle(particles);
@@ -12,6 +12,7 @@
 #include <viskores/filter/flow/internal/BoundsMap.h>
 #include <viskores/filter/flow/internal/DataSetIntegratorUnsteadyState.h>
 #include <viskores/filter/flow/internal/ParticleAdvector.h>
+#include <viskores/filter/flow/internal/TimeStepCache.h>
 
 namespace viskores
 {
@@ -53,6 +54,9 @@ FilterParticleAdvectionUnsteadyState<Derived>::DoExecutePartitions(
 {
   this->ValidateOptions();
 
+  if (this->TimeStepReader)
+    return this->DoExecuteTimeSteps(input);
+
   using DSIType = viskores::filter::flow::internal::
     DataSetIntegratorUnsteadyState<ParticleType, FieldType, TerminationType, AnalysisType>;
 
@@ -89,13 +93,78 @@ FilterParticleAdvectionUnsteadyState<Derived>::DoExecutePartitions(
                      analysis);
   }
   viskores::filter::flow::internal::ParticleAdvector<DSIType> pav(
-    this->BoundsMap, dsi, this->UseThreadedAlgorithm);
+    this->BoundsMap, dsi, this->UseThreadedAlgorithm, this->ExchangeOptions);
 
   viskores::cont::ArrayHandle<ParticleType> particles;
   this->Seeds.AsArrayHandle(particles);
   return pav.Execute(particles, this->StepSize);
 }
 
+template <typename Derived>
+VISKORES_CONT viskores::cont::PartitionedDataSet
+FilterParticleAdvectionUnsteadyState<Derived>::DoExecuteTimeSteps(
+  const viskores::cont::PartitionedDataSet& input)
+{
+  using DSIType = viskores::filter::flow::internal::
+    DataSetIntegratorUnsteadyState<ParticleType, FieldType, TerminationType, AnalysisType>;
+
+  viskores::filter::flow::internal::TimeStepCache cache(this->TimeStepReader,
+                                                        this->TimeStepTimes,
+                                                        this->NumberOfResidentTimeSteps,
+                                                        this->PrefetchTimeSteps);
+  cache.Insert(0, input);
+
+  if (this->BlockIdsSet)
+    this->BoundsMap = viskores::filter::flow::internal::BoundsMap(input, this->BlockIds);
+  else
+    this->BoundsMap = viskores::filter::flow::internal::BoundsMap(input);
+
+  // The fields and times of each block are filled in one window at a time.
+  std::vector<DSIType> dsi;
+  for (viskores::Id i = 0; i < input.GetNumberOfPartitions(); i++)
+  {
+    viskores::Id blockId = this->BoundsMap.GetLocalBlockId(i);
+    auto ds = input.GetPartition(i);
+    FieldType field = this->GetField(ds);
+    TerminationType termination = this->GetTermination(ds);
+    AnalysisType analysis = this->GetAnalysis(ds);
+    dsi.emplace_back(
+      blockId, field, field, ds, ds, 0, 0, this->SolverType, termination, analysis);
+  }
+
+  const viskores::Id numWindows = cache.GetNumberOfTimeSteps() - 1;
+  auto setWindow = [&](viskores::Id window, std::vector<DSIType>& blocks)
+  {
+    auto data1 = cache.Get(window);
+    auto data2 = cache.Get(window + 1);
+    if (data1.GetNumberOfPartitions() != input.GetNumberOfPartitions() ||
+        data2.GetNumberOfPartitions() != input.GetNumberOfPartitions())
+      throw viskores::cont::ErrorFilterExecution(
+        "Time steps must have the same partitions as the input.");
+
+    const bool lastWindow = (window + 1 == numWindows);
+    for (std::size_t i = 0; i < blocks.size(); i++)
+    {
+      auto ds1 = data1.GetPartition(static_cast<viskores::Id>(i));
+      auto ds2 = data2.GetPartition(static_cast<viskores::Id>(i));
+      blocks[i].SetTimeWindow(this->GetField(ds1),
+                              this->GetField(ds2),
+                              ds1,
+                              ds2,
+                              cache.GetTime(window),
+                              cache.GetTime(window + 1),
+                              !lastWindow);
+    }
+  };
+
+  viskores::filter::flow::internal::ParticleAdvector<DSIType> pav(
+    this->BoundsMap, dsi, this->UseThreadedAlgorithm, this->ExchangeOptions);
+
+  viskores::cont::ArrayHandle<ParticleType> particles;
+  this->Seeds.AsArrayHandle(particles);
+  return pav.ExecuteTimeWindows(particles, this->StepSize, numWindows, setWindow);
+}
+
 }
 }
 } // namespace viskores::filter::flow
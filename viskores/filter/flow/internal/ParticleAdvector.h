@@ -15,6 +15,8 @@
 #include <viskores/filter/flow/internal/BoundsMap.h>
 #include <viskores/filter/flow/internal/DataSetIntegrator.h>
 
+#include <functional>
+
 namespace viskores
 {
 namespace filter
@@ -32,9 +34,12 @@ public:
 
   ParticleAdvector(const viskores::filter::flow::internal::BoundsMap& bm,
                    const std::vector<DSIType>& blocks,
-                   const bool& useThreaded)
+                   const bool& useThreaded,
+                   const viskores::filter::flow::ParticleExchangeOptions& exchangeOptions =
+                     viskores::filter::flow::ParticleExchangeOptions{})
     : Blocks(blocks)
     , BoundsMap(bm)
+    , ExchangeOptions(exchangeOptions)
     , UseThreadedAlgorithm(useThreaded)
   {
   }
@@ -59,18 +64,102 @@ public:
     }
   }
 
+  /// Advects the seeds through a sequence of time windows in one pass.
+  ///
+  /// `setWindow(i, blocks)` prepares the blocks for window `i`. Particles that reach the
+  /// end of a window are held by their block and carried into the next window, so the
+  /// blocks must provide `TakeHeldParticles()`. The blocks keep their results across
+  /// windows and the combined output is returned.
+  viskores::cont::PartitionedDataSet ExecuteTimeWindows(
+    const viskores::cont::ArrayHandle<ParticleType>& seeds,
+    viskores::FloatDefault stepSize,
+    viskores::Id numWindows,
+    const std::function<void(viskores::Id, std::vector<DSIType>&)>& setWindow)
+  {
+    if (!this->UseThreadedAlgorithm)
+    {
+      using AlgorithmType = viskores::filter::flow::internal::AdvectAlgorithm<DSIType>;
+      return this->RunTimeWindows<AlgorithmType>(seeds, stepSize, numWindows, setWindow);
+    }
+    else
+    {
+      // AdvectAlgorithmThreaded is disabled for the same reason as in Execute.
+      VISKORES_LOG_S(viskores::cont::LogLevel::Info,
+                     "Threaded flow management currently disabled.");
+      using AlgorithmType = viskores::filter::flow::internal::AdvectAlgorithm<DSIType>;
+      return this->RunTimeWindows<AlgorithmType>(seeds, stepSize, numWindows, setWindow);
+    }
+  }
+
 private:
   template <typename AlgorithmType>
   viskores::cont::PartitionedDataSet RunAlgo(const viskores::cont::ArrayHandle<ParticleType>& seeds,
                                              viskores::FloatDefault stepSize)
   {
     AlgorithmType algo(this->BoundsMap, this->Blocks);
+    algo.SetExchangeOptions(this->ExchangeOptions);
     algo.Execute(seeds, stepSize);
     return algo.GetOutput();
   }
 
+  template <typename AlgorithmType>
+  viskores::cont::PartitionedDataSet RunTimeWindows(
+    const viskores::cont::ArrayHandle<ParticleType>& seeds,
+    viskores::FloatDefault stepSize,
+    viskores::Id numWindows,
+    const std::function<void(viskores::Id, std::vector<DSIType>&)>& setWindow)
+  {
+    auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+    std::vector<DSIType> blocks = this->Blocks;
+    std::vector<ParticleType> carried;
+    std::vector<std::vector<viskores::Id>> carriedBlockIds;
+
+    for (viskores::Id window = 0; window < numWindows; window++)
+    {
+      setWindow(window, blocks);
+
+      AlgorithmType algo(this->BoundsMap, blocks);
+      algo.SetExchangeOptions(this->ExchangeOptions);
+      algo.SetStepSize(stepSize);
+      if (window == 0)
+        algo.SetSeeds(seeds);
+      else
+        algo.SetSeedArray(carried, carriedBlockIds);
+      algo.Go();
+      blocks = std::move(algo.Blocks);
+
+      // Particles continue on the block (and rank) where the window ended for them.
+      carried.clear();
+      carriedBlockIds.clear();
+      for (auto& block : blocks)
+      {
+        for (auto& p : block.TakeHeldParticles())
+        {
+          carried.emplace_back(p);
+          carriedBlockIds.push_back({ block.GetID() });
+        }
+      }
+
+      viskores::Id numCarried = static_cast<viskores::Id>(carried.size());
+      viskores::Id totalNumCarried = 0;
+      viskoresdiy::mpi::all_reduce(comm, numCarried, totalNumCarried, std::plus<viskores::Id>{});
+      if (totalNumCarried == 0)
+        break;
+    }
+
+    viskores::cont::PartitionedDataSet output;
+    for (const auto& b : blocks)
+    {
+      viskores::cont::DataSet ds;
+      if (b.GetOutput(ds))
+        output.AppendPartition(ds);
+    }
+    return output;
+  }
+
   std::vector<DSIType> Blocks;
   viskores::filter::flow::internal::BoundsMap BoundsMap;
+  viskores::filter::flow::ParticleExchangeOptions ExchangeOptions;
   bool UseThreadedAlgorithm;
 };
 
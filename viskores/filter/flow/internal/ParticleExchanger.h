@@ -10,6 +10,20 @@
 #ifndef viskores_filter_flow_internal_ParticleExchanger_h
 #define viskores_filter_flow_internal_ParticleExchanger_h
 
+#include <viskores/Particle.h>
+#include <viskores/cont/ErrorFilterExecution.h>
+#include <viskores/cont/Logging.h>
+#include <viskores/filter/flow/FlowTypes.h>
+
+#include <viskores/thirdparty/diy/diy.h>
+#ifdef VISKORES_ENABLE_MPI
+#include <viskores/thirdparty/diy/mpi-cast.h>
+#endif
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace viskores
 {
 namespace filter
@@ -19,6 +33,178 @@ namespace flow
 namespace internal
 {
 
+inline void SaveParticleBlockIds(viskoresdiy::BinaryBuffer& bb,
+                                 const std::vector<viskores::Id>& blockIds)
+{
+  viskoresdiy::save(bb, static_cast<viskores::UInt32>(blockIds.size()));
+  if (!blockIds.empty())
+    bb.save_binary(reinterpret_cast<const char*>(blockIds.data()),
+                   blockIds.size() * sizeof(viskores::Id));
+}
+
+inline void LoadParticleBlockIds(viskoresdiy::BinaryBuffer& bb,
+                                 std::vector<viskores::Id>& blockIds)
+{
+  viskores::UInt32 numBlockIds = 0;
+  viskoresdiy::load(bb, numBlockIds);
+  blockIds.resize(numBlockIds);
+  if (numBlockIds > 0)
+    bb.load_binary(reinterpret_cast<char*>(blockIds.data()),
+                   blockIds.size() * sizeof(viskores::Id));
+}
+
+/// Encodes a particle and its candidate block ids for transfer between ranks.
+///
+/// The generic codec uses the full DIY serialization of the particle type. Particle
+/// types that only need a subset of their state to continue advecting on another rank
+/// specialize this codec to send a compact record instead.
+template <typename ParticleType>
+struct ParticleExchangeCodec
+{
+  static void Save(viskoresdiy::BinaryBuffer& bb,
+                   const ParticleType& p,
+                   const std::vector<viskores::Id>& blockIds,
+                   bool viskoresNotUsed(float32Positions))
+  {
+    viskoresdiy::save(bb, p);
+    SaveParticleBlockIds(bb, blockIds);
+  }
+
+  static void Load(viskoresdiy::BinaryBuffer& bb,
+                   ParticleType& p,
+                   std::vector<viskores::Id>& blockIds,
+                   bool viskoresNotUsed(float32Positions))
+  {
+    viskoresdiy::load(bb, p);
+    LoadParticleBlockIds(bb, blockIds);
+  }
+};
+
+/// A `viskores::Particle` only needs its position, time, id and step count to continue
+/// on another rank. The status is always reset before a particle leaves a block, so it
+/// is not sent. Positions can optionally be narrowed to 32-bit floats.
+template <>
+struct ParticleExchangeCodec<viskores::Particle>
+{
+  static void Save(viskoresdiy::BinaryBuffer& bb,
+                   const viskores::Particle& p,
+                   const std::vector<viskores::Id>& blockIds,
+                   bool float32Positions)
+  {
+    if (float32Positions)
+      viskoresdiy::save(bb, static_cast<viskores::Vec3f_32>(p.GetPosition()));
+    else
+      viskoresdiy::save(bb, p.GetPosition());
+    viskoresdiy::save(bb, p.GetTime());
+    viskoresdiy::save(bb, p.GetID());
+    viskoresdiy::save(bb, p.GetNumberOfSteps());
+    SaveParticleBlockIds(bb, blockIds);
+  }
+
+  static void Load(viskoresdiy::BinaryBuffer& bb,
+                   viskores::Particle& p,
+                   std::vector<viskores::Id>& blockIds,
+                   bool float32Positions)
+  {
+    if (float32Positions)
+    {
+      viskores::Vec3f_32 pos;
+      viskoresdiy::load(bb, pos);
+      p.SetPosition(static_cast<viskores::Vec3f>(pos));
+    }
+    else
+    {
+      viskores::Vec3f pos;
+      viskoresdiy::load(bb, pos);
+      p.SetPosition(pos);
+    }
+
+    viskores::FloatDefault time;
+    viskoresdiy::load(bb, time);
+    p.SetTime(time);
+
+    viskores::Id id;
+    viskoresdiy::load(bb, id);
+    p.SetID(id);
+
+    viskores::Id numSteps;
+    viskoresdiy::load(bb, numSteps);
+    p.SetNumberOfSteps(numSteps);
+
+    p.SetStatus(viskores::ParticleStatus());
+    LoadParticleBlockIds(bb, blockIds);
+  }
+};
+
+/// A batch of particles headed to (or received from) a single rank.
+///
+/// The message starts with a small header (the encoding flags and the number of
+/// particles) followed by the encoded particles.
+template <typename ParticleType>
+class ParticleMessage
+{
+public:
+  using Codec = ParticleExchangeCodec<ParticleType>;
+
+  explicit ParticleMessage(bool float32Positions = false)
+    : Float32Positions(float32Positions)
+  {
+  }
+
+  void Add(const ParticleType& p, const std::vector<viskores::Id>& blockIds)
+  {
+    Codec::Save(this->Body, p, blockIds, this->Float32Positions);
+    this->NumberOfParticles++;
+  }
+
+  viskores::Id GetNumberOfParticles() const { return this->NumberOfParticles; }
+  std::size_t GetSize() const { return this->Body.size(); }
+  bool Empty() const { return this->NumberOfParticles == 0; }
+
+  /// Write the header and the particles into a single contiguous buffer.
+  void Pack(viskoresdiy::MemoryBuffer& bb) const
+  {
+    viskoresdiy::save(bb, static_cast<viskores::UInt8>(this->Float32Positions ? 1 : 0));
+    viskoresdiy::save(bb, this->NumberOfParticles);
+    bb.save_binary(this->Body.buffer.data(), this->Body.size());
+    bb.reset();
+  }
+
+  /// Decode a buffer created by `Pack` and append its contents.
+  static void Unpack(viskoresdiy::MemoryBuffer& bb,
+                     std::vector<ParticleType>& particles,
+                     std::unordered_map<viskores::Id, std::vector<viskores::Id>>& blockIdsMap)
+  {
+    viskores::UInt8 flags = 0;
+    viskores::Id numParticles = 0;
+    viskoresdiy::load(bb, flags);
+    viskoresdiy::load(bb, numParticles);
+    const bool float32Positions = (flags & 1) != 0;
+
+    particles.reserve(particles.size() + static_cast<std::size_t>(numParticles));
+    for (viskores::Id i = 0; i < numParticles; i++)
+    {
+      ParticleType p;
+      std::vector<viskores::Id> blockIds;
+      Codec::Load(bb, p, blockIds, float32Positions);
+      blockIdsMap[p.GetID()] = std::move(blockIds);
+      particles.emplace_back(p);
+    }
+  }
+
+private:
+  viskoresdiy::MemoryBuffer Body;
+  bool Float32Positions;
+  viskores::Id NumberOfParticles = 0;
+};
+
+/// Sends particles that leave the blocks owned by this rank to the ranks that own
+/// their next block.
+///
+/// Outgoing particles are encoded as they arrive and aggregated per destination rank.
+/// A destination's message is posted with a nonblocking send once it reaches the size
+/// threshold, or when the caller asks for a flush because it has no local work left to
+/// overlap the communication with. Incoming messages are drained without blocking.
 template <typename ParticleType>
 class ParticleExchanger
 {
@@ -37,13 +223,32 @@ public:
   ~ParticleExchanger() {} //{ this->CleanupSendBuffers(false); }
 #endif
 
-  bool HaveWork() const { return !this->SendBuffers.empty(); }
+  void SetOptions(const viskores::filter::flow::ParticleExchangeOptions& options)
+  {
+    this->Options = options;
+  }
+  const viskores::filter::flow::ParticleExchangeOptions& GetOptions() const
+  {
+    return this->Options;
+  }
+
+  bool HaveWork() const
+  {
+#ifdef VISKORES_ENABLE_MPI
+    return !this->SendBuffers.empty() || !this->PendingSends.empty();
+#else
+    return false;
+#endif
+  }
 
+  /// Queue `outData` for their destinations and collect any particles that arrived.
+  /// When `flush` is true, every partially filled message is sent immediately.
   void Exchange(const std::vector<ParticleType>& outData,
                 const std::vector<viskores::Id>& outRanks,
                 const std::unordered_map<viskores::Id, std::vector<viskores::Id>>& outBlockIDsMap,
                 std::vector<ParticleType>& inData,
-                std::unordered_map<viskores::Id, std::vector<viskores::Id>>& inDataBlockIDsMap)
+                std::unordered_map<viskores::Id, std::vector<viskores::Id>>& inDataBlockIDsMap,
+                bool flush = true)
   {
     VISKORES_ASSERT(outData.size() == outRanks.size());
 
@@ -53,9 +258,12 @@ public:
     else
     {
       this->CleanupSendBuffers(true);
-      this->SendParticles(outData, outRanks, outBlockIDsMap);
+      this->QueueParticles(outData, outRanks, outBlockIDsMap);
+      this->SendPending(flush);
       this->RecvParticles(inData, inDataBlockIDsMap);
     }
+#else
+    (void)flush;
 #endif
   }
 
@@ -75,9 +283,9 @@ private:
     }
   }
 
-#ifdef VISKORES_ENABLE_MPI
-  using ParticleCommType = std::pair<ParticleType, std::vector<viskores::Id>>;
+  viskores::filter::flow::ParticleExchangeOptions Options;
 
+#ifdef VISKORES_ENABLE_MPI
   void CleanupSendBuffers(bool checkRequests)
   {
     if (!checkRequests)
@@ -129,43 +337,52 @@ private:
     }
   }
 
-  void SendParticles(
+  void QueueParticles(
     const std::vector<ParticleType>& outData,
     const std::vector<viskores::Id>& outRanks,
     const std::unordered_map<viskores::Id, std::vector<viskores::Id>>& outBlockIDsMap)
   {
-    if (outData.empty())
-      return;
-
-    //create the send data: vector of particles, vector of vector of blockIds.
     std::size_t n = outData.size();
-    std::unordered_map<int, std::vector<ParticleCommType>> sendData;
-
-    // dst, vector of pair(particles, blockIds)
     for (std::size_t i = 0; i < n; i++)
     {
+      int dst = static_cast<int>(outRanks[i]);
+      if (dst == this->Rank)
+      {
+        VISKORES_LOG_S(viskores::cont::LogLevel::Error, "Error. Sending a particle to yourself.");
+        continue;
+      }
+
       const auto& bids = outBlockIDsMap.find(outData[i].GetID())->second;
-      //sendData[outRanks[i]].emplace_back(std::make_pair(std::move(outData[i]), std::move(bids)));
-      sendData[outRanks[i]].emplace_back(std::make_pair(outData[i], bids));
+      auto it = this->PendingSends.find(dst);
+      if (it == this->PendingSends.end())
+        it = this->PendingSends
+               .emplace(dst, ParticleMessage<ParticleType>(this->Options.UseFloat32Positions))
+               .first;
+      it->second.Add(outData[i], bids);
+
+      //Post the message as soon as it is large enough.
+      if (static_cast<viskores::Id>(it->second.GetSize()) >= this->Options.MessageSizeThreshold)
+      {
+        this->SendMessage(dst, it->second);
+        this->PendingSends.erase(it);
+      }
     }
-
-    //Send to dst, vector<pair<particle, bids>>
-    for (auto& si : sendData)
-      this->SendParticlesToDst(si.first, si.second);
   }
 
-  void SendParticlesToDst(int dst, const std::vector<ParticleCommType>& data)
+  void SendPending(bool flush)
   {
-    if (dst == this->Rank)
-    {
-      VISKORES_LOG_S(viskores::cont::LogLevel::Error, "Error. Sending a particle to yourself.");
+    if (!flush)
       return;
-    }
 
-    //Serialize vector(pair(particle, bids)) and send.
+    for (auto& entry : this->PendingSends)
+      this->SendMessage(entry.first, entry.second);
+    this->PendingSends.clear();
+  }
+
+  void SendMessage(int dst, const ParticleMessage<ParticleType>& msg)
+  {
     viskoresdiy::MemoryBuffer* bb = new viskoresdiy::MemoryBuffer();
-    viskoresdiy::save(*bb, data);
-    bb->reset();
+    msg.Pack(*bb);
 
     MPI_Request req;
     int err =
@@ -182,8 +399,6 @@ private:
     inData.resize(0);
     inDataBlockIDsMap.clear();
 
-    std::vector<viskoresdiy::MemoryBuffer> buffers;
-
     MPI_Status status;
     while (true)
     {
@@ -196,18 +411,18 @@ private:
       if (flag == 0) //no message arrived we are done.
         break;
 
-      //Otherwise, recv the incoming data
+      //Otherwise, recv the incoming data directly into the decode buffer.
       int incomingSize;
       err = MPI_Get_count(&status, MPI_BYTE, &incomingSize);
       if (err != MPI_SUCCESS)
         throw viskores::cont::ErrorFilterExecution(
           "Error in MPI_Probe in ParticleExchanger::RecvParticles");
 
-      std::vector<char> recvBuff;
-      recvBuff.resize(incomingSize);
+      viskoresdiy::MemoryBuffer memBuff;
+      memBuff.buffer.resize(static_cast<std::size_t>(incomingSize));
       MPI_Status recvStatus;
 
-      err = MPI_Recv(recvBuff.data(),
+      err = MPI_Recv(memBuff.buffer.data(),
                      incomingSize,
                      MPI_BYTE,
                      status.MPI_SOURCE,
@@ -219,20 +434,8 @@ private:
           "Error in MPI_Probe in ParticleExchanger::RecvParticles");
 
       //Add incoming data to inData and inDataBlockIds.
-      viskoresdiy::MemoryBuffer memBuff;
-      memBuff.save_binary(recvBuff.data(), incomingSize);
-      memBuff.reset();
-
-      std::vector<ParticleCommType> data;
-      viskoresdiy::load(memBuff, data);
       memBuff.reset();
-      for (const auto& d : data)
-      {
-        const auto& particle = d.first;
-        const auto& bids = d.second;
-        inDataBlockIDsMap[particle.GetID()] = bids;
-        inData.emplace_back(particle);
-      }
+      ParticleMessage<ParticleType>::Unpack(memBuff, inData, inDataBlockIDsMap);
 
       //Note, we don't terminate the while loop here. We want to go back and
       //check if any messages came in while buffers were being processed.
@@ -243,6 +446,7 @@ private:
   viskores::Id NumRanks;
   viskores::Id Rank;
   std::unordered_map<MPI_Request, viskoresdiy::MemoryBuffer*> SendBuffers;
+  std::unordered_map<int, ParticleMessage<ParticleType>> PendingSends;
   int Tag = 100;
 #else
   viskores::Id NumRanks = 1;
@@ -0,0 +1,177 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_filter_flow_internal_TimeStepCache_h
+#define viskores_filter_flow_internal_TimeStepCache_h
+
+#include <viskores/cont/ErrorFilterExecution.h>
+#include <viskores/cont/Logging.h>
+#include <viskores/cont/PartitionedDataSet.h>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace viskores
+{
+namespace filter
+{
+namespace flow
+{
+namespace internal
+{
+
+/// A sliding window over the time steps of an unsteady flow field.
+///
+/// Time steps are loaded on demand through a reader callback. Unsteady advection only
+/// moves forward in time, so requesting step `i` releases every step before `i - 1`.
+/// At most `numResident` steps are held in memory or in flight at once. When
+/// prefetching is enabled, the free slots are used to load the following steps on a
+/// background thread while the current window is advected.
+class TimeStepCache
+{
+public:
+  using ReaderType = std::function<viskores::cont::PartitionedDataSet(viskores::Id)>;
+
+  TimeStepCache(const ReaderType& reader,
+                const std::vector<viskores::FloatDefault>& times,
+                viskores::Id numResident,
+                bool prefetch)
+    : Reader(reader)
+    , Times(times)
+    , NumberOfResident(numResident)
+    , Prefetch(prefetch)
+  {
+    if (!this->Reader)
+      throw viskores::cont::ErrorFilterExecution("No time step reader provided.");
+    if (this->Times.size() < 2)
+      throw viskores::cont::ErrorFilterExecution("At least two time steps are required.");
+    for (std::size_t i = 1; i < this->Times.size(); i++)
+      if (!(this->Times[i - 1] < this->Times[i]))
+        throw viskores::cont::ErrorFilterExecution("Time step values must be increasing.");
+    if (this->NumberOfResident < 2)
+      throw viskores::cont::ErrorFilterExecution("At least two time steps must be resident.");
+  }
+
+  ~TimeStepCache()
+  {
+    // Do not leave a background read touching the reader after we are gone.
+    for (auto& it : this->Pending)
+      if (it.second.valid())
+        it.second.wait();
+  }
+
+  TimeStepCache(const TimeStepCache&) = delete;
+  TimeStepCache& operator=(const TimeStepCache&) = delete;
+
+  viskores::Id GetNumberOfTimeSteps() const
+  {
+    return static_cast<viskores::Id>(this->Times.size());
+  }
+
+  viskores::FloatDefault GetTime(viskores::Id step) const
+  {
+    return this->Times[static_cast<std::size_t>(step)];
+  }
+
+  /// Number of times the reader has been called. Steps added with `Insert()` are not counted.
+  viskores::Id GetNumberOfReads() const { return this->NumberOfReads; }
+
+  /// Adds a step that is already in memory (e.g., the input of the filter).
+  void Insert(viskores::Id step, const viskores::cont::PartitionedDataSet& data)
+  {
+    this->Resident[step] = data;
+  }
+
+  /// Returns the data for `step`, reading it or waiting for a prefetch as needed.
+  viskores::cont::PartitionedDataSet Get(viskores::Id step)
+  {
+    if (step < 0 || step >= this->GetNumberOfTimeSteps())
+      throw viskores::cont::ErrorFilterExecution("Time step out of range.");
+
+    this->Release(step - 1);
+
+    auto it = this->Resident.find(step);
+    if (it == this->Resident.end())
+    {
+      viskores::cont::PartitionedDataSet data;
+      auto pending = this->Pending.find(step);
+      if (pending != this->Pending.end())
+      {
+        data = pending->second.get();
+        this->Pending.erase(pending);
+      }
+      else
+      {
+        VISKORES_LOG_S(viskores::cont::LogLevel::Perf, "Reading time step " << step);
+        data = this->Read(step);
+      }
+      it = this->Resident.emplace(step, data).first;
+    }
+    auto result = it->second;
+
+    if (this->Prefetch)
+      this->StartPrefetch(step);
+    return result;
+  }
+
+private:
+  viskores::cont::PartitionedDataSet Read(viskores::Id step)
+  {
+    // Reads are serialized so that the reader does not need to be reentrant.
+    std::lock_guard<std::mutex> lock(this->ReaderMutex);
+    this->NumberOfReads++;
+    return this->Reader(step);
+  }
+
+  void Release(viskores::Id firstKept)
+  {
+    this->Resident.erase(this->Resident.begin(), this->Resident.lower_bound(firstKept));
+    for (auto it = this->Pending.begin(); it != this->Pending.end() && it->first < firstKept;)
+    {
+      it->second.wait();
+      it = this->Pending.erase(it);
+    }
+  }
+
+  void StartPrefetch(viskores::Id step)
+  {
+    for (viskores::Id next = step + 1; next < this->GetNumberOfTimeSteps(); next++)
+    {
+      const auto used = static_cast<viskores::Id>(this->Resident.size() + this->Pending.size());
+      if (used >= this->NumberOfResident)
+        break;
+      if (this->Resident.count(next) > 0 || this->Pending.count(next) > 0)
+        continue;
+
+      VISKORES_LOG_S(viskores::cont::LogLevel::Perf, "Prefetching time step " << next);
+      this->Pending[next] =
+        std::async(std::launch::async, [this, next]() { return this->Read(next); });
+    }
+  }
+
+  ReaderType Reader;
+  std::vector<viskores::FloatDefault> Times;
+  viskores::Id NumberOfResident;
+  bool Prefetch;
+
+  std::map<viskores::Id, viskores::cont::PartitionedDataSet> Resident;
+  std::map<viskores::Id, std::future<viskores::cont::PartitionedDataSet>> Pending;
+  std::mutex ReaderMutex;
+  std::atomic<viskores::Id> NumberOfReads{ 0 };
+};
+
+}
+}
+}
+} //viskores::filter::flow::internal
+
+#endif //viskores_filter_flow_internal_TimeStepCache_h
@@ -10,7 +10,9 @@
 #include <iostream>
 #include <viskores/cont/DataSetBuilderUniform.h>
 #include <viskores/cont/testing/Testing.h>
+#include <viskores/filter/flow/FlowMapCache.h>
 #include <viskores/filter/flow/Lagrangian.h>
+#include <viskores/filter/flow/LagrangianStructures.h>
 #include <viskores/filter/flow/testing/GenerateTestDataSets.h>
 
 namespace
@@ -83,11 +85,104 @@ void TestLagrangianFilterMultiStepInterval()
   }
 }
 
+void TestFlowMapCache()
+{
+  const viskores::Id numIntervals = 4;
+  const viskores::FloatDefault stepSize = 0.1f;
+  // The velocity is 0.1 in every direction, and each interval is a single step.
+  const viskores::FloatDefault stepDisplacement = 0.01f;
+
+  auto dataSets = MakeDataSets();
+  for (auto& input : dataSets)
+  {
+    viskores::filter::flow::Lagrangian lagrangian;
+    lagrangian.SetResetParticles(true);
+    lagrangian.SetStepSize(static_cast<viskores::Float32>(stepSize));
+    lagrangian.SetWriteFrequency(1);
+    lagrangian.SetActiveField("velocity");
+
+    // The second cache composes without reusing an earlier composition.
+    viskores::filter::flow::FlowMapCache cache;
+    viskores::filter::flow::FlowMapCache uncachedCache;
+    for (viskores::Id i = 0; i < numIntervals; i++)
+    {
+      auto flowMap = lagrangian.Execute(input);
+      cache.Append(flowMap, stepSize);
+      uncachedCache.Append(flowMap, stepSize);
+    }
+    VISKORES_TEST_ASSERT(cache.GetNumberOfIntervals() == numIntervals, "Wrong number of intervals");
+    VISKORES_TEST_ASSERT(test_equal(cache.GetDuration(1, 3), 3 * stepSize), "Wrong duration");
+
+    auto starts = cache.GetFlowMap(1).GetCoordinateSystem().GetDataAsMultiplexer();
+    auto startsPortal = starts.ReadPortal();
+    auto bounds = input.GetCoordinateSystem().GetBounds();
+    // The seeds on the upper boundary leave the grid right away, so the later flow maps
+    // interpolate shorter displacements in the cells next to it. The FTLE also looks at
+    // the neighbors of a point.
+    const viskores::FloatDefault margin = 3;
+    auto awayFromBoundary = [&](const viskores::Vec3f& start)
+    {
+      return start[0] + margin < bounds.X.Max && start[1] + margin < bounds.Y.Max &&
+        start[2] + margin < bounds.Z.Max;
+    };
+
+    // Extending a composition reuses the previous result.
+    cache.Compose(1, 2);
+    auto ends = cache.Compose(1, 3);
+    VISKORES_TEST_ASSERT(ends.GetNumberOfValues() == starts.GetNumberOfValues(),
+                         "Wrong number of composed points");
+    auto endsPortal = ends.ReadPortal();
+    for (viskores::Id i = 0; i < ends.GetNumberOfValues(); i++)
+    {
+      auto start = startsPortal.Get(i);
+      if (awayFromBoundary(start))
+      {
+        viskores::Vec3f expected = start + viskores::Vec3f(3 * stepDisplacement);
+        VISKORES_TEST_ASSERT(test_equal(endsPortal.Get(i), expected), "Wrong composed position");
+      }
+    }
+
+    auto uncachedEnds = uncachedCache.Compose(1, 3);
+    VISKORES_TEST_ASSERT(test_equal_ArrayHandles(ends, uncachedEnds),
+                         "Cached and uncached compositions differ");
+
+    // A uniform translation does not stretch anything.
+    auto computeFTLE = [&](viskores::cont::ArrayHandle<viskores::Vec3f> flowMapEnds)
+    {
+      viskores::filter::flow::LagrangianStructures ftle;
+      ftle.SetUseFlowMapOutput(true);
+      ftle.SetFlowMapOutput(flowMapEnds);
+      ftle.SetAdvectionTime(cache.GetDuration(1, 3));
+      auto output = ftle.Execute(cache.GetFlowMap(1));
+      VISKORES_TEST_ASSERT(output.HasPointField("FTLE"), "FTLE field missing");
+      viskores::cont::ArrayHandle<viskores::FloatDefault> values;
+      output.GetPointField("FTLE").GetData().AsArrayHandle(values);
+      return values;
+    };
+    auto ftleValues = computeFTLE(ends);
+    VISKORES_TEST_ASSERT(test_equal_ArrayHandles(ftleValues, computeFTLE(uncachedEnds)),
+                         "Cached and uncached FTLE differ");
+    auto ftlePortal = ftleValues.ReadPortal();
+    for (viskores::Id i = 0; i < ftleValues.GetNumberOfValues(); i++)
+    {
+      if (awayFromBoundary(startsPortal.Get(i)))
+      {
+        VISKORES_TEST_ASSERT(test_equal(ftlePortal.Get(i), 0), "FTLE of translation is not 0");
+      }
+    }
+
+    cache.PopFront();
+    VISKORES_TEST_ASSERT(cache.GetNumberOfIntervals() == numIntervals - 1,
+                         "Wrong number of intervals after pop");
+  }
+}
+
 } //namespace
 
 void TestLagrangian()
 {
   TestLagrangianFilterMultiStepInterval();
+  TestFlowMapCache();
 }
 
 int UnitTestLagrangianFilter(int argc, char* argv[])
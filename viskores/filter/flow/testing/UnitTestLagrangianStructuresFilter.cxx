@@ -356,17 +356,13 @@ void Test3DLCS()
   viskores::Id3 dims(5, 5, 5);
 
   auto dataSets = viskores::worklet::testing::CreateAllDataSets(bounds, dims, false);
+  // Curvilinear and unstructured grids compute the gradient of the flow map over the cells.
+  dataSets.push_back(viskores::worklet::testing::CreateExplicitFromStructuredDataSet(
+    bounds, dims, viskores::worklet::testing::ExplicitDataSetOption::SINGLE));
+  dataSets.push_back(viskores::worklet::testing::CreateExplicitFromStructuredDataSet(
+    bounds, dims, viskores::worklet::testing::ExplicitDataSetOption::CURVILINEAR));
   for (auto& input : dataSets)
   {
-    using Structured3DType = viskores::cont::CellSetStructured<3>;
-    using Structured2DType = viskores::cont::CellSetStructured<2>;
-
-    viskores::cont::UnknownCellSet cellset = input.GetCellSet();
-
-    //Only structured supported in filter right now.
-    if (!(cellset.IsType<Structured2DType>() || cellset.IsType<Structured3DType>()))
-      continue;
-
     std::vector<viskores::FloatDefault> diffVec;
     std::vector<viskores::FloatDefault> visitVec;
     std::vector<viskores::Vec3f> fieldVec;
@@ -0,0 +1,203 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#include <viskores/Particle.h>
+#include <viskores/cont/EnvironmentTracker.h>
+#include <viskores/cont/testing/Testing.h>
+#include <viskores/filter/flow/internal/ParticleExchanger.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+using BlockIdsMap = std::unordered_map<viskores::Id, std::vector<viskores::Id>>;
+
+template <typename ParticleType>
+void RoundTrip(const std::vector<ParticleType>& particles,
+               const BlockIdsMap& blockIds,
+               bool float32Positions,
+               std::vector<ParticleType>& outParticles,
+               BlockIdsMap& outBlockIds)
+{
+  viskores::filter::flow::internal::ParticleMessage<ParticleType> msg(float32Positions);
+  for (const auto& p : particles)
+    msg.Add(p, blockIds.find(p.GetID())->second);
+  VISKORES_TEST_ASSERT(msg.GetNumberOfParticles() == static_cast<viskores::Id>(particles.size()));
+
+  viskoresdiy::MemoryBuffer buff;
+  msg.Pack(buff);
+  viskores::filter::flow::internal::ParticleMessage<ParticleType>::Unpack(
+    buff, outParticles, outBlockIds);
+}
+
+void TestCompactParticleMessage()
+{
+  std::cout << "Testing compact particle messages" << std::endl;
+
+  std::vector<viskores::Particle> particles;
+  BlockIdsMap blockIds;
+  for (viskores::Id i = 0; i < 10; i++)
+  {
+    viskores::Particle p(viskores::Vec3f(static_cast<viskores::FloatDefault>(i) + 0.25f,
+                                         static_cast<viskores::FloatDefault>(i) * 2.0f,
+                                         -1.5f),
+                         i + 100,
+                         i * 3);
+    p.SetTime(static_cast<viskores::FloatDefault>(i) * 0.5f);
+    p.GetStatus().SetSpatialBounds();
+    particles.emplace_back(p);
+
+    std::vector<viskores::Id> ids;
+    for (viskores::Id j = 0; j <= i % 3; j++)
+      ids.emplace_back(i + j);
+    blockIds[p.GetID()] = ids;
+  }
+
+  for (bool float32Positions : { false, true })
+  {
+    std::vector<viskores::Particle> out;
+    BlockIdsMap outBlockIds;
+    RoundTrip(particles, blockIds, float32Positions, out, outBlockIds);
+
+    VISKORES_TEST_ASSERT(out.size() == particles.size(), "Wrong number of particles");
+    for (std::size_t i = 0; i < particles.size(); i++)
+    {
+      const auto& p = particles[i];
+      const auto& q = out[i];
+      VISKORES_TEST_ASSERT(q.GetID() == p.GetID(), "Wrong particle id");
+      VISKORES_TEST_ASSERT(q.GetNumberOfSteps() == p.GetNumberOfSteps(), "Wrong step count");
+      VISKORES_TEST_ASSERT(test_equal(q.GetTime(), p.GetTime()), "Wrong time");
+      VISKORES_TEST_ASSERT(test_equal(q.GetPosition(), p.GetPosition()), "Wrong position");
+      VISKORES_TEST_ASSERT(q.GetStatus().CanContinue(), "Status should be reset");
+      VISKORES_TEST_ASSERT(outBlockIds[q.GetID()] == blockIds[p.GetID()], "Wrong block ids");
+    }
+  }
+
+  // The compact encoding must be smaller than the full serialization.
+  viskores::filter::flow::internal::ParticleMessage<viskores::Particle> compact(true);
+  viskoresdiy::MemoryBuffer full;
+  for (const auto& p : particles)
+  {
+    compact.Add(p, blockIds[p.GetID()]);
+    viskoresdiy::save(full, p);
+    viskoresdiy::save(full, blockIds[p.GetID()]);
+  }
+  VISKORES_TEST_ASSERT(compact.GetSize() < full.size(), "Compact message is not smaller");
+}
+
+void TestChargedParticleMessage()
+{
+  std::cout << "Testing charged particle messages" << std::endl;
+
+  std::vector<viskores::ChargedParticle> particles;
+  BlockIdsMap blockIds;
+  for (viskores::Id i = 0; i < 5; i++)
+  {
+    viskores::ChargedParticle p(viskores::Vec3f(static_cast<viskores::FloatDefault>(i), 1, 2),
+                                i,
+                                1.0,
+                                2.0,
+                                3.0,
+                                viskores::Vec3f(0, 0, static_cast<viskores::FloatDefault>(i)));
+    particles.emplace_back(p);
+    blockIds[i] = { i, i + 1 };
+  }
+
+  std::vector<viskores::ChargedParticle> out;
+  BlockIdsMap outBlockIds;
+  RoundTrip(particles, blockIds, true, out, outBlockIds);
+
+  VISKORES_TEST_ASSERT(out.size() == particles.size(), "Wrong number of particles");
+  for (std::size_t i = 0; i < particles.size(); i++)
+  {
+    VISKORES_TEST_ASSERT(out[i].GetID() == particles[i].GetID(), "Wrong particle id");
+    VISKORES_TEST_ASSERT(test_equal(out[i].GetPosition(), particles[i].GetPosition()),
+                         "Wrong position");
+    VISKORES_TEST_ASSERT(outBlockIds[out[i].GetID()] == blockIds[particles[i].GetID()],
+                         "Wrong block ids");
+  }
+}
+
+void TestExchange()
+{
+  std::cout << "Testing aggregated particle exchange" << std::endl;
+
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  const viskores::Id numRanks = comm.size();
+  const viskores::Id rank = comm.rank();
+  const viskores::Id numPerRank = 50;
+
+  viskores::filter::flow::ParticleExchangeOptions options;
+  // Small enough that some messages are sent before the final flush.
+  options.MessageSizeThreshold = 256;
+  options.UseFloat32Positions = true;
+
+  viskores::filter::flow::internal::ParticleExchanger<viskores::Particle> exchanger(comm);
+  exchanger.SetOptions(options);
+
+  std::vector<viskores::Particle> outgoing;
+  std::vector<viskores::Id> outgoingRanks;
+  BlockIdsMap outgoingBlockIds;
+  for (viskores::Id dst = 0; dst < numRanks; dst++)
+  {
+    if (numRanks > 1 && dst == rank)
+      continue;
+    for (viskores::Id i = 0; i < numPerRank; i++)
+    {
+      viskores::Id id = (rank * numRanks + dst) * numPerRank + i;
+      outgoing.emplace_back(viskores::Vec3f(static_cast<viskores::FloatDefault>(rank), 0, 0), id);
+      outgoingRanks.emplace_back(dst);
+      outgoingBlockIds[id] = { dst };
+    }
+  }
+
+  const std::size_t numExpected =
+    static_cast<std::size_t>(numPerRank * (numRanks > 1 ? numRanks - 1 : 1));
+
+  // Hold back partially filled messages on the first call, then flush.
+  std::vector<viskores::Particle> incoming, received;
+  BlockIdsMap incomingBlockIds, receivedBlockIds;
+  exchanger.Exchange(
+    outgoing, outgoingRanks, outgoingBlockIds, incoming, incomingBlockIds, false);
+  received.insert(received.end(), incoming.begin(), incoming.end());
+  receivedBlockIds.insert(incomingBlockIds.begin(), incomingBlockIds.end());
+
+  outgoing.clear();
+  outgoingRanks.clear();
+  while (received.size() < numExpected || exchanger.HaveWork())
+  {
+    exchanger.Exchange(outgoing, outgoingRanks, outgoingBlockIds, incoming, incomingBlockIds, true);
+    received.insert(received.end(), incoming.begin(), incoming.end());
+    receivedBlockIds.insert(incomingBlockIds.begin(), incomingBlockIds.end());
+  }
+
+  VISKORES_TEST_ASSERT(received.size() == numExpected, "Wrong number of particles received");
+  for (const auto& p : received)
+  {
+    const auto& bids = receivedBlockIds[p.GetID()];
+    VISKORES_TEST_ASSERT(bids.size() == 1 && bids[0] == rank, "Particle sent to wrong rank");
+  }
+
+  comm.barrier();
+}
+
+void TestParticleExchanger()
+{
+  TestCompactParticleMessage();
+  TestChargedParticleMessage();
+  TestExchange();
+}
+
+} // anonymous namespace
+
+int UnitTestParticleExchanger(int argc, char* argv[])
+{
+  return viskores::cont::testing::Testing::Run(TestParticleExchanger, argc, argv);
+}
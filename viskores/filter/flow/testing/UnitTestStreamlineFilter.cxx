@@ -165,6 +165,100 @@ void TestPathline(bool useThreaded)
   }
 }
 
+void TestPathlineTimeSteps(bool prefetch)
+{
+  const viskores::Id3 dims(5, 5, 5);
+  const viskores::Vec3f vecX(1, 0, 0);
+  const viskores::Bounds bounds(0, 4, 0, 4, 0, 4);
+  const std::vector<viskores::FloatDefault> times = { 0.0f, 0.5f, 1.0f, 1.5f, 2.0f };
+  const viskores::FloatDefault stepSize = .1f;
+  std::string var = "vec";
+
+  for (int fType = 0; fType < 2; fType++)
+  {
+    auto dataSets = viskores::worklet::testing::CreateAllDataSets(bounds, dims, false);
+    for (auto& ds : dataSets)
+    {
+      ds.AddPointField(var, CreateConstantVectorField(ds.GetNumberOfPoints(), vecX));
+
+      // Every step is a separate copy of the data, as if read from disk.
+      viskores::Id numReads = 0;
+      auto reader = [&](viskores::Id step) -> viskores::cont::PartitionedDataSet
+      {
+        VISKORES_TEST_ASSERT(step > 0 && step < static_cast<viskores::Id>(times.size()),
+                             "Unexpected time step read");
+        numReads++;
+        viskores::cont::DataSet stepData;
+        stepData.CopyStructure(ds);
+        stepData.AddPointField(var, CreateConstantVectorField(ds.GetNumberOfPoints(), vecX));
+        return viskores::cont::PartitionedDataSet(stepData);
+      };
+
+      viskores::cont::ArrayHandle<viskores::Particle> seedArray = viskores::cont::make_ArrayHandle(
+        { viskores::Particle(viskores::Vec3f(.2f, 1.0f, .2f), 0),
+          viskores::Particle(viskores::Vec3f(.2f, 2.0f, .2f), 1),
+          viskores::Particle(viskores::Vec3f(.2f, 3.0f, .2f), 2) });
+
+      viskores::cont::DataSet output;
+      if (fType == 0)
+      {
+        viskores::filter::flow::Pathline filt;
+        filt.SetActiveField(var);
+        filt.SetStepSize(stepSize);
+        filt.SetNumberOfSteps(1000);
+        filt.SetSeeds(seedArray);
+        filt.SetTimeStepReader(times, reader);
+        filt.SetPrefetchTimeSteps(prefetch);
+        output = filt.Execute(ds);
+
+        // The segments of the time windows are joined into one pathline per particle.
+        viskores::cont::UnknownCellSet dcells = output.GetCellSet();
+        VISKORES_TEST_ASSERT(dcells.GetNumberOfCells() == 3, "Wrong number of cells");
+
+        // The point where one window ends and the next begins is not repeated.
+        auto coords = output.GetCoordinateSystem().GetDataAsMultiplexer().ReadPortal();
+        for (viskores::Id cell = 0; cell < 3; cell++)
+        {
+          viskores::IdComponent numPoints = dcells.GetNumberOfPointsInCell(cell);
+          std::vector<viskores::Id> ids(static_cast<std::size_t>(numPoints));
+          dcells.GetCellPointIds(cell, ids.data());
+          for (std::size_t i = 1; i < ids.size(); i++)
+            VISKORES_TEST_ASSERT(coords.Get(ids[i]) != coords.Get(ids[i - 1]),
+                                 "Repeated point in pathline");
+          VISKORES_TEST_ASSERT(coords.Get(ids.back())[0] > 0.2f + times.back() - 0.01f,
+                               "Pathline does not cover all time steps");
+        }
+      }
+      else
+      {
+        viskores::filter::flow::PathParticle filt;
+        filt.SetActiveField(var);
+        filt.SetStepSize(stepSize);
+        filt.SetNumberOfSteps(1000);
+        filt.SetSeeds(seedArray);
+        filt.SetTimeStepReader(times, reader);
+        filt.SetPrefetchTimeSteps(prefetch);
+        output = filt.Execute(ds);
+
+        // The particles move with unit speed until they pass the last time step.
+        auto coords = output.GetCoordinateSystem().GetDataAsMultiplexer();
+        VISKORES_TEST_ASSERT(coords.GetNumberOfValues() == 3, "Wrong number of coordinates");
+        auto portal = coords.ReadPortal();
+        for (viskores::Id i = 0; i < 3; i++)
+        {
+          auto x = portal.Get(i)[0];
+          VISKORES_TEST_ASSERT(x > 0.2f + times.back() - 0.01f &&
+                                 x < 0.2f + times.back() + stepSize + 0.01f,
+                               "Particle did not advect across all time steps");
+        }
+      }
+
+      VISKORES_TEST_ASSERT(numReads == static_cast<viskores::Id>(times.size() - 1),
+                           "Each time step should be read exactly once");
+    }
+  }
+}
+
 void TestAMRStreamline(bool useSL, bool useThreaded)
 {
   viskores::Bounds outerBounds(0, 10, 0, 10, 0, 10);
@@ -614,6 +708,8 @@ void TestStreamlineFilters()
     TestStreamline(useThreaded);
     TestPathline(useThreaded);
   }
+  for (auto prefetch : flags)
+    TestPathlineTimeSteps(prefetch);
   for (auto useSL : flags)
     TestAMRStreamline(useSL, false);
 
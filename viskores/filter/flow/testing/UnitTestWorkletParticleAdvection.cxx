@@ -728,7 +728,9 @@ void TestWorkletsBasic()
     Stepper rk4(eval, stepSize);
 
     viskores::Id maxSteps = 83;
-    std::vector<std::string> workletTypes = { "particleAdvection", "streamline" };
+    std::vector<std::string> workletTypes = { "particleAdvection",
+                                              "streamline",
+                                              "streamlineChunked" };
     viskores::FloatDefault endT = stepSize * static_cast<viskores::FloatDefault>(maxSteps);
 
     for (auto w : workletTypes)
@@ -786,11 +788,12 @@ void TestWorkletsBasic()
                                "Particle advection particle did not terminate");
         }
       }
-      else if (w == "streamline")
+      else if (w == "streamline" || w == "streamlineChunked")
       {
         viskores::worklet::flow::ParticleAdvection pa;
         Termination termination(maxSteps);
-        SAnalysis analysis(maxSteps);
+        // A small chunk size records each streamline over many rounds.
+        SAnalysis analysis(maxSteps, w == "streamline" ? SAnalysis::DefaultChunkSize : 7);
         pa.Run(rk4, seedsArray, termination, analysis);
 
         viskores::Id numRequiredPoints = static_cast<viskores::Id>(samplePts.size());
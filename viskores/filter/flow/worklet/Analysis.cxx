@@ -10,6 +10,8 @@
 
 #include <viskores/filter/flow/worklet/Analysis.h>
 
+#include <viskores/Math.h>
+
 #include <viskores/cont/Algorithm.h>
 #include <viskores/cont/ArrayCopy.h>
 #include <viskores/cont/ConvertNumComponentsToOffsets.h>
@@ -58,37 +60,108 @@ VISKORES_CONT bool NoAnalysis<ParticleType>::MakeDataSet(
 
 namespace detail
 {
-class GetSteps : public viskores::worklet::WorkletMapField
+// Copy the points recorded for each slot of a round to the front of the round.
+class CompactRound : public viskores::worklet::WorkletMapField
 {
 public:
   VISKORES_CONT
-  GetSteps() {}
-  using ControlSignature = void(FieldIn, FieldOut);
-  using ExecutionSignature = void(_1, _2);
-
-  template <typename ParticleType>
-  VISKORES_EXEC void operator()(const ParticleType& p, viskores::Id& numSteps) const
+  CompactRound(viskores::Id chunkSize)
+    : ChunkSize(chunkSize)
+  {
+  }
+  using ControlSignature =
+    void(FieldIn count, FieldIn offset, WholeArrayIn roundPoints, WholeArrayOut points);
+  using ExecutionSignature = void(InputIndex, _1, _2, _3, _4);
+
+  template <typename InPortalType, typename OutPortalType>
+  VISKORES_EXEC void operator()(const viskores::Id& slot,
+                                const viskores::Id& count,
+                                const viskores::Id& offset,
+                                const InPortalType& roundPoints,
+                                OutPortalType& points) const
   {
-    numSteps = p.GetNumberOfSteps();
+    for (viskores::Id i = 0; i < count; i++)
+      points.Set(offset + i, roundPoints.Get(slot * this->ChunkSize + i));
   }
+
+private:
+  viskores::Id ChunkSize;
 };
 
-class ComputeNumPoints : public viskores::worklet::WorkletMapField
+// A particle continues in the next round if it filled its slots without stopping.
+class IsContinuing : public viskores::worklet::WorkletMapField
 {
 public:
   VISKORES_CONT
-  ComputeNumPoints() {}
-  using ControlSignature = void(FieldIn, FieldIn, FieldOut);
-  using ExecutionSignature = void(_1, _2, _3);
-
-  // Offset is number of points in streamline.
-  // 1 (initial point) + number of steps taken (p.NumSteps - initalNumSteps)
-  template <typename ParticleType>
-  VISKORES_EXEC void operator()(const ParticleType& p,
-                                const viskores::Id& initialNumSteps,
-                                viskores::Id& diff) const
+  IsContinuing(viskores::Id chunkSize)
+    : ChunkSize(chunkSize)
+  {
+  }
+  using ControlSignature =
+    void(FieldIn particleId, FieldIn count, WholeArrayIn particles, FieldOut);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  template <typename PortalType>
+  VISKORES_EXEC void operator()(const viskores::Id& particleId,
+                                const viskores::Id& count,
+                                const PortalType& particles,
+                                viskores::UInt8& continuing) const
+  {
+    continuing = (count == this->ChunkSize && particles.Get(particleId).GetStatus().CanContinue())
+      ? 1
+      : 0;
+  }
+
+private:
+  viskores::Id ChunkSize;
+};
+
+class AssignSlots : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn particleId, WholeArrayOut slots);
+  using ExecutionSignature = void(InputIndex, _1, _2);
+
+  template <typename PortalType>
+  VISKORES_EXEC void operator()(const viskores::Id& slot,
+                                const viskores::Id& particleId,
+                                PortalType& slots) const
   {
-    diff = 1 + p.GetNumberOfSteps() - initialNumSteps;
+    slots.Set(particleId, slot);
+  }
+};
+
+// Append the points of one round to the polyline of each particle. A particle
+// occupies at most one slot per round, so the writes do not overlap.
+class ScatterRound : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn particleId,
+                                FieldIn count,
+                                FieldIn offset,
+                                WholeArrayIn roundPoints,
+                                WholeArrayIn streamOffsets,
+                                WholeArrayInOut written,
+                                WholeArrayOut streams);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+
+  template <typename PointPortalType,
+            typename OffsetPortalType,
+            typename WrittenPortalType,
+            typename StreamPortalType>
+  VISKORES_EXEC void operator()(const viskores::Id& particleId,
+                                const viskores::Id& count,
+                                const viskores::Id& offset,
+                                const PointPortalType& roundPoints,
+                                const OffsetPortalType& streamOffsets,
+                                WrittenPortalType& written,
+                                StreamPortalType& streams) const
+  {
+    viskores::Id numWritten = written.Get(particleId);
+    viskores::Id start = streamOffsets.Get(particleId) + numWritten;
+    for (viskores::Id i = 0; i < count; i++)
+      streams.Set(start + i, roundPoints.Get(offset + i));
+    written.Set(particleId, numWritten + count);
   }
 };
 
@@ -99,50 +172,138 @@ VISKORES_CONT void StreamlineAnalysis<ParticleType>::InitializeAnalysis(
   const viskores::cont::ArrayHandle<ParticleType>& particles)
 {
   this->NumParticles = particles.GetNumberOfValues();
+  this->History.clear();
 
-  //Create ValidPointArray initialized to zero.
-  viskores::cont::ArrayHandleConstant<viskores::Id> validity(
-    0, this->NumParticles * (this->MaxSteps + 1));
-  viskores::cont::ArrayCopy(validity, this->Validity);
   //Create StepCountArray initialized to zero.
   viskores::cont::ArrayHandleConstant<viskores::Id> streamLengths(0, this->NumParticles);
   viskores::cont::ArrayCopy(streamLengths, this->StreamLengths);
 
-  // Initialize InitLengths
-  viskores::Id numSeeds = static_cast<viskores::Id>(particles.GetNumberOfValues());
-  viskores::cont::ArrayHandleIndex idxArray(numSeeds);
+  // The first round advects every particle, each in its own slot. Short
+  // streamlines never need more than maxSteps + 1 points.
+  this->RoundChunkSize =
+    viskores::Max(viskores::Id(2), viskores::Min(this->ChunkSize, this->MaxSteps + 1));
+  this->NumSlots = this->NumParticles;
+  this->SlotParticleIds = viskores::cont::ArrayHandle<viskores::Id>();
+  viskores::cont::ArrayCopy(viskores::cont::ArrayHandleIndex(this->NumParticles),
+                            this->SlotParticleIds);
+  viskores::cont::ArrayCopy(this->SlotParticleIds, this->Slots);
+  this->RoundCounts = viskores::cont::ArrayHandle<viskores::Id>();
+  viskores::cont::ArrayCopy(viskores::cont::ArrayHandleConstant<viskores::Id>(0, this->NumSlots),
+                            this->RoundCounts);
+  this->RoundPoints = viskores::cont::ArrayHandle<viskores::Vec3f>();
+  this->RoundPoints.Allocate(this->NumSlots * this->RoundChunkSize);
+  this->RoundPending = true;
+}
+
+template <typename ParticleType>
+VISKORES_CONT void StreamlineAnalysis<ParticleType>::StoreRound()
+{
+  RoundHistory round;
+  round.ParticleIds = this->SlotParticleIds;
+  round.Counts = this->RoundCounts;
+  viskores::Id numPoints = viskores::cont::Algorithm::ScanExclusive(round.Counts, round.Offsets);
+
+  round.Points.Allocate(numPoints);
   viskores::cont::Invoker invoker;
-  invoker(detail::GetSteps{}, particles, this->InitialLengths);
+  invoker(detail::CompactRound{ this->RoundChunkSize },
+          round.Counts,
+          round.Offsets,
+          this->RoundPoints,
+          round.Points);
+
+  this->History.emplace_back(std::move(round));
+  this->RoundPending = false;
+}
+
+template <typename ParticleType>
+VISKORES_CONT bool StreamlineAnalysis<ParticleType>::PrepareNextRound(
+  const viskores::cont::ArrayHandle<ParticleType>& particles,
+  viskores::cont::ArrayHandle<viskores::Id>& continuingIds)
+{
+  if (!this->RoundPending)
+    return false;
+  this->StoreRound();
+
+  const auto& round = this->History.back();
+  viskores::cont::Invoker invoker;
+  viskores::cont::ArrayHandle<viskores::UInt8> continuing;
+  invoker(detail::IsContinuing{ this->RoundChunkSize },
+          round.ParticleIds,
+          round.Counts,
+          particles,
+          continuing);
+  viskores::cont::Algorithm::CopyIf(round.ParticleIds, continuing, continuingIds);
+
+  this->NumSlots = continuingIds.GetNumberOfValues();
+  if (this->NumSlots == 0)
+  {
+    this->RoundPoints.ReleaseResources();
+    return false;
+  }
+
+  // Give each continuing particle a new slot for the next round. The previous
+  // round's arrays are referenced by the history, so allocate new ones.
+  this->SlotParticleIds = viskores::cont::ArrayHandle<viskores::Id>();
+  viskores::cont::ArrayCopy(continuingIds, this->SlotParticleIds);
+  invoker(detail::AssignSlots{}, this->SlotParticleIds, this->Slots);
+  this->RoundCounts = viskores::cont::ArrayHandle<viskores::Id>();
+  viskores::cont::ArrayCopy(viskores::cont::ArrayHandleConstant<viskores::Id>(0, this->NumSlots),
+                            this->RoundCounts);
+  this->RoundPoints = viskores::cont::ArrayHandle<viskores::Vec3f>();
+  this->RoundPoints.Allocate(this->NumSlots * this->RoundChunkSize);
+  this->RoundPending = true;
+  return true;
 }
 
 template <typename ParticleType>
 VISKORES_CONT void StreamlineAnalysis<ParticleType>::FinalizeAnalysis(
   viskores::cont::ArrayHandle<ParticleType>& particles)
 {
+  if (this->RoundPending)
+    this->StoreRound();
+  // The history shares the slot arrays of the last round, so let go of them instead of
+  // releasing their memory.
+  this->RoundPoints.ReleaseResources();
+  this->RoundCounts = viskores::cont::ArrayHandle<viskores::Id>();
+  this->Slots.ReleaseResources();
+  this->SlotParticleIds = viskores::cont::ArrayHandle<viskores::Id>();
+
   viskores::Id numSeeds = particles.GetNumberOfValues();
-  viskores::cont::ArrayHandle<viskores::Vec3f> positions;
-  viskores::cont::Algorithm::CopyIf(this->Streams, this->Validity, positions, IsOne());
-  viskores::cont::Algorithm::Copy(positions, this->Streams);
 
-  // Create the cells
-  viskores::cont::ArrayHandle<viskores::Id> numPoints;
+  // Each particle has one polyline holding every point it recorded.
+  viskores::Id numPoints;
+  auto offsets = viskores::cont::ConvertNumComponentsToOffsets(this->StreamLengths, numPoints);
+
+  this->Streams = viskores::cont::ArrayHandle<viskores::Vec3f>();
+  this->Streams.Allocate(numPoints);
+  viskores::cont::ArrayHandle<viskores::Id> written;
+  viskores::cont::ArrayCopy(viskores::cont::ArrayHandleConstant<viskores::Id>(0, numSeeds),
+                            written);
   viskores::cont::Invoker invoker;
-  invoker(detail::ComputeNumPoints{}, particles, this->InitialLengths, numPoints);
+  for (auto& round : this->History)
+  {
+    invoker(detail::ScatterRound{},
+            round.ParticleIds,
+            round.Counts,
+            round.Offsets,
+            round.Points,
+            offsets,
+            written,
+            this->Streams);
+    round = RoundHistory{};
+  }
+  this->History.clear();
 
-  viskores::cont::ArrayHandle<viskores::Id> cellIndex;
-  viskores::Id connectivityLen = viskores::cont::Algorithm::ScanExclusive(numPoints, cellIndex);
-  viskores::cont::ArrayHandleIndex connCount(connectivityLen);
+  // Create the cells
   viskores::cont::ArrayHandle<viskores::Id> connectivity;
-  viskores::cont::ArrayCopy(connCount, connectivity);
+  viskores::cont::ArrayCopy(viskores::cont::ArrayHandleIndex(numPoints), connectivity);
 
   viskores::cont::ArrayHandle<viskores::UInt8> cellTypes;
   auto polyLineShape = viskores::cont::make_ArrayHandleConstant<viskores::UInt8>(
     viskores::CELL_SHAPE_POLY_LINE, numSeeds);
   viskores::cont::ArrayCopy(polyLineShape, cellTypes);
 
-  auto offsets = viskores::cont::ConvertNumComponentsToOffsets(numPoints);
-
-  this->PolyLines.Fill(this->Streams.GetNumberOfValues(), cellTypes, connectivity, offsets);
+  this->PolyLines.Fill(numPoints, cellTypes, connectivity, offsets);
   this->Particles = particles;
 }
 
@@ -17,6 +17,8 @@
 #include <viskores/cont/ExecutionObjectBase.h>
 #include <viskores/filter/flow/viskores_filter_flow_export.h>
 
+#include <vector>
+
 namespace viskores
 {
 namespace worklet
@@ -47,6 +49,12 @@ public:
     (void)oldParticle;
     (void)newParticle;
   }
+
+  VISKORES_EXEC bool CanContinue(const viskores::Id index) const
+  {
+    (void)index;
+    return true;
+  }
 };
 
 template <typename ParticleType>
@@ -72,6 +80,15 @@ public:
     (void)particles;
   }
 
+  VISKORES_CONT
+  bool PrepareNextRound(const viskores::cont::ArrayHandle<ParticleType>& particles,
+                        viskores::cont::ArrayHandle<viskores::Id>& continuingIds)
+  {
+    (void)particles;
+    (void)continuingIds;
+    return false;
+  }
+
   VISKORES_CONT
   //template <typename ParticleType>
   void FinalizeAnalysis(viskores::cont::ArrayHandle<ParticleType>& particles)
@@ -94,34 +111,37 @@ public:
                                         const std::vector<NoAnalysis>& results);
 };
 
+/// Records the positions of each particle into a fixed number of history slots per
+/// advection round. A particle whose slots are full stops advecting until the next round.
 template <typename ParticleType>
 class VISKORES_FILTER_FLOW_EXPORT StreamlineAnalysisExec
 {
 public:
   VISKORES_EXEC_CONT
   StreamlineAnalysisExec()
-    : NumParticles(0)
-    , MaxSteps(0)
-    , Streams()
+    : ChunkSize(0)
+    , RoundPoints()
+    , RoundCounts()
+    , Slots()
     , StreamLengths()
-    , Validity()
   {
   }
 
   VISKORES_CONT
-  StreamlineAnalysisExec(viskores::Id numParticles,
-                         viskores::Id maxSteps,
-                         const viskores::cont::ArrayHandle<viskores::Vec3f>& streams,
+  StreamlineAnalysisExec(viskores::Id numSlots,
+                         viskores::Id chunkSize,
+                         const viskores::cont::ArrayHandle<viskores::Vec3f>& roundPoints,
+                         const viskores::cont::ArrayHandle<viskores::Id>& roundCounts,
+                         const viskores::cont::ArrayHandle<viskores::Id>& slots,
                          const viskores::cont::ArrayHandle<viskores::Id>& streamLengths,
-                         const viskores::cont::ArrayHandle<viskores::Id>& validity,
                          viskores::cont::DeviceAdapterId device,
                          viskores::cont::Token& token)
-    : NumParticles(numParticles)
-    , MaxSteps(maxSteps + 1)
+    : ChunkSize(chunkSize)
   {
-    Streams = streams.PrepareForOutput(this->NumParticles * this->MaxSteps, device, token);
+    RoundPoints = roundPoints.PrepareForOutput(numSlots * this->ChunkSize, device, token);
+    RoundCounts = roundCounts.PrepareForInPlace(device, token);
+    Slots = slots.PrepareForInput(device, token);
     StreamLengths = streamLengths.PrepareForInPlace(device, token);
-    Validity = validity.PrepareForInPlace(device, token);
   }
 
   VISKORES_EXEC void PreStepAnalyze(const viskores::Id index, const ParticleType& particle)
@@ -130,9 +150,7 @@ public:
     if (streamLength == 0)
     {
       this->StreamLengths.Set(index, 1);
-      viskores::Id loc = index * MaxSteps;
-      this->Streams.Set(loc, particle.GetPosition());
-      this->Validity.Set(loc, 1);
+      this->Record(index, particle.GetPosition());
     }
   }
 
@@ -143,23 +161,43 @@ public:
   {
     (void)oldParticle;
     viskores::Id streamLength = this->StreamLengths.Get(index);
-    viskores::Id loc = index * MaxSteps + streamLength;
     this->StreamLengths.Set(index, ++streamLength);
-    this->Streams.Set(loc, newParticle.GetPosition());
-    this->Validity.Set(loc, 1);
+    this->Record(index, newParticle.GetPosition());
+  }
+
+  VISKORES_EXEC bool CanContinue(const viskores::Id index) const
+  {
+    return this->RoundCounts.Get(this->Slots.Get(index)) < this->ChunkSize;
   }
 
 private:
+  VISKORES_EXEC void Record(const viskores::Id index, const viskores::Vec3f& pt)
+  {
+    viskores::Id slot = this->Slots.Get(index);
+    viskores::Id count = this->RoundCounts.Get(slot);
+    this->RoundPoints.Set(slot * this->ChunkSize + count, pt);
+    this->RoundCounts.Set(slot, count + 1);
+  }
+
   using IdPortal = typename viskores::cont::ArrayHandle<viskores::Id>::WritePortalType;
+  using IdReadPortal = typename viskores::cont::ArrayHandle<viskores::Id>::ReadPortalType;
   using VecPortal = typename viskores::cont::ArrayHandle<viskores::Vec3f>::WritePortalType;
 
-  viskores::Id NumParticles;
-  viskores::Id MaxSteps;
-  VecPortal Streams;
+  viskores::Id ChunkSize;
+  VecPortal RoundPoints;
+  IdPortal RoundCounts;
+  IdReadPortal Slots;
   IdPortal StreamLengths;
-  IdPortal Validity;
 };
 
+/// @brief Records the trajectory of each particle and builds polylines from them.
+///
+/// Rather than reserving `maxSteps` points for every particle up front, the history is
+/// recorded in rounds. Each round gives the particles that are still advecting a chunk
+/// of `chunkSize` points. After a round, the recorded points are compacted and the
+/// particles that filled their chunk continue in the next round. The compacted chunks
+/// are assembled into a `CellSetExplicit` of polylines once, in `FinalizeAnalysis`, so
+/// memory is bounded by the length of the trajectories actually taken.
 template <typename ParticleType>
 class StreamlineAnalysis : public viskores::cont::ExecutionObjectBase
 {
@@ -169,42 +207,41 @@ public:
   viskores::cont::ArrayHandle<viskores::Vec3f> Streams;
   viskores::cont::CellSetExplicit<> PolyLines;
 
-  //Helper functor for compacting history
-  struct IsOne
-  {
-    template <typename T>
-    VISKORES_EXEC_CONT bool operator()(const T& x) const
-    {
-      return x == T(1);
-    }
-  };
+  static constexpr viskores::Id DefaultChunkSize = 256;
 
   VISKORES_CONT
   StreamlineAnalysis()
     : Particles()
     , MaxSteps(0)
+    , ChunkSize(DefaultChunkSize)
   {
   }
 
   VISKORES_CONT
-  StreamlineAnalysis(viskores::Id maxSteps)
+  StreamlineAnalysis(viskores::Id maxSteps, viskores::Id chunkSize = DefaultChunkSize)
     : Particles()
     , MaxSteps(maxSteps)
+    , ChunkSize(chunkSize)
   {
   }
 
   VISKORES_CONT
-  void UseAsTemplate(const StreamlineAnalysis& other) { this->MaxSteps = other.MaxSteps; }
+  void UseAsTemplate(const StreamlineAnalysis& other)
+  {
+    this->MaxSteps = other.MaxSteps;
+    this->ChunkSize = other.ChunkSize;
+  }
 
   VISKORES_CONT StreamlineAnalysisExec<ParticleType> PrepareForExecution(
     viskores::cont::DeviceAdapterId device,
     viskores::cont::Token& token) const
   {
-    return StreamlineAnalysisExec<ParticleType>(this->NumParticles,
-                                                this->MaxSteps,
-                                                this->Streams,
+    return StreamlineAnalysisExec<ParticleType>(this->NumSlots,
+                                                this->RoundChunkSize,
+                                                this->RoundPoints,
+                                                this->RoundCounts,
+                                                this->Slots,
                                                 this->StreamLengths,
-                                                this->Validity,
                                                 device,
                                                 token);
   }
@@ -214,6 +251,13 @@ public:
   VISKORES_CONT
   void InitializeAnalysis(const viskores::cont::ArrayHandle<ParticleType>& particles);
 
+  /// Stores the points recorded in the last round. Returns true and fills
+  /// `continuingIds` with the particles that ran out of history slots and must be
+  /// advected in another round.
+  VISKORES_CONT
+  bool PrepareNextRound(const viskores::cont::ArrayHandle<ParticleType>& particles,
+                        viskores::cont::ArrayHandle<viskores::Id>& continuingIds);
+
   VISKORES_CONT
   //template <typename ParticleType>
   void FinalizeAnalysis(viskores::cont::ArrayHandle<ParticleType>& particles);
@@ -223,12 +267,34 @@ public:
                                         const std::vector<StreamlineAnalysis>& results);
 
 private:
-  viskores::Id NumParticles;
+  struct RoundHistory
+  {
+    // Compacted points recorded during the round.
+    viskores::cont::ArrayHandle<viskores::Vec3f> Points;
+    // For each slot of the round: the particle index, the number of points and
+    // where they start in `Points`.
+    viskores::cont::ArrayHandle<viskores::Id> ParticleIds;
+    viskores::cont::ArrayHandle<viskores::Id> Counts;
+    viskores::cont::ArrayHandle<viskores::Id> Offsets;
+  };
+
+  VISKORES_CONT void StoreRound();
+
+  viskores::Id NumParticles = 0;
   viskores::Id MaxSteps;
+  viskores::Id ChunkSize;
+
+  // State of the current round.
+  viskores::Id NumSlots = 0;
+  viskores::Id RoundChunkSize = 0;
+  bool RoundPending = false;
+  viskores::cont::ArrayHandle<viskores::Vec3f> RoundPoints;
+  viskores::cont::ArrayHandle<viskores::Id> RoundCounts;
+  viskores::cont::ArrayHandle<viskores::Id> SlotParticleIds;
+  viskores::cont::ArrayHandle<viskores::Id> Slots;
 
   viskores::cont::ArrayHandle<viskores::Id> StreamLengths;
-  viskores::cont::ArrayHandle<viskores::Id> InitialLengths;
-  viskores::cont::ArrayHandle<viskores::Id> Validity;
+  std::vector<RoundHistory> History;
 };
 
 #ifndef viskores_filter_flow_worklet_Analysis_cxx
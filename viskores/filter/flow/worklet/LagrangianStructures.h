@@ -188,6 +188,47 @@ public:
   viskores::filter::flow::internal::GridMetaData GridData;
 };
 
+/// Computes the FTLE from the spatial gradient of the flow map, for grids where the
+/// gradient comes from the cells of the mesh rather than from logical neighbors.
+class LagrangianStructuresFromGradient : public viskores::worklet::WorkletMapField
+{
+public:
+  using Scalar = viskores::FloatDefault;
+
+  VISKORES_CONT
+  LagrangianStructuresFromGradient(Scalar endTime)
+    : EndTime(endTime)
+  {
+  }
+
+  using ControlSignature = void(FieldIn, FieldOut);
+
+  using ExecutionSignature = void(_1, _2);
+
+  template <typename T>
+  VISKORES_EXEC void operator()(const viskores::Vec<viskores::Vec<T, 3>, 3>& gradient,
+                                Scalar& outputField) const
+  {
+    // The rows of the gradient are the derivatives w.r.t. X, Y, Z, which makes this the
+    // transpose of the Jacobian. Both give the same eigenvalues for the tensor below.
+    viskores::Matrix<Scalar, 3, 3> jacobian;
+    for (viskores::IdComponent i = 0; i < 3; i++)
+      viskores::MatrixSetRow(jacobian, i, viskores::Vec<Scalar, 3>(gradient[i]));
+
+    viskores::filter::flow::internal::ComputeLeftCauchyGreenTensor(jacobian);
+
+    viskores::Vec<Scalar, 3> eigenValues;
+    viskores::filter::flow::internal::Jacobi(jacobian, eigenValues);
+
+    Scalar delta = eigenValues[0];
+    outputField = viskores::Log(delta) / (static_cast<Scalar>(2.0f) * EndTime);
+  }
+
+public:
+  // To calculate FTLE field
+  Scalar EndTime;
+};
+
 }
 }
 } //viskores::worklet::flow
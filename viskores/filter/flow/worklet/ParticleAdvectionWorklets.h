@@ -38,18 +38,63 @@ namespace worklet
 namespace flow
 {
 
+namespace detail
+{
+
+// Advances a particle by a single step and records the outcome. Returns whether the
+// particle can keep going.
+template <typename IntegratorType, typename IntegralCurveType>
+VISKORES_EXEC bool AdvanceParticle(const viskores::Id& idx,
+                                   const IntegratorType& integrator,
+                                   IntegralCurveType& integralCurve,
+                                   viskores::FloatDefault& time,
+                                   bool& tookAnySteps,
+                                   bool pushOutOfBounds)
+{
+  //the integrator status needs to be more robust:
+  // 1. you could have success AND at temporal boundary.
+  // 2. could you have success AND at spatial?
+  // 3. all three?
+  auto particle = integralCurve.GetParticle(idx);
+  viskores::Vec3f outpos;
+  auto status = integrator.Step(particle, time, outpos);
+  if (status.CheckOk())
+  {
+    integralCurve.StepUpdate(idx, particle, time, outpos);
+    tookAnySteps = true;
+  }
+
+  //We can't take a step inside spatial boundary.
+  //Try and take a step just past the boundary.
+  else if (status.CheckSpatialBounds() && pushOutOfBounds)
+  {
+    status = integrator.SmallStep(particle, time, outpos);
+    if (status.CheckOk())
+    {
+      integralCurve.StepUpdate(idx, particle, time, outpos);
+      tookAnySteps = true;
+    }
+  }
+  integralCurve.StatusUpdate(idx, status);
+  return integralCurve.CanContinue(idx);
+}
+
+} // namespace detail
+
 class ParticleAdvectWorklet : public viskores::worklet::WorkletMapField
 {
 public:
   VISKORES_EXEC_CONT
   ParticleAdvectWorklet()
     : PushOutOfBounds(true)
+    , Resume(false)
   {
   }
 
   VISKORES_EXEC_CONT
-  ParticleAdvectWorklet(bool pushOutOfBounds)
+  ParticleAdvectWorklet(bool pushOutOfBounds, bool resume = false)
     : PushOutOfBounds(pushOutOfBounds)
+    , Resume(resume)
   {
   }
 
@@ -64,37 +109,14 @@ public:
   {
     auto particle = integralCurve.GetParticle(idx);
     viskores::FloatDefault time = particle.GetTime();
-    bool tookAnySteps = false;
+    // A resumed particle keeps the steps it took in earlier rounds.
+    bool tookAnySteps = this->Resume && particle.GetStatus().CheckTookAnySteps();
 
-    //the integrator status needs to be more robust:
-    // 1. you could have success AND at temporal boundary.
-    // 2. could you have success AND at spatial?
-    // 3. all three?
     integralCurve.PreStepUpdate(idx, particle);
-    do
+    while (detail::AdvanceParticle(
+      idx, integrator, integralCurve, time, tookAnySteps, this->PushOutOfBounds))
     {
-      particle = integralCurve.GetParticle(idx);
-      viskores::Vec3f outpos;
-      auto status = integrator.Step(particle, time, outpos);
-      if (status.CheckOk())
-      {
-        integralCurve.StepUpdate(idx, particle, time, outpos);
-        tookAnySteps = true;
-      }
-
-      //We can't take a step inside spatial boundary.
-      //Try and take a step just past the boundary.
-      else if (status.CheckSpatialBounds() && this->PushOutOfBounds)
-      {
-        status = integrator.SmallStep(particle, time, outpos);
-        if (status.CheckOk())
-        {
-          integralCurve.StepUpdate(idx, particle, time, outpos);
-          tookAnySteps = true;
-        }
-      }
-      integralCurve.StatusUpdate(idx, status);
-    } while (integralCurve.CanContinue(idx));
+    }
 
     //Mark if any steps taken
     integralCurve.UpdateTookSteps(idx, tookAnySteps);
@@ -102,9 +124,9 @@ public:
 
 private:
   bool PushOutOfBounds;
+  bool Resume;
 };
 
-
 template <typename IntegratorType,
           typename ParticleType,
           typename TerminationType,
@@ -152,6 +174,17 @@ public:
     viskores::cont::Invoker invoker;
     invoker(worklet, idxArray, integrator, particlesObj);
 
+    // Some analyses bound the work done per invocation (e.g., streamlines record
+    // their history in fixed size chunks). Resume the particles they paused.
+    viskores::cont::ArrayHandle<viskores::Id> continuingIds;
+    while (analysis.PrepareNextRound(particles, continuingIds))
+    {
+      ParticleArrayType roundObj(particles, termination, analysis);
+      viskores::worklet::flow::ParticleAdvectWorklet roundWorklet(
+        analysis.SupportPushOutOfBounds(), true);
+      invoker(roundWorklet, continuingIds, integrator, roundObj);
+    }
+
     // Finalize the analysis and clear intermittent arrays.
     analysis.FinalizeAnalysis(particles);
   }
@@ -98,7 +98,8 @@ public:
     ParticleType particle(this->GetParticle(idx));
     auto terminate = this->Termination.CheckTermination(particle);
     this->Particles.Set(idx, particle);
-    return terminate;
+    // The analysis may also pause a particle, e.g. when its history buffer is full.
+    return terminate && this->Analysis.CanContinue(idx);
   }
 
   VISKORES_EXEC
@@ -0,0 +1,234 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#include <viskores/cont/Algorithm.h>
+#include <viskores/cont/ArrayGetValues.h>
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/ArrayHandlePermutation.h>
+#include <viskores/cont/ArrayPortalToIterators.h>
+#include <viskores/cont/EnvironmentTracker.h>
+#include <viskores/cont/ErrorBadValue.h>
+#include <viskores/filter/scalar_topology/BranchIndex.h>
+#include <viskores/filter/scalar_topology/internal/SelectTopVolumeBranchesBlock.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/DataSetMesh.h>
+
+VISKORES_THIRDPARTY_PRE_INCLUDE
+#include <viskores/thirdparty/diy/diy.h>
+VISKORES_THIRDPARTY_POST_INCLUDE
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace viskores
+{
+namespace filter
+{
+namespace scalar_topology
+{
+
+namespace
+{
+
+// Append the values of all ranks to the values of this rank
+template <typename T>
+void AllGatherValues(std::vector<T>& values)
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  if (comm.size() > 1)
+  {
+    std::vector<std::vector<T>> gathered;
+    viskoresdiy::mpi::all_gather(comm, values, gathered);
+    values.clear();
+    for (const auto& rankValues : gathered)
+    {
+      values.insert(values.end(), rankValues.begin(), rankValues.end());
+    }
+  }
+}
+
+template <typename T>
+void SortBranchesDescending(const viskores::cont::ArrayHandle<T>& values,
+                            viskores::cont::ArrayHandle<viskores::Id>& sortedBranches,
+                            viskores::cont::ArrayHandle<T>& sortedValues)
+{
+  viskores::cont::Algorithm::Copy(values, sortedValues);
+  viskores::cont::Algorithm::Copy(viskores::cont::ArrayHandleIndex(values.GetNumberOfValues()),
+                                  sortedBranches);
+  viskores::cont::Algorithm::SortByKey(sortedValues, sortedBranches, viskores::SortGreater());
+}
+
+viskores::cont::ArrayHandle<viskores::Id> FirstBranches(
+  const viskores::cont::ArrayHandle<viskores::Id>& sortedBranches,
+  viskores::Id numBranches)
+{
+  numBranches =
+    std::max(viskores::Id{ 0 }, std::min(numBranches, sortedBranches.GetNumberOfValues()));
+  viskores::cont::ArrayHandle<viskores::Id> result;
+  viskores::cont::Algorithm::CopySubRange(sortedBranches, 0, numBranches, result);
+  return result;
+}
+
+// Number of leading values that are greater than the threshold. Binary search, as the
+// values are sorted in descending order.
+template <typename T>
+viskores::Id CountAbove(const viskores::cont::ArrayHandle<T>& sortedValues, T threshold)
+{
+  auto portal = sortedValues.ReadPortal();
+  auto begin = viskores::cont::ArrayPortalToIteratorBegin(portal);
+  auto end = viskores::cont::ArrayPortalToIteratorEnd(portal);
+  return static_cast<viskores::Id>(std::lower_bound(begin, end, threshold, std::greater<T>()) -
+                                   begin);
+}
+
+} // anonymous namespace
+
+VISKORES_CONT void BranchIndex::Build(
+  const viskores::cont::PartitionedDataSet& branchDecomposition)
+{
+  std::vector<viskores::Id> rootGRIds;
+  std::vector<viskores::Id> upperEndGRIds;
+  std::vector<viskores::Id> lowerEndGRIds;
+  std::vector<viskores::Id> volumes;
+  std::vector<viskores::Float64> persistences;
+
+  viskores::Id totalVolume = 0;
+  if (branchDecomposition.GetNumberOfPartitions() > 0)
+  {
+    viskores::Id3 pointDimensions, globalPointDimensions, globalPointIndexStart;
+    branchDecomposition.GetPartition(0)
+      .GetCellSet()
+      .CastAndCallForTypes<VISKORES_DEFAULT_CELL_SET_LIST_STRUCTURED>(
+        viskores::worklet::contourtree_augmented::GetLocalAndGlobalPointDimensions(),
+        pointDimensions,
+        globalPointDimensions,
+        globalPointIndexStart);
+    totalVolume = globalPointDimensions[0] * globalPointDimensions[1] * globalPointDimensions[2];
+  }
+
+  for (viskores::Id ds_no = 0; ds_no < branchDecomposition.GetNumberOfPartitions(); ++ds_no)
+  {
+    const viskores::cont::DataSet& ds = branchDecomposition.GetPartition(ds_no);
+    if (!ds.HasField("BranchRootGRId") || !ds.HasField("UpperEndValue"))
+    {
+      throw viskores::cont::ErrorBadValue(
+        "BranchIndex expects the output of DistributedBranchDecompositionFilter.");
+    }
+
+    // compute the volume of the branches in the same way as SelectTopVolumeBranchesFilter
+    int globalBlockId = static_cast<int>(
+      viskores::cont::ArrayGetValue(0,
+                                    ds.GetField("viskoresGlobalBlockId")
+                                      .GetData()
+                                      .AsArrayHandle<viskores::cont::ArrayHandle<viskores::Id>>()));
+    internal::SelectTopVolumeBranchesBlock block(ds_no, globalBlockId);
+    block.SortBranchByVolume(ds, totalVolume);
+
+    auto appendIds = [&](std::vector<viskores::Id>& values, const std::string& fieldName)
+    {
+      auto portal = ds.GetField(fieldName)
+                      .GetData()
+                      .AsArrayHandle<viskores::cont::ArrayHandle<viskores::Id>>()
+                      .ReadPortal();
+      for (viskores::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+      {
+        values.push_back(portal.Get(i));
+      }
+    };
+    appendIds(rootGRIds, "BranchRootGRId");
+    appendIds(upperEndGRIds, "UpperEndGlobalRegularIds");
+    appendIds(lowerEndGRIds, "LowerEndGlobalRegularIds");
+
+    auto volumePortal = block.TopVolumeData.BranchVolume.ReadPortal();
+    for (viskores::Id i = 0; i < volumePortal.GetNumberOfValues(); ++i)
+    {
+      volumes.push_back(volumePortal.Get(i));
+    }
+
+    auto appendPersistence = [&](const auto& upperEndValue)
+    {
+      using ValueType = typename std::decay_t<decltype(upperEndValue)>::ValueType;
+      auto upperPortal = upperEndValue.ReadPortal();
+      auto lowerPortal = ds.GetField("LowerEndValue")
+                           .GetData()
+                           .AsArrayHandle<viskores::cont::ArrayHandle<ValueType>>()
+                           .ReadPortal();
+      for (viskores::Id i = 0; i < upperPortal.GetNumberOfValues(); ++i)
+      {
+        persistences.push_back(static_cast<viskores::Float64>(upperPortal.Get(i)) -
+                               static_cast<viskores::Float64>(lowerPortal.Get(i)));
+      }
+    };
+    ds.GetField("UpperEndValue")
+      .GetData()
+      .CastAndCallForTypes<viskores::TypeListScalarAll, viskores::cont::StorageListBasic>(
+        appendPersistence);
+  }
+
+  AllGatherValues(rootGRIds);
+  AllGatherValues(upperEndGRIds);
+  AllGatherValues(lowerEndGRIds);
+  AllGatherValues(volumes);
+  AllGatherValues(persistences);
+
+  // a branch is known by all blocks that contain part of it, so we keep one copy per root
+  const viskores::Id nGathered = static_cast<viskores::Id>(rootGRIds.size());
+  viskores::cont::ArrayHandle<viskores::Id> sortedRootGRIds;
+  viskores::cont::Algorithm::Copy(
+    viskores::cont::make_ArrayHandle(rootGRIds, viskores::CopyFlag::Off), sortedRootGRIds);
+  viskores::cont::ArrayHandle<viskores::Id> gatheredIndex;
+  viskores::cont::Algorithm::Copy(viskores::cont::ArrayHandleIndex(nGathered), gatheredIndex);
+  viskores::cont::Algorithm::SortByKey(sortedRootGRIds, gatheredIndex);
+  viskores::cont::ArrayHandle<viskores::Id> uniqueIndex;
+  viskores::cont::Algorithm::ReduceByKey(
+    sortedRootGRIds, gatheredIndex, this->BranchRootGRIds, uniqueIndex, viskores::Minimum());
+
+  auto keepUnique = [&](const auto& values, auto& result)
+  {
+    viskores::cont::Algorithm::Copy(
+      viskores::cont::make_ArrayHandlePermutation(
+        uniqueIndex, viskores::cont::make_ArrayHandle(values, viskores::CopyFlag::Off)),
+      result);
+  };
+  keepUnique(upperEndGRIds, this->UpperEndGRIds);
+  keepUnique(lowerEndGRIds, this->LowerEndGRIds);
+  keepUnique(volumes, this->BranchVolume);
+  keepUnique(persistences, this->BranchPersistence);
+
+  SortBranchesDescending(this->BranchVolume, this->SortedByVolume, this->SortedVolume);
+  SortBranchesDescending(
+    this->BranchPersistence, this->SortedByPersistence, this->SortedPersistence);
+}
+
+VISKORES_CONT viskores::cont::ArrayHandle<viskores::Id> BranchIndex::GetTopVolumeBranches(
+  viskores::Id numBranches) const
+{
+  return FirstBranches(this->SortedByVolume, numBranches);
+}
+
+VISKORES_CONT viskores::cont::ArrayHandle<viskores::Id> BranchIndex::GetTopPersistenceBranches(
+  viskores::Id numBranches) const
+{
+  return FirstBranches(this->SortedByPersistence, numBranches);
+}
+
+VISKORES_CONT viskores::cont::ArrayHandle<viskores::Id> BranchIndex::GetBranchesAboveVolume(
+  viskores::Id threshold) const
+{
+  return FirstBranches(this->SortedByVolume, CountAbove(this->SortedVolume, threshold));
+}
+
+VISKORES_CONT viskores::cont::ArrayHandle<viskores::Id> BranchIndex::GetBranchesAbovePersistence(
+  viskores::Float64 threshold) const
+{
+  return FirstBranches(this->SortedByPersistence, CountAbove(this->SortedPersistence, threshold));
+}
+
+} // namespace scalar_topology
+} // namespace filter
+} // namespace viskores
@@ -0,0 +1,127 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_filter_scalar_topology_BranchIndex_h
+#define viskores_filter_scalar_topology_BranchIndex_h
+
+#include <viskores/cont/ArrayHandle.h>
+#include <viskores/cont/PartitionedDataSet.h>
+#include <viskores/filter/scalar_topology/viskores_filter_scalar_topology_export.h>
+
+namespace viskores
+{
+namespace filter
+{
+namespace scalar_topology
+{
+
+/// \brief Sorted index of the branches of a branch decomposition.
+///
+/// The index is built once from the output of `DistributedBranchDecompositionFilter`.
+/// It collects the branches of all blocks on all ranks, removes the duplicates, and
+/// sorts the branches by volume and by persistence. The volume is computed in the same
+/// way as in `SelectTopVolumeBranchesFilter`. The persistence is the difference of the
+/// values at the two ends of the branch.
+///
+/// A top-K query copies the first K entries of a sorted order. A threshold query finds
+/// the end of its range with a binary search and copies the range. So the cost of a
+/// query depends on the size of its answer and not on the number of branches. Changing
+/// K or the threshold does not require the branch decomposition to be recomputed.
+///
+/// The queries return indices into the arrays of the index (e.g., `GetBranchRootGRIds()`),
+/// which are ordered by the global regular id of the branch root. The main branch has
+/// the largest volume and the largest persistence, so it is the first result of all
+/// queries that include it.
+///
+/// Building the index is a collective operation when there is more than one rank.
+class VISKORES_FILTER_SCALAR_TOPOLOGY_EXPORT BranchIndex
+{
+public:
+  VISKORES_CONT BranchIndex() = default;
+
+  /// Build the index from the output of `DistributedBranchDecompositionFilter`.
+  VISKORES_CONT explicit BranchIndex(const viskores::cont::PartitionedDataSet& branchDecomposition)
+  {
+    this->Build(branchDecomposition);
+  }
+
+  /// Build the index from the output of `DistributedBranchDecompositionFilter`,
+  /// replacing the previous content.
+  VISKORES_CONT void Build(const viskores::cont::PartitionedDataSet& branchDecomposition);
+
+  VISKORES_CONT viskores::Id GetNumberOfBranches() const
+  {
+    return this->BranchRootGRIds.GetNumberOfValues();
+  }
+
+  /// Global regular id of the root of each branch
+  VISKORES_CONT const viskores::cont::ArrayHandle<viskores::Id>& GetBranchRootGRIds() const
+  {
+    return this->BranchRootGRIds;
+  }
+  /// Global regular id of the upper end of each branch
+  VISKORES_CONT const viskores::cont::ArrayHandle<viskores::Id>& GetUpperEndGRIds() const
+  {
+    return this->UpperEndGRIds;
+  }
+  /// Global regular id of the lower end of each branch
+  VISKORES_CONT const viskores::cont::ArrayHandle<viskores::Id>& GetLowerEndGRIds() const
+  {
+    return this->LowerEndGRIds;
+  }
+  /// Number of mesh vertices in the region of each branch
+  VISKORES_CONT const viskores::cont::ArrayHandle<viskores::Id>& GetBranchVolume() const
+  {
+    return this->BranchVolume;
+  }
+  /// Difference of the values at the upper and lower end of each branch
+  VISKORES_CONT const viskores::cont::ArrayHandle<viskores::Float64>& GetBranchPersistence() const
+  {
+    return this->BranchPersistence;
+  }
+
+  /// Indices of the (up to) `numBranches` branches with the largest volume, in descending
+  /// order of volume.
+  VISKORES_CONT viskores::cont::ArrayHandle<viskores::Id> GetTopVolumeBranches(
+    viskores::Id numBranches) const;
+
+  /// Indices of the (up to) `numBranches` branches with the largest persistence, in
+  /// descending order of persistence.
+  VISKORES_CONT viskores::cont::ArrayHandle<viskores::Id> GetTopPersistenceBranches(
+    viskores::Id numBranches) const;
+
+  /// Indices of the branches with a volume greater than `threshold`, in descending order
+  /// of volume.
+  VISKORES_CONT viskores::cont::ArrayHandle<viskores::Id> GetBranchesAboveVolume(
+    viskores::Id threshold) const;
+
+  /// Indices of the branches with a persistence greater than `threshold`, in descending
+  /// order of persistence.
+  VISKORES_CONT viskores::cont::ArrayHandle<viskores::Id> GetBranchesAbovePersistence(
+    viskores::Float64 threshold) const;
+
+private:
+  viskores::cont::ArrayHandle<viskores::Id> BranchRootGRIds;
+  viskores::cont::ArrayHandle<viskores::Id> UpperEndGRIds;
+  viskores::cont::ArrayHandle<viskores::Id> LowerEndGRIds;
+  viskores::cont::ArrayHandle<viskores::Id> BranchVolume;
+  viskores::cont::ArrayHandle<viskores::Float64> BranchPersistence;
+
+  // branch indices in descending order of volume/persistence and the sorted values,
+  // which are searched by the threshold queries
+  viskores::cont::ArrayHandle<viskores::Id> SortedByVolume;
+  viskores::cont::ArrayHandle<viskores::Id> SortedVolume;
+  viskores::cont::ArrayHandle<viskores::Id> SortedByPersistence;
+  viskores::cont::ArrayHandle<viskores::Float64> SortedPersistence;
+};
+
+} // namespace scalar_topology
+} // namespace filter
+} // namespace viskores
+
+#endif
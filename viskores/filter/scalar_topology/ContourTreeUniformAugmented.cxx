@@ -49,6 +49,8 @@
 //  Oliver Ruebel (LBNL)
 //==============================================================================
 
+#include <viskores/cont/CellSetExplicit.h>
+#include <viskores/cont/CellSetSingleType.h>
 #include <viskores/filter/scalar_topology/ContourTreeUniformAugmented.h>
 #include <viskores/filter/scalar_topology/internal/ComputeBlockIndices.h>
 #include <viskores/filter/scalar_topology/worklet/ContourTreeUniformAugmented.h>
@@ -132,10 +134,23 @@ viskores::cont::DataSet ContourTreeAugmented::DoExecute(const viskores::cont::Da
   }
 
   // Use the GetPointDimensions struct defined in the header to collect the meshSize information
+  // Unstructured cell sets are handled by the explicit mesh, which derives the neighbourhoods
+  // from the cells instead.
   viskores::Id3 meshSize;
   const auto& cells = input.GetCellSet();
-  cells.CastAndCallForTypes<VISKORES_DEFAULT_CELL_SET_LIST_STRUCTURED>(
-    viskores::worklet::contourtree_augmented::GetPointDimensions(), meshSize);
+  const bool isExplicit = cells.CanConvert<viskores::cont::CellSetExplicit<>>() ||
+    cells.CanConvert<viskores::cont::CellSetSingleType<>>();
+  if (!isExplicit)
+  {
+    cells.CastAndCallForTypes<VISKORES_DEFAULT_CELL_SET_LIST_STRUCTURED>(
+      viskores::worklet::contourtree_augmented::GetPointDimensions(), meshSize);
+  }
+  else if (this->MultiBlockTreeHelper &&
+           this->MultiBlockTreeHelper->GetGlobalNumberOfBlocks() > 1)
+  {
+    throw viskores::cont::ErrorFilterExecution(
+      "Contour tree on unstructured cell sets supports only a single block.");
+  }
 
   // TODO blockIndex needs to change if we have multiple blocks per MPI rank and DoExecute is called for multiple blocks
   std::size_t blockIndex = 0;
@@ -163,16 +178,27 @@ viskores::cont::DataSet ContourTreeAugmented::DoExecute(const viskores::cont::Da
     using T = typename std::decay_t<decltype(concrete)>::ValueType;
 
     viskores::worklet::ContourTreeAugmented worklet;
+    auto& contourTree = MultiBlockTreeHelper
+      ? MultiBlockTreeHelper->LocalContourTrees[blockIndex]
+      : this->ContourTreeData;
+    auto& sortOrder = MultiBlockTreeHelper ? MultiBlockTreeHelper->LocalSortOrders[blockIndex]
+                                           : this->MeshSortOrder;
     // Run the worklet
-    worklet.Run(concrete,
-                MultiBlockTreeHelper ? MultiBlockTreeHelper->LocalContourTrees[blockIndex]
-                                     : this->ContourTreeData,
-                MultiBlockTreeHelper ? MultiBlockTreeHelper->LocalSortOrders[blockIndex]
-                                     : this->MeshSortOrder,
-                this->NumIterations,
-                meshSize,
-                this->UseMarchingCubes,
-                compRegularStruct);
+    if (!isExplicit)
+    {
+      worklet.Run(concrete,
+                  contourTree,
+                  sortOrder,
+                  this->NumIterations,
+                  meshSize,
+                  this->UseMarchingCubes,
+                  compRegularStruct);
+    }
+    else
+    {
+      worklet.Run(
+        concrete, contourTree, sortOrder, this->NumIterations, cells, compRegularStruct);
+    }
 
     // If we run in parallel but with only one global block, then we need set our outputs correctly
     // here to match the expected behavior in parallel
@@ -90,6 +90,12 @@ namespace scalar_topology
 /// facilitate iso-value selection, enable localization of all vertices of a
 /// mesh in the tree among others.
 ///
+/// The filter also accepts single-block unstructured data given by a
+/// `viskores::cont::CellSetExplicit` or `viskores::cont::CellSetSingleType` whose
+/// cells are all triangles or all tetrahedra. The neighbours of each vertex are
+/// then derived from the cells that contain it, and boundary augmentation uses
+/// the vertices on the boundary of the mesh.
+///
 /// In addition to single-block computation, the filter also supports multi-block
 /// regular grids. The blocks are processed in parallel using DIY and then the
 /// tree are merged progressively using a binary-reduction scheme to compute the
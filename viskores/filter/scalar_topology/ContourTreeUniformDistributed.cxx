@@ -1145,12 +1145,49 @@ VISKORES_CONT void ContourTreeUniformDistributed::DoPostExecute(
                                          this->UseBoundaryExtremaOnly,
                                          this->TimingsLogLevel,
                                          this->TreeLogLevel);
-  viskoresdiy::reduce(master, assigner, partners, computeDistributedContourTreeFunctor);
+  if (this->UseAsynchronousFanIn)
+  {
+    master.iexchange(
+      [&](DistributedContourTreeBlockData* blockData,
+          const viskoresdiy::Master::ProxyWithLink& icp) -> bool
+      {
+        return computeDistributedContourTreeFunctor.ProcessAvailableRounds(
+          blockData, icp, partners, assigner);
+      });
+  }
+  else
+  {
+    viskoresdiy::reduce(master, assigner, partners, computeDistributedContourTreeFunctor);
+  }
   // Record timing for the actual reduction
   timingsStream << "    " << std::setw(38) << std::left << "Fan In Reduction"
                 << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
   timer.Start();
 
+  // Log the time and communication volume of each round of the fan in
+  master.foreach (
+    [&](DistributedContourTreeBlockData* blockData, const viskoresdiy::Master::ProxyWithLink&)
+    {
+      std::stringstream fanInRoundsStream;
+      fanInRoundsStream << "    " << std::setw(8) << std::left << "Round" << std::setw(14)
+                        << "Wait (s)" << std::setw(14) << "Compute (s)" << std::setw(18)
+                        << "Received (B)"
+                        << "Sent (B)" << std::endl;
+      for (const auto& roundStatistics : blockData->FanInStatistics)
+      {
+        fanInRoundsStream << "    " << std::setw(8) << std::left << roundStatistics.Round
+                          << std::setw(14) << roundStatistics.WaitSeconds << std::setw(14)
+                          << roundStatistics.ComputeSeconds << std::setw(18)
+                          << roundStatistics.BytesReceived << roundStatistics.BytesSent
+                          << std::endl;
+      }
+      VISKORES_LOG_S(this->TimingsLogLevel,
+                     std::endl
+                       << "    ------------ Fan In Rounds (block=" << blockData->LocalBlockNo
+                       << ")  ------------" << std::endl
+                       << fanInRoundsStream.str());
+    });
+
   // Be safe! that the Fan In is completed on all blocks and ranks
   comm.barrier();
 
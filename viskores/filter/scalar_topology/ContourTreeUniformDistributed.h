@@ -141,6 +141,16 @@ public:
 
   VISKORES_CONT bool GetSaveDotFiles() { return this->SaveDotFiles; }
 
+  /// Compute the fan in asynchronously. Each block merges the data of its partner in a round
+  /// as soon as it arrives instead of waiting until all exchanges of the round are complete,
+  /// so that the merges of different blocks overlap with the communication of others.
+  VISKORES_CONT void SetUseAsynchronousFanIn(bool useAsynchronousFanIn)
+  {
+    this->UseAsynchronousFanIn = useAsynchronousFanIn;
+  }
+
+  VISKORES_CONT bool GetUseAsynchronousFanIn() { return this->UseAsynchronousFanIn; }
+
 private:
   /// Intermediate results computed while executing the filter. These are only valid
   /// during a single invocation of DoExecutePartitions and are passed by reference
@@ -217,6 +227,9 @@ private:
   /// Save dot files for all tree computations
   bool SaveDotFiles = false;
 
+  /// Merge blocks in the fan in as soon as their data arrives rather than round by round
+  bool UseAsynchronousFanIn = false;
+
   /// Log level to be used for outputting timing information. Default is viskores::cont::LogLevel::Perf
   viskores::cont::LogLevel TimingsLogLevel = viskores::cont::LogLevel::Perf;
 
@@ -7,6 +7,7 @@
 //============================================================================
 
 #include "TestingContourTreeUniformDistributedFilter.h"
+#include <viskores/filter/scalar_topology/BranchIndex.h>
 
 #include <viskores/filter/scalar_topology/worklet/branch_decomposition/HierarchicalVolumetricBranchDecomposer.h>
 #include <viskores/filter/scalar_topology/worklet/contourtree_augmented/Types.h>
@@ -97,7 +98,8 @@ viskores::cont::PartitionedDataSet RunContourTreeDUniformDistributed(
   bool computeHierarchicalVolumetricBranchDecomposition,
   viskores::Id3& globalSize,
   bool passBlockIndices,
-  const viskores::Id presimplifyThreshold)
+  const viskores::Id presimplifyThreshold,
+  bool useAsynchronousFanIn)
 {
   // Get dimensions of data set
   viskores::cont::CastAndCall(
@@ -148,6 +150,7 @@ viskores::cont::PartitionedDataSet RunContourTreeDUniformDistributed(
   filter.SetUseMarchingCubes(useMarchingCubes);
   filter.SetUseBoundaryExtremaOnly(true);
   filter.SetAugmentHierarchicalTree(augmentHierarchicalTree);
+  filter.SetUseAsynchronousFanIn(useAsynchronousFanIn);
   filter.SetActiveField(fieldName);
   if (presimplifyThreshold > 0)
   {
@@ -228,17 +231,33 @@ viskores::cont::PartitionedDataSet RunContourTreeDUniformDistributed(
   }
 }
 
-void TestContourTreeUniformDistributed8x9(int nBlocks, int rank, int size)
+void TestContourTreeUniformDistributed8x9(int nBlocks,
+                                          int rank,
+                                          int size,
+                                          bool useAsynchronousFanIn)
 {
   if (rank == 0)
   {
     std::cout << "Testing ContourTreeUniformDistributed on 2D 8x9 data set divided into " << nBlocks
-              << " blocks." << std::endl;
+              << " blocks" << (useAsynchronousFanIn ? " with asynchronous fan in." : ".")
+              << std::endl;
   }
   viskores::cont::DataSet in_ds =
     viskores::cont::testing::MakeTestDataSet().Make2DUniformDataSet3();
+  viskores::Id3 globalSize;
   viskores::cont::PartitionedDataSet result =
-    RunContourTreeDUniformDistributed(in_ds, "pointvar", false, nBlocks, rank, size);
+    RunContourTreeDUniformDistributed(in_ds,
+                                      "pointvar",
+                                      false,
+                                      nBlocks,
+                                      rank,
+                                      size,
+                                      false,
+                                      false,
+                                      globalSize,
+                                      true,
+                                      0,
+                                      useAsynchronousFanIn);
 
   if (viskores::cont::EnvironmentTracker::GetCommunicator().rank() == 0)
   {
@@ -323,6 +342,9 @@ void TestContourTreeUniformDistributedBranchDecomposition8x9(int nBlocks, int ra
   iso_filter.SetMarchingCubes(false);
   auto iso_result = iso_filter.Execute(tp_result);
 
+  // the index gathers the branches from all ranks, so it is built on every rank
+  viskores::filter::scalar_topology::BranchIndex branchIndex(result);
+
   if (viskores::cont::EnvironmentTracker::GetCommunicator().rank() == 0)
   {
     using Edge = viskores::worklet::contourtree_distributed::Edge;
@@ -380,6 +402,54 @@ void TestContourTreeUniformDistributedBranchDecomposition8x9(int nBlocks, int ra
 
     std::cout << "Branch Decomposition: Results Match!" << std::endl;
 
+    // The branch index must agree with SelectTopVolumeBranchesFilter, which skips the main branch
+    VISKORES_TEST_ASSERT(branchIndex.GetNumberOfBranches() ==
+                           static_cast<viskores::Id>(expected.size()),
+                         "Wrong number of branches in branch index");
+    auto rootGRIds = branchIndex.GetBranchRootGRIds().ReadPortal();
+    auto volume = branchIndex.GetBranchVolume().ReadPortal();
+    auto persistence = branchIndex.GetBranchPersistence().ReadPortal();
+    auto topVolumeBranches = branchIndex.GetTopVolumeBranches(3);
+    auto topVolume = topVolumeBranches.ReadPortal();
+    VISKORES_TEST_ASSERT(topVolume.GetNumberOfValues() == 3, "Wrong number of top branches");
+    VISKORES_TEST_ASSERT(rootGRIds.Get(topVolume.Get(0)) == 61 && volume.Get(topVolume.Get(0)) > 6,
+                         "Main branch should come first");
+    VISKORES_TEST_ASSERT(rootGRIds.Get(topVolume.Get(1)) == 38 && volume.Get(topVolume.Get(1)) == 6,
+                         "Wrong second branch by volume");
+    VISKORES_TEST_ASSERT(rootGRIds.Get(topVolume.Get(2)) == 50 && volume.Get(topVolume.Get(2)) == 2,
+                         "Wrong third branch by volume");
+    VISKORES_TEST_ASSERT(branchIndex.GetTopVolumeBranches(100).GetNumberOfValues() ==
+                           branchIndex.GetNumberOfBranches(),
+                         "Top branch query should be clamped to the number of branches");
+    VISKORES_TEST_ASSERT(branchIndex.GetBranchesAboveVolume(2).GetNumberOfValues() == 2,
+                         "Wrong number of branches above volume threshold");
+    VISKORES_TEST_ASSERT(viskores::cont::ArrayGetValue(
+                           0, branchIndex.GetTopPersistenceBranches(1)) == topVolume.Get(0),
+                         "Main branch should have the largest persistence");
+
+    // compare the threshold queries against a search over all branches
+    for (viskores::Id branch = 0; branch < branchIndex.GetNumberOfBranches(); ++branch)
+    {
+      const viskores::Float64 threshold = persistence.Get(branch);
+      auto aboveBranches = branchIndex.GetBranchesAbovePersistence(threshold);
+      auto above = aboveBranches.ReadPortal();
+      viskores::Id expectedAbove = 0;
+      for (viskores::Id other = 0; other < branchIndex.GetNumberOfBranches(); ++other)
+      {
+        expectedAbove += (persistence.Get(other) > threshold) ? 1 : 0;
+      }
+      VISKORES_TEST_ASSERT(above.GetNumberOfValues() == expectedAbove,
+                           "Wrong number of branches above persistence threshold");
+      for (viskores::Id i = 0; i < above.GetNumberOfValues(); ++i)
+      {
+        VISKORES_TEST_ASSERT(persistence.Get(above.Get(i)) > threshold,
+                             "Branch below persistence threshold returned");
+        VISKORES_TEST_ASSERT(
+          i == 0 || persistence.Get(above.Get(i)) <= persistence.Get(above.Get(i - 1)),
+          "Branches not sorted by persistence");
+      }
+    }
+
     for (viskores::Id ds_no = 0; ds_no < result.GetNumberOfPartitions(); ++ds_no)
     {
       auto ds = tp_result.GetPartition(ds_no);
@@ -547,20 +617,36 @@ void TestContourTreeUniformDistributedBranchDecomposition8x9(int nBlocks, int ra
   }
 }
 
-void TestContourTreeUniformDistributed5x6x7(int nBlocks, bool marchingCubes, int rank, int size)
+void TestContourTreeUniformDistributed5x6x7(int nBlocks,
+                                            bool marchingCubes,
+                                            int rank,
+                                            int size,
+                                            bool useAsynchronousFanIn)
 {
   if (rank == 0)
   {
     std::cout << "Testing ContourTreeUniformDistributed with "
               << (marchingCubes ? "marching cubes" : "Freudenthal")
-              << " mesh connectivity on 3D 5x6x7 data set divided into " << nBlocks << " blocks."
-              << std::endl;
+              << " mesh connectivity on 3D 5x6x7 data set divided into " << nBlocks << " blocks"
+              << (useAsynchronousFanIn ? " with asynchronous fan in." : ".") << std::endl;
   }
 
   viskores::cont::DataSet in_ds =
     viskores::cont::testing::MakeTestDataSet().Make3DUniformDataSet4();
+  viskores::Id3 globalSize;
   viskores::cont::PartitionedDataSet result =
-    RunContourTreeDUniformDistributed(in_ds, "pointvar", marchingCubes, nBlocks, rank, size);
+    RunContourTreeDUniformDistributed(in_ds,
+                                      "pointvar",
+                                      marchingCubes,
+                                      nBlocks,
+                                      rank,
+                                      size,
+                                      false,
+                                      false,
+                                      globalSize,
+                                      true,
+                                      0,
+                                      useAsynchronousFanIn);
 
   if (rank == 0)
   {
@@ -194,7 +194,8 @@ viskores::cont::PartitionedDataSet RunContourTreeDUniformDistributed(
   bool computeHierarchicalVolumetricBranchDecomposition,
   viskores::Id3& globalSize,
   bool passBlockIndices = true,
-  const viskores::Id presimplifyThreshold = 0);
+  const viskores::Id presimplifyThreshold = 0,
+  bool useAsynchronousFanIn = false);
 
 inline viskores::cont::PartitionedDataSet RunContourTreeDUniformDistributed(
   const viskores::cont::DataSet& ds,
@@ -221,7 +222,10 @@ inline viskores::cont::PartitionedDataSet RunContourTreeDUniformDistributed(
                                            passBlockIndices);
 }
 
-void TestContourTreeUniformDistributed8x9(int nBlocks, int rank = 0, int size = 1);
+void TestContourTreeUniformDistributed8x9(int nBlocks,
+                                          int rank = 0,
+                                          int size = 1,
+                                          bool useAsynchronousFanIn = false);
 
 void TestContourTreeUniformDistributedBranchDecomposition8x9(int nBlocks,
                                                              int rank = 0,
@@ -230,7 +234,8 @@ void TestContourTreeUniformDistributedBranchDecomposition8x9(int nBlocks,
 void TestContourTreeUniformDistributed5x6x7(int nBlocks,
                                             bool marchingCubes,
                                             int rank = 0,
-                                            int size = 1);
+                                            int size = 1,
+                                            bool useAsynchronousFanIn = false);
 
 void TestContourTreeFile(std::string ds_filename,
                          std::string fieldName,
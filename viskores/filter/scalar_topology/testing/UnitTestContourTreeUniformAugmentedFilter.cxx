@@ -49,7 +49,9 @@
 //  Oliver Ruebel (LBNL)
 //==============================================================================
 
+#include <viskores/cont/CellSetSingleType.h>
 #include <viskores/cont/DataSetBuilderUniform.h>
+#include <viskores/cont/ErrorBadValue.h>
 #include <viskores/cont/testing/MakeTestDataSet.h>
 
 #include <viskores/filter/scalar_topology/ContourTreeUniformAugmented.h>
@@ -364,6 +366,72 @@ private:
     return filter;
   }
 
+  //
+  // Split the cells of a uniform data set into the triangles (2D) or tetrahedra (3D) of its
+  // Freudenthal triangulation and return them as an explicit data set with the same point field
+  //
+  viskores::cont::DataSet MakeFreudenthalExplicitDataSet(
+    const viskores::cont::DataSet& uniformDataSet) const
+  {
+    viskores::Id3 pointDims{ 1, 1, 1 };
+    uniformDataSet.GetCellSet().CastAndCallForTypes<VISKORES_DEFAULT_CELL_SET_LIST_STRUCTURED>(
+      [&](const auto& cellSet)
+      {
+        auto dims = cellSet.GetPointDimensions();
+        for (viskores::IdComponent d = 0; d < dims.GetNumberOfComponents(); ++d)
+        {
+          pointDims[d] = dims[d];
+        }
+      });
+    const bool is3D = pointDims[2] > 1;
+    auto pointId = [&](viskores::Id i, viskores::Id j, viskores::Id k)
+    { return (k * pointDims[1] + j) * pointDims[0] + i; };
+
+    std::vector<viskores::Id> connectivity;
+    for (viskores::Id k = 0; k < (is3D ? pointDims[2] - 1 : 1); ++k)
+      for (viskores::Id j = 0; j < pointDims[1] - 1; ++j)
+        for (viskores::Id i = 0; i < pointDims[0] - 1; ++i)
+        {
+          if (!is3D)
+          {
+            // both triangles share the diagonal from (i, j) to (i + 1, j + 1)
+            connectivity.insert(connectivity.end(),
+                                { pointId(i, j, 0),
+                                  pointId(i + 1, j, 0),
+                                  pointId(i + 1, j + 1, 0),
+                                  pointId(i, j, 0),
+                                  pointId(i + 1, j + 1, 0),
+                                  pointId(i, j + 1, 0) });
+            continue;
+          }
+          // one tetrahedron for each order of stepping along the axes from (i, j, k) to
+          // (i + 1, j + 1, k + 1)
+          const viskores::IdComponent axisOrders[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 },
+                                                           { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+          for (const auto& axisOrder : axisOrders)
+          {
+            viskores::Id3 corner{ i, j, k };
+            connectivity.push_back(pointId(corner[0], corner[1], corner[2]));
+            for (viskores::IdComponent axis : axisOrder)
+            {
+              ++corner[axis];
+              connectivity.push_back(pointId(corner[0], corner[1], corner[2]));
+            }
+          }
+        }
+
+    viskores::cont::CellSetSingleType<> cellSet;
+    cellSet.Fill(pointDims[0] * pointDims[1] * pointDims[2],
+                 is3D ? viskores::CELL_SHAPE_TETRA : viskores::CELL_SHAPE_TRIANGLE,
+                 is3D ? 4 : 3,
+                 viskores::cont::make_ArrayHandle(connectivity, viskores::CopyFlag::On));
+    viskores::cont::DataSet explicitDataSet;
+    explicitDataSet.SetCellSet(cellSet);
+    explicitDataSet.AddCoordinateSystem(uniformDataSet.GetCoordinateSystem());
+    explicitDataSet.AddField(uniformDataSet.GetField("pointvar"));
+    return explicitDataSet;
+  }
+
 public:
   //
   // Create a uniform 2D structured cell set as input with values for contours
@@ -701,6 +769,65 @@ public:
       "Wrong result for ContourTree filter");
   }
 
+  void TestContourTree_Explicit_Freudenthal(unsigned int computeRegularStructure,
+                                             unsigned int dataSetNo,
+                                             viskores::Id expectedNumberOfArcs) const
+  {
+    std::cout << "Testing ContourTree_Augmented explicit simplicial mesh. dataSetNo=" << dataSetNo
+              << " computeRegularStructure=" << computeRegularStructure << std::endl;
+
+    // The triangulated mesh must give the same tree as the Freudenthal triangulation of the grid
+    viskores::cont::DataSet uniformDataSet = (dataSetNo == 0)
+      ? MakeTestDataSet().Make2DUniformDataSet1()
+      : MakeTestDataSet().Make3DUniformDataSet1();
+    viskores::filter::scalar_topology::ContourTreeAugmented uniformFilter(false,
+                                                                          computeRegularStructure);
+    uniformFilter.SetActiveField("pointvar");
+    uniformFilter.Execute(uniformDataSet);
+    viskores::worklet::contourtree_augmented::EdgePairArray expectedSaddlePeak;
+    viskores::worklet::contourtree_augmented::ProcessContourTree::CollectSortedSuperarcs(
+      uniformFilter.GetContourTree(), uniformFilter.GetSortOrder(), expectedSaddlePeak);
+
+    viskores::filter::scalar_topology::ContourTreeAugmented filter(false, computeRegularStructure);
+    filter.SetActiveField("pointvar");
+    filter.Execute(MakeFreudenthalExplicitDataSet(uniformDataSet));
+    viskores::worklet::contourtree_augmented::EdgePairArray saddlePeak;
+    viskores::worklet::contourtree_augmented::ProcessContourTree::CollectSortedSuperarcs(
+      filter.GetContourTree(), filter.GetSortOrder(), saddlePeak);
+
+    // Print the contour tree we computed
+    std::cout << "Computed Contour Tree" << std::endl;
+    viskores::worklet::contourtree_augmented::PrintEdgePairArrayColumnLayout(saddlePeak);
+
+    VISKORES_TEST_ASSERT(test_equal(saddlePeak.GetNumberOfValues(), expectedNumberOfArcs),
+                         "Wrong result for ContourTree filter");
+    VISKORES_TEST_ASSERT(test_equal_ArrayHandles(saddlePeak, expectedSaddlePeak),
+                         "Wrong result for ContourTree filter");
+    if (computeRegularStructure == 1)
+    {
+      VISKORES_TEST_ASSERT(
+        test_equal_ArrayHandles(filter.GetContourTree().Arcs, uniformFilter.GetContourTree().Arcs),
+        "Wrong regular structure for ContourTree filter");
+    }
+  }
+
+  void TestContourTree_Explicit_NonSimplicial() const
+  {
+    std::cout << "Testing ContourTree_Augmented explicit mesh with hexahedra" << std::endl;
+    viskores::filter::scalar_topology::ContourTreeAugmented filter;
+    filter.SetActiveField("pointvar");
+    bool threw = false;
+    try
+    {
+      filter.Execute(MakeTestDataSet().Make3DExplicitDataSet5());
+    }
+    catch (const viskores::cont::ErrorBadValue&)
+    {
+      threw = true;
+    }
+    VISKORES_TEST_ASSERT(threw, "ContourTree filter accepted cells that are not simplices");
+  }
+
   void TestAnalysis() const
   {
     std::cout << "Testing ContourTree_Augmented With Analysis" << std::endl;
@@ -818,6 +945,15 @@ public:
     // Make sure the contour tree does not change when we use boundary augmentation
     this->TestContourTree_Mesh3D_MarchingCubes_NonCubicExtents(2);
 
+    // Test explicit triangle and tetrahedron meshes against their uniform counterparts
+    this->TestContourTree_Explicit_Freudenthal(1, 0, 7);
+    this->TestContourTree_Explicit_Freudenthal(0, 0, 7);
+    this->TestContourTree_Explicit_Freudenthal(2, 0, 7);
+    this->TestContourTree_Explicit_Freudenthal(1, 2, 9);
+    this->TestContourTree_Explicit_Freudenthal(0, 2, 9);
+    this->TestContourTree_Explicit_Freudenthal(2, 2, 9);
+    this->TestContourTree_Explicit_NonSimplicial();
+
     // Test Analysis
     this->TestAnalysis();
   }
@@ -774,6 +774,15 @@ public:
                          "Wrong result for ContourTree filter");
     VISKORES_TEST_ASSERT(test_equal(saddlePeak.WritePortal().Get(6), viskores::make_Pair(13, 19)),
                          "Wrong result for ContourTree filter");
+
+    // The sort order and sort indices of the mesh are held during all stages, so the peak must
+    // be at least their size
+    const viskores::UInt64 numVertices = static_cast<viskores::UInt64>(meshSize[0] * meshSize[1]);
+    VISKORES_TEST_ASSERT(contourTreeWorklet.PeakMemoryBytes >=
+                           2 * numVertices * sizeof(viskores::Id),
+                         "Peak memory not reported by ContourTree worklet");
+    VISKORES_TEST_ASSERT(contourTreeWorklet.MemoryLogString.find("Peak") != std::string::npos,
+                         "Memory log not recorded by ContourTree worklet");
   }
 
   void TestContourTree_Mesh3D_Freudenthal() const
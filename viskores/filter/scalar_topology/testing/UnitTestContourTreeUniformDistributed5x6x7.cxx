@@ -75,6 +75,8 @@ public:
     TestContourTreeUniformDistributed5x6x7(4, true);
     TestContourTreeUniformDistributed5x6x7(8, true);
     TestContourTreeUniformDistributed5x6x7(16, true);
+    TestContourTreeUniformDistributed5x6x7(8, false, 0, 1, true);
+    TestContourTreeUniformDistributed5x6x7(8, true, 0, 1, true);
 
     // test for contour tree presimplification on 3D 5x6x7 dataset
     TestContourTreePresimplification(
@@ -71,6 +71,8 @@ public:
     TestContourTreeUniformDistributed8x9(4);
     TestContourTreeUniformDistributed8x9(8);
     TestContourTreeUniformDistributed8x9(16);
+    TestContourTreeUniformDistributed8x9(4, 0, 1, true);
+    TestContourTreeUniformDistributed8x9(16, 0, 1, true);
   }
 };
 }
@@ -101,6 +101,9 @@ public:
     TestContourTreeUniformDistributed5x6x7(4, true, rank, size);
     TestContourTreeUniformDistributed5x6x7(8, true, rank, size);
     TestContourTreeUniformDistributed5x6x7(16, true, rank, size);
+    TestContourTreeUniformDistributed8x9(8, rank, size, true);
+    TestContourTreeUniformDistributed5x6x7(8, false, rank, size, true);
+    TestContourTreeUniformDistributed5x6x7(16, true, rank, size, true);
   }
 };
 }
@@ -53,6 +53,7 @@
 #define viskores_worklet_ContourTreeUniformAugmented_h
 
 
+#include <algorithm>
 #include <sstream>
 #include <utility>
 
@@ -63,6 +64,7 @@
 #include <viskores/cont/ArrayHandleCounting.h>
 #include <viskores/cont/Field.h>
 #include <viskores/cont/Timer.h>
+#include <viskores/cont/UnknownCellSet.h>
 #include <viskores/worklet/DispatcherMapField.h>
 #include <viskores/worklet/WorkletMapField.h>
 
@@ -84,7 +86,8 @@ namespace viskores
 namespace worklet
 {
 
-/// Compute the contour tree for 2d and 3d uniform grids and arbitrary topology graphs
+/// Compute the contour tree for 2d and 3d uniform grids, simplicial meshes given by explicit
+/// cells, and arbitrary topology graphs
 class ContourTreeAugmented
 {
 public:
@@ -98,6 +101,20 @@ public:
   /// Remember the results from our time-keeping so we can customize our logging
   std::string TimingsLogString;
 
+  /*!
+  * Log level to be used for outputting the memory held by the arrays of the computation after each
+  * stage. Default is viskores::cont::LogLevel::Perf. Use viskores::cont::LogLevel::Off to disable
+  * outputting the results via viskores logging here. The results are saved in the MemoryLogString
+  * variable so we can use it to do our own logging
+  */
+  viskores::cont::LogLevel MemoryLogLevel = viskores::cont::LogLevel::Perf;
+
+  /// Remember the results from our memory tracking so we can customize our logging
+  std::string MemoryLogString;
+
+  /// Largest number of bytes held by the arrays of the computation after any stage of the last run
+  viskores::UInt64 PeakMemoryBytes = 0;
+
 
   /*!
   * Run the contour tree to merge an existing set of contour trees
@@ -221,6 +238,40 @@ public:
     }
   }
 
+  /*!
+   * Run the contour tree analysis on a simplicial mesh given by explicit cells. The
+   * neighbourhood of each vertex is derived from the cells it belongs to, so the cells must
+   * either all be triangles or all be tetrahedra.
+   *
+   *  fieldArray   : The values of the mesh vertices
+   *  contourTree  : The output contour tree to be computed (output)
+   *  sortOrder    : The sort order for the mesh vertices (output)
+   *  nIterations  : The number of iterations used to compute the contour tree (output)
+   *  cellSet      : A CellSetExplicit or CellSetSingleType with the cells of the mesh
+   *  computeRegularStructure : 0=Off, 1=full augmentation with all vertices
+   *                            2=boundary augmentation using the vertices on the mesh boundary.
+   */
+  template <typename FieldType, typename StorageType>
+  void Run(const viskores::cont::ArrayHandle<FieldType, StorageType> fieldArray,
+           contourtree_augmented::ContourTree& contourTree,
+           contourtree_augmented::IdArrayType& sortOrder,
+           viskores::Id& nIterations,
+           const viskores::cont::UnknownCellSet& cellSet,
+           unsigned int computeRegularStructure = 1)
+  {
+    using namespace viskores::worklet::contourtree_augmented;
+    // Build the mesh and its vertex neighbourhoods
+    DataSetMeshExplicit mesh(cellSet);
+    // Run the contour tree on the mesh
+    RunContourTree(fieldArray,
+                   contourTree,
+                   sortOrder,
+                   nIterations,
+                   mesh,
+                   computeRegularStructure,
+                   mesh.GetMeshBoundaryExecutionObject());
+  }
+
 
 private:
   /*!
@@ -268,10 +319,24 @@ private:
     timer.Start();
     std::stringstream timingsStream; // Use a string stream to log in one message
 
+    // Track the memory held by the arrays of the computation after each stage. The input field
+    // and the mesh structure (beyond the sort) are owned by the caller and are not counted.
+    std::stringstream memoryStream;
+    this->PeakMemoryBytes = 0;
+    auto recordMemory = [&](const char* stage, viskores::UInt64 numberOfBytes)
+    {
+      numberOfBytes += ArrayHandlesNumberOfBytes(mesh.SortOrder, mesh.SortIndices);
+      this->PeakMemoryBytes = std::max(this->PeakMemoryBytes, numberOfBytes);
+      memoryStream << "    " << std::setw(38) << std::left << stage << ": "
+                   << static_cast<viskores::Float64>(numberOfBytes) / (1024. * 1024.) << " MiB"
+                   << std::endl;
+    };
+
     // Sort the mesh data
     mesh.SortData(fieldArray);
     timingsStream << "    " << std::setw(38) << std::left << "Sort Data"
                   << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
+    recordMemory("Sort Data", 0);
     timer.Start();
 
     // Stage 3: Assign every mesh vertex to a peak
@@ -280,14 +345,20 @@ private:
     extrema.BuildRegularChains(true);
     timingsStream << "    " << std::setw(38) << std::left << "Join Tree Regular Chains"
                   << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
+    recordMemory("Join Tree Regular Chains", extrema.GetNumberOfBytes());
     timer.Start();
 
     // Stage 4: Identify join saddles & construct Active Join Graph
-    MergeTree joinTree(mesh.NumVertices, true);
+    // The join tree is allocated after the active graph is set up, so that its arrays are not
+    // held while the per-vertex temporaries of the initialisation are alive
     ActiveGraph joinGraph(true);
     joinGraph.Initialise(mesh, extrema);
+    MergeTree joinTree(mesh.NumVertices, true);
     timingsStream << "    " << std::setw(38) << std::left << "Join Tree Initialize Active Graph"
                   << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
+    recordMemory("Join Tree Initialize Active Graph",
+                 extrema.GetNumberOfBytes() + joinGraph.GetNumberOfBytes() +
+                   joinTree.GetNumberOfBytes());
 
 #ifdef DEBUG_PRINT
     joinGraph.DebugPrint("Active Graph Instantiated", __FILE__, __LINE__);
@@ -298,6 +369,7 @@ private:
     joinGraph.MakeMergeTree(joinTree, extrema);
     timingsStream << "    " << std::setw(38) << std::left << "Join Tree Compute"
                   << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
+    recordMemory("Join Tree Compute", extrema.GetNumberOfBytes() + joinTree.GetNumberOfBytes());
 #ifdef DEBUG_PRINT
     joinTree.DebugPrint("Join tree Computed", __FILE__, __LINE__);
     joinTree.DebugPrintTree("Join tree", __FILE__, __LINE__, mesh);
@@ -309,14 +381,19 @@ private:
     extrema.BuildRegularChains(false);
     timingsStream << "    " << std::setw(38) << std::left << "Split Tree Regular Chains"
                   << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
+    recordMemory("Split Tree Regular Chains",
+                 extrema.GetNumberOfBytes() + joinTree.GetNumberOfBytes());
     timer.Start();
 
     // Stage 7:     Identify split saddles & construct Active Split Graph
-    MergeTree splitTree(mesh.NumVertices, false);
     ActiveGraph splitGraph(false);
     splitGraph.Initialise(mesh, extrema);
+    MergeTree splitTree(mesh.NumVertices, false);
     timingsStream << "    " << std::setw(38) << std::left << "Split Tree Initialize Active Graph"
                   << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
+    recordMemory("Split Tree Initialize Active Graph",
+                 extrema.GetNumberOfBytes() + joinTree.GetNumberOfBytes() +
+                   splitGraph.GetNumberOfBytes() + splitTree.GetNumberOfBytes());
 #ifdef DEBUG_PRINT
     splitGraph.DebugPrint("Active Graph Instantiated", __FILE__, __LINE__);
 #endif
@@ -326,6 +403,9 @@ private:
     splitGraph.MakeMergeTree(splitTree, extrema);
     timingsStream << "    " << std::setw(38) << std::left << "Split Tree Compute"
                   << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
+    recordMemory("Split Tree Compute",
+                 extrema.GetNumberOfBytes() + joinTree.GetNumberOfBytes() +
+                   splitTree.GetNumberOfBytes());
 #ifdef DEBUG_PRINT
     splitTree.DebugPrint("Split tree Computed", __FILE__, __LINE__);
     // Debug split and join tree
@@ -342,6 +422,13 @@ private:
     timingsStream << "    " << std::setw(38) << std::left
                   << "Contour Tree Hyper and Super Structure"
                   << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
+    recordMemory("Contour Tree Hyper and Super Structure",
+                 extrema.GetNumberOfBytes() + joinTree.GetNumberOfBytes() +
+                   splitTree.GetNumberOfBytes() + contourTree.GetNumberOfBytes());
+    // The regular structure only needs the contour tree and the extrema, so we release the
+    // merge trees before allocating its per-vertex arrays
+    joinTree.ReleaseResources();
+    splitTree.ReleaseResources();
     timer.Start();
 
     // 9.2 Then we compute the regular structure
@@ -358,6 +445,12 @@ private:
                     << "Contour Tree Boundary Regular Structure"
                     << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
     }
+    if (computeRegularStructure != 0)
+    {
+      recordMemory("Contour Tree Regular Structure",
+                   extrema.GetNumberOfBytes() + contourTree.GetNumberOfBytes());
+    }
+    extrema.ReleaseResources();
     timer.Start();
 
     // Collect the output data
@@ -382,6 +475,21 @@ private:
           << std::endl
           << this->TimingsLogString);
     }
+
+    // Log the memory held after each stage in one coherent log entry
+    memoryStream << "    " << std::setw(38) << std::left << "Peak"
+                 << ": " << static_cast<viskores::Float64>(this->PeakMemoryBytes) / (1024. * 1024.)
+                 << " MiB" << std::endl;
+    this->MemoryLogString = memoryStream.str();
+    if (this->MemoryLogLevel != viskores::cont::LogLevel::Off)
+    {
+      VISKORES_LOG_S(
+        this->MemoryLogLevel,
+        std::endl
+          << "    ------------------- Contour Tree Worklet Memory -----------------------"
+          << std::endl
+          << this->MemoryLogString);
+    }
   }
 };
 
@@ -220,6 +220,9 @@ public:
   // releases temporary arrays
   void ReleaseTemporaryArrays();
 
+  // number of bytes held by the arrays of the active graph
+  viskores::UInt64 GetNumberOfBytes() const;
+
   // prints the contents of the active graph in a standard format
   void DebugPrint(const char* message, const char* fileName, long lineNum);
 
@@ -255,7 +258,9 @@ inline void ActiveGraph::Initialise(Mesh& mesh, const MeshExtrema& meshExtrema)
   // Neighbourhood mask (one bit set per connected component in neighbourhood
   IdArrayType neighbourhoodMasks;
   neighbourhoodMasks.Allocate(mesh.NumVertices);
-  IdArrayType outDegrees; // TODO Should we change this to an unsigned type
+  // The neighbourhood masks have one bit per neighbour, so the outdegree is at most 64 and
+  // a byte per vertex is sufficient to store it
+  viskores::cont::ArrayHandle<viskores::UInt8> outDegrees;
   outDegrees.Allocate(mesh.NumVertices);
 
   // Initialize the nerighborhoodMasks and outDegrees arrays
@@ -288,8 +293,9 @@ inline void ActiveGraph::Initialise(Mesh& mesh, const MeshExtrema& meshExtrema)
     */
   IdArrayType inverseIndex;
   OneIfCritical oneIfCriticalFunctor;
-  auto oneIfCriticalArrayHandle = viskores::cont::ArrayHandleTransform<IdArrayType, OneIfCritical>(
-    outDegrees, oneIfCriticalFunctor);
+  auto oneIfCriticalArrayHandle =
+    viskores::cont::ArrayHandleTransform<viskores::cont::ArrayHandle<viskores::UInt8>,
+                                         OneIfCritical>(outDegrees, oneIfCriticalFunctor);
   viskores::cont::Algorithm::ScanExclusive(oneIfCriticalArrayHandle, inverseIndex);
 
   // now we can compute how many critical points we carry forward
@@ -322,6 +328,9 @@ inline void ActiveGraph::Initialise(Mesh& mesh, const MeshExtrema& meshExtrema)
                this->Outdegree,
                this->Hyperarcs,
                this->ActiveVertices);
+  // the per-vertex outdegrees and inverse index are not needed anymore
+  outDegrees.ReleaseResources();
+  inverseIndex.ReleaseResources();
 
   // now we need to compute the FirstEdge array from the outDegrees
   this->FirstEdge.Allocate(nCriticalPoints);
@@ -350,6 +359,7 @@ inline void ActiveGraph::Initialise(Mesh& mesh, const MeshExtrema& meshExtrema)
                this->EdgeNear,
                this->EdgeFar,
                this->ActiveEdges);
+  neighbourhoodMasks.ReleaseResources();
 
   // now we have to go through and set the far ends of the new edges using the
   // inverse index array
@@ -361,6 +371,7 @@ inline void ActiveGraph::Initialise(Mesh& mesh, const MeshExtrema& meshExtrema)
   // then we loop through the active vertices to convert their indices to active graph indices
   active_graph_inc_ns::InitializeHyperarcsFromActiveIndices initHyperarcsWorklet;
   this->Invoke(initHyperarcsWorklet, this->Hyperarcs, activeIndices);
+  activeIndices.ReleaseResources();
 
   // finally, allocate and initialise the edgeSorter array
   this->EdgeSorter.Allocate(this->ActiveEdges.GetNumberOfValues());
@@ -915,6 +926,23 @@ inline void ActiveGraph::ReleaseTemporaryArrays()
 }
 
 
+// number of bytes held by the arrays of the active graph
+inline viskores::UInt64 ActiveGraph::GetNumberOfBytes() const
+{
+  return ArrayHandlesNumberOfBytes(this->GlobalIndex,
+                                   this->Hyperarcs,
+                                   this->FirstEdge,
+                                   this->Outdegree,
+                                   this->EdgeFar,
+                                   this->EdgeNear,
+                                   this->ActiveVertices,
+                                   this->ActiveEdges,
+                                   this->EdgeSorter,
+                                   this->SuperID,
+                                   this->HyperID);
+}
+
+
 // prints the contents of the active graph in a standard format
 inline void ActiveGraph::DebugPrint(const char* message, const char* fileName, long lineNum)
 { // DebugPrint()
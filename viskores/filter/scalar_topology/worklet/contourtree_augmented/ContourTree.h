@@ -165,6 +165,9 @@ public:
   // initialises contour tree arrays - rest is done by another class
   inline void Init(viskores::Id dataSize);
 
+  // number of bytes held by the arrays of the contour tree
+  inline viskores::UInt64 GetNumberOfBytes() const;
+
   // debug routine
   inline std::string DebugPrint(const char* message, const char* fileName, long lineNum) const;
 
@@ -200,6 +203,25 @@ inline void ContourTree::Init(viskores::Id dataSize)
 } // Init()
 
 
+// number of bytes held by the arrays of the contour tree
+inline viskores::UInt64 ContourTree::GetNumberOfBytes() const
+{ // GetNumberOfBytes()
+  return ArrayHandlesNumberOfBytes(this->Nodes,
+                                   this->Arcs,
+                                   this->Superparents,
+                                   this->Supernodes,
+                                   this->Superarcs,
+                                   this->Augmentnodes,
+                                   this->Augmentarcs,
+                                   this->Hyperparents,
+                                   this->WhenTransferred,
+                                   this->Hypernodes,
+                                   this->Hyperarcs,
+                                   this->FirstSupernodePerIteration,
+                                   this->FirstHypernodePerIteration);
+} // GetNumberOfBytes()
+
+
 inline void ContourTree::PrintContent(std::ostream& outStream /*= std::cout*/) const
 {
   PrintHeader(this->Arcs.GetNumberOfValues(), outStream);
@@ -451,6 +451,13 @@ inline void ContourTreeMaker::ComputeHyperAndSuperStructure()
 #ifdef DEBUG_PRINT
   DebugPrint("Contour Tree Super Structure Constructed", __FILE__, __LINE__);
 #endif
+
+  // the degrees and augmented superarcs are only needed to build the superstructure
+  this->Updegree.ReleaseResources();
+  this->Downdegree.ReleaseResources();
+  this->AugmentedJoinSuperarcs.ReleaseResources();
+  this->AugmentedSplitSuperarcs.ReleaseResources();
+  this->ActiveSupernodes.ReleaseResources();
 } // ComputeHyperAndSuperStructure()
 
 
@@ -358,5 +358,6 @@ inline void DataSetMesh::DebugPrintValues(const viskores::cont::ArrayHandle<T, S
 #include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/DataSetMeshTriangulation2DFreudenthal.h>
 #include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/DataSetMeshTriangulation3DFreudenthal.h>
 #include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/DataSetMeshTriangulation3DMarchingCubes.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/DataSetMeshExplicit.h>
 
 #endif
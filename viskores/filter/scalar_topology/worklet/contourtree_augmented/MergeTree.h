@@ -121,6 +121,12 @@ public:
   // creates merge tree (empty)
   MergeTree(viskores::Id meshSize, bool isJoinTree);
 
+  // number of bytes held by the arrays of the tree
+  viskores::UInt64 GetNumberOfBytes() const;
+
+  // releases all arrays once the tree is no longer needed
+  void ReleaseResources();
+
   // debug routine
   void DebugPrint(const char* message, const char* fileName, long lineNum);
 
@@ -164,6 +170,34 @@ inline MergeTree::MergeTree(viskores::Id meshSize, bool isJoinTree)
 } // MergeTree()
 
 
+// number of bytes held by the arrays of the tree
+inline viskores::UInt64 MergeTree::GetNumberOfBytes() const
+{ // GetNumberOfBytes()
+  return ArrayHandlesNumberOfBytes(this->Arcs,
+                                   this->Superparents,
+                                   this->Supernodes,
+                                   this->Superarcs,
+                                   this->Hyperparents,
+                                   this->Hypernodes,
+                                   this->Hyperarcs,
+                                   this->FirstSuperchild);
+} // GetNumberOfBytes()
+
+
+// releases all arrays once the tree is no longer needed
+inline void MergeTree::ReleaseResources()
+{ // ReleaseResources()
+  this->Arcs.ReleaseResources();
+  this->Superparents.ReleaseResources();
+  this->Supernodes.ReleaseResources();
+  this->Superarcs.ReleaseResources();
+  this->Hyperparents.ReleaseResources();
+  this->Hypernodes.ReleaseResources();
+  this->Hyperarcs.ReleaseResources();
+  this->FirstSuperchild.ReleaseResources();
+} // ReleaseResources()
+
+
 // debug routine
 inline void MergeTree::DebugPrint(const char* message, const char* fileName, long lineNum)
 { // DebugPrint()
@@ -97,6 +97,21 @@ public:
   VISKORES_CONT
   void BuildRegularChains(bool isMaximal);
 
+  // number of bytes held by the peaks & pits
+  VISKORES_CONT
+  viskores::UInt64 GetNumberOfBytes() const
+  {
+    return ArrayHandlesNumberOfBytes(this->Peaks, this->Pits);
+  }
+
+  // releases the peaks & pits once they are no longer needed
+  VISKORES_CONT
+  void ReleaseResources()
+  {
+    this->Peaks.ReleaseResources();
+    this->Pits.ReleaseResources();
+  }
+
   // debug routine
   VISKORES_CONT
   void DebugPrint(const char* message, const char* fileName, long lineNum);
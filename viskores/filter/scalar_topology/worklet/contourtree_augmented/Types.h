@@ -183,6 +183,23 @@ VISKORES_CONT inline void AssertArrayHandleNoFlagsSet(
 #endif
 }
 
+// Helper function: Number of bytes held by the buffers of a set of arrays. Implicit arrays
+// (e.g., ArrayHandleIndex) hold no values and do not count.
+template <typename... ArrayHandleTypes>
+VISKORES_CONT inline viskores::UInt64 ArrayHandlesNumberOfBytes(const ArrayHandleTypes&... arrays)
+{
+  viskores::UInt64 numberOfBytes = 0;
+  auto addBuffers = [&numberOfBytes](const std::vector<viskores::cont::internal::Buffer>& buffers)
+  {
+    for (const auto& buffer : buffers)
+    {
+      numberOfBytes += static_cast<viskores::UInt64>(buffer.GetNumberOfBytes());
+    }
+  };
+  (addBuffers(arrays.GetBuffers()), ...);
+  return numberOfBytes;
+}
+
 
 template <typename T>
 struct MaskedIndexFunctor
@@ -85,10 +85,10 @@ public:
   VISKORES_EXEC_CONT
   InitializeActiveGraphVertices() {}
 
-  template <typename InFieldPortalType, typename OutFieldPortalType>
+  template <typename InDegreePortalType, typename InFieldPortalType, typename OutFieldPortalType>
   VISKORES_EXEC void operator()(
     const viskores::Id& sortIndex,
-    const InFieldPortalType& outDegrees,
+    const InDegreePortalType& outDegrees,
     const InFieldPortalType& inverseIndex,
     const InFieldPortalType& extrema,
     const viskores::Id /*vertexIndex*/, // FIXME: Remove unused parameter?
@@ -106,7 +106,7 @@ public:
       // add the vertex to the active graph
       globalIndex.Set(activeIndex, sortIndex);
       // set the first edge and outDegrees for it
-      outdegree.Set(activeIndex, outDegrees.Get(sortIndex));
+      outdegree.Set(activeIndex, static_cast<viskores::Id>(outDegrees.Get(sortIndex)));
       // store the vertex as a merge tree ID, remembering to suppress flags
       hyperarcs.Set(activeIndex, MaskedIndex(extrema.Get(sortIndex)));
       // and store the vertex in the active vertex array
@@ -90,16 +90,18 @@ public:
   {
   }
 
-  template <typename MeshStructureType, typename OutFieldPortalType>
+  template <typename MeshStructureType, typename OutFieldPortalType, typename OutDegreePortalType>
   VISKORES_EXEC void operator()(const viskores::Id& sortIndex,
                                 const MeshStructureType& meshStructure,
                                 const OutFieldPortalType& neighbourhoodMasksPortal,
-                                const OutFieldPortalType& outDegreesPortal) const
+                                const OutDegreePortalType& outDegreesPortal) const
   {
     const viskores::Pair<viskores::Id, viskores::Id>& maskAndDegree =
       meshStructure.GetNeighbourComponentsMaskAndDegree(sortIndex, this->IsJoinGraph);
     neighbourhoodMasksPortal.Set(sortIndex, maskAndDegree.first);
-    outDegreesPortal.Set(sortIndex, maskAndDegree.second);
+    // the outdegree may be stored in a compact integer type
+    using OutDegreeType = typename OutDegreePortalType::ValueType;
+    outDegreesPortal.Set(sortIndex, static_cast<OutDegreeType>(maskAndDegree.second));
 
     // In serial this worklet implements the following operation
     // for (indexType sortIndex = 0; sortIndex < mesh.GetNumberOfVertices(); ++sortIndex)
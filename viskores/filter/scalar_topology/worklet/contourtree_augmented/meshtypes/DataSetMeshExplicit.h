@@ -0,0 +1,270 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+// Copyright (c) 2018, The Regents of the University of California, through
+// Lawrence Berkeley National Laboratory (subject to receipt of any required approvals
+// from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// (1) Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//
+// (2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// (3) Neither the name of the University of California, Lawrence Berkeley National
+//     Laboratory, U.S. Dept. of Energy nor the names of its contributors may be
+//     used to endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+// OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//=============================================================================
+//
+//  This code is an extension of the algorithm presented in the paper:
+//  Parallel Peak Pruning for Scalable SMP Contour Tree Computation.
+//  Hamish Carr, Gunther Weber, Christopher Sewell, and James Ahrens.
+//  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
+//  (LDAV), October 2016, Baltimore, Maryland.
+//
+//  The PPP2 algorithm and software were jointly developed by
+//  Hamish Carr (University of Leeds), Gunther H. Weber (LBNL), and
+//  Oliver Ruebel (LBNL)
+//==============================================================================
+
+
+#ifndef viskores_worklet_contourtree_augmented_data_set_mesh_explicit_h
+#define viskores_worklet_contourtree_augmented_data_set_mesh_explicit_h
+
+#include <viskores/BinaryOperators.h>
+#include <viskores/CellShape.h>
+#include <viskores/cont/Algorithm.h>
+#include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/ArrayGetValues.h>
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/ArrayHandleView.h>
+#include <viskores/cont/CellSetExplicit.h>
+#include <viskores/cont/CellSetSingleType.h>
+#include <viskores/cont/ErrorBadValue.h>
+#include <viskores/cont/ExecutionObjectBase.h>
+#include <viskores/cont/Invoker.h>
+#include <viskores/cont/UnknownCellSet.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/DataSetMesh.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/MeshStructureExplicit.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/explicitmesh/CountVertexNeighboursWorklet.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/explicitmesh/FillVertexNeighboursWorklet.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/explicitmesh/MarkBoundaryVerticesWorklet.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/mesh_boundary/MeshBoundaryExplicit.h>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace contourtree_augmented
+{
+
+/// Class representing a simplicial mesh given by explicit cells (triangles or tetrahedra) for
+/// contour tree computation. The neighbours of a vertex are the vertices it shares a cell with,
+/// which are found through the reverse (point to cell) connectivity of the cell set.
+class DataSetMeshExplicit
+  : public DataSetMesh
+  , public viskores::cont::ExecutionObjectBase
+{ // class DataSetMeshExplicit
+public:
+  /// The neighbourhood masks have one bit per neighbour, which limits the number of neighbours
+  static constexpr int MAX_OUTDEGREE = explicit_mesh_inc::MAX_NEIGHBOURS;
+
+  //Mesh dependent helper functions
+  void SetPrepareForExecutionBehavior(bool getMax);
+
+  /// Prepare mesh for use in Viskores worklets. This function creates a MeshStructureExplicit
+  /// ExecutionObject that implements relevant mesh functions on the device.
+  MeshStructureExplicit PrepareForExecution(viskores::cont::DeviceAdapterId device,
+                                            viskores::cont::Token& token) const;
+
+  /// Constructor
+  /// @param cellSet A CellSetExplicit or CellSetSingleType whose cells are either all triangles
+  ///                or all tetrahedra. Throws viskores::cont::ErrorBadValue for other cell sets
+  ///                and when a vertex has more than MAX_OUTDEGREE neighbours.
+  DataSetMeshExplicit(const viskores::cont::UnknownCellSet& cellSet);
+
+  /// Helper function to create a boundary execution object for the mesh. The boundary
+  /// consists of the vertices on facets (edges or triangles) that belong to a single cell.
+  MeshBoundaryExplicitExec GetMeshBoundaryExecutionObject() const;
+
+  /// Get the largest number of neighbours of any vertex
+  viskores::Id GetMaxNumberOfNeighbours() const { return this->MaxNeighbours; }
+
+private:
+  bool UseGetMax; // Define the behavior ofr the PrepareForExecution function
+  viskores::Id MaxNeighbours;
+  // Cell to point and point to cell connectivity of the cell set
+  IdArrayType CellConnectivity;
+  IdArrayType CellOffsets;
+  IdArrayType PointCells;
+  IdArrayType PointCellOffsets;
+  // Neighbours of each vertex, sorted by mesh index
+  IdArrayType NeighbourConnectivity;
+  IdArrayType NeighbourOffsets;
+  // Whether a vertex lies on the boundary of the mesh
+  viskores::cont::ArrayHandle<bool> BoundaryFlags;
+
+  template <typename ShapesStorage, typename ConnectivityStorage, typename OffsetsStorage>
+  void Initialize(
+    const viskores::cont::CellSetExplicit<ShapesStorage, ConnectivityStorage, OffsetsStorage>&
+      cellSet);
+}; // class DataSetMeshExplicit
+
+// creates input mesh
+inline DataSetMeshExplicit::DataSetMeshExplicit(const viskores::cont::UnknownCellSet& cellSet)
+  : DataSetMesh(viskores::Id3{ cellSet.GetNumberOfPoints(), 1, 1 })
+  , UseGetMax(false)
+  , MaxNeighbours(0)
+{
+  if (cellSet.CanConvert<viskores::cont::CellSetSingleType<>>())
+  {
+    this->Initialize(cellSet.AsCellSet<viskores::cont::CellSetSingleType<>>());
+  }
+  else if (cellSet.CanConvert<viskores::cont::CellSetExplicit<>>())
+  {
+    this->Initialize(cellSet.AsCellSet<viskores::cont::CellSetExplicit<>>());
+  }
+  else
+  {
+    throw viskores::cont::ErrorBadValue(
+      "Contour tree requires a structured cell set, CellSetExplicit, or CellSetSingleType.");
+  }
+}
+
+template <typename ShapesStorage, typename ConnectivityStorage, typename OffsetsStorage>
+inline void DataSetMeshExplicit::Initialize(
+  const viskores::cont::CellSetExplicit<ShapesStorage, ConnectivityStorage, OffsetsStorage>&
+    cellSet)
+{
+  using viskores::TopologyElementTagCell;
+  using viskores::TopologyElementTagPoint;
+  viskores::cont::Invoker invoke;
+
+  // The link of a vertex is only given by its neighbours for simplices
+  if (cellSet.GetNumberOfCells() > 0)
+  {
+    const auto shapeRange = viskores::cont::Algorithm::Reduce(
+      cellSet.GetShapesArray(TopologyElementTagCell{}, TopologyElementTagPoint{}),
+      viskores::Vec<viskores::UInt8, 2>(viskores::UInt8{ 255 }, viskores::UInt8{ 0 }),
+      viskores::MinAndMax<viskores::UInt8>());
+    if (shapeRange[0] != shapeRange[1] ||
+        (shapeRange[0] != viskores::CELL_SHAPE_TRIANGLE &&
+         shapeRange[0] != viskores::CELL_SHAPE_TETRA))
+    {
+      throw viskores::cont::ErrorBadValue(
+        "Contour tree on explicit cells requires all cells to be triangles or all to be "
+        "tetrahedra.");
+    }
+  }
+
+  viskores::cont::ArrayCopy(
+    cellSet.GetConnectivityArray(TopologyElementTagCell{}, TopologyElementTagPoint{}),
+    this->CellConnectivity);
+  viskores::cont::ArrayCopy(
+    cellSet.GetOffsetsArray(TopologyElementTagCell{}, TopologyElementTagPoint{}),
+    this->CellOffsets);
+  viskores::cont::ArrayCopy(
+    cellSet.GetConnectivityArray(TopologyElementTagPoint{}, TopologyElementTagCell{}),
+    this->PointCells);
+  viskores::cont::ArrayCopy(
+    cellSet.GetOffsetsArray(TopologyElementTagPoint{}, TopologyElementTagCell{}),
+    this->PointCellOffsets);
+
+  // Count the neighbours of each vertex and turn the counts into offsets
+  viskores::cont::ArrayHandleIndex meshIndices(this->NumVertices);
+  IdArrayType numNeighbours;
+  invoke(explicit_mesh_inc::CountVertexNeighboursWorklet{},
+         meshIndices,
+         this->CellConnectivity,
+         this->CellOffsets,
+         this->PointCells,
+         this->PointCellOffsets,
+         numNeighbours);
+  this->MaxNeighbours = (this->NumVertices > 0)
+    ? viskores::cont::Algorithm::Reduce(numNeighbours, viskores::Id{ 0 }, viskores::Maximum())
+    : 0;
+  if (this->MaxNeighbours > MAX_OUTDEGREE)
+  {
+    throw viskores::cont::ErrorBadValue(
+      "Contour tree on explicit cells supports at most 64 neighbours per vertex.");
+  }
+  viskores::cont::Algorithm::ScanExtended(numNeighbours, this->NeighbourOffsets);
+  numNeighbours.ReleaseResources();
+
+  // Collect the neighbours of each vertex
+  this->NeighbourConnectivity.Allocate(
+    viskores::cont::ArrayGetValue(this->NumVertices, this->NeighbourOffsets));
+  invoke(explicit_mesh_inc::FillVertexNeighboursWorklet{},
+         meshIndices,
+         viskores::cont::make_ArrayHandleView(this->NeighbourOffsets, 0, this->NumVertices),
+         this->CellConnectivity,
+         this->CellOffsets,
+         this->PointCells,
+         this->PointCellOffsets,
+         this->NeighbourConnectivity);
+
+  invoke(explicit_mesh_inc::MarkBoundaryVerticesWorklet{},
+         meshIndices,
+         this->CellConnectivity,
+         this->CellOffsets,
+         this->PointCells,
+         this->PointCellOffsets,
+         this->BoundaryFlags);
+}
+
+inline void DataSetMeshExplicit::SetPrepareForExecutionBehavior(bool getMax)
+{
+  this->UseGetMax = getMax;
+}
+
+// Get VISKORES execution object that represents the structure of the mesh and provides the mesh helper functions on the device
+inline MeshStructureExplicit DataSetMeshExplicit::PrepareForExecution(
+  viskores::cont::DeviceAdapterId device,
+  viskores::cont::Token& token) const
+{
+  return MeshStructureExplicit(this->MaxNeighbours,
+                               this->UseGetMax,
+                               this->SortIndices,
+                               this->SortOrder,
+                               this->NeighbourConnectivity,
+                               this->NeighbourOffsets,
+                               this->CellConnectivity,
+                               this->CellOffsets,
+                               this->PointCells,
+                               this->PointCellOffsets,
+                               device,
+                               token);
+}
+
+inline MeshBoundaryExplicitExec DataSetMeshExplicit::GetMeshBoundaryExecutionObject() const
+{
+  return MeshBoundaryExplicitExec(this->BoundaryFlags);
+}
+
+} // namespace contourtree_augmented
+} // worklet
+} // viskores
+
+#endif
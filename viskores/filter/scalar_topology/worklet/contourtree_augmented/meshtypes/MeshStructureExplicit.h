@@ -0,0 +1,288 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+//============================================================================
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+// Copyright (c) 2018, The Regents of the University of California, through
+// Lawrence Berkeley National Laboratory (subject to receipt of any required approvals
+// from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// (1) Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//
+// (2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// (3) Neither the name of the University of California, Lawrence Berkeley National
+//     Laboratory, U.S. Dept. of Energy nor the names of its contributors may be
+//     used to endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+// OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//=============================================================================
+//
+//  This code is an extension of the algorithm presented in the paper:
+//  Parallel Peak Pruning for Scalable SMP Contour Tree Computation.
+//  Hamish Carr, Gunther Weber, Christopher Sewell, and James Ahrens.
+//  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
+//  (LDAV), October 2016, Baltimore, Maryland.
+//
+//  The PPP2 algorithm and software were jointly developed by
+//  Hamish Carr (University of Leeds), Gunther H. Weber (LBNL), and
+//  Oliver Ruebel (LBNL)
+//==============================================================================
+
+
+#ifndef viskores_worklet_contourtree_augmented_mesh_structure_explicit_h
+#define viskores_worklet_contourtree_augmented_mesh_structure_explicit_h
+
+#include <viskores/Pair.h>
+#include <viskores/Types.h>
+#include <viskores/cont/ArrayHandle.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/Types.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/explicitmesh/GatherVertexNeighbours.h>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace contourtree_augmented
+{
+
+/// Execution object providing the mesh helper functions for a simplicial mesh given by explicit
+/// cells. The neighbours of each vertex are stored sorted by mesh index in NeighbourConnectivity
+/// and the cells of each vertex are looked up in the reverse (point to cell) connectivity.
+class MeshStructureExplicit
+{
+public:
+  using IdArrayPortalType = IdArrayType::ReadPortalType;
+
+  // Default constucture. Needed for the CUDA built to work
+  VISKORES_EXEC_CONT
+  MeshStructureExplicit()
+    : MaxNeighbours(0)
+    , GetMax(false)
+  {
+  }
+
+  // Main constructor used in the code
+  VISKORES_CONT
+  MeshStructureExplicit(viskores::Id maxNeighbours,
+                        bool getMax,
+                        const IdArrayType& sortIndices,
+                        const IdArrayType& sortOrder,
+                        const IdArrayType& neighbourConnectivity,
+                        const IdArrayType& neighbourOffsets,
+                        const IdArrayType& cellConnectivity,
+                        const IdArrayType& cellOffsets,
+                        const IdArrayType& pointCells,
+                        const IdArrayType& pointCellOffsets,
+                        viskores::cont::DeviceAdapterId device,
+                        viskores::cont::Token& token)
+    : MaxNeighbours(maxNeighbours)
+    , GetMax(getMax)
+  {
+    this->SortIndicesPortal = sortIndices.PrepareForInput(device, token);
+    this->SortOrderPortal = sortOrder.PrepareForInput(device, token);
+    this->NeighbourConnectivityPortal = neighbourConnectivity.PrepareForInput(device, token);
+    this->NeighbourOffsetsPortal = neighbourOffsets.PrepareForInput(device, token);
+    this->CellConnectivityPortal = cellConnectivity.PrepareForInput(device, token);
+    this->CellOffsetsPortal = cellOffsets.PrepareForInput(device, token);
+    this->PointCellsPortal = pointCells.PrepareForInput(device, token);
+    this->PointCellOffsetsPortal = pointCellOffsets.PrepareForInput(device, token);
+  }
+
+  VISKORES_EXEC
+  viskores::Id GetMaxNumberOfNeighbours() const { return this->MaxNeighbours; }
+
+  VISKORES_EXEC
+  inline viskores::Id GetNeighbourIndex(viskores::Id sortIndex, viskores::Id nbrNo) const
+  { // GetNeighbourIndex
+    viskores::Id meshIndex = this->SortOrderPortal.Get(sortIndex);
+    viskores::Id nbrsBegin = this->NeighbourOffsetsPortal.Get(meshIndex);
+    viskores::Id nbrsEnd = this->NeighbourOffsetsPortal.Get(meshIndex + 1);
+    if (nbrNo >= nbrsEnd - nbrsBegin)
+    {
+      return -1;
+    }
+    return this->SortIndicesPortal.Get(this->NeighbourConnectivityPortal.Get(nbrsBegin + nbrNo));
+  } // GetNeighbourIndex
+
+  // sets outgoing paths for saddles
+  VISKORES_EXEC
+  inline viskores::Id GetExtremalNeighbour(viskores::Id sortIndex) const
+  { // GetExtremalNeighbour()
+    viskores::Id meshIndex = this->SortOrderPortal.Get(sortIndex);
+    viskores::Id nbrsEnd = this->NeighbourOffsetsPortal.Get(meshIndex + 1);
+
+    // follow the steepest edge, which is as good as any other ascending (descending) edge
+    viskores::Id extremalNeighbour = sortIndex;
+    for (viskores::Id nbr = this->NeighbourOffsetsPortal.Get(meshIndex); nbr < nbrsEnd; ++nbr)
+    {
+      viskores::Id nbrSortIndex =
+        this->SortIndicesPortal.Get(this->NeighbourConnectivityPortal.Get(nbr));
+      if (this->GetMax ? (nbrSortIndex > extremalNeighbour) : (nbrSortIndex < extremalNeighbour))
+      {
+        extremalNeighbour = nbrSortIndex;
+      }
+    }
+    return (extremalNeighbour == sortIndex) ? (sortIndex | TERMINAL_ELEMENT) : extremalNeighbour;
+  } // GetExtremalNeighbour()
+
+  // The upper (lower) link of a vertex splits into one component per ascending (descending)
+  // edge of the active graph. Two upper neighbours are joined in the link if they share a cell
+  // with the vertex, as all vertices of a simplex are connected, so the components are found
+  // by a union-find over the cells of the vertex. Each component is represented by its
+  // neighbour with the lowest number.
+  VISKORES_EXEC
+  inline viskores::Pair<viskores::Id, viskores::Id> GetNeighbourComponentsMaskAndDegree(
+    viskores::Id sortIndex,
+    bool getMaxComponents) const
+  { // GetNeighbourComponentsMaskAndDegree()
+    viskores::Id meshIndex = this->SortOrderPortal.Get(sortIndex);
+    viskores::Id nbrsBegin = this->NeighbourOffsetsPortal.Get(meshIndex);
+    viskores::IdComponent numNbrs = static_cast<viskores::IdComponent>(
+      this->NeighbourOffsetsPortal.Get(meshIndex + 1) - nbrsBegin);
+
+    // component of each neighbour or -1 if the edge to it is not outbound
+    viskores::IdComponent component[explicit_mesh_inc::MAX_NEIGHBOURS];
+    for (viskores::IdComponent nbrNo = 0; nbrNo < numNbrs; ++nbrNo)
+    {
+      viskores::Id nbrSortIndex =
+        this->SortIndicesPortal.Get(this->NeighbourConnectivityPortal.Get(nbrsBegin + nbrNo));
+      bool outbound =
+        getMaxComponents ? (nbrSortIndex > sortIndex) : (nbrSortIndex < sortIndex);
+      component[nbrNo] = outbound ? nbrNo : -1;
+    }
+
+    viskores::Id cellsEnd = this->PointCellOffsetsPortal.Get(meshIndex + 1);
+    for (viskores::Id cellNo = this->PointCellOffsetsPortal.Get(meshIndex); cellNo < cellsEnd;
+         ++cellNo)
+    { // per cell
+      viskores::Id cell = this->PointCellsPortal.Get(cellNo);
+      viskores::Id pointsEnd = this->CellOffsetsPortal.Get(cell + 1);
+      viskores::IdComponent cellRoot = -1;
+      for (viskores::Id pointNo = this->CellOffsetsPortal.Get(cell); pointNo < pointsEnd; ++pointNo)
+      {
+        viskores::Id point = this->CellConnectivityPortal.Get(pointNo);
+        if (point == meshIndex)
+        {
+          continue;
+        }
+        viskores::IdComponent nbrNo = this->FindNeighbour(nbrsBegin, numNbrs, point);
+        if (component[nbrNo] < 0)
+        {
+          continue;
+        }
+        viskores::IdComponent root = FindRoot(component, nbrNo);
+        if (cellRoot < 0)
+        {
+          cellRoot = root;
+        }
+        else if (root < cellRoot)
+        {
+          component[cellRoot] = root;
+          cellRoot = root;
+        }
+        else if (root > cellRoot)
+        {
+          component[root] = cellRoot;
+        }
+      }
+    } // per cell
+
+    viskores::Id outDegree = 0;
+    viskores::Id neighbourComponentMask = 0;
+    for (viskores::IdComponent nbrNo = 0; nbrNo < numNbrs; ++nbrNo)
+    {
+      if (component[nbrNo] == nbrNo)
+      {
+        ++outDegree;
+        neighbourComponentMask |= viskores::Id{ 1 } << nbrNo;
+      }
+    }
+    return viskores::Pair<viskores::Id, viskores::Id>{ neighbourComponentMask, outDegree };
+  } // GetNeighbourComponentsMaskAndDegree()
+
+private:
+  IdArrayPortalType SortIndicesPortal;
+  IdArrayPortalType SortOrderPortal;
+  IdArrayPortalType NeighbourConnectivityPortal;
+  IdArrayPortalType NeighbourOffsetsPortal;
+  IdArrayPortalType CellConnectivityPortal;
+  IdArrayPortalType CellOffsetsPortal;
+  IdArrayPortalType PointCellsPortal;
+  IdArrayPortalType PointCellOffsetsPortal;
+  viskores::Id MaxNeighbours;
+  bool GetMax;
+
+  // binary search for a vertex in the neighbours of a vertex, which are sorted by mesh index
+  VISKORES_EXEC
+  inline viskores::IdComponent FindNeighbour(viskores::Id nbrsBegin,
+                                             viskores::IdComponent numNbrs,
+                                             viskores::Id point) const
+  { // FindNeighbour()
+    viskores::IdComponent low = 0;
+    viskores::IdComponent high = numNbrs - 1;
+    while (low < high)
+    {
+      viskores::IdComponent middle = (low + high) / 2;
+      if (this->NeighbourConnectivityPortal.Get(nbrsBegin + middle) < point)
+      {
+        low = middle + 1;
+      }
+      else
+      {
+        high = middle;
+      }
+    }
+    return low;
+  } // FindNeighbour()
+
+  VISKORES_EXEC
+  static inline viskores::IdComponent FindRoot(viskores::IdComponent* component,
+                                               viskores::IdComponent nbrNo)
+  { // FindRoot()
+    while (component[nbrNo] != nbrNo)
+    {
+      component[nbrNo] = component[component[nbrNo]];
+      nbrNo = component[nbrNo];
+    }
+    return nbrNo;
+  } // FindRoot()
+}; // MeshStructureExplicit
+
+} // namespace contourtree_augmented
+} // namespace worklet
+} // namespace viskores
+
+#endif
@@ -0,0 +1,138 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+//============================================================================
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+// Copyright (c) 2018, The Regents of the University of California, through
+// Lawrence Berkeley National Laboratory (subject to receipt of any required approvals
+// from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// (1) Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//
+// (2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// (3) Neither the name of the University of California, Lawrence Berkeley National
+//     Laboratory, U.S. Dept. of Energy nor the names of its contributors may be
+//     used to endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+// OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//=============================================================================
+//
+//  This code is an extension of the algorithm presented in the paper:
+//  Parallel Peak Pruning for Scalable SMP Contour Tree Computation.
+//  Hamish Carr, Gunther Weber, Christopher Sewell, and James Ahrens.
+//  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
+//  (LDAV), October 2016, Baltimore, Maryland.
+//
+//  The PPP2 algorithm and software were jointly developed by
+//  Hamish Carr (University of Leeds), Gunther H. Weber (LBNL), and
+//  Oliver Ruebel (LBNL)
+//==============================================================================
+
+
+#ifndef viskores_worklet_contourtree_augmented_explicit_mesh_inc_gather_vertex_neighbours_h
+#define viskores_worklet_contourtree_augmented_explicit_mesh_inc_gather_vertex_neighbours_h
+
+#include <viskores/Types.h>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace contourtree_augmented
+{
+namespace explicit_mesh_inc
+{
+
+/// The largest number of neighbours of a vertex of an explicit mesh. The neighbourhood masks
+/// of the active graph have one bit per neighbour, so this is the number of bits of an Id.
+static constexpr viskores::IdComponent MAX_NEIGHBOURS = 64;
+
+/// Collects the vertices that share a cell with meshIndex, sorted by mesh index and without
+/// duplicates. The cells of the vertex are looked up in the reverse (point to cell)
+/// connectivity. Returns the number of neighbours, or MAX_NEIGHBOURS + 1 if there are more
+/// than fit into neighbours, which must hold MAX_NEIGHBOURS values.
+template <typename IdPortalType>
+VISKORES_EXEC viskores::IdComponent GatherVertexNeighbours(viskores::Id meshIndex,
+                                                           const IdPortalType& cellConnectivity,
+                                                           const IdPortalType& cellOffsets,
+                                                           const IdPortalType& pointCells,
+                                                           const IdPortalType& pointCellOffsets,
+                                                           viskores::Id* neighbours)
+{
+  viskores::IdComponent numNeighbours = 0;
+  const viskores::Id cellsEnd = pointCellOffsets.Get(meshIndex + 1);
+  for (viskores::Id cellNo = pointCellOffsets.Get(meshIndex); cellNo < cellsEnd; ++cellNo)
+  {
+    const viskores::Id cell = pointCells.Get(cellNo);
+    const viskores::Id pointsEnd = cellOffsets.Get(cell + 1);
+    for (viskores::Id pointNo = cellOffsets.Get(cell); pointNo < pointsEnd; ++pointNo)
+    {
+      const viskores::Id point = cellConnectivity.Get(pointNo);
+      if (point == meshIndex)
+      {
+        continue;
+      }
+      // insertion into the sorted list, skipping points that are already in it
+      viskores::IdComponent position = numNeighbours;
+      while (position > 0 && neighbours[position - 1] > point)
+      {
+        --position;
+      }
+      if (position > 0 && neighbours[position - 1] == point)
+      {
+        continue;
+      }
+      if (numNeighbours == MAX_NEIGHBOURS)
+      {
+        return MAX_NEIGHBOURS + 1;
+      }
+      for (viskores::IdComponent i = numNeighbours; i > position; --i)
+      {
+        neighbours[i] = neighbours[i - 1];
+      }
+      neighbours[position] = point;
+      ++numNeighbours;
+    }
+  }
+  return numNeighbours;
+} // GatherVertexNeighbours
+
+} // namespace explicit_mesh_inc
+} // namespace contourtree_augmented
+} // namespace worklet
+} // namespace viskores
+
+#endif
@@ -0,0 +1,158 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+//============================================================================
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+// Copyright (c) 2018, The Regents of the University of California, through
+// Lawrence Berkeley National Laboratory (subject to receipt of any required approvals
+// from the U.S. Dept. of Energy).  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// (1) Redistributions of source code must retain the above copyright notice, this
+//     list of conditions and the following disclaimer.
+//
+// (2) Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+// (3) Neither the name of the University of California, Lawrence Berkeley National
+//     Laboratory, U.S. Dept. of Energy nor the names of its contributors may be
+//     used to endorse or promote products derived from this software without
+//     specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+// IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+// OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//=============================================================================
+//
+//  This code is an extension of the algorithm presented in the paper:
+//  Parallel Peak Pruning for Scalable SMP Contour Tree Computation.
+//  Hamish Carr, Gunther Weber, Christopher Sewell, and James Ahrens.
+//  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
+//  (LDAV), October 2016, Baltimore, Maryland.
+//
+//  The PPP2 algorithm and software were jointly developed by
+//  Hamish Carr (University of Leeds), Gunther H. Weber (LBNL), and
+//  Oliver Ruebel (LBNL)
+//==============================================================================
+
+
+#ifndef viskores_worklet_contourtree_augmented_explicit_mesh_inc_mark_boundary_vertices_worklet_h
+#define viskores_worklet_contourtree_augmented_explicit_mesh_inc_mark_boundary_vertices_worklet_h
+
+#include <viskores/worklet/WorkletMapField.h>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace contourtree_augmented
+{
+namespace explicit_mesh_inc
+{
+
+/// Marks the vertices of a simplicial mesh that lie on its boundary. A vertex lies on the
+/// boundary if one of the facets of its cells that contain it (an edge of a triangle or a
+/// triangle of a tetrahedron) belongs to only one cell.
+class MarkBoundaryVerticesWorklet : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn meshIndex,
+                                WholeArrayIn cellConnectivity,
+                                WholeArrayIn cellOffsets,
+                                WholeArrayIn pointCells,
+                                WholeArrayIn pointCellOffsets,
+                                FieldOut onBoundary);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6);
+
+  template <typename IdPortalType>
+  VISKORES_EXEC void operator()(const viskores::Id& meshIndex,
+                                const IdPortalType& cellConnectivity,
+                                const IdPortalType& cellOffsets,
+                                const IdPortalType& pointCells,
+                                const IdPortalType& pointCellOffsets,
+                                bool& onBoundary) const
+  {
+    onBoundary = false;
+    const viskores::Id cellsBegin = pointCellOffsets.Get(meshIndex);
+    const viskores::Id cellsEnd = pointCellOffsets.Get(meshIndex + 1);
+    for (viskores::Id cellNo = cellsBegin; cellNo < cellsEnd; ++cellNo)
+    {
+      const viskores::Id cell = pointCells.Get(cellNo);
+      const viskores::Id pointsBegin = cellOffsets.Get(cell);
+      const viskores::Id pointsEnd = cellOffsets.Get(cell + 1);
+      // the facets containing the vertex are those opposite to the other vertices of the cell
+      for (viskores::Id oppositeNo = pointsBegin; oppositeNo < pointsEnd; ++oppositeNo)
+      {
+        const viskores::Id opposite = cellConnectivity.Get(oppositeNo);
+        if (opposite == meshIndex)
+        {
+          continue;
+        }
+        // count the other cells of the vertex that share the facet
+        bool shared = false;
+        for (viskores::Id otherNo = cellsBegin; otherNo < cellsEnd && !shared; ++otherNo)
+        {
+          const viskores::Id other = pointCells.Get(otherNo);
+          if (other == cell)
+          {
+            continue;
+          }
+          shared = true;
+          for (viskores::Id pointNo = pointsBegin; pointNo < pointsEnd && shared; ++pointNo)
+          {
+            const viskores::Id point = cellConnectivity.Get(pointNo);
+            if (point == opposite)
+            {
+              continue;
+            }
+            bool found = false;
+            const viskores::Id otherEnd = cellOffsets.Get(other + 1);
+            for (viskores::Id i = cellOffsets.Get(other); i < otherEnd && !found; ++i)
+            {
+              found = (cellConnectivity.Get(i) == point);
+            }
+            shared = found;
+          }
+        }
+        if (!shared)
+        {
+          onBoundary = true;
+          return;
+        }
+      }
+    }
+  }
+}; // MarkBoundaryVerticesWorklet
+
+} // namespace explicit_mesh_inc
+} // namespace contourtree_augmented
+} // namespace worklet
+} // namespace viskores
+
+#endif
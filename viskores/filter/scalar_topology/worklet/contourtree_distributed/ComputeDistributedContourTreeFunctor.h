@@ -52,11 +52,16 @@
 #ifndef viskores_worklet_contourtree_distributed_computedistributedcontourtreefunctor_h
 #define viskores_worklet_contourtree_distributed_computedistributedcontourtreefunctor_h
 
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 #include <viskores/Types.h>
 #include <viskores/cont/Error.h>
 #include <viskores/filter/scalar_topology/worklet/ContourTreeUniformAugmented.h>
 #include <viskores/filter/scalar_topology/worklet/contourtree_augmented/Types.h>
 #include <viskores/filter/scalar_topology/worklet/contourtree_distributed/DistributedContourTreeBlockData.h>
+#include <viskores/filter/scalar_topology/worklet/contourtree_distributed/InlineBlobBuffer.h>
 #include <viskores/filter/scalar_topology/worklet/contourtree_distributed/PrintGraph.h>
 
 // clang-format off
@@ -112,6 +117,7 @@ public:
     viskores::cont::Timer timer; // Time individual steps
     timer.Start();
     std::stringstream timingsStream;
+    FanInRoundStatistics roundStatistics = this->StartRound(block, rp.round());
 
     // Get our rank and DIY id
     const viskores::Id rank = viskores::cont::EnvironmentTracker::GetCommunicator().rank();
@@ -140,6 +146,7 @@ public:
         viskores::cont::Timer loopTimer; // time the steps of this loop
         loopTimer.Start();
 
+        roundStatistics.BytesReceived += rp.incoming(ingid).size();
         viskores::Id3 otherBlockOrigin;
         rp.dequeue(ingid, otherBlockOrigin);
         viskores::Id3 otherBlockSize;
@@ -150,198 +157,16 @@ public:
         timingsStream << "      Subphase of Merge Block" << std::endl;
         timingsStream << "        |-->" << std::setw(38) << std::left << "DIY Deque Data"
                       << ": " << loopTimer.GetElapsedTime() << " seconds" << std::endl;
-        loopTimer.Start();
-
-#ifdef DEBUG_PRINT_CTUD
-        VISKORES_LOG_S(viskores::cont::LogLevel::Info,
-                       "Local block has extents: " << block->BlockOrigin << " " << block->BlockSize
-                                                   << std::endl
-                                                   << "Combining with block received from ID "
-                                                   << ingid << " with extents: " << otherBlockOrigin
-                                                   << " " << otherBlockSize << std::endl);
-#endif
-
-        // Merge the two contour tree meshes
-        std::stringstream mergeMessageStream;
-        mergeMessageStream << "    Rank    : " << rank << std::endl
-                           << "    DIY Id  : " << selfid << std::endl
-                           << "    Other Id: " << ingid << std::endl
-                           << "    Round   : " << rp.round() << std::endl;
-        block->ContourTreeMeshes.back().MergeWith(
-          otherContourTreeMesh, this->TimingsLogLevel, mergeMessageStream.str());
-
-        timingsStream << "        |-->" << std::setw(38) << std::left << "Merge Contour Tree Mesh"
-                      << ": " << loopTimer.GetElapsedTime() << " seconds" << std::endl;
-        loopTimer.Start();
-
-#ifdef DEBUG_PRINT_CTUD
-        // save the corresponding .gv file for the contour tree mesh
-        std::string contourTreeMeshFileName = std::string("Rank_") +
-          std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
-          std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
-          std::to_string(rp.round()) + "_Partner_" + std::to_string(ingid) +
-          std::string("_Step_0_Combined_Mesh.gv");
-        std::string contourTreeMeshLabel = std::string("Block ") +
-          std::to_string(static_cast<int>(block->LocalBlockNo)) + " Round " +
-          std::to_string(rp.round()) + " Partner " + std::to_string(ingid) +
-          std::string(" Step 0 Combined Mesh");
-        std::string contourTreeMeshString =
-          viskores::worklet::contourtree_distributed::ContourTreeMeshDotGraphPrint<FieldType>(
-            contourTreeMeshLabel,
-            block->ContourTreeMeshes.back(),
-            worklet::contourtree_distributed::SHOW_CONTOUR_TREE_MESH_ALL);
-        std::ofstream contourTreeMeshFile(contourTreeMeshFileName);
-        contourTreeMeshFile << contourTreeMeshString;
-        timingsStream << "        |-->" << std::setw(38) << std::left
-                      << "Save Contour Tree Mesh Dot"
-                      << ": " << loopTimer.GetElapsedTime() << " seconds" << std::endl;
-        loopTimer.Start();
-#endif
-
-        // Compute the origin and size of the new block
-        viskores::Id3 currBlockOrigin{
-          std::min(otherBlockOrigin[0], block->BlockOrigin[0]),
-          std::min(otherBlockOrigin[1], block->BlockOrigin[1]),
-          std::min(otherBlockOrigin[2], block->BlockOrigin[2]),
-        };
-        viskores::Id3 currBlockMaxIndex{ // Needed only to compute the block size
-                                         std::max(otherBlockOrigin[0] + otherBlockSize[0],
-                                                  block->BlockOrigin[0] + block->BlockSize[0]),
-                                         std::max(otherBlockOrigin[1] + otherBlockSize[1],
-                                                  block->BlockOrigin[1] + block->BlockSize[1]),
-                                         std::max(otherBlockOrigin[2] + otherBlockSize[2],
-                                                  block->BlockOrigin[2] + block->BlockSize[2])
-        };
-        viskores::Id3 currBlockSize{ currBlockMaxIndex[0] - currBlockOrigin[0],
-                                     currBlockMaxIndex[1] - currBlockOrigin[1],
-                                     currBlockMaxIndex[2] - currBlockOrigin[2] };
-
-        // Compute the contour tree from our merged mesh
-        viskores::Id currNumIterations;
-        block->ContourTrees.emplace_back(); // Create new empty contour tree object
-        viskores::worklet::contourtree_augmented::IdArrayType currSortOrder;
-        viskores::worklet::ContourTreeAugmented worklet;
-        worklet.TimingsLogLevel =
-          viskores::cont::LogLevel::Off; // disable the print logging, we'll print this later
-        viskores::Id3 maxIdx{ currBlockOrigin[0] + currBlockSize[0] - 1,
-                              currBlockOrigin[1] + currBlockSize[1] - 1,
-                              currBlockOrigin[2] + currBlockSize[2] - 1 };
-        auto meshBoundaryExecObj = block->ContourTreeMeshes.back().GetMeshBoundaryExecutionObject(
-          this->GlobalSize, currBlockOrigin, maxIdx);
-        try
-        {
-          worklet.Run(block->ContourTreeMeshes.back()
-                        .SortedValues, // Unused param. Provide something to keep the API happy
-                      block->ContourTreeMeshes.back(),
-                      block->ContourTrees.back(),
-                      currSortOrder,
-                      currNumIterations,
-                      1, // Fully augmented
-                      meshBoundaryExecObj);
-        }
-        // In case the contour tree got stuck, expand the debug information from
-        // the message to check whether we combined bad blocks
-        catch (const viskores::cont::ErrorInternal& ex)
-        {
-          std::stringstream ex_message;
-          ex_message << ex.what();
-          ex_message << " Self/In DIY Id=(" << selfid << ", " << ingid << ")";
-          ex_message << " Rank=" << rank << " Round=" << rp.round();
-          ex_message << " Origin Self=(" << block->BlockOrigin[0] << ", " << block->BlockOrigin[1]
-                     << ", " << block->BlockOrigin[2] << ")";
-          ex_message << " Origin In=(" << otherBlockOrigin[0] << ", " << otherBlockOrigin[1] << ", "
-                     << otherBlockOrigin[2] << ")";
-          ex_message << " Origin Comb=(" << currBlockOrigin[0] << ", " << currBlockOrigin[1] << ", "
-                     << currBlockOrigin[2] << ")";
-          ex_message << " Size Self=(" << block->BlockSize[0] << ", " << block->BlockSize[1] << ", "
-                     << block->BlockSize[2] << ")";
-          ex_message << " Size In=(" << otherBlockSize[0] << ", " << otherBlockSize[1] << ", "
-                     << otherBlockSize[2] << ")";
-          ex_message << " Size Comb=(" << currBlockSize[0] << ", " << currBlockSize[1] << ", "
-                     << currBlockSize[2] << ")";
-          std::throw_with_nested(viskores::cont::ErrorInternal(ex_message.str()));
-        }
-
-        // Update block extents
-        block->BlockOrigin = currBlockOrigin;
-        block->BlockSize = currBlockSize;
-
-        timingsStream << "        |-->" << std::setw(38) << std::left
-                      << "Compute Joint Contour Tree"
-                      << ": " << loopTimer.GetElapsedTime() << " seconds" << std::endl;
-        loopTimer.Start();
-
-#ifdef DEBUG_PRINT_CTUD
-        /*
-        // TODO: GET THIS COMPILING. NEED TO LIKELY PUT THIS IN A SEPARATE FUNCTION TO GET THE STORAGE TYPE TEMPLATE PARAMETER
-        // TODO/FIXME: At this time we should only be dealing with contour tree meshes and not possibly other mesh types,
-        // and block does not have a Meshes member. Shouldn't this all be ContourTreeMesh instead?
-        // and the ones for the contour tree regular and superstructures
-        std::string regularStructureFileName = std::string("Rank_") +
-          std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
-          std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
-          std::to_string(rp.round()) + " Partner " + std::to_string(ingid) +
-          std::string("_Step_1_Contour_Tree_Regular_Structure.gv");
-        std::string regularStructureLabel = std::string("Block ") +
-          std::to_string(static_cast<int>(block->LocalBlockNo)) + " Round " +
-          std::to_string(rp.round()) + " Partner " + std::to_string(ingid) +
-          std::string(" Step 1 Contour Tree Regular Structure");
-        std::string regularStructureString =
-                      worklet::contourtree_distributed::ContourTreeDotGraphPrint < FieldType,
-                    MeshType,
-                    viskores::worklet::contourtree_augmented::IdArrayType()(
-                      regularStructureLabel,
-                      block->Meshes.back(),
-                      block->ContourTrees.back(),
-                      worklet::contourtree_distributed::SHOW_REGULAR_STRUCTURE |
-                        worklet::contourtree_distributed::SHOW_ALL_IDS);
-        std::ofstream regularStructureFile(regularStructureFileName);
-        regularStructureFile << regularStructureString;
-
-        std::string superStructureFileName = std::string("Rank_") +
-          std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
-          std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
-          std::to_string(rp.round()) + " Partner " + std::to_string(ingid) +
-          std::string("_Step_2_Contour_Tree_Super_Structure.gv");
-        std::ofstream superStructureFile(superStructureFileName);
-        superStructureFile << worklet::contourtree_distributed::ContourTreeDotGraphPrint < T,
-          MeshType,
-          viskores::worklet::contourtree_augmented::IdArrayType()(
-            std::string("Block ") + std::to_string(static_cast<int>(block->LocalBlockNo)) +
-              " Round " + std::to_string(rp.round()) + " Partner " + std::to_string(ingid) +
-              std::string(" Step 2 Contour Tree Super Structure"),
-            block->Meshes.back(),
-            block->ContourTrees.back(),
-            worklet::contourtree_distributed::SHOW_SUPER_STRUCTURE |
-              worklet::contourtree_distributed::SHOW_HYPER_STRUCTURE |
-              worklet::contourtree_distributed::SHOW_ALL_IDS |
-              worklet::contourtree_distributed::SHOW_ALL_SUPERIDS |
-              worklet::contourtree_distributed::SHOW_ALL_HYPERIDS);
-        */
-#endif
-
-        // Log the contour tree timiing stats
-        (void)rank; // Suppress unused variable warning if logging is disabled.
-        VISKORES_LOG_S(this->TimingsLogLevel,
-                       std::endl
-                         << "    ---------------- Contour Tree Worklet Timings ------------------"
-                         << std::endl
-                         << "    Rank    : " << rank << std::endl
-                         << "    DIY Id  : " << selfid << std::endl
-                         << "    In Id   : " << ingid << std::endl
-                         << "    Round   : " << rp.round() << std::endl
-                         << worklet.TimingsLogString);
-        // Log the contour tree size stats
-        VISKORES_LOG_S(this->TreeLogLevel,
-                       std::endl
-                         << "    ---------------- Contour Tree Array Sizes ---------------------"
-                         << std::endl
-                         << "    Rank    : " << rank << std::endl
-                         << "    DIY Id  : " << selfid << std::endl
-                         << "    In Id   : " << ingid << std::endl
-                         << "    Round   : " << rp.round() << std::endl
-                         << block->ContourTrees.back().PrintArraySizes());
 
+        this->MergeBlock(block,
+                         otherBlockOrigin,
+                         otherBlockSize,
+                         otherContourTreeMesh,
+                         rank,
+                         selfid,
+                         ingid,
+                         rp.round(),
+                         timingsStream);
       } // end if (ingid != selfid)
     }   // end for
 
@@ -355,106 +180,13 @@ public:
     // last round) then compute contour tree mesh to send and save it.
     if (rp.round() != 0 && rp.out_link().size() != 0)
     {
-      viskores::Id3 maxIdx{ block->BlockOrigin[0] + block->BlockSize[0] - 1,
-                            block->BlockOrigin[1] + block->BlockSize[1] - 1,
-                            block->BlockOrigin[2] + block->BlockSize[2] - 1 };
-
-      // Compute BRACT
-      viskores::worklet::contourtree_distributed::BoundaryTree boundaryTree;
-      // ... Get the mesh boundary object
-      auto meshBoundaryExecObj = block->ContourTreeMeshes.back().GetMeshBoundaryExecutionObject(
-        this->GlobalSize, block->BlockOrigin, maxIdx);
-      // Make the BRACT and InteriorForest (i.e., residue)
-      block->InteriorForests.emplace_back();
-      auto boundaryTreeMaker = viskores::worklet::contourtree_distributed::BoundaryTreeMaker<
-        viskores::worklet::contourtree_augmented::ContourTreeMesh<FieldType>,
-        viskores::worklet::contourtree_augmented::MeshBoundaryContourTreeMeshExec>(
-        &(block->ContourTreeMeshes.back()),
-        meshBoundaryExecObj,
-        block->ContourTrees.back(),
-        &boundaryTree,
-        &(block->InteriorForests.back()));
-      // Construct the BRACT and InteriorForest. Since we are working on a ContourTreeMesh we do
-      // not need to provide and IdRelabeler here in order to compute the InteriorForest
-      boundaryTreeMaker.Construct(nullptr, this->UseBoundaryExtremaOnly);
-      // Construct contour tree mesh from BRACT
-      block->ContourTreeMeshes.emplace_back(
-        boundaryTree.VertexIndex, boundaryTree.Superarcs, block->ContourTreeMeshes.back());
-
-#ifdef DEBUG_PRINT_CTUD
-      /*
-      // TODO: GET THIS COMPILING.
-      // TODO/FIXME: Need to get inggid here somehow
-      // save the Boundary Tree as a dot file
-      std::string boundaryTreeFileName = std::string("Rank_") +
-        std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
-        std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
-        std::to_string(rp.round()) + "_Partner_" + std::to_string(ingid) +
-        std::string("_Step_3_Boundary_Tree.gv");
-      std::ofstream boundaryTreeFile(boundaryTreeFileName);
-      boundaryTreeFile << viskores::worklet::contourtree_distributed::BoundaryTreeDotGraphPrint
-        (std::string("Block ") + std::to_string(static_cast<int>(block->LocalBlockNo)) + " Round " +
-         std::to_string(rp.round()) + " Partner " + std::to_string(ingid) +
-         std::string(" Step 3 Boundary Tree"),
-         block->Meshes.back()],
-         block->BoundaryTrees.back());
-
-      // and save the Interior Forest as another dot file
-      std::string interiorForestFileName = std::string("Rank_") +
-        std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
-        std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
-        std::to_string(rp.round()) + "_Partner_" + std::to_string(ingid) +
-        std::string("_Step_4_Interior_Forest.gv");
-      std::ofstream interiorForestFile(interiorForestFileName);
-      interiorForestFileName << InteriorForestDotGraphPrintFile<MeshType>(
-        std::string("Block ") + std::to_string(static_cast<int>(block->LocalBlockNo)) + " Round " +
-          std::to_string(rp.round()) + " Partner " + std::to_string(ingid) +
-          std::string(" Step 4 Interior Forest"),
-        block->InteriorForests.back(),
-        block->ContourTrees.back(),
-        block->BoundaryTrees.back(),
-        block->Meshes.back());
-
-      // save the corresponding .gv file
-      std::string boundaryTreeMeshFileName = std::string("Rank_") +
-        std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
-        std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
-        std::to_string(rp.round()) + "_Partner_" + std::to_string(ingid) +
-        std::string("_Step_5_Boundary_Tree_Mesh.gv");
-      std::ofstream boundaryTreeMeshFile(boundaryTreeMeshFileName);
-      boundaryTreeMeshFile
-        << viskores::worklet::contourtree_distributed::ContourTreeMeshDotGraphPrint<FieldType>(
-             std::string("Block ") + std::to_string(static_cast<int>(block->LocalBlockNo)) +
-               " Round " + std::to_string(rp.round()) + " Partner " + std::to_string(ingid) +
-               std::string(" Step 5 Boundary Tree Mesh"),
-             block->ContourTreeMeshes.back(),
-             worklet::contourtree_distributed::SHOW_CONTOUR_TREE_MESH_ALL);
-      */
-#endif
-
-      // Log the boundary tree size statistics
-      VISKORES_LOG_S(this->TreeLogLevel,
-                     std::endl
-                       << "    ---------------- Boundary Tree Array Sizes ---------------------"
-                       << std::endl
-                       << "    Rank    : " << rank << std::endl
-                       << "    DIY Id  : " << selfid << std::endl
-                       << "    Round   : " << rp.round() << std::endl
-                       << boundaryTree.PrintArraySizes());
-      // Log the interior forest statistics
-      VISKORES_LOG_S(this->TreeLogLevel,
-                     std::endl
-                       << "    ---------------- Interior Forest Array Sizes ---------------------"
-                       << std::endl
-                       << "    Rank    : " << rank << std::endl
-                       << "    DIY Id  : " << selfid << std::endl
-                       << "    Round   : " << rp.round() << std::endl
-                       << block->InteriorForests.back().PrintArraySizes());
+      this->ComputeTreesToSend(block, rank, selfid, rp.round());
     } // end if (rp.round() != 0 && rp.out_link().size() != 0)
 
     // log the time to compute the boundary tree, interior forest, and contour tree mesh, i.e, the data we need to send
     timingsStream << "    " << std::setw(38) << std::left << "Compute Trees To Send"
                   << ": " << timer.GetElapsedTime() << " seconds" << std::endl;
+    roundStatistics.ComputeSeconds = totalTimer.GetElapsedTime();
     timer.Start();
 
 
@@ -465,14 +197,8 @@ public:
       auto target = rp.out_link().target(cc);
       if (target.gid != selfid)
       {
-        rp.enqueue(target, block->BlockOrigin);
-        rp.enqueue(target, block->BlockSize);
-        rp.enqueue(target, block->ContourTreeMeshes.back());
-        VISKORES_LOG_S(this->TreeLogLevel,
-                       std::endl
-                         << "FanInEnqueue: Rank=" << rank << "; Round=" << rp.round()
-                         << "; DIY Send Id=" << selfid << "; DIY Target ID=" << target.gid
-                         << std::endl);
+        roundStatistics.BytesSent +=
+          this->EnqueueBlock(block, rp, target, rank, selfid, rp.round(), false);
       }
     } // end for
 
@@ -482,6 +208,7 @@ public:
     // Log the total this functor call step took
     timingsStream << "    " << std::setw(38) << std::left << "Total Time Functor Step"
                   << ": " << totalTimer.GetElapsedTime() << " seconds" << std::endl;
+    this->EndRound(block, roundStatistics);
     // Record the times we logged
     VISKORES_LOG_S(this->TimingsLogLevel,
                    std::endl
@@ -494,8 +221,492 @@ public:
 
   } //end ComputeDistributedContourTreeFunctor
 
+  /// Callback used by DIY iexchange to compute the fan in asynchronously. Rather than waiting
+  /// for all exchanges of a round to complete, each block processes its next round as soon as
+  /// the data of its partners for that round has arrived. The rounds and partners are the same
+  /// as for viskoresdiy::reduce with the given partners, so the result is the same.
+  /// @param[in] block The local data block. Instance of DistributedContourTreeBlockData.
+  /// @param[in] icp DIY communication proxy of the iexchange
+  /// @param[in] partners The partners of the blocks in each round
+  /// @param[in] assigner The DIY assigner used to find the rank of the partners
+  /// @returns true if the block is done until it receives more data
+  bool ProcessAvailableRounds(
+    viskores::worklet::contourtree_distributed::DistributedContourTreeBlockData<FieldType>* block,
+    const viskoresdiy::Master::ProxyWithLink& icp,
+    const viskoresdiy::RegularSwapPartners& partners,
+    const viskoresdiy::Assigner& assigner) const
+  {
+    const viskores::Id rank = viskores::cont::EnvironmentTracker::GetCommunicator().rank();
+    const int selfid = icp.gid();
+
+    // DIY drops incoming data that is not dequeued during this call, so we keep the data
+    // from partners of later rounds until we get to their round
+    std::vector<int> incoming;
+    icp.incoming(incoming);
+    for (const int ingid : incoming)
+    {
+      if (!icp.incoming(ingid))
+      {
+        continue;
+      }
+      auto& received = block->FanInReceived[ingid];
+      received.NumberOfBytes = icp.incoming(ingid).size();
+      InlineBlobBuffer incomingBuffer(icp.incoming(ingid));
+      viskoresdiy::load(incomingBuffer, received.BlockOrigin);
+      viskoresdiy::load(incomingBuffer, received.BlockSize);
+      viskoresdiy::load(incomingBuffer, received.Mesh);
+    }
+
+    const unsigned int numRounds = static_cast<unsigned int>(partners.rounds());
+    while (block->FanInRound <= numRounds)
+    {
+      const unsigned int round = block->FanInRound;
+      // check that all partners of this round have sent their data
+      std::vector<int> roundIncoming;
+      if (round > 0)
+      {
+        partners.incoming(static_cast<int>(round), selfid, roundIncoming, *icp.master());
+      }
+      std::sort(roundIncoming.begin(), roundIncoming.end());
+      for (const int ingid : roundIncoming)
+      {
+        if (ingid != selfid && block->FanInReceived.find(ingid) == block->FanInReceived.end())
+        {
+          return true; // wait for the data of this partner
+        }
+      }
+
+      viskores::cont::Timer totalTimer;
+      totalTimer.Start();
+      std::stringstream timingsStream;
+      FanInRoundStatistics roundStatistics = this->StartRound(block, round);
+      for (const int ingid : roundIncoming)
+      {
+        if (ingid != selfid)
+        {
+          auto received = block->FanInReceived.find(ingid);
+          roundStatistics.BytesReceived += received->second.NumberOfBytes;
+          timingsStream << "      Subphase of Merge Block" << std::endl;
+          this->MergeBlock(block,
+                           received->second.BlockOrigin,
+                           received->second.BlockSize,
+                           received->second.Mesh,
+                           rank,
+                           selfid,
+                           ingid,
+                           round,
+                           timingsStream);
+          block->FanInReceived.erase(received);
+        }
+      }
+
+      std::vector<int> roundOutgoing;
+      if (round < numRounds)
+      {
+        partners.outgoing(static_cast<int>(round), selfid, roundOutgoing, *icp.master());
+      }
+      bool sendsToOthers = false;
+      for (const int outgid : roundOutgoing)
+      {
+        sendsToOthers = sendsToOthers || (outgid != selfid);
+      }
+      // the contour tree mesh of round 0 was pre-computed by the filter
+      if (round != 0 && sendsToOthers)
+      {
+        this->ComputeTreesToSend(block, rank, selfid, round);
+      }
+      roundStatistics.ComputeSeconds = totalTimer.GetElapsedTime();
+
+      for (const int outgid : roundOutgoing)
+      {
+        if (outgid != selfid)
+        {
+          viskoresdiy::BlockID target{ outgid, assigner.rank(outgid) };
+          roundStatistics.BytesSent +=
+            this->EnqueueBlock(block, icp, target, rank, selfid, round, true);
+        }
+      }
+      this->EndRound(block, roundStatistics);
+
+      VISKORES_LOG_S(this->TimingsLogLevel,
+                     std::endl
+                       << "    ---------------- Fan In Asynchronous Step ---------------------"
+                       << std::endl
+                       << "    Rank    : " << rank << std::endl
+                       << "    DIY Id  : " << selfid << std::endl
+                       << "    Round   : " << round << std::endl
+                       << timingsStream.str() << "    " << std::setw(38) << std::left
+                       << "Total Time Round"
+                       << ": " << totalTimer.GetElapsedTime() << " seconds" << std::endl);
+      block->FanInRound++;
+    }
+    return true;
+  } // ProcessAvailableRounds
+
 
 private:
+  /// Start the statistics of a fan in round of the block
+  FanInRoundStatistics StartRound(
+    viskores::worklet::contourtree_distributed::DistributedContourTreeBlockData<FieldType>* block,
+    unsigned int round) const
+  {
+    FanInRoundStatistics roundStatistics;
+    roundStatistics.Round = round;
+    if (block->FanInWaitTimer.Started())
+    {
+      roundStatistics.WaitSeconds = block->FanInWaitTimer.GetElapsedTime();
+    }
+    return roundStatistics;
+  }
+
+  /// Record the statistics of a fan in round and start timing the wait for the next one
+  void EndRound(
+    viskores::worklet::contourtree_distributed::DistributedContourTreeBlockData<FieldType>* block,
+    const FanInRoundStatistics& roundStatistics) const
+  {
+    block->FanInStatistics.push_back(roundStatistics);
+    block->FanInWaitTimer.Start();
+  }
+
+  /// Merge the contour tree mesh received from another block into the block and compute the
+  /// contour tree of the combined mesh
+  void MergeBlock(
+    viskores::worklet::contourtree_distributed::DistributedContourTreeBlockData<FieldType>* block,
+    const viskores::Id3& otherBlockOrigin,
+    const viskores::Id3& otherBlockSize,
+    viskores::worklet::contourtree_augmented::ContourTreeMesh<FieldType>& otherContourTreeMesh,
+    viskores::Id rank,
+    int selfid,
+    int ingid,
+    unsigned int round,
+    std::stringstream& timingsStream) const
+  {
+    viskores::cont::Timer loopTimer; // time the steps of the merge
+    loopTimer.Start();
+
+    // Merge the two contour tree meshes
+    std::stringstream mergeMessageStream;
+    mergeMessageStream << "    Rank    : " << rank << std::endl
+                       << "    DIY Id  : " << selfid << std::endl
+                       << "    Other Id: " << ingid << std::endl
+                       << "    Round   : " << round << std::endl;
+    block->ContourTreeMeshes.back().MergeWith(
+      otherContourTreeMesh, this->TimingsLogLevel, mergeMessageStream.str());
+
+    timingsStream << "        |-->" << std::setw(38) << std::left << "Merge Contour Tree Mesh"
+                  << ": " << loopTimer.GetElapsedTime() << " seconds" << std::endl;
+    loopTimer.Start();
+
+#ifdef DEBUG_PRINT_CTUD
+    // save the corresponding .gv file for the contour tree mesh
+    std::string contourTreeMeshFileName = std::string("Rank_") +
+      std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
+      std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
+      std::to_string(round) + "_Partner_" + std::to_string(ingid) +
+      std::string("_Step_0_Combined_Mesh.gv");
+    std::string contourTreeMeshLabel = std::string("Block ") +
+      std::to_string(static_cast<int>(block->LocalBlockNo)) + " Round " +
+      std::to_string(round) + " Partner " + std::to_string(ingid) +
+      std::string(" Step 0 Combined Mesh");
+    std::string contourTreeMeshString =
+      viskores::worklet::contourtree_distributed::ContourTreeMeshDotGraphPrint<FieldType>(
+        contourTreeMeshLabel,
+        block->ContourTreeMeshes.back(),
+        worklet::contourtree_distributed::SHOW_CONTOUR_TREE_MESH_ALL);
+    std::ofstream contourTreeMeshFile(contourTreeMeshFileName);
+    contourTreeMeshFile << contourTreeMeshString;
+    timingsStream << "        |-->" << std::setw(38) << std::left
+                  << "Save Contour Tree Mesh Dot"
+                  << ": " << loopTimer.GetElapsedTime() << " seconds" << std::endl;
+    loopTimer.Start();
+#endif
+
+    // Compute the origin and size of the new block
+    viskores::Id3 currBlockOrigin{
+      std::min(otherBlockOrigin[0], block->BlockOrigin[0]),
+      std::min(otherBlockOrigin[1], block->BlockOrigin[1]),
+      std::min(otherBlockOrigin[2], block->BlockOrigin[2]),
+    };
+    viskores::Id3 currBlockMaxIndex{ // Needed only to compute the block size
+                                     std::max(otherBlockOrigin[0] + otherBlockSize[0],
+                                              block->BlockOrigin[0] + block->BlockSize[0]),
+                                     std::max(otherBlockOrigin[1] + otherBlockSize[1],
+                                              block->BlockOrigin[1] + block->BlockSize[1]),
+                                     std::max(otherBlockOrigin[2] + otherBlockSize[2],
+                                              block->BlockOrigin[2] + block->BlockSize[2])
+    };
+    viskores::Id3 currBlockSize{ currBlockMaxIndex[0] - currBlockOrigin[0],
+                                 currBlockMaxIndex[1] - currBlockOrigin[1],
+                                 currBlockMaxIndex[2] - currBlockOrigin[2] };
+
+    // Compute the contour tree from our merged mesh
+    viskores::Id currNumIterations;
+    block->ContourTrees.emplace_back(); // Create new empty contour tree object
+    viskores::worklet::contourtree_augmented::IdArrayType currSortOrder;
+    viskores::worklet::ContourTreeAugmented worklet;
+    worklet.TimingsLogLevel =
+      viskores::cont::LogLevel::Off; // disable the print logging, we'll print this later
+    viskores::Id3 maxIdx{ currBlockOrigin[0] + currBlockSize[0] - 1,
+                          currBlockOrigin[1] + currBlockSize[1] - 1,
+                          currBlockOrigin[2] + currBlockSize[2] - 1 };
+    auto meshBoundaryExecObj = block->ContourTreeMeshes.back().GetMeshBoundaryExecutionObject(
+      this->GlobalSize, currBlockOrigin, maxIdx);
+    try
+    {
+      worklet.Run(block->ContourTreeMeshes.back()
+                    .SortedValues, // Unused param. Provide something to keep the API happy
+                  block->ContourTreeMeshes.back(),
+                  block->ContourTrees.back(),
+                  currSortOrder,
+                  currNumIterations,
+                  1, // Fully augmented
+                  meshBoundaryExecObj);
+    }
+    // In case the contour tree got stuck, expand the debug information from
+    // the message to check whether we combined bad blocks
+    catch (const viskores::cont::ErrorInternal& ex)
+    {
+      std::stringstream ex_message;
+      ex_message << ex.what();
+      ex_message << " Self/In DIY Id=(" << selfid << ", " << ingid << ")";
+      ex_message << " Rank=" << rank << " Round=" << round;
+      ex_message << " Origin Self=(" << block->BlockOrigin[0] << ", " << block->BlockOrigin[1]
+                 << ", " << block->BlockOrigin[2] << ")";
+      ex_message << " Origin In=(" << otherBlockOrigin[0] << ", " << otherBlockOrigin[1] << ", "
+                 << otherBlockOrigin[2] << ")";
+      ex_message << " Origin Comb=(" << currBlockOrigin[0] << ", " << currBlockOrigin[1] << ", "
+                 << currBlockOrigin[2] << ")";
+      ex_message << " Size Self=(" << block->BlockSize[0] << ", " << block->BlockSize[1] << ", "
+                 << block->BlockSize[2] << ")";
+      ex_message << " Size In=(" << otherBlockSize[0] << ", " << otherBlockSize[1] << ", "
+                 << otherBlockSize[2] << ")";
+      ex_message << " Size Comb=(" << currBlockSize[0] << ", " << currBlockSize[1] << ", "
+                 << currBlockSize[2] << ")";
+      std::throw_with_nested(viskores::cont::ErrorInternal(ex_message.str()));
+    }
+
+    // Update block extents
+    block->BlockOrigin = currBlockOrigin;
+    block->BlockSize = currBlockSize;
+
+    timingsStream << "        |-->" << std::setw(38) << std::left
+                  << "Compute Joint Contour Tree"
+                  << ": " << loopTimer.GetElapsedTime() << " seconds" << std::endl;
+    loopTimer.Start();
+
+#ifdef DEBUG_PRINT_CTUD
+    /*
+    // TODO: GET THIS COMPILING. NEED TO LIKELY PUT THIS IN A SEPARATE FUNCTION TO GET THE STORAGE TYPE TEMPLATE PARAMETER
+    // TODO/FIXME: At this time we should only be dealing with contour tree meshes and not possibly other mesh types,
+    // and block does not have a Meshes member. Shouldn't this all be ContourTreeMesh instead?
+    // and the ones for the contour tree regular and superstructures
+    std::string regularStructureFileName = std::string("Rank_") +
+      std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
+      std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
+      std::to_string(round) + " Partner " + std::to_string(ingid) +
+      std::string("_Step_1_Contour_Tree_Regular_Structure.gv");
+    std::string regularStructureLabel = std::string("Block ") +
+      std::to_string(static_cast<int>(block->LocalBlockNo)) + " Round " +
+      std::to_string(round) + " Partner " + std::to_string(ingid) +
+      std::string(" Step 1 Contour Tree Regular Structure");
+    std::string regularStructureString =
+                  worklet::contourtree_distributed::ContourTreeDotGraphPrint < FieldType,
+                MeshType,
+                viskores::worklet::contourtree_augmented::IdArrayType()(
+                  regularStructureLabel,
+                  block->Meshes.back(),
+                  block->ContourTrees.back(),
+                  worklet::contourtree_distributed::SHOW_REGULAR_STRUCTURE |
+                    worklet::contourtree_distributed::SHOW_ALL_IDS);
+    std::ofstream regularStructureFile(regularStructureFileName);
+    regularStructureFile << regularStructureString;
+
+    std::string superStructureFileName = std::string("Rank_") +
+      std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
+      std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
+      std::to_string(round) + " Partner " + std::to_string(ingid) +
+      std::string("_Step_2_Contour_Tree_Super_Structure.gv");
+    std::ofstream superStructureFile(superStructureFileName);
+    superStructureFile << worklet::contourtree_distributed::ContourTreeDotGraphPrint < T,
+      MeshType,
+      viskores::worklet::contourtree_augmented::IdArrayType()(
+        std::string("Block ") + std::to_string(static_cast<int>(block->LocalBlockNo)) +
+          " Round " + std::to_string(round) + " Partner " + std::to_string(ingid) +
+          std::string(" Step 2 Contour Tree Super Structure"),
+        block->Meshes.back(),
+        block->ContourTrees.back(),
+        worklet::contourtree_distributed::SHOW_SUPER_STRUCTURE |
+          worklet::contourtree_distributed::SHOW_HYPER_STRUCTURE |
+          worklet::contourtree_distributed::SHOW_ALL_IDS |
+          worklet::contourtree_distributed::SHOW_ALL_SUPERIDS |
+          worklet::contourtree_distributed::SHOW_ALL_HYPERIDS);
+    */
+#endif
+
+    // Log the contour tree timiing stats
+    (void)rank; // Suppress unused variable warning if logging is disabled.
+    VISKORES_LOG_S(this->TimingsLogLevel,
+                   std::endl
+                     << "    ---------------- Contour Tree Worklet Timings ------------------"
+                     << std::endl
+                     << "    Rank    : " << rank << std::endl
+                     << "    DIY Id  : " << selfid << std::endl
+                     << "    In Id   : " << ingid << std::endl
+                     << "    Round   : " << round << std::endl
+                     << worklet.TimingsLogString);
+    // Log the contour tree size stats
+    VISKORES_LOG_S(this->TreeLogLevel,
+                   std::endl
+                     << "    ---------------- Contour Tree Array Sizes ---------------------"
+                     << std::endl
+                     << "    Rank    : " << rank << std::endl
+                     << "    DIY Id  : " << selfid << std::endl
+                     << "    In Id   : " << ingid << std::endl
+                     << "    Round   : " << round << std::endl
+                     << block->ContourTrees.back().PrintArraySizes());
+
+  }
+
+  /// Compute the boundary tree and interior forest of the block and the contour tree mesh to send
+  void ComputeTreesToSend(
+    viskores::worklet::contourtree_distributed::DistributedContourTreeBlockData<FieldType>* block,
+    viskores::Id rank,
+    int selfid,
+    unsigned int round) const
+  {
+    (void)rank;
+    (void)selfid;
+    viskores::Id3 maxIdx{ block->BlockOrigin[0] + block->BlockSize[0] - 1,
+                          block->BlockOrigin[1] + block->BlockSize[1] - 1,
+                          block->BlockOrigin[2] + block->BlockSize[2] - 1 };
+
+    // Compute BRACT
+    viskores::worklet::contourtree_distributed::BoundaryTree boundaryTree;
+    // ... Get the mesh boundary object
+    auto meshBoundaryExecObj = block->ContourTreeMeshes.back().GetMeshBoundaryExecutionObject(
+      this->GlobalSize, block->BlockOrigin, maxIdx);
+    // Make the BRACT and InteriorForest (i.e., residue)
+    block->InteriorForests.emplace_back();
+    auto boundaryTreeMaker = viskores::worklet::contourtree_distributed::BoundaryTreeMaker<
+      viskores::worklet::contourtree_augmented::ContourTreeMesh<FieldType>,
+      viskores::worklet::contourtree_augmented::MeshBoundaryContourTreeMeshExec>(
+      &(block->ContourTreeMeshes.back()),
+      meshBoundaryExecObj,
+      block->ContourTrees.back(),
+      &boundaryTree,
+      &(block->InteriorForests.back()));
+    // Construct the BRACT and InteriorForest. Since we are working on a ContourTreeMesh we do
+    // not need to provide and IdRelabeler here in order to compute the InteriorForest
+    boundaryTreeMaker.Construct(nullptr, this->UseBoundaryExtremaOnly);
+    // Construct contour tree mesh from BRACT
+    block->ContourTreeMeshes.emplace_back(
+      boundaryTree.VertexIndex, boundaryTree.Superarcs, block->ContourTreeMeshes.back());
+
+#ifdef DEBUG_PRINT_CTUD
+    /*
+    // TODO: GET THIS COMPILING.
+    // TODO/FIXME: Need to get inggid here somehow
+    // save the Boundary Tree as a dot file
+    std::string boundaryTreeFileName = std::string("Rank_") +
+      std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
+      std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
+      std::to_string(round) + "_Partner_" + std::to_string(ingid) +
+      std::string("_Step_3_Boundary_Tree.gv");
+    std::ofstream boundaryTreeFile(boundaryTreeFileName);
+    boundaryTreeFile << viskores::worklet::contourtree_distributed::BoundaryTreeDotGraphPrint
+      (std::string("Block ") + std::to_string(static_cast<int>(block->LocalBlockNo)) + " Round " +
+       std::to_string(round) + " Partner " + std::to_string(ingid) +
+       std::string(" Step 3 Boundary Tree"),
+       block->Meshes.back()],
+       block->BoundaryTrees.back());
+
+    // and save the Interior Forest as another dot file
+    std::string interiorForestFileName = std::string("Rank_") +
+      std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
+      std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
+      std::to_string(round) + "_Partner_" + std::to_string(ingid) +
+      std::string("_Step_4_Interior_Forest.gv");
+    std::ofstream interiorForestFile(interiorForestFileName);
+    interiorForestFileName << InteriorForestDotGraphPrintFile<MeshType>(
+      std::string("Block ") + std::to_string(static_cast<int>(block->LocalBlockNo)) + " Round " +
+        std::to_string(round) + " Partner " + std::to_string(ingid) +
+        std::string(" Step 4 Interior Forest"),
+      block->InteriorForests.back(),
+      block->ContourTrees.back(),
+      block->BoundaryTrees.back(),
+      block->Meshes.back());
+
+    // save the corresponding .gv file
+    std::string boundaryTreeMeshFileName = std::string("Rank_") +
+      std::to_string(static_cast<int>(rank)) + std::string("_Block_") +
+      std::to_string(static_cast<int>(block->LocalBlockNo)) + "_Round_" +
+      std::to_string(round) + "_Partner_" + std::to_string(ingid) +
+      std::string("_Step_5_Boundary_Tree_Mesh.gv");
+    std::ofstream boundaryTreeMeshFile(boundaryTreeMeshFileName);
+    boundaryTreeMeshFile
+      << viskores::worklet::contourtree_distributed::ContourTreeMeshDotGraphPrint<FieldType>(
+           std::string("Block ") + std::to_string(static_cast<int>(block->LocalBlockNo)) +
+             " Round " + std::to_string(round) + " Partner " + std::to_string(ingid) +
+             std::string(" Step 5 Boundary Tree Mesh"),
+           block->ContourTreeMeshes.back(),
+           worklet::contourtree_distributed::SHOW_CONTOUR_TREE_MESH_ALL);
+    */
+#endif
+
+    // Log the boundary tree size statistics
+    VISKORES_LOG_S(this->TreeLogLevel,
+                   std::endl
+                     << "    ---------------- Boundary Tree Array Sizes ---------------------"
+                     << std::endl
+                     << "    Rank    : " << rank << std::endl
+                     << "    DIY Id  : " << selfid << std::endl
+                     << "    Round   : " << round << std::endl
+                     << boundaryTree.PrintArraySizes());
+    // Log the interior forest statistics
+    VISKORES_LOG_S(this->TreeLogLevel,
+                   std::endl
+                     << "    ---------------- Interior Forest Array Sizes ---------------------"
+                     << std::endl
+                     << "    Rank    : " << rank << std::endl
+                     << "    DIY Id  : " << selfid << std::endl
+                     << "    Round   : " << round << std::endl
+                     << block->InteriorForests.back().PrintArraySizes());
+  }
+
+  /// Enqueue the current block for the target and return the number of bytes enqueued. The
+  /// iexchange used by the asynchronous fan in needs the arrays inline with the rest of the data.
+  std::size_t EnqueueBlock(
+    viskores::worklet::contourtree_distributed::DistributedContourTreeBlockData<FieldType>* block,
+    const viskoresdiy::Master::Proxy& proxy,
+    const viskoresdiy::BlockID& target,
+    viskores::Id rank,
+    int selfid,
+    unsigned int round,
+    bool inlineArrays) const
+  {
+    const std::size_t bytesBefore = proxy.outgoing(target).size();
+    if (inlineArrays)
+    {
+      InlineBlobBuffer outgoingBuffer(proxy.outgoing(target));
+      viskoresdiy::save(outgoingBuffer, block->BlockOrigin);
+      viskoresdiy::save(outgoingBuffer, block->BlockSize);
+      viskoresdiy::save(outgoingBuffer, block->ContourTreeMeshes.back());
+    }
+    else
+    {
+      proxy.enqueue(target, block->BlockOrigin);
+      proxy.enqueue(target, block->BlockSize);
+      proxy.enqueue(target, block->ContourTreeMeshes.back());
+    }
+    (void)rank;
+    VISKORES_LOG_S(this->TreeLogLevel,
+                   std::endl
+                     << "FanInEnqueue: Rank=" << rank << "; Round=" << round
+                     << "; DIY Send Id=" << selfid << "; DIY Target ID=" << target.gid
+                     << std::endl);
+    return proxy.outgoing(target).size() - bytesBefore;
+  }
+
   /// Extends of the global mesh
   viskores::Id3 GlobalSize;
 
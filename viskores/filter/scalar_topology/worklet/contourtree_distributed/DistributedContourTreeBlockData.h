@@ -52,7 +52,11 @@
 #ifndef viskores_worklet_contourtree_distributed_contourtreeblockdata_h
 #define viskores_worklet_contourtree_distributed_contourtreeblockdata_h
 
+#include <map>
+#include <vector>
+
 #include <viskores/Types.h>
+#include <viskores/cont/Timer.h>
 #include <viskores/filter/scalar_topology/worklet/contourtree_augmented/Types.h>
 #include <viskores/filter/scalar_topology/worklet/contourtree_augmented/meshtypes/ContourTreeMesh.h>
 #include <viskores/filter/scalar_topology/worklet/contourtree_distributed/HierarchicalAugmenter.h>
@@ -71,6 +75,28 @@ namespace worklet
 {
 namespace contourtree_distributed
 {
+/// Time and communication volume of one fan in round of a block
+struct FanInRoundStatistics
+{
+  unsigned int Round = 0;
+  /// Time from the end of the previous round of the block to the start of this round
+  viskores::Float64 WaitSeconds = 0.0;
+  /// Time to merge the received blocks and to compute the trees to send
+  viskores::Float64 ComputeSeconds = 0.0;
+  std::size_t BytesReceived = 0;
+  std::size_t BytesSent = 0;
+};
+
+/// Block data received during an asynchronous fan in before the round in which it is merged
+template <typename FieldType>
+struct FanInReceivedBlock
+{
+  viskores::Id3 BlockOrigin;
+  viskores::Id3 BlockSize;
+  viskores::worklet::contourtree_augmented::ContourTreeMesh<FieldType> Mesh;
+  std::size_t NumberOfBytes = 0;
+};
+
 template <typename FieldType>
 struct DistributedContourTreeBlockData
 {
@@ -88,6 +114,15 @@ struct DistributedContourTreeBlockData
     ContourTreeMeshes;
   std::vector<viskores::worklet::contourtree_distributed::InteriorForest> InteriorForests;
 
+  // Fan in statistics, one entry per round
+  std::vector<FanInRoundStatistics> FanInStatistics;
+  viskores::cont::Timer FanInWaitTimer;
+
+  // Asynchronous fan in: the next round to process and the data received from partners of
+  // this or later rounds, indexed by the DIY id of the sender
+  unsigned int FanInRound = 0;
+  std::map<int, FanInReceivedBlock<FieldType>> FanInReceived;
+
   // Fan out data
   viskores::worklet::contourtree_distributed::HierarchicalContourTree<FieldType> HierarchicalTree;
 
@@ -0,0 +1,87 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_worklet_contourtree_distributed_inline_blob_buffer_h
+#define viskores_worklet_contourtree_distributed_inline_blob_buffer_h
+
+#include <viskores/thirdparty/diy/diy.h>
+
+#include <cstddef>
+
+namespace viskores
+{
+namespace worklet
+{
+namespace contourtree_distributed
+{
+
+/// DIY binary buffer that writes the binary blobs (i.e., the contents of the ArrayHandles)
+/// into the byte stream of the wrapped buffer instead of attaching them to it.
+///
+/// DIY's iexchange sends each blob to another rank as a separate message but does not count
+/// these messages as outstanding work, so it never detects that the exchange is complete.
+/// Serializing through this buffer sends each queue as a single message.
+struct InlineBlobBuffer : public viskoresdiy::BinaryBuffer
+{
+  explicit InlineBlobBuffer(viskoresdiy::BinaryBuffer& buffer)
+    : Buffer(buffer)
+  {
+  }
+
+  void save_binary(const char* x, std::size_t count) override
+  {
+    this->Buffer.save_binary(x, count);
+  }
+  void append_binary(const char* x, std::size_t count) override
+  {
+    this->Buffer.append_binary(x, count);
+  }
+  void load_binary(char* x, std::size_t count) override { this->Buffer.load_binary(x, count); }
+  void load_binary_back(char* x, std::size_t count) override
+  {
+    this->Buffer.load_binary_back(x, count);
+  }
+  char* grow(std::size_t count) override { return this->Buffer.grow(count); }
+  char* advance(std::size_t count) override { return this->Buffer.advance(count); }
+
+  void save_binary_blob(const char* x, std::size_t count) override
+  {
+    viskoresdiy::save(this->Buffer, count);
+    this->Buffer.save_binary(x, count);
+  }
+  void save_binary_blob(const char* x,
+                        std::size_t count,
+                        viskoresdiy::BinaryBlob::Deleter deleter) override
+  {
+    this->save_binary_blob(x, count);
+    // the data has been copied, so the owner of the blob can release it
+    if (deleter)
+    {
+      deleter(x);
+    }
+  }
+  viskoresdiy::BinaryBlob load_binary_blob() override
+  {
+    std::size_t count;
+    viskoresdiy::load(this->Buffer, count);
+    char* data = new char[count];
+    this->Buffer.load_binary(data, count);
+    return viskoresdiy::BinaryBlob{ viskoresdiy::BinaryBlob::Pointer{
+                                      data, [](const char p[]) { delete[] p; } },
+                                    count };
+  }
+
+private:
+  viskoresdiy::BinaryBuffer& Buffer;
+};
+
+} // namespace contourtree_distributed
+} // namespace worklet
+} // namespace viskores
+
+#endif
@@ -9,6 +9,8 @@
 #include <viskores/io/EncodePNG.h>
 #include <viskores/io/FileUtils.h>
 
+#include <viskores/cont/ErrorBadValue.h>
+#include <viskores/cont/ErrorInternal.h>
 #include <viskores/cont/Logging.h>
 #include <viskores/internal/Configure.h>
 
@@ -16,6 +18,539 @@ VISKORES_THIRDPARTY_PRE_INCLUDE
 #include <viskores/thirdparty/lodepng/viskoreslodepng/lodepng.h>
 VISKORES_THIRDPARTY_POST_INCLUDE
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <thread>
+
+namespace
+{
+
+// Images are encoded in horizontal stripes of at least this many bytes. Each stripe is
+// compressed on its own, so smaller stripes would cost compression for little speedup.
+constexpr std::size_t MinimumStripeSize = 1 << 16;
+
+// The largest data size of a PNG chunk.
+constexpr std::size_t MaximumChunkSize = 0x7fffffff;
+
+viskores::png::LodePNGCompressSettings MakeCompressSettings(viskores::IdComponent level)
+{
+  viskores::png::LodePNGCompressSettings settings;
+  viskores::png::lodepng_compress_settings_init(&settings);
+  if (level == 0)
+  {
+    settings.btype = 0;
+    return settings;
+  }
+  // Higher levels search a longer LZ77 window for longer matches. Level 6 is the default
+  // of lodepng.
+  constexpr unsigned WindowSize[] = { 256, 512, 1024, 2048, 2048, 2048, 8192, 16384, 32768 };
+  constexpr unsigned NiceMatch[] = { 16, 32, 64, 64, 128, 128, 258, 258, 258 };
+  settings.windowsize = WindowSize[level - 1];
+  settings.nicematch = NiceMatch[level - 1];
+  settings.lazymatching = (level >= 4) ? 1 : 0;
+  return settings;
+}
+
+// Calls `functor(index)` for each index in [0, count), each on its own thread.
+template <typename Functor>
+void ForEachStripe(std::size_t count, const Functor& functor)
+{
+  std::vector<std::future<void>> tasks;
+  for (std::size_t index = 1; index < count; ++index)
+  {
+    tasks.push_back(std::async(std::launch::async, functor, index));
+  }
+  functor(0);
+  for (auto& task : tasks)
+  {
+    task.get();
+  }
+}
+
+viskores::UInt32 Adler32(const unsigned char* data, std::size_t size)
+{
+  viskores::UInt32 sum1 = 1;
+  viskores::UInt32 sum2 = 0;
+  while (size > 0)
+  {
+    // 5552 is the most bytes that can be summed before the sums overflow.
+    std::size_t amount = std::min(size, std::size_t(5552));
+    size -= amount;
+    for (; amount > 0; --amount)
+    {
+      sum1 += *data++;
+      sum2 += sum1;
+    }
+    sum1 %= 65521;
+    sum2 %= 65521;
+  }
+  return (sum2 << 16) | sum1;
+}
+
+// Combines the checksums of two consecutive buffers given the size of the second one.
+viskores::UInt32 CombineAdler32(viskores::UInt32 first,
+                                viskores::UInt32 second,
+                                std::size_t secondSize)
+{
+  constexpr viskores::UInt32 Base = 65521;
+  const viskores::UInt32 remainder = static_cast<viskores::UInt32>(secondSize % Base);
+  viskores::UInt32 sum1 = first & 0xffff;
+  viskores::UInt32 sum2 = (remainder * sum1) % Base;
+  sum1 += (second & 0xffff) + Base - 1;
+  sum2 += (first >> 16) + (second >> 16) + Base - remainder;
+  sum1 = (sum1 >= Base) ? sum1 - Base : sum1;
+  sum1 = (sum1 >= Base) ? sum1 - Base : sum1;
+  sum2 = (sum2 >= 2 * Base) ? sum2 - 2 * Base : sum2;
+  sum2 = (sum2 >= Base) ? sum2 - Base : sum2;
+  return (sum2 << 16) | sum1;
+}
+
+/// Walks the blocks of a raw deflate stream (RFC 1951) without decompressing it to find
+/// where the final block starts and where the stream ends, to the bit. Stripes that are
+/// compressed separately are spliced into one stream at these positions.
+class DeflateScanner
+{
+public:
+  DeflateScanner(const std::vector<unsigned char>& data)
+    : Data(data)
+  {
+  }
+
+  void Scan(std::size_t& finalBlockBit, std::size_t& endBit)
+  {
+    bool final = false;
+    while (!final)
+    {
+      finalBlockBit = this->Position;
+      final = (this->Bits(1) != 0);
+      switch (this->Bits(2))
+      {
+        case 0:
+          this->SkipStored();
+          break;
+        case 1:
+          this->SkipFixed();
+          break;
+        case 2:
+          this->SkipDynamic();
+          break;
+        default:
+          throw viskores::cont::ErrorInternal("Invalid deflate block type.");
+      }
+    }
+    endBit = this->Position;
+  }
+
+private:
+  struct HuffmanCode
+  {
+    viskores::UInt16 Count[16];
+    viskores::UInt16 Symbol[288];
+  };
+
+  const std::vector<unsigned char>& Data;
+  std::size_t Position = 0;
+
+  unsigned Bits(int numberOfBits)
+  {
+    if (this->Position + static_cast<std::size_t>(numberOfBits) > 8 * this->Data.size())
+    {
+      throw viskores::cont::ErrorInternal("Deflate stream ended unexpectedly.");
+    }
+    unsigned value = 0;
+    for (int bit = 0; bit < numberOfBits; ++bit, ++this->Position)
+    {
+      value |= ((this->Data[this->Position >> 3] >> (this->Position & 7)) & 1u) << bit;
+    }
+    return value;
+  }
+
+  static void BuildCode(HuffmanCode& code, const unsigned char* lengths, int numberOfSymbols)
+  {
+    std::fill(code.Count, code.Count + 16, viskores::UInt16(0));
+    for (int symbol = 0; symbol < numberOfSymbols; ++symbol)
+    {
+      ++code.Count[lengths[symbol]];
+    }
+    viskores::UInt16 offsets[16];
+    offsets[1] = 0;
+    for (int length = 1; length < 15; ++length)
+    {
+      offsets[length + 1] = static_cast<viskores::UInt16>(offsets[length] + code.Count[length]);
+    }
+    for (int symbol = 0; symbol < numberOfSymbols; ++symbol)
+    {
+      if (lengths[symbol] != 0)
+      {
+        code.Symbol[offsets[lengths[symbol]]++] = static_cast<viskores::UInt16>(symbol);
+      }
+    }
+  }
+
+  // Canonical Huffman codes are read one bit at a time, most significant bit first.
+  int Decode(const HuffmanCode& code)
+  {
+    int value = 0;
+    int first = 0;
+    int index = 0;
+    for (int length = 1; length < 16; ++length)
+    {
+      value |= static_cast<int>(this->Bits(1));
+      const int count = code.Count[length];
+      if (value - count < first)
+      {
+        return code.Symbol[index + (value - first)];
+      }
+      index += count;
+      first = (first + count) << 1;
+      value <<= 1;
+    }
+    throw viskores::cont::ErrorInternal("Invalid Huffman code in deflate stream.");
+  }
+
+  void SkipStored()
+  {
+    this->Position = (this->Position + 7) & ~std::size_t(7);
+    const unsigned length = this->Bits(16);
+    if ((this->Bits(16) ^ 0xffff) != length)
+    {
+      throw viskores::cont::ErrorInternal("Invalid stored block in deflate stream.");
+    }
+    this->Position += 8 * std::size_t(length);
+  }
+
+  void SkipFixed()
+  {
+    unsigned char lengths[288 + 30];
+    std::fill(lengths, lengths + 144, static_cast<unsigned char>(8));
+    std::fill(lengths + 144, lengths + 256, static_cast<unsigned char>(9));
+    std::fill(lengths + 256, lengths + 280, static_cast<unsigned char>(7));
+    std::fill(lengths + 280, lengths + 288, static_cast<unsigned char>(8));
+    std::fill(lengths + 288, lengths + 288 + 30, static_cast<unsigned char>(5));
+    HuffmanCode lengthCode;
+    HuffmanCode distanceCode;
+    BuildCode(lengthCode, lengths, 288);
+    BuildCode(distanceCode, lengths + 288, 30);
+    this->SkipCodes(lengthCode, distanceCode);
+  }
+
+  void SkipDynamic()
+  {
+    static constexpr int Order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5,
+                                       11, 4,  12, 3, 13, 2, 14, 1, 15 };
+    const int numberOfLengths = static_cast<int>(this->Bits(5)) + 257;
+    const int numberOfDistances = static_cast<int>(this->Bits(5)) + 1;
+    const int numberOfCodeLengths = static_cast<int>(this->Bits(4)) + 4;
+
+    unsigned char lengths[288 + 32] = {};
+    for (int index = 0; index < numberOfCodeLengths; ++index)
+    {
+      lengths[Order[index]] = static_cast<unsigned char>(this->Bits(3));
+    }
+    HuffmanCode lengthCode;
+    BuildCode(lengthCode, lengths, 19);
+
+    const int total = numberOfLengths + numberOfDistances;
+    int index = 0;
+    while (index < total)
+    {
+      int symbol = this->Decode(lengthCode);
+      if (symbol < 16)
+      {
+        lengths[index++] = static_cast<unsigned char>(symbol);
+        continue;
+      }
+      unsigned char repeated = 0;
+      int repeat;
+      if (symbol == 16)
+      {
+        if (index == 0)
+        {
+          throw viskores::cont::ErrorInternal("Invalid code lengths in deflate stream.");
+        }
+        repeated = lengths[index - 1];
+        repeat = 3 + static_cast<int>(this->Bits(2));
+      }
+      else if (symbol == 17)
+      {
+        repeat = 3 + static_cast<int>(this->Bits(3));
+      }
+      else
+      {
+        repeat = 11 + static_cast<int>(this->Bits(7));
+      }
+      if (index + repeat > total)
+      {
+        throw viskores::cont::ErrorInternal("Invalid code lengths in deflate stream.");
+      }
+      std::fill(lengths + index, lengths + index + repeat, repeated);
+      index += repeat;
+    }
+
+    HuffmanCode distanceCode;
+    BuildCode(lengthCode, lengths, numberOfLengths);
+    BuildCode(distanceCode, lengths + numberOfLengths, numberOfDistances);
+    this->SkipCodes(lengthCode, distanceCode);
+  }
+
+  void SkipCodes(const HuffmanCode& lengthCode, const HuffmanCode& distanceCode)
+  {
+    static constexpr int LengthExtraBits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static constexpr int DistanceExtraBits[30] = { 0, 0, 0, 0, 1, 1, 2, 2,  3,  3,
+                                                   4, 4, 5, 5, 6, 6, 7, 7,  8,  8,
+                                                   9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    for (;;)
+    {
+      int symbol = this->Decode(lengthCode);
+      if (symbol < 256)
+      {
+        continue;
+      }
+      if (symbol == 256)
+      {
+        return;
+      }
+      symbol -= 257;
+      if (symbol >= 29)
+      {
+        throw viskores::cont::ErrorInternal("Invalid length symbol in deflate stream.");
+      }
+      this->Bits(LengthExtraBits[symbol]);
+      const int distance = this->Decode(distanceCode);
+      if (distance >= 30)
+      {
+        throw viskores::cont::ErrorInternal("Invalid distance symbol in deflate stream.");
+      }
+      this->Bits(DistanceExtraBits[distance]);
+    }
+  }
+};
+
+template <int Type>
+inline unsigned char FilterByte(int value, int left, int up, int upLeft)
+{
+  switch (Type)
+  {
+    case 0:
+      return static_cast<unsigned char>(value);
+    case 1:
+      return static_cast<unsigned char>(value - left);
+    case 2:
+      return static_cast<unsigned char>(value - up);
+    case 3:
+      return static_cast<unsigned char>(value - ((left + up) >> 1));
+    default:
+    {
+      // Paeth predictor, written without branches so that it vectorizes.
+      const int distanceLeft = std::abs(up - upLeft);
+      const int distanceUp = std::abs(left - upLeft);
+      const int distanceUpLeft = std::abs(left + up - 2 * upLeft);
+      const int prediction = ((distanceLeft <= distanceUp) && (distanceLeft <= distanceUpLeft))
+        ? left
+        : ((distanceUp <= distanceUpLeft) ? up : upLeft);
+      return static_cast<unsigned char>(value - prediction);
+    }
+  }
+}
+
+// Filters a row with the given filter type, passing each filtered byte and its index to
+// `functor`. Pixels of the first column have no left neighbors and are handled apart so
+// that the loop over the rest of the row vectorizes.
+template <int Type, typename Functor>
+inline void FilterBytes(const unsigned char* row,
+                        const unsigned char* previous,
+                        std::size_t size,
+                        std::size_t bytesPerPixel,
+                        Functor&& functor)
+{
+  for (std::size_t index = 0; index < bytesPerPixel; ++index)
+  {
+    functor(index, FilterByte<Type>(row[index], 0, previous[index], 0));
+  }
+  for (std::size_t index = bytesPerPixel; index < size; ++index)
+  {
+    functor(index,
+            FilterByte<Type>(row[index],
+                             row[index - bytesPerPixel],
+                             previous[index],
+                             previous[index - bytesPerPixel]));
+  }
+}
+
+template <int Type>
+std::size_t FilterCost(const unsigned char* row,
+                       const unsigned char* previous,
+                       std::size_t size,
+                       std::size_t bytesPerPixel)
+{
+  std::size_t cost = 0;
+  FilterBytes<Type>(row,
+                    previous,
+                    size,
+                    bytesPerPixel,
+                    [&](std::size_t, unsigned char value)
+                    {
+                      const int signedValue = static_cast<signed char>(value);
+                      cost += static_cast<std::size_t>(std::abs(signedValue));
+                    });
+  return cost;
+}
+
+template <int Type>
+void ApplyFilter(unsigned char* out,
+                 const unsigned char* row,
+                 const unsigned char* previous,
+                 std::size_t size,
+                 std::size_t bytesPerPixel)
+{
+  out[0] = static_cast<unsigned char>(Type);
+  FilterBytes<Type>(row,
+                    previous,
+                    size,
+                    bytesPerPixel,
+                    [&](std::size_t index, unsigned char value) { out[index + 1] = value; });
+}
+
+// Writes the filter type and the filtered bytes of one row to `out`. When `adaptive`, the
+// filter with the smallest sum of absolute values is chosen, as lodepng and libpng do;
+// otherwise the row is stored unfiltered.
+void FilterRow(unsigned char* out,
+               const unsigned char* row,
+               const unsigned char* previous,
+               std::size_t size,
+               std::size_t bytesPerPixel,
+               bool adaptive)
+{
+  int bestType = 0;
+  if (adaptive)
+  {
+    const std::size_t costs[5] = { FilterCost<0>(row, previous, size, bytesPerPixel),
+                                   FilterCost<1>(row, previous, size, bytesPerPixel),
+                                   FilterCost<2>(row, previous, size, bytesPerPixel),
+                                   FilterCost<3>(row, previous, size, bytesPerPixel),
+                                   FilterCost<4>(row, previous, size, bytesPerPixel) };
+    bestType = static_cast<int>(std::min_element(costs, costs + 5) - costs);
+  }
+  switch (bestType)
+  {
+    case 0:
+      ApplyFilter<0>(out, row, previous, size, bytesPerPixel);
+      break;
+    case 1:
+      ApplyFilter<1>(out, row, previous, size, bytesPerPixel);
+      break;
+    case 2:
+      ApplyFilter<2>(out, row, previous, size, bytesPerPixel);
+      break;
+    case 3:
+      ApplyFilter<3>(out, row, previous, size, bytesPerPixel);
+      break;
+    default:
+      ApplyFilter<4>(out, row, previous, size, bytesPerPixel);
+      break;
+  }
+}
+
+struct ImageLayout
+{
+  const unsigned char* Data;
+  std::size_t Width;
+  std::size_t Height;
+  std::size_t InputPixelSize;
+  // Smaller than the input pixel size when an opaque alpha channel is dropped.
+  std::size_t OutputPixelSize;
+
+  const unsigned char* Row(std::size_t y, std::vector<unsigned char>& buffer) const
+  {
+    const unsigned char* input = this->Data + y * this->Width * this->InputPixelSize;
+    if (this->OutputPixelSize == this->InputPixelSize)
+    {
+      return input;
+    }
+    for (std::size_t x = 0; x < this->Width; ++x)
+    {
+      std::memcpy(buffer.data() + x * this->OutputPixelSize,
+                  input + x * this->InputPixelSize,
+                  this->OutputPixelSize);
+    }
+    return buffer.data();
+  }
+};
+
+struct Stripe
+{
+  std::size_t FirstRow = 0;
+  std::size_t EndRow = 0;
+  std::size_t FilteredSize = 0;
+  viskores::UInt32 Adler = 1;
+  std::vector<unsigned char> Deflated;
+  std::size_t FinalBlockBit = 0;
+  std::size_t EndBit = 0;
+  unsigned Error = 0;
+};
+
+void EncodeStripe(const ImageLayout& image,
+                  const viskores::png::LodePNGCompressSettings& settings,
+                  bool adaptive,
+                  Stripe& stripe)
+{
+  const std::size_t rowSize = image.Width * image.OutputPixelSize;
+  std::vector<unsigned char> filtered((stripe.EndRow - stripe.FirstRow) * (rowSize + 1));
+  std::vector<unsigned char> currentBuffer(rowSize);
+  std::vector<unsigned char> previousBuffer(rowSize, 0);
+  const unsigned char* previous =
+    (stripe.FirstRow > 0) ? image.Row(stripe.FirstRow - 1, previousBuffer) : previousBuffer.data();
+  unsigned char* out = filtered.data();
+  for (std::size_t y = stripe.FirstRow; y < stripe.EndRow; ++y, out += rowSize + 1)
+  {
+    const unsigned char* current = image.Row(y, currentBuffer);
+    FilterRow(out, current, previous, rowSize, image.OutputPixelSize, adaptive);
+    previous = current;
+    std::swap(currentBuffer, previousBuffer);
+  }
+  stripe.FilteredSize = filtered.size();
+  stripe.Adler = Adler32(filtered.data(), filtered.size());
+
+  unsigned char* deflated = nullptr;
+  std::size_t deflatedSize = 0;
+  stripe.Error = viskores::png::lodepng_deflate(
+    &deflated, &deflatedSize, filtered.data(), filtered.size(), &settings);
+  if (!stripe.Error)
+  {
+    stripe.Deflated.assign(deflated, deflated + deflatedSize);
+  }
+  std::free(deflated);
+  if (!stripe.Error)
+  {
+    DeflateScanner(stripe.Deflated).Scan(stripe.FinalBlockBit, stripe.EndBit);
+  }
+}
+
+void AppendUInt32(std::vector<unsigned char>& out, viskores::UInt32 value)
+{
+  out.push_back(static_cast<unsigned char>(value >> 24));
+  out.push_back(static_cast<unsigned char>(value >> 16));
+  out.push_back(static_cast<unsigned char>(value >> 8));
+  out.push_back(static_cast<unsigned char>(value));
+}
+
+void AppendChunk(std::vector<unsigned char>& png,
+                 const char* type,
+                 const unsigned char* data,
+                 std::size_t size)
+{
+  AppendUInt32(png, static_cast<viskores::UInt32>(size));
+  const std::size_t start = png.size();
+  png.insert(png.end(), type, type + 4);
+  png.insert(png.end(), data, data + size);
+  AppendUInt32(png, viskores::png::lodepng_crc32(png.data() + start, size + 4));
+}
+
+} // anonymous namespace
+
 namespace viskores
 {
 namespace io
@@ -24,26 +559,173 @@ namespace io
 viskores::UInt32 EncodePNG(std::vector<unsigned char> const& image,
                            unsigned long width,
                            unsigned long height,
-                           std::vector<unsigned char>& output_png)
+                           std::vector<unsigned char>& output_png,
+                           viskores::IdComponent compressionLevel,
+                           viskores::IdComponent numberOfThreads)
 {
-  // The default is 8 bit RGBA; does anyone care to have more options?
-  // We can certainly add them in a backwards-compatible way if need be.
-  viskores::UInt32 error = viskores::png::lodepng::encode(
-    output_png, image, static_cast<unsigned int>(width), static_cast<unsigned int>(height));
-  if (error)
+  if (image.size() < std::size_t(4) * width * height)
   {
-    VISKORES_LOG_S(viskores::cont::LogLevel::Error,
-                   "LodePNG Encoder error number " << error << ": "
-                                                   << png::lodepng_error_text(error));
+    throw viskores::cont::ErrorBadValue("Image is smaller than its width and height.");
   }
-  return error;
+  return EncodePNG(
+    image.data(), width, height, 4, 8, output_png, compressionLevel, numberOfThreads);
 }
 
+viskores::UInt32 EncodePNG(const unsigned char* image,
+                           unsigned long width,
+                           unsigned long height,
+                           viskores::IdComponent numberOfComponents,
+                           viskores::IdComponent bitDepth,
+                           std::vector<unsigned char>& output_png,
+                           viskores::IdComponent compressionLevel,
+                           viskores::IdComponent numberOfThreads)
+{
+  if ((numberOfComponents != 3) && (numberOfComponents != 4))
+  {
+    throw viskores::cont::ErrorBadValue("PNG images must have 3 or 4 components.");
+  }
+  if ((bitDepth != 8) && (bitDepth != 16))
+  {
+    throw viskores::cont::ErrorBadValue("PNG images must have 8 or 16 bits per channel.");
+  }
+  if ((compressionLevel < 0) || (compressionLevel > 9))
+  {
+    throw viskores::cont::ErrorBadValue("PNG compression level must be between 0 and 9.");
+  }
+  if (numberOfThreads < 0)
+  {
+    throw viskores::cont::ErrorBadValue("Number of threads must not be negative.");
+  }
+  if ((width == 0) || (height == 0))
+  {
+    throw viskores::cont::ErrorBadValue("PNG images must have at least one pixel.");
+  }
+
+  const std::size_t channelSize = static_cast<std::size_t>(bitDepth / 8);
+  ImageLayout layout;
+  layout.Data = image;
+  layout.Width = width;
+  layout.Height = height;
+  layout.InputPixelSize = static_cast<std::size_t>(numberOfComponents) * channelSize;
+  layout.OutputPixelSize = layout.InputPixelSize;
+
+  std::size_t maximumStripes = static_cast<std::size_t>(numberOfThreads);
+  if (maximumStripes == 0)
+  {
+    maximumStripes = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  const std::size_t imageSize = layout.Height * layout.Width * layout.InputPixelSize;
+  const std::size_t numberOfStripes = std::max(
+    std::min({ imageSize / MinimumStripeSize, maximumStripes, layout.Height }), std::size_t(1));
+  std::vector<Stripe> stripes(numberOfStripes);
+  for (std::size_t index = 0; index < numberOfStripes; ++index)
+  {
+    stripes[index].FirstRow = layout.Height * index / numberOfStripes;
+    stripes[index].EndRow = layout.Height * (index + 1) / numberOfStripes;
+  }
+
+  if (numberOfComponents == 4)
+  {
+    std::vector<unsigned char> opaque(numberOfStripes, 0);
+    ForEachStripe(numberOfStripes,
+                  [&](std::size_t index)
+                  {
+                    const unsigned char* pixel =
+                      image + stripes[index].FirstRow * layout.Width * layout.InputPixelSize;
+                    const unsigned char* end =
+                      image + stripes[index].EndRow * layout.Width * layout.InputPixelSize;
+                    for (; pixel < end; pixel += layout.InputPixelSize)
+                    {
+                      for (std::size_t byte = 3 * channelSize; byte < 4 * channelSize; ++byte)
+                      {
+                        if (pixel[byte] != 0xff)
+                        {
+                          return;
+                        }
+                      }
+                    }
+                    opaque[index] = 1;
+                  });
+    if (std::find(opaque.begin(), opaque.end(), 0) == opaque.end())
+    {
+      layout.OutputPixelSize = 3 * channelSize;
+    }
+  }
+
+  const viskores::png::LodePNGCompressSettings settings = MakeCompressSettings(compressionLevel);
+  const bool adaptive = (compressionLevel > 0);
+  ForEachStripe(numberOfStripes,
+                [&](std::size_t index)
+                { EncodeStripe(layout, settings, adaptive, stripes[index]); });
+
+  // Splice the stripes into one zlib stream (RFC 1950). Every stripe but the last has its
+  // final block flag cleared and is followed by an empty stored block, which pads to a
+  // byte boundary so the next stripe can be copied as is.
+  std::vector<unsigned char> zlib;
+  const unsigned char method = 0x78;
+  const int levelFlag =
+    (compressionLevel < 2) ? 0 : ((compressionLevel < 6) ? 1 : ((compressionLevel == 6) ? 2 : 3));
+  const int checkedFlags = (levelFlag << 6) + (31 - (method * 256 + (levelFlag << 6)) % 31) % 31;
+  const unsigned char flags = static_cast<unsigned char>(checkedFlags);
+  zlib.push_back(method);
+  zlib.push_back(flags);
+  viskores::UInt32 adler = 1;
+  for (std::size_t index = 0; index < numberOfStripes; ++index)
+  {
+    const Stripe& stripe = stripes[index];
+    if (stripe.Error)
+    {
+      VISKORES_LOG_S(viskores::cont::LogLevel::Error,
+                     "LodePNG Encoder error number "
+                       << stripe.Error << ": " << png::lodepng_error_text(stripe.Error));
+      return stripe.Error;
+    }
+    const std::size_t start = zlib.size();
+    const std::size_t stripeSize = (stripe.EndBit + 7) / 8;
+    zlib.insert(zlib.end(), stripe.Deflated.data(), stripe.Deflated.data() + stripeSize);
+    if (index + 1 < numberOfStripes)
+    {
+      zlib[start + stripe.FinalBlockBit / 8] &=
+        static_cast<unsigned char>(~(1u << (stripe.FinalBlockBit % 8)));
+      if ((8 - stripe.EndBit % 8) % 8 < 3)
+      {
+        zlib.push_back(0);
+      }
+      const unsigned char emptyStoredBlock[] = { 0x00, 0x00, 0xff, 0xff };
+      zlib.insert(zlib.end(), emptyStoredBlock, emptyStoredBlock + 4);
+    }
+    adler = CombineAdler32(adler, stripe.Adler, stripe.FilteredSize);
+  }
+  AppendUInt32(zlib, adler);
+
+  output_png.clear();
+  const unsigned char signature[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+  output_png.insert(output_png.end(), signature, signature + 8);
+  std::vector<unsigned char> header;
+  AppendUInt32(header, static_cast<viskores::UInt32>(width));
+  AppendUInt32(header, static_cast<viskores::UInt32>(height));
+  header.push_back(static_cast<unsigned char>(bitDepth));
+  // Color type 2 is RGB and 6 is RGBA. Compression, filter, and interlace methods are 0.
+  header.push_back(static_cast<unsigned char>((layout.OutputPixelSize == 3 * channelSize) ? 2 : 6));
+  header.insert(header.end(), 3, 0);
+  AppendChunk(output_png, "IHDR", header.data(), header.size());
+  for (std::size_t offset = 0; offset < zlib.size(); offset += MaximumChunkSize)
+  {
+    AppendChunk(output_png,
+                "IDAT",
+                zlib.data() + offset,
+                std::min(MaximumChunkSize, zlib.size() - offset));
+  }
+  AppendChunk(output_png, "IEND", nullptr, 0);
+  return 0;
+}
 
 viskores::UInt32 SavePNG(std::string const& filename,
                          std::vector<unsigned char> const& image,
                          unsigned long width,
-                         unsigned long height)
+                         unsigned long height,
+                         viskores::IdComponent compressionLevel,
+                         viskores::IdComponent numberOfThreads)
 {
   if (!viskores::io::EndsWith(filename, ".png"))
   {
@@ -52,10 +734,15 @@ viskores::UInt32 SavePNG(std::string const& filename,
   }
 
   std::vector<unsigned char> output_png;
-  viskores::UInt32 error = EncodePNG(image, width, height, output_png);
+  viskores::UInt32 error =
+    EncodePNG(image, width, height, output_png, compressionLevel, numberOfThreads);
   if (!error)
   {
-    viskores::png::lodepng::save_file(output_png, filename);
+    error = viskores::png::lodepng::save_file(output_png, filename);
+    if (error)
+    {
+      VISKORES_LOG_S(viskores::cont::LogLevel::Error, "Could not write PNG file " << filename);
+    }
   }
   return error;
 }
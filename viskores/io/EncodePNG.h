@@ -12,6 +12,7 @@
 #include <viskores/Types.h>
 #include <viskores/io/viskores_io_export.h>
 
+#include <string>
 #include <vector>
 
 namespace viskores
@@ -19,18 +20,46 @@ namespace viskores
 namespace io
 {
 
+/// @brief Encode an 8-bit RGBA image as a PNG file in memory.
+///
+/// `image` holds `width` times `height` RGBA pixels starting at the top left corner.
+/// `compressionLevel` trades encoding speed for file size: 0 stores the pixels without
+/// compression, 1 is the fastest compression, and 9 the smallest. The default, 6, matches
+/// the lodepng defaults. The image is split into horizontal stripes that are filtered and
+/// compressed concurrently on up to `numberOfThreads` threads (0 uses all hardware threads).
+///
+/// Returns 0 on success or a lodepng error code.
 VISKORES_IO_EXPORT
 viskores::UInt32 EncodePNG(std::vector<unsigned char> const& image,
                            unsigned long width,
                            unsigned long height,
-                           unsigned char* out_png,
-                           std::size_t out_size);
+                           std::vector<unsigned char>& output_png,
+                           viskores::IdComponent compressionLevel = 6,
+                           viskores::IdComponent numberOfThreads = 0);
 
+/// @brief Encode an RGB or RGBA image with 8 or 16 bits per channel as a PNG file in memory.
+///
+/// `numberOfComponents` is 3 (RGB) or 4 (RGBA) and `bitDepth` is 8 or 16. 16-bit channels
+/// are stored big endian as in the PNG format. An alpha channel that is opaque everywhere
+/// is dropped from the file. See the overload above for the other arguments.
+VISKORES_IO_EXPORT
+viskores::UInt32 EncodePNG(const unsigned char* image,
+                           unsigned long width,
+                           unsigned long height,
+                           viskores::IdComponent numberOfComponents,
+                           viskores::IdComponent bitDepth,
+                           std::vector<unsigned char>& output_png,
+                           viskores::IdComponent compressionLevel = 6,
+                           viskores::IdComponent numberOfThreads = 0);
+
+/// @brief Encode an 8-bit RGBA image with `EncodePNG` and save it to a file.
 VISKORES_IO_EXPORT
 viskores::UInt32 SavePNG(std::string const& filename,
                          std::vector<unsigned char> const& image,
                          unsigned long width,
-                         unsigned long height);
+                         unsigned long height,
+                         viskores::IdComponent compressionLevel = 6,
+                         viskores::IdComponent numberOfThreads = 0);
 }
 } // viskores::io
 
@@ -104,6 +104,25 @@ ImageWriterBase::~ImageWriterBase() noexcept {}
 
 void ImageWriterBase::WriteDataSet(const viskores::cont::DataSet& dataSet,
                                    const std::string& colorFieldName)
+{
+  viskores::Id width;
+  viskores::Id height;
+  ColorArrayType pixels;
+  this->ExtractImage(dataSet, colorFieldName, width, height, pixels);
+
+  if (CreateDirectoriesFromFilePath(this->FileName))
+  {
+    VISKORES_LOG_S(viskores::cont::LogLevel::Info,
+                   "Created output directory: " << ParentPath(this->FileName));
+  }
+  this->Write(width, height, pixels);
+}
+
+void ImageWriterBase::ExtractImage(const viskores::cont::DataSet& dataSet,
+                                   const std::string& colorFieldName,
+                                   viskores::Id& width,
+                                   viskores::Id& height,
+                                   ColorArrayType& pixels) const
 {
   using CellSetType = viskores::cont::CellSetStructured<2>;
   if (!dataSet.GetCellSet().IsType<CellSetType>())
@@ -114,8 +133,8 @@ void ImageWriterBase::WriteDataSet(const viskores::cont::DataSet& dataSet,
   CellSetType cellSet = dataSet.GetCellSet().AsCellSet<CellSetType>();
   viskores::Id2 cellDimensions = cellSet.GetCellDimensions();
   // Number of points is one more in each dimension than number of cells
-  viskores::Id width = cellDimensions[0] + 1;
-  viskores::Id height = cellDimensions[1] + 1;
+  width = cellDimensions[0] + 1;
+  height = cellDimensions[1] + 1;
 
   viskores::cont::Field colorField;
   if (!colorFieldName.empty())
@@ -149,12 +168,7 @@ void ImageWriterBase::WriteDataSet(const viskores::cont::DataSet& dataSet,
     }
   }
 
-  if (CreateDirectoriesFromFilePath(this->FileName))
-  {
-    VISKORES_LOG_S(viskores::cont::LogLevel::Info,
-                   "Created output directory: " << ParentPath(this->FileName));
-  }
-  this->Write(width, height, NormalizeColors(colorField.GetData()));
+  pixels = NormalizeColors(colorField.GetData());
 }
 
 } // namespace viskores::io
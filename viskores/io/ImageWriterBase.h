@@ -75,6 +75,14 @@ protected:
   VISKORES_CONT virtual void Write(viskores::Id width,
                                    viskores::Id height,
                                    const ColorArrayType& pixels) = 0;
+
+  /// Finds the color field of a data set as described in `WriteDataSet` and returns the
+  /// size of the image and its normalized colors.
+  VISKORES_CONT void ExtractImage(const viskores::cont::DataSet& dataSet,
+                                  const std::string& colorField,
+                                  viskores::Id& width,
+                                  viskores::Id& height,
+                                  ColorArrayType& pixels) const;
 };
 }
 }
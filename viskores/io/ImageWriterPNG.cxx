@@ -9,12 +9,75 @@
 
 #include <viskores/io/ImageWriterPNG.h>
 
+#include <viskores/cont/ErrorBadValue.h>
+#include <viskores/cont/Logging.h>
+#include <viskores/io/EncodePNG.h>
+#include <viskores/io/ErrorIO.h>
+#include <viskores/io/FileUtils.h>
 #include <viskores/io/PixelTypes.h>
 
 VISKORES_THIRDPARTY_PRE_INCLUDE
 #include <viskores/thirdparty/lodepng/viskoreslodepng/lodepng.h>
 VISKORES_THIRDPARTY_POST_INCLUDE
 
+namespace
+{
+
+template <typename PixelType>
+std::vector<unsigned char> PackPixels(viskores::Id width,
+                                      viskores::Id height,
+                                      const viskores::io::ImageWriterBase::ColorArrayType& pixels)
+{
+  auto pixelPortal = pixels.ReadPortal();
+  std::vector<unsigned char> imageData(static_cast<typename std::vector<unsigned char>::size_type>(
+    pixels.GetNumberOfValues() * PixelType::BYTES_PER_PIXEL));
+
+  // Write out the data starting from the end (Images are stored Bottom-Left to Top-Right,
+  // but are viewed from Top-Left to Bottom-Right)
+  viskores::Id pngIndex = 0;
+  for (viskores::Id yIndex = height - 1; yIndex >= 0; yIndex--)
+  {
+    for (viskores::Id xIndex = 0; xIndex < width; xIndex++)
+    {
+      viskores::Id viskoresIndex = yIndex * width + xIndex;
+      PixelType(pixelPortal.Get(viskoresIndex))
+        .FillImageAtIndexWithPixel(imageData.data(), pngIndex);
+      pngIndex++;
+    }
+  }
+  return imageData;
+}
+
+void EncodeAndSave(const std::string& fileName,
+                   const std::vector<unsigned char>& imageData,
+                   viskores::Id width,
+                   viskores::Id height,
+                   viskores::IdComponent bitDepth,
+                   viskores::IdComponent compressionLevel,
+                   viskores::IdComponent numberOfThreads)
+{
+  std::vector<unsigned char> png;
+  viskores::UInt32 error = viskores::io::EncodePNG(imageData.data(),
+                                                   static_cast<unsigned long>(width),
+                                                   static_cast<unsigned long>(height),
+                                                   3,
+                                                   bitDepth,
+                                                   png,
+                                                   compressionLevel,
+                                                   numberOfThreads);
+  if (!error)
+  {
+    error = viskores::png::lodepng::save_file(png, fileName);
+  }
+  if (error)
+  {
+    throw viskores::io::ErrorIO("Could not write PNG file " + fileName + ": " +
+                                viskores::png::lodepng_error_text(error));
+  }
+}
+
+} // anonymous namespace
+
 namespace viskores
 {
 namespace io
@@ -22,6 +85,70 @@ namespace io
 
 ImageWriterPNG::~ImageWriterPNG() noexcept {}
 
+void ImageWriterPNG::SetCompressionLevel(viskores::IdComponent level)
+{
+  if ((level < 0) || (level > 9))
+  {
+    throw viskores::cont::ErrorBadValue("PNG compression level must be between 0 and 9.");
+  }
+  this->CompressionLevel = level;
+}
+
+void ImageWriterPNG::SetNumberOfThreads(viskores::IdComponent numberOfThreads)
+{
+  if (numberOfThreads < 0)
+  {
+    throw viskores::cont::ErrorBadValue("Number of threads must not be negative.");
+  }
+  this->NumberOfThreads = numberOfThreads;
+}
+
+std::future<void> ImageWriterPNG::WriteDataSetAsync(const viskores::cont::DataSet& dataSet,
+                                                    const std::string& colorField)
+{
+  viskores::Id width;
+  viskores::Id height;
+  ColorArrayType pixels;
+  this->ExtractImage(dataSet, colorField, width, height, pixels);
+
+  std::vector<unsigned char> imageData;
+  viskores::IdComponent bitDepth = 0;
+  switch (this->Depth)
+  {
+    case PixelDepth::PIXEL_8:
+      imageData = PackPixels<viskores::io::RGBPixel_8>(width, height, pixels);
+      bitDepth = viskores::io::RGBPixel_8::GetBitDepth();
+      break;
+    case PixelDepth::PIXEL_16:
+      imageData = PackPixels<viskores::io::RGBPixel_16>(width, height, pixels);
+      bitDepth = viskores::io::RGBPixel_16::GetBitDepth();
+      break;
+  }
+
+  if (CreateDirectoriesFromFilePath(this->FileName))
+  {
+    VISKORES_LOG_S(viskores::cont::LogLevel::Info,
+                   "Created output directory: " << ParentPath(this->FileName));
+  }
+  return std::async(std::launch::async,
+                    [fileName = this->FileName,
+                     imageData = std::move(imageData),
+                     width,
+                     height,
+                     bitDepth,
+                     compressionLevel = this->CompressionLevel,
+                     numberOfThreads = this->NumberOfThreads]()
+                    {
+                      EncodeAndSave(fileName,
+                                    imageData,
+                                    width,
+                                    height,
+                                    bitDepth,
+                                    compressionLevel,
+                                    numberOfThreads);
+                    });
+}
+
 void ImageWriterPNG::Write(viskores::Id width, viskores::Id height, const ColorArrayType& pixels)
 {
   switch (this->Depth)
@@ -40,31 +167,13 @@ void ImageWriterPNG::WriteToFile(viskores::Id width,
                                  viskores::Id height,
                                  const ColorArrayType& pixels)
 {
-  auto pixelPortal = pixels.ReadPortal();
-  std::vector<unsigned char> imageData(static_cast<typename std::vector<unsigned char>::size_type>(
-    pixels.GetNumberOfValues() * PixelType::BYTES_PER_PIXEL));
-
-  // Write out the data starting from the end (Images are stored Bottom-Left to Top-Right,
-  // but are viewed from Top-Left to Bottom-Right)
-  viskores::Id pngIndex = 0;
-  for (viskores::Id yIndex = height - 1; yIndex >= 0; yIndex--)
-  {
-    for (viskores::Id xIndex = 0; xIndex < width; xIndex++)
-    {
-      viskores::Id viskoresIndex = yIndex * width + xIndex;
-      PixelType(pixelPortal.Get(viskoresIndex))
-        .FillImageAtIndexWithPixel(imageData.data(), pngIndex);
-      pngIndex++;
-    }
-  }
-
-  viskores::png::lodepng_encode_file(
-    this->FileName.c_str(),
-    imageData.data(),
-    static_cast<unsigned>(width),
-    static_cast<unsigned>(height),
-    static_cast<viskores::png::LodePNGColorType>(PixelType::GetColorType()),
-    PixelType::GetBitDepth());
+  EncodeAndSave(this->FileName,
+                PackPixels<PixelType>(width, height, pixels),
+                width,
+                height,
+                PixelType::GetBitDepth(),
+                this->CompressionLevel,
+                this->NumberOfThreads);
 }
 }
 } // namespace viskores::io
@@ -11,6 +11,8 @@
 
 #include <viskores/io/ImageWriterBase.h>
 
+#include <future>
+
 namespace viskores
 {
 namespace io
@@ -22,8 +24,9 @@ namespace io
 /// is written to the file by calling the `WriteDataSet` method.
 ///
 /// When writing files, `ImageReaderPNG` automatically compresses data to optimal
-/// sizes relative to the actual bit complexity of the provided image.
-///
+/// sizes relative to the actual bit complexity of the provided image. The image is
+/// filtered and compressed in horizontal stripes on several threads, and
+/// `WriteDataSetAsync` can write it in the background.
 ///
 class VISKORES_IO_EXPORT ImageWriterPNG : public viskores::io::ImageWriterBase
 {
@@ -35,6 +38,34 @@ public:
   ImageWriterPNG(const ImageWriterPNG&) = delete;
   ImageWriterPNG& operator=(const ImageWriterPNG&) = delete;
 
+  /// @brief Write the color field of a data set to an image file in the background.
+  ///
+  /// The colors are copied before this method returns, so the data set (such as the
+  /// color buffer of a `viskores::rendering::Canvas`) can be changed or redrawn right
+  /// away. The image is compressed and written on another thread. The returned future
+  /// becomes ready once the file is written and rethrows any error from writing it. The
+  /// writer itself may be destroyed before then.
+  VISKORES_CONT std::future<void> WriteDataSetAsync(const viskores::cont::DataSet& dataSet,
+                                                    const std::string& colorField = {});
+
+  /// @brief Specify how hard to compress the image.
+  ///
+  /// 0 stores the pixels without compression, 1 compresses fastest, and 9 makes the
+  /// smallest files. The default is 6.
+  VISKORES_CONT void SetCompressionLevel(viskores::IdComponent level);
+  /// @copydoc SetCompressionLevel
+  VISKORES_CONT viskores::IdComponent GetCompressionLevel() const
+  {
+    return this->CompressionLevel;
+  }
+
+  /// @brief Specify the largest number of threads used to compress an image.
+  ///
+  /// The default, 0, uses all hardware threads.
+  VISKORES_CONT void SetNumberOfThreads(viskores::IdComponent numberOfThreads);
+  /// @copydoc SetNumberOfThreads
+  VISKORES_CONT viskores::IdComponent GetNumberOfThreads() const { return this->NumberOfThreads; }
+
 protected:
   VISKORES_CONT void Write(viskores::Id width,
                            viskores::Id height,
@@ -44,6 +75,10 @@ protected:
   VISKORES_CONT void WriteToFile(viskores::Id width,
                                  viskores::Id height,
                                  const ColorArrayType& pixels);
+
+private:
+  viskores::IdComponent CompressionLevel = 6;
+  viskores::IdComponent NumberOfThreads = 0;
 };
 }
 } // namespace viskores::io
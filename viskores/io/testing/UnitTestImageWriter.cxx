@@ -9,6 +9,7 @@
 
 #include <viskores/cont/DataSetBuilderUniform.h>
 #include <viskores/cont/ErrorBadType.h>
+#include <viskores/cont/ErrorBadValue.h>
 #include <viskores/cont/testing/Testing.h>
 #include <viskores/io/ImageReaderPNG.h>
 #include <viskores/io/ImageReaderPNM.h>
@@ -18,6 +19,7 @@
 #include <viskores/rendering/Canvas.h>
 #include <viskores/rendering/Color.h>
 
+#include <future>
 #include <string>
 
 namespace
@@ -298,6 +300,99 @@ void TestWriteDataSetBadColorArrayType()
   VISKORES_TEST_ASSERT(throws, "Image writer did not reject signed integer color channels");
 }
 
+void TestPNGCompression()
+{
+  std::cout << "TestPNGCompression" << std::endl;
+
+  // Large enough to be compressed in several stripes.
+  constexpr viskores::Id width = 300;
+  constexpr viskores::Id height = 250;
+  viskores::io::ImageWriterBase::ColorArrayType colorArray;
+  viskores::io::ImageWriterBase::ColorArrayType expected8;
+  viskores::io::ImageWriterBase::ColorArrayType expected16;
+  colorArray.Allocate(width * height);
+  expected8.Allocate(width * height);
+  expected16.Allocate(width * height);
+  {
+    auto colorPortal = colorArray.WritePortal();
+    auto expected8Portal = expected8.WritePortal();
+    auto expected16Portal = expected16.WritePortal();
+    for (viskores::Id y = 0; y < height; ++y)
+    {
+      for (viskores::Id x = 0; x < width; ++x)
+      {
+        viskores::Vec3f_32 rgb(static_cast<viskores::Float32>(x) / width,
+                               static_cast<viskores::Float32>(y) / height,
+                               static_cast<viskores::Float32>((x * y) % 7) / 6.0f);
+        colorPortal.Set(y * width + x, viskores::Vec4f_32(rgb[0], rgb[1], rgb[2], 1.0f));
+        viskores::Vec4f_32 rgb8(1.0f);
+        for (viskores::IdComponent channel = 0; channel < 3; ++channel)
+        {
+          rgb8[channel] =
+            static_cast<viskores::Float32>(static_cast<viskores::UInt8>(rgb[channel] * 255.0f)) /
+            255.0f;
+        }
+        expected8Portal.Set(y * width + x, rgb8);
+        expected16Portal.Set(y * width + x, ExpectedRGB16(rgb[0], rgb[1], rgb[2]));
+      }
+    }
+  }
+  viskores::cont::DataSet dataSet =
+    viskores::cont::DataSetBuilderUniform::Create(viskores::Id2(width, height));
+  dataSet.AddPointField(ColorFieldName, colorArray);
+
+  auto validate = [&](const std::string& filename,
+                      const viskores::io::ImageWriterBase::ColorArrayType& expected)
+  {
+    viskores::io::ImageReaderPNG reader(filename);
+    viskores::cont::DataSet readDataSet = reader.ReadDataSet();
+    auto pixels = readDataSet.GetPointField(reader.GetPointFieldName())
+                    .GetData()
+                    .AsArrayHandle<viskores::io::ImageWriterBase::ColorArrayType>();
+    auto pixelCompare = test_equal_ArrayHandles(pixels, expected);
+    VISKORES_TEST_ASSERT(pixelCompare, pixelCompare.GetMergedMessage());
+  };
+
+  for (viskores::IdComponent level : { 0, 1, 6, 9 })
+  {
+    for (viskores::IdComponent numberOfThreads : { 1, 4 })
+    {
+      std::cout << "  level " << level << ", " << numberOfThreads << " threads" << std::endl;
+      viskores::io::ImageWriterPNG writer("pngCompressionTest.png");
+      writer.SetCompressionLevel(level);
+      writer.SetNumberOfThreads(numberOfThreads);
+      VISKORES_TEST_ASSERT(writer.GetCompressionLevel() == level);
+      writer.WriteDataSet(dataSet, ColorFieldName);
+      validate("pngCompressionTest.png", expected8);
+    }
+  }
+
+  std::cout << "  asynchronous write" << std::endl;
+  std::future<void> written;
+  {
+    viskores::io::ImageWriterPNG writer("pngAsyncTest.png");
+    writer.SetPixelDepth(viskores::io::ImageWriterBase::PixelDepth::PIXEL_16);
+    written = writer.WriteDataSetAsync(dataSet, ColorFieldName);
+  }
+  // The colors are copied before WriteDataSetAsync returns, so changing them must not
+  // change the written image.
+  colorArray.Fill(viskores::Vec4f_32(0.0f));
+  written.get();
+  validate("pngAsyncTest.png", expected16);
+
+  bool throws = false;
+  try
+  {
+    viskores::io::ImageWriterPNG writer("pngBadLevel.png");
+    writer.SetCompressionLevel(10);
+  }
+  catch (const viskores::cont::ErrorBadValue&)
+  {
+    throws = true;
+  }
+  VISKORES_TEST_ASSERT(throws, "Image writer did not reject a bad compression level");
+}
+
 void TestPNMImage(const viskores::rendering::Canvas& canvas)
 {
   TestReadAndWritePNM(
@@ -331,6 +426,7 @@ void TestImage()
   TestWriteDataSetBadColorArrayType();
   TestPNMImage(canvas);
   TestPNGImage(canvas);
+  TestPNGCompression();
 }
 }
 
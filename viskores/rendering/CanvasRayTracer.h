@@ -12,6 +12,7 @@
 #include <viskores/rendering/viskores_rendering_export.h>
 
 #include <viskores/rendering/Canvas.h>
+#include <viskores/rendering/raytracing/Camera.h>
 #include <viskores/rendering/raytracing/Ray.h>
 
 namespace viskores
@@ -55,8 +56,25 @@ public:
   VISKORES_CONT
   void ResizeBuffers(viskores::Id width, viskores::Id height) override;
 
+  /// @brief Specify the pixels that mappers cast rays through.
+  ///
+  /// Mappers that render by ray tracing only write the selected pixels, leaving the
+  /// rest of the canvas unchanged. The default selects every pixel.
+  VISKORES_CONT
+  void SetPixelSelection(const viskores::rendering::raytracing::PixelSelection& selection)
+  {
+    this->Selection = selection;
+  }
+  /// @copydoc SetPixelSelection
+  VISKORES_CONT
+  const viskores::rendering::raytracing::PixelSelection& GetPixelSelection() const
+  {
+    return this->Selection;
+  }
+
 private:
   DepthBufferType DistancesToCamera;
+  viskores::rendering::raytracing::PixelSelection Selection;
 }; // class CanvasRayTracer
 }
 } // namespace viskores::rendering
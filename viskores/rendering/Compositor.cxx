@@ -0,0 +1,457 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#include <viskores/rendering/Compositor.h>
+
+#include <viskores/cont/EnvironmentTracker.h>
+#include <viskores/cont/ErrorBadValue.h>
+#include <viskores/cont/Logging.h>
+
+#include <viskores/thirdparty/diy/diy.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace viskores
+{
+namespace rendering
+{
+
+namespace
+{
+
+constexpr std::size_t FragmentSize = 5;
+
+// The pixels [Begin, End) of the image that a block is responsible for.
+//
+// With depth blending, each pixel has one color. With ordered blending, each pixel
+// has a list of fragments (a depth followed by a color) that are only blended once
+// all ranks have contributed theirs. Blending pairs of ranks as they meet would be
+// wrong when the ranks meeting first are not adjacent in the visibility order of a
+// pixel.
+struct ImageBlock
+{
+  viskores::Id Begin = 0;
+  viskores::Id End = 0;
+  std::vector<viskores::Float32> Depths; // closest depth of each pixel
+  std::vector<viskores::Float32> Colors; // 4 components per pixel
+  std::vector<viskores::Int32> NumberOfFragments;
+  std::vector<viskores::Float32> Fragments;
+
+  void Enqueue(const viskoresdiy::ReduceProxy& srp, const viskoresdiy::BlockID& target) const
+  {
+    srp.enqueue(target, this->Depths);
+    srp.enqueue(target, this->Colors);
+    srp.enqueue(target, this->NumberOfFragments);
+    srp.enqueue(target, this->Fragments);
+  }
+
+  void Dequeue(const viskoresdiy::ReduceProxy& srp, int gid)
+  {
+    srp.dequeue(gid, this->Depths);
+    srp.dequeue(gid, this->Colors);
+    srp.dequeue(gid, this->NumberOfFragments);
+    srp.dequeue(gid, this->Fragments);
+  }
+
+  // Returns the pixels [first, last) of this block, counted from Begin.
+  ImageBlock Slice(std::size_t first, std::size_t last) const
+  {
+    ImageBlock slice;
+    slice.Begin = this->Begin + static_cast<viskores::Id>(first);
+    slice.End = this->Begin + static_cast<viskores::Id>(last);
+    slice.Depths.assign(this->Depths.begin() + static_cast<std::ptrdiff_t>(first),
+                        this->Depths.begin() + static_cast<std::ptrdiff_t>(last));
+    if (!this->Colors.empty())
+    {
+      slice.Colors.assign(this->Colors.begin() + static_cast<std::ptrdiff_t>(4 * first),
+                          this->Colors.begin() + static_cast<std::ptrdiff_t>(4 * last));
+    }
+    if (!this->NumberOfFragments.empty())
+    {
+      std::size_t fragmentsBegin = 0;
+      for (std::size_t i = 0; i < first; i++)
+        fragmentsBegin += static_cast<std::size_t>(this->NumberOfFragments[i]);
+      std::size_t fragmentsEnd = fragmentsBegin;
+      for (std::size_t i = first; i < last; i++)
+        fragmentsEnd += static_cast<std::size_t>(this->NumberOfFragments[i]);
+      slice.NumberOfFragments.assign(
+        this->NumberOfFragments.begin() + static_cast<std::ptrdiff_t>(first),
+        this->NumberOfFragments.begin() + static_cast<std::ptrdiff_t>(last));
+      slice.Fragments.assign(
+        this->Fragments.begin() + static_cast<std::ptrdiff_t>(FragmentSize * fragmentsBegin),
+        this->Fragments.begin() + static_cast<std::ptrdiff_t>(FragmentSize * fragmentsEnd));
+    }
+    return slice;
+  }
+
+  // Combines the same pixels held by another block. Depth ties go to `otherFirst`.
+  void Merge(const ImageBlock& other, bool otherFirst, Compositor::BlendMode mode)
+  {
+    const std::size_t numPixels = this->Depths.size();
+    if (other.Depths.size() != numPixels)
+      throw viskores::cont::ErrorBadValue("Images to composite differ in size across ranks.");
+
+    if (mode == Compositor::BlendMode::Depth)
+    {
+      for (std::size_t i = 0; i < numPixels; i++)
+      {
+        if (other.Depths[i] < this->Depths[i] ||
+            (otherFirst && other.Depths[i] == this->Depths[i]))
+        {
+          this->Depths[i] = other.Depths[i];
+          std::copy(other.Colors.begin() + static_cast<std::ptrdiff_t>(4 * i),
+                    other.Colors.begin() + static_cast<std::ptrdiff_t>(4 * i + 4),
+                    this->Colors.begin() + static_cast<std::ptrdiff_t>(4 * i));
+        }
+      }
+      return;
+    }
+
+    // Interleave the fragment lists of each pixel. Sorting by depth happens in Resolve.
+    std::vector<viskores::Int32> numberOfFragments(numPixels);
+    std::vector<viskores::Float32> fragments;
+    fragments.reserve(this->Fragments.size() + other.Fragments.size());
+    auto first = (otherFirst ? other : *this).Fragments.begin();
+    auto second = (otherFirst ? *this : other).Fragments.begin();
+    const auto& firstCounts = (otherFirst ? other : *this).NumberOfFragments;
+    const auto& secondCounts = (otherFirst ? *this : other).NumberOfFragments;
+    for (std::size_t i = 0; i < numPixels; i++)
+    {
+      const auto firstSize = static_cast<std::ptrdiff_t>(FragmentSize) * firstCounts[i];
+      const auto secondSize = static_cast<std::ptrdiff_t>(FragmentSize) * secondCounts[i];
+      fragments.insert(fragments.end(), first, first + firstSize);
+      fragments.insert(fragments.end(), second, second + secondSize);
+      first += firstSize;
+      second += secondSize;
+      numberOfFragments[i] = firstCounts[i] + secondCounts[i];
+      this->Depths[i] = std::min(this->Depths[i], other.Depths[i]);
+    }
+    this->NumberOfFragments.swap(numberOfFragments);
+    this->Fragments.swap(fragments);
+  }
+
+  // Blends the fragments of each pixel front to back into its color.
+  void Resolve()
+  {
+    const std::size_t numPixels = this->Depths.size();
+    this->Colors.assign(4 * numPixels, 0.f);
+    std::vector<const viskores::Float32*> sorted;
+    const viskores::Float32* fragment = this->Fragments.data();
+    for (std::size_t i = 0; i < numPixels; i++)
+    {
+      sorted.clear();
+      for (viskores::Int32 f = 0; f < this->NumberOfFragments[i]; f++, fragment += FragmentSize)
+        sorted.push_back(fragment);
+      std::stable_sort(sorted.begin(),
+                       sorted.end(),
+                       [](const viskores::Float32* a, const viskores::Float32* b)
+                       { return a[0] < b[0]; });
+
+      viskores::Float32* color = &this->Colors[4 * i];
+      for (const viskores::Float32* f : sorted)
+      {
+        const viskores::Float32 transmit = 1.f - color[3];
+        for (std::size_t c = 0; c < 4; c++)
+          color[c] += f[c + 1] * transmit;
+      }
+    }
+    this->NumberOfFragments.clear();
+    this->Fragments.clear();
+  }
+};
+
+// Composites the images of all ranks. On return, `image` holds the composited colors
+// and depths of all pixels on rank 0.
+void CompositeImages(ImageBlock& image,
+                     Compositor::CompositeAlgorithm algorithm,
+                     viskores::IdComponent radix,
+                     Compositor::BlendMode mode)
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  if (comm.size() == 1)
+  {
+    if (mode == Compositor::BlendMode::Ordered)
+      image.Resolve();
+    return;
+  }
+
+  const viskores::Id numPixels = image.End - image.Begin;
+
+  viskoresdiy::Master master(
+    comm,
+    1,
+    -1,
+    []() -> void* { return new ImageBlock(); },
+    [](void* ptr) { delete static_cast<ImageBlock*>(ptr); });
+
+  viskoresdiy::ContiguousAssigner assigner(/*num ranks*/ comm.size(),
+                                           /*global-num-blocks*/ comm.size());
+  viskoresdiy::RegularDecomposer<viskoresdiy::DiscreteBounds> decomposer(
+    /*dim*/ 1, viskoresdiy::interval(0, comm.size() - 1), comm.size());
+  decomposer.decompose(comm.rank(), assigner, master);
+  VISKORES_ASSERT(master.size() == 1); // each rank will have exactly 1 block.
+  std::swap(*master.block<ImageBlock>(0), image);
+
+  // Binary-swap is radix-k with every group holding two blocks. When the number of
+  // ranks is not a power of k, the partners factor it into the closest group sizes.
+  const int k = algorithm == Compositor::CompositeAlgorithm::BinarySwap
+    ? 2
+    : std::max(2, static_cast<int>(radix));
+  viskoresdiy::RegularSwapPartners partners(decomposer, k, /*contiguous*/ true);
+
+  auto callback = [mode](ImageBlock* block,
+                         const viskoresdiy::ReduceProxy& srp,
+                         const viskoresdiy::RegularSwapPartners&)
+  {
+    const int selfGid = srp.gid();
+
+    // 1. Merge the pieces of our range sent by the group of the last round.
+    for (int i = 0; i < srp.in_link().size(); i++)
+    {
+      const int gid = srp.in_link().target(i).gid;
+      if (gid == selfGid)
+        continue;
+      ImageBlock piece;
+      piece.Dequeue(srp, gid);
+      block->Merge(piece, gid < selfGid, mode);
+    }
+
+    // 2. Split our range among the group of this round and keep our own piece. Every
+    // member of the group holds the same range, so they agree on the pieces.
+    const int groupSize = srp.out_link().size();
+    if (groupSize == 0)
+    {
+      if (mode == Compositor::BlendMode::Ordered)
+        block->Resolve();
+      return;
+    }
+
+    const std::size_t length = block->Depths.size();
+    ImageBlock kept;
+    for (int i = 0; i < groupSize; i++)
+    {
+      const auto pieces = static_cast<std::size_t>(groupSize);
+      const std::size_t first = length * static_cast<std::size_t>(i) / pieces;
+      const std::size_t last = length * static_cast<std::size_t>(i + 1) / pieces;
+      auto target = srp.out_link().target(i);
+      if (target.gid == selfGid)
+        kept = block->Slice(first, last);
+      else
+        block->Slice(first, last).Enqueue(srp, target);
+    }
+    *block = std::move(kept);
+  };
+
+  viskoresdiy::reduce(master, assigner, partners, callback);
+
+  // Every rank now holds a distinct, final range of the image. Collect them on rank 0.
+  const ImageBlock& local = *master.block<ImageBlock>(0);
+  std::vector<viskores::Float32> payload(local.Colors);
+  payload.insert(payload.end(), local.Depths.begin(), local.Depths.end());
+  if (comm.rank() == 0)
+  {
+    std::vector<viskores::Id> begins;
+    std::vector<std::vector<viskores::Float32>> payloads;
+    viskoresdiy::mpi::gather(comm, local.Begin, begins, 0);
+    viskoresdiy::mpi::gather(comm, payload, payloads, 0);
+
+    image = ImageBlock();
+    image.End = numPixels;
+    image.Colors.resize(static_cast<std::size_t>(4 * numPixels));
+    image.Depths.resize(static_cast<std::size_t>(numPixels));
+    for (std::size_t r = 0; r < payloads.size(); r++)
+    {
+      const auto count = static_cast<std::ptrdiff_t>(payloads[r].size() / 5);
+      const auto begin = static_cast<std::ptrdiff_t>(begins[r]);
+      std::copy(payloads[r].begin(),
+                payloads[r].begin() + 4 * count,
+                image.Colors.begin() + 4 * begin);
+      std::copy(payloads[r].begin() + 4 * count, payloads[r].end(), image.Depths.begin() + begin);
+    }
+  }
+  else
+  {
+    viskoresdiy::mpi::gather(comm, local.Begin, 0);
+    viskoresdiy::mpi::gather(comm, payload, 0);
+  }
+}
+
+} // anonymous namespace
+
+Compositor::Compositor()
+  : Algorithm(CompositeAlgorithm::RadixK)
+  , Radix(8)
+  , Mode(BlendMode::Depth)
+{
+}
+
+void Compositor::SetAlgorithm(CompositeAlgorithm algorithm)
+{
+  this->Algorithm = algorithm;
+}
+
+Compositor::CompositeAlgorithm Compositor::GetAlgorithm() const
+{
+  return this->Algorithm;
+}
+
+void Compositor::SetRadix(viskores::IdComponent radix)
+{
+  if (radix < 2)
+    throw viskores::cont::ErrorBadValue("Radix-k compositing needs a radix of at least 2.");
+  this->Radix = radix;
+}
+
+viskores::IdComponent Compositor::GetRadix() const
+{
+  return this->Radix;
+}
+
+void Compositor::SetBlendMode(BlendMode mode)
+{
+  this->Mode = mode;
+}
+
+Compositor::BlendMode Compositor::GetBlendMode() const
+{
+  return this->Mode;
+}
+
+void Compositor::Composite(viskores::rendering::Canvas& canvas) const
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  if (comm.size() == 1)
+    return;
+
+  VISKORES_LOG_SCOPE(viskores::cont::LogLevel::Perf, "Compositor::Composite");
+
+  const viskores::Id numPixels = canvas.GetWidth() * canvas.GetHeight();
+  ImageBlock image;
+  image.End = numPixels;
+  image.Depths.resize(static_cast<std::size_t>(numPixels));
+  if (this->Mode == BlendMode::Depth)
+    image.Colors.resize(static_cast<std::size_t>(4 * numPixels));
+  else
+    image.NumberOfFragments.resize(static_cast<std::size_t>(numPixels));
+  {
+    auto colorPortal = canvas.GetColorBuffer().ReadPortal();
+    auto depthPortal = canvas.GetDepthBuffer().ReadPortal();
+    for (viskores::Id i = 0; i < numPixels; i++)
+    {
+      const auto pixel = static_cast<std::size_t>(i);
+      const auto color = colorPortal.Get(i);
+      image.Depths[pixel] = depthPortal.Get(i);
+      if (this->Mode == BlendMode::Depth)
+      {
+        for (viskores::IdComponent c = 0; c < 4; c++)
+          image.Colors[4 * pixel + static_cast<std::size_t>(c)] = color[c];
+      }
+      else if (color != viskores::Vec4f_32(0.f))
+      {
+        image.NumberOfFragments[pixel] = 1;
+        image.Fragments.insert(image.Fragments.end(),
+                               { image.Depths[pixel], color[0], color[1], color[2], color[3] });
+      }
+    }
+  }
+
+  CompositeImages(image, this->Algorithm, this->Radix, this->Mode);
+
+  if (comm.rank() == 0)
+  {
+    auto colorPortal = canvas.GetColorBuffer().WritePortal();
+    auto depthPortal = canvas.GetDepthBuffer().WritePortal();
+    for (viskores::Id i = 0; i < numPixels; i++)
+    {
+      const auto offset = static_cast<std::size_t>(4 * i);
+      colorPortal.Set(i,
+                      viskores::Vec4f_32(image.Colors[offset],
+                                         image.Colors[offset + 1],
+                                         image.Colors[offset + 2],
+                                         image.Colors[offset + 3]));
+      depthPortal.Set(i, image.Depths[static_cast<std::size_t>(i)]);
+    }
+  }
+}
+
+void Compositor::Composite(
+  const std::vector<viskores::rendering::raytracing::PartialComposite<viskores::Float32>>& partials,
+  viskores::rendering::Canvas& canvas) const
+{
+  VISKORES_LOG_SCOPE(viskores::cont::LogLevel::Perf, "Compositor::Composite partials");
+
+  // Every partial becomes a fragment of its pixel, so partials of different data sets
+  // on the same rank are ordered with those of other ranks.
+  const viskores::Id numPixels = canvas.GetWidth() * canvas.GetHeight();
+  ImageBlock image;
+  image.End = numPixels;
+  image.Depths.assign(static_cast<std::size_t>(numPixels),
+                      std::numeric_limits<viskores::Float32>::max());
+  image.NumberOfFragments.assign(static_cast<std::size_t>(numPixels), 0);
+  for (const auto& partial : partials)
+  {
+    if (partial.Buffer.GetNumChannels() != 4)
+      throw viskores::cont::ErrorBadValue("Only RGBA partial composites can be composited.");
+    auto pixelPortal = partial.PixelIds.ReadPortal();
+    for (viskores::Id i = 0; i < pixelPortal.GetNumberOfValues(); i++)
+    {
+      const viskores::Id pixel = pixelPortal.Get(i);
+      if (pixel < 0 || pixel >= numPixels)
+        throw viskores::cont::ErrorBadValue("Partial composite pixel is outside the canvas.");
+      image.NumberOfFragments[static_cast<std::size_t>(pixel)]++;
+    }
+  }
+
+  std::vector<std::size_t> offsets(static_cast<std::size_t>(numPixels));
+  std::size_t numFragments = 0;
+  for (std::size_t pixel = 0; pixel < offsets.size(); pixel++)
+  {
+    offsets[pixel] = numFragments;
+    numFragments += static_cast<std::size_t>(image.NumberOfFragments[pixel]);
+  }
+  image.Fragments.resize(FragmentSize * numFragments);
+  for (const auto& partial : partials)
+  {
+    auto pixelPortal = partial.PixelIds.ReadPortal();
+    auto distancePortal = partial.Distances.ReadPortal();
+    auto bufferPortal = partial.Buffer.Buffer.ReadPortal();
+    for (viskores::Id i = 0; i < pixelPortal.GetNumberOfValues(); i++)
+    {
+      const auto pixel = static_cast<std::size_t>(pixelPortal.Get(i));
+      const viskores::Float32 distance = distancePortal.Get(i);
+      viskores::Float32* fragment = &image.Fragments[FragmentSize * offsets[pixel]++];
+      fragment[0] = distance;
+      for (viskores::IdComponent c = 0; c < 4; c++)
+        fragment[c + 1] = bufferPortal.Get(4 * i + c);
+      image.Depths[pixel] = std::min(image.Depths[pixel], distance);
+    }
+  }
+
+  CompositeImages(image, this->Algorithm, this->Radix, BlendMode::Ordered);
+
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  if (comm.rank() == 0)
+  {
+    auto colorPortal = canvas.GetColorBuffer().WritePortal();
+    for (viskores::Id i = 0; i < numPixels; i++)
+    {
+      const auto offset = static_cast<std::size_t>(4 * i);
+      const viskores::Vec4f_32 front(image.Colors[offset],
+                                     image.Colors[offset + 1],
+                                     image.Colors[offset + 2],
+                                     image.Colors[offset + 3]);
+      colorPortal.Set(i, front + colorPortal.Get(i) * (1.f - front[3]));
+    }
+  }
+}
+
+}
+} // namespace viskores::rendering
@@ -0,0 +1,114 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#ifndef viskores_rendering_Compositor_h
+#define viskores_rendering_Compositor_h
+
+#include <viskores/rendering/Canvas.h>
+#include <viskores/rendering/raytracing/PartialComposite.h>
+#include <viskores/rendering/viskores_rendering_export.h>
+
+#include <vector>
+
+namespace viskores
+{
+namespace rendering
+{
+
+/// @brief Composites the images rendered on every MPI rank into a single image.
+///
+/// Each rank renders its part of the data into its own `Canvas`, which must have the
+/// same size on every rank. `Composite()` combines the canvases of all ranks of the
+/// communicator in `viskores::cont::EnvironmentTracker` and leaves the result in the
+/// canvas of rank 0. The canvases of the other ranks are left unchanged.
+///
+/// The image is split among the ranks with binary-swap or radix-k, so every rank
+/// blends an equal share of the pixels and the image is only gathered once at the
+/// end. Pixels are blended either by depth, for opaque surfaces, or in visibility
+/// order, for volume renderings. When blending in visibility order, do not blend the
+/// background into the images of the ranks (e.g., call
+/// `MapperVolume::SetCompositeBackground(false)`) and call `Canvas::BlendBackground()`
+/// on rank 0 after compositing.
+///
+/// @code{.cpp}
+/// view.Paint();
+/// viskores::rendering::Compositor compositor;
+/// compositor.Composite(*view.GetCanvas());
+/// if (comm.rank() == 0)
+///   view.SaveAs("image.png");
+/// @endcode
+class VISKORES_RENDERING_EXPORT Compositor
+{
+public:
+  /// @brief How the pixels are exchanged between ranks.
+  enum struct CompositeAlgorithm
+  {
+    /// Halves the image between pairs of ranks each round.
+    BinarySwap,
+    /// Splits the image among groups of up to `GetRadix()` ranks each round, which
+    /// takes fewer rounds than binary-swap on many ranks.
+    RadixK
+  };
+
+  /// @brief How the pixels of different ranks are combined.
+  enum struct BlendMode
+  {
+    /// Keeps the pixel closest to the camera. For opaque surfaces.
+    Depth,
+    /// Blends the pixels front to back in the order given by their depth, with the
+    /// colors taken as premultiplied by alpha. For volume renderings of data whose
+    /// blocks do not overlap.
+    Ordered
+  };
+
+  Compositor();
+
+  /// @brief Specifies how pixels are exchanged. The default is `RadixK`.
+  void SetAlgorithm(CompositeAlgorithm algorithm);
+  /// @copydoc SetAlgorithm
+  CompositeAlgorithm GetAlgorithm() const;
+
+  /// @brief Specifies the target group size of radix-k. The default is 8.
+  void SetRadix(viskores::IdComponent radix);
+  /// @copydoc SetRadix
+  viskores::IdComponent GetRadix() const;
+
+  /// @brief Specifies how pixels are combined. The default is `Depth`.
+  void SetBlendMode(BlendMode mode);
+  /// @copydoc SetBlendMode
+  BlendMode GetBlendMode() const;
+
+  /// @brief Composites the color and depth buffers of `canvas` over all ranks.
+  ///
+  /// This is a collective operation. On return, the canvas of rank 0 holds the
+  /// composited image. With `Ordered` blending, the depth buffer is used to sort the
+  /// pixels of the ranks, so it should hold the depth at which each rank's
+  /// contribution to a pixel starts.
+  void Composite(viskores::rendering::Canvas& canvas) const;
+
+  /// @brief Composites partial composites produced by unstructured volume rendering
+  /// (`ConnectivityProxy::PartialTrace()`) over all ranks into `canvas` on rank 0.
+  ///
+  /// The partial composites are always blended in visibility order, sorted by their
+  /// distance along each ray. The colors of the partials are blended over the existing
+  /// contents of the canvas on rank 0. The depth buffer of the canvas is not changed.
+  void Composite(
+    const std::vector<viskores::rendering::raytracing::PartialComposite<viskores::Float32>>&
+      partials,
+    viskores::rendering::Canvas& canvas) const;
+
+private:
+  CompositeAlgorithm Algorithm;
+  viskores::IdComponent Radix;
+  BlendMode Mode;
+};
+
+}
+} // namespace viskores::rendering
+
+#endif //viskores_rendering_Compositor_h
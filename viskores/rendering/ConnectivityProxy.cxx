@@ -53,6 +53,9 @@ public:
     }
   }
 
+  VISKORES_CONT
+  void SetDataSet(const viskores::cont::DataSet& dataSet) { Dataset = dataSet; }
+
   VISKORES_CONT
   void SetUnitScalar(viskores::Float32 unitScalar) { Tracer.SetUnitScalar(unitScalar); }
 
@@ -230,6 +233,7 @@ public:
     }
     viskores::rendering::raytracing::Camera rayCamera = camera.CreateRaytracingCamera(
       (viskores::Int32)canvas->GetWidth(), (viskores::Int32)canvas->GetHeight());
+    rayCamera.SetPixelSelection(canvas->GetPixelSelection());
     viskores::rendering::raytracing::Ray<viskores::Float32> rays;
     rayCamera.CreateRays(rays, this->Dataset.GetCoordinateSystem(this->CoordinateName).GetBounds());
     rays.Buffers.at(0).InitConst(0.f);
@@ -329,6 +333,12 @@ ConnectivityProxy& ConnectivityProxy::operator=(viskores::rendering::Connectivit
 VISKORES_CONT
 ConnectivityProxy::~ConnectivityProxy() = default;
 
+VISKORES_CONT
+void ConnectivityProxy::SetDataSet(const viskores::cont::DataSet& dataSet)
+{
+  Internals->SetDataSet(dataSet);
+}
+
 VISKORES_CONT
 void ConnectivityProxy::SetSampleDistance(const viskores::Float32& distance)
 {
@@ -55,6 +55,11 @@ public:
     Energy,
   };
 
+  /// Replaces the data set to render, keeping the names of the field and coordinates.
+  /// The mesh connectivity built for the previous data set is reused when the new one
+  /// has the same cell set and coordinates, such as when only the field changed.
+  void SetDataSet(const viskores::cont::DataSet& dataSet);
+
   void SetRenderMode(RenderMode mode);
   void SetSampleDistance(const viskores::Float32&);
   void SetScalarField(const std::string& fieldName);
@@ -75,7 +75,18 @@ void MapperConnectivity::RenderCellsImpl(
   dataset.AddField(scalarField);
   dataset.AddField(ghostField);
 
-  viskores::rendering::ConnectivityProxy tracerProxy(dataset, scalarField.GetName());
+  // Reuse the tracer, and with it the mesh connectivity, across renders.
+  if (!this->Tracer || coords.GetName() != this->TracerCoordinateName)
+  {
+    this->Tracer = std::make_shared<ConnectivityProxy>(dataset, scalarField.GetName());
+    this->TracerCoordinateName = coords.GetName();
+  }
+  else
+  {
+    this->Tracer->SetDataSet(dataset);
+    this->Tracer->SetScalarField(scalarField.GetName());
+  }
+  viskores::rendering::ConnectivityProxy& tracerProxy = *this->Tracer;
 
   if (SampleDistance == -1.f)
   {
@@ -14,11 +14,22 @@
 #include <viskores/rendering/Mapper.h>
 #include <viskores/rendering/View.h>
 
+#include <memory>
+
 namespace viskores
 {
 namespace rendering
 {
 
+class ConnectivityProxy;
+
+/// @brief Volume renders unstructured meshes by tracing rays from cell to cell.
+///
+/// The mesh connectivity, external faces, and cell locator the tracer needs are kept
+/// between renders and only rebuilt when the cell set or coordinates change, so
+/// rendering many frames of a static mesh, such as a camera orbit, pays for them once.
+/// Copies of the mapper share them.
+
 class VISKORES_RENDERING_EXPORT MapperConnectivity : public Mapper
 {
 public:
@@ -35,6 +46,8 @@ public:
 protected:
   viskores::Float32 SampleDistance;
   CanvasRayTracer* CanvasRT;
+  std::shared_ptr<ConnectivityProxy> Tracer;
+  std::string TracerCoordinateName;
   virtual void RenderCellsImpl(const viskores::cont::UnknownCellSet& cellset,
                                const viskores::cont::CoordinateSystem& coords,
                                const viskores::cont::Field& scalarField,
@@ -186,6 +186,7 @@ void MapperCylinder::RenderCellsImpl(const viskores::cont::UnknownCellSet& cells
   viskores::Int32 height = (viskores::Int32)this->Internals->Canvas->GetHeight();
 
   this->Internals->RayCamera = camera.CreateRaytracingCamera(width, height);
+  this->Internals->RayCamera.SetPixelSelection(this->Internals->Canvas->GetPixelSelection());
 
   this->Internals->RayCamera.CreateRays(this->Internals->Rays, shapeBounds);
   this->Internals->Rays.Buffers.at(0).InitConst(0.f);
@@ -150,6 +150,35 @@ void MapperGlyphBase::SetStride(viskores::Id stride)
   this->Stride = stride;
 }
 
+bool MapperGlyphBase::GetLevelOfDetail() const
+{
+  return this->LevelOfDetail;
+}
+
+void MapperGlyphBase::SetLevelOfDetail(bool on)
+{
+  this->LevelOfDetail = on;
+  if (!on)
+  {
+    this->Hierarchy.Clear();
+  }
+}
+
+viskores::Float32 MapperGlyphBase::GetLevelOfDetailPixelSize() const
+{
+  return this->LevelOfDetailPixelSize;
+}
+
+void MapperGlyphBase::SetLevelOfDetailPixelSize(viskores::Float32 size)
+{
+  if (!(size > 0.f))
+  {
+    throw viskores::cont::ErrorBadValue(
+      "MapperGlyphBase: level of detail pixel size must be positive");
+  }
+  this->LevelOfDetailPixelSize = size;
+}
+
 void MapperGlyphBase::SetCompositeBackground(bool on)
 {
   this->CompositeBackground = on;
@@ -176,5 +205,45 @@ viskores::cont::DataSet MapperGlyphBase::FilterPoints(
   return result;
 }
 
+viskores::cont::DataSet MapperGlyphBase::SelectLevelOfDetail(
+  const viskores::cont::DataSet& dataSet,
+  const std::string& fieldName,
+  const viskores::rendering::Camera& camera,
+  viskores::Float32 glyphSize)
+{
+  if (!this->LevelOfDetail || this->Association != viskores::cont::Field::Association::Points)
+  {
+    return dataSet;
+  }
+
+  const viskores::cont::CoordinateSystem coords = dataSet.GetCoordinateSystem();
+  const viskores::cont::Field field = dataSet.GetField(fieldName);
+  if (!this->Hierarchy.IsBuiltFrom(coords, field) || glyphSize != this->HierarchyGlyphSize)
+  {
+    this->Hierarchy.Build(coords, glyphSize, field);
+    this->HierarchyGlyphSize = glyphSize;
+  }
+
+  const viskores::Id width = this->Canvas->GetWidth();
+  const viskores::Id height = this->Canvas->GetHeight();
+  viskores::cont::CoordinateSystem lodCoords;
+  viskores::cont::ArrayHandle<viskores::Float32> lodSizes;
+  viskores::cont::Field lodField;
+  this->Hierarchy.Select(
+    viskores::MatrixMultiply(camera.CreateProjectionMatrix(width, height),
+                             camera.CreateViewMatrix()),
+    height,
+    this->LevelOfDetailPixelSize,
+    lodCoords,
+    lodSizes,
+    lodField);
+
+  // The glyphs are placed on the points, so the aggregates need no cells.
+  viskores::cont::DataSet result;
+  result.AddCoordinateSystem(lodCoords);
+  result.AddField(lodField);
+  return result;
+}
+
 }
 } // namespace viskores::rendering
@@ -13,8 +13,10 @@
 #include <viskores/cont/ColorTable.h>
 #include <viskores/rendering/Camera.h>
 #include <viskores/rendering/Mapper.h>
+#include <viskores/rendering/raytracing/PointHierarchy.h>
 
 #include <memory>
+#include <string>
 
 namespace viskores
 {
@@ -90,6 +92,24 @@ public:
   /// @copydoc GetScaleDelta
   virtual void SetScaleDelta(viskores::Float32 delta);
 
+  /// @brief Specify whether to thin the glyphs to a level of detail suited to the view.
+  ///
+  /// When on, the points are grouped into a hierarchy of aggregates (see
+  /// `raytracing::PointHierarchy`) and each render draws one glyph per aggregate that covers
+  /// at most `LevelOfDetailPixelSize` pixels. Each such glyph sits at the centroid of the
+  /// points it stands for and takes the average of their field values. Only applies to
+  /// glyphs on points, and not to `GlyphType::Quad`. Off by default.
+  virtual bool GetLevelOfDetail() const;
+  /// @copydoc GetLevelOfDetail
+  virtual void SetLevelOfDetail(bool on);
+
+  /// @brief The largest size in pixels of the aggregates drawn with level of detail.
+  ///
+  /// The default is 2.
+  virtual viskores::Float32 GetLevelOfDetailPixelSize() const;
+  /// @copydoc GetLevelOfDetailPixelSize
+  virtual void SetLevelOfDetailPixelSize(viskores::Float32 size);
+
   virtual void SetCompositeBackground(bool on);
 
 protected:
@@ -97,6 +117,14 @@ protected:
                                                const viskores::cont::CoordinateSystem& coords,
                                                const viskores::cont::Field& scalarField) const;
 
+  /// Replaces the points of `dataSet` (as returned by `FilterPoints()`) with the aggregates
+  /// to draw for `camera` when level of detail is on. `glyphSize` is the largest size of a
+  /// glyph. The hierarchy is kept for the next render unless the points change.
+  viskores::cont::DataSet SelectLevelOfDetail(const viskores::cont::DataSet& dataSet,
+                                              const std::string& fieldName,
+                                              const viskores::rendering::Camera& camera,
+                                              viskores::Float32 glyphSize);
+
 
   viskores::rendering::CanvasRayTracer* Canvas = nullptr;
   bool CompositeBackground = true;
@@ -109,6 +137,14 @@ protected:
   bool ScaleByValue = false;
   viskores::Float32 BaseSize = -1.f;
   viskores::Float32 ScaleDelta = 0.5f;
+
+  bool LevelOfDetail = false;
+  viskores::Float32 LevelOfDetailPixelSize = 2.f;
+
+private:
+  // The level of detail hierarchy and what it was built for.
+  viskores::rendering::raytracing::PointHierarchy Hierarchy;
+  viskores::Float32 HierarchyGlyphSize = 0.f;
 };
 }
 } //namespace viskores::rendering
@@ -370,6 +370,13 @@ void MapperGlyphScalar::RenderCellsImpl(
   viskores::rendering::raytracing::GlyphExtractor glyphExtractor;
 
   viskores::cont::DataSet processedDataSet = this->FilterPoints(cellset, coords, scalarField);
+  if (this->GlyphType != viskores::rendering::GlyphType::Quad)
+  {
+    viskores::Float32 glyphSize =
+      this->ScaleByValue ? baseSize + baseSize * this->ScaleDelta : baseSize;
+    processedDataSet =
+      this->SelectLevelOfDetail(processedDataSet, scalarField.GetName(), camera, glyphSize);
+  }
   viskores::cont::UnknownCellSet processedCellSet = processedDataSet.GetCellSet();
   viskores::cont::CoordinateSystem processedCoords = processedDataSet.GetCoordinateSystem();
   viskores::cont::Field processedField = processedDataSet.GetField(scalarField.GetName());
@@ -469,6 +476,7 @@ void MapperGlyphScalar::RenderCellsImpl(
 
     viskores::rendering::raytracing::Camera RayCamera =
       camera.CreateRaytracingCamera(width, height);
+    RayCamera.SetPixelSelection(this->Canvas->GetPixelSelection());
     viskores::rendering::raytracing::Ray<viskores::Float32> Rays;
 
     RayCamera.CreateRays(Rays, shapeBounds);
@@ -86,6 +86,10 @@ void MapperGlyphVector::RenderCellsImpl(
   viskores::rendering::raytracing::GlyphExtractorVector glyphExtractor;
 
   viskores::cont::DataSet processedDataSet = this->FilterPoints(cellset, coords, field);
+  viskores::Float32 glyphSize =
+    this->ScaleByValue ? baseSize + baseSize * this->ScaleDelta : baseSize;
+  processedDataSet =
+    this->SelectLevelOfDetail(processedDataSet, field.GetName(), camera, glyphSize);
   viskores::cont::UnknownCellSet processedCellSet = processedDataSet.GetCellSet();
   viskores::cont::CoordinateSystem processedCoords = processedDataSet.GetCoordinateSystem();
   viskores::cont::Field processedField = processedDataSet.GetField(field.GetName());
@@ -139,6 +143,7 @@ void MapperGlyphVector::RenderCellsImpl(
   viskores::Int32 height = (viskores::Int32)this->Canvas->GetHeight();
 
   viskores::rendering::raytracing::Camera RayCamera = camera.CreateRaytracingCamera(width, height);
+  RayCamera.SetPixelSelection(this->Canvas->GetPixelSelection());
   viskores::rendering::raytracing::Ray<viskores::Float32> Rays;
 
   RayCamera.CreateRays(Rays, shapeBounds);
@@ -9,11 +9,14 @@
 
 #include <viskores/rendering/MapperPoint.h>
 
+#include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/ArrayHandleIndex.h>
 #include <viskores/cont/Timer.h>
 
 #include <viskores/rendering/CanvasRayTracer.h>
 #include <viskores/rendering/raytracing/Camera.h>
 #include <viskores/rendering/raytracing/Logger.h>
+#include <viskores/rendering/raytracing/PointHierarchy.h>
 #include <viskores/rendering/raytracing/RayOperations.h>
 #include <viskores/rendering/raytracing/RayTracer.h>
 #include <viskores/rendering/raytracing/RunTriangulator.h>
@@ -36,6 +39,12 @@ struct MapperPoint::InternalsType
   viskores::cont::Field::Association Association = viskores::cont::Field::Association::Points;
   viskores::Float32 PointDelta = 0.5f;
   bool UseVariableRadius = false;
+  bool LevelOfDetail = false;
+  viskores::Float32 LevelOfDetailPixelSize = 2.f;
+
+  // The level of detail hierarchy and what it was built for.
+  viskores::rendering::raytracing::PointHierarchy Hierarchy;
+  viskores::Vec3f_32 HierarchyRadius;
 
   VISKORES_CONT
   InternalsType() = default;
@@ -170,8 +179,61 @@ void MapperPoint::RenderCellsImpl(const viskores::cont::UnknownCellSet& cellset,
   viskores::Bounds shapeBounds;
 
   raytracing::SphereExtractor sphereExtractor;
+  viskores::cont::Field renderField = scalarField;
+  const bool levelOfDetail = this->Internals->LevelOfDetail &&
+    this->Internals->Association == viskores::cont::Field::Association::Points;
+
+  if (levelOfDetail)
+  {
+    timer.Start();
+    auto& hierarchy = this->Internals->Hierarchy;
+    const viskores::Vec3f_32 radius(
+      baseRadius, this->Internals->UseVariableRadius ? 1.f : 0.f, this->Internals->PointDelta);
+    if (!hierarchy.IsBuiltFrom(coords, scalarField) || radius != this->Internals->HierarchyRadius)
+    {
+      if (this->Internals->UseVariableRadius)
+      {
+        sphereExtractor.ExtractCoordinates(coords,
+                                           scalarField,
+                                           baseRadius - baseRadius * this->Internals->PointDelta,
+                                           baseRadius + baseRadius * this->Internals->PointDelta);
+        hierarchy.Build(coords, sphereExtractor.GetRadii(), scalarField);
+      }
+      else
+      {
+        hierarchy.Build(coords, baseRadius, scalarField);
+      }
+      this->Internals->HierarchyRadius = radius;
+      logger->AddLogData("lod_build", timer.GetElapsedTime());
+    }
 
-  if (this->Internals->UseVariableRadius)
+    timer.Start();
+    const viskores::Id width = this->Internals->Canvas->GetWidth();
+    const viskores::Id height = this->Internals->Canvas->GetHeight();
+    viskores::cont::CoordinateSystem lodCoords;
+    viskores::cont::ArrayHandle<viskores::Float32> lodRadii;
+    hierarchy.Select(viskores::MatrixMultiply(camera.CreateProjectionMatrix(width, height),
+                                              camera.CreateViewMatrix()),
+                     height,
+                     this->Internals->LevelOfDetailPixelSize,
+                     lodCoords,
+                     lodRadii,
+                     renderField);
+    logger->AddLogData("lod_select", timer.GetElapsedTime());
+    logger->AddLogData("lod_points", lodRadii.GetNumberOfValues());
+
+    if (lodRadii.GetNumberOfValues() > 0)
+    {
+      viskores::cont::ArrayHandle<viskores::Id> pointIds;
+      viskores::cont::ArrayCopy(viskores::cont::ArrayHandleIndex(lodRadii.GetNumberOfValues()),
+                                pointIds);
+      auto sphereIntersector = std::make_shared<raytracing::SphereIntersector>();
+      sphereIntersector->SetData(lodCoords, pointIds, lodRadii);
+      this->Internals->Tracer.AddShapeIntersector(sphereIntersector);
+      shapeBounds.Include(sphereIntersector->GetShapeBounds());
+    }
+  }
+  else if (this->Internals->UseVariableRadius)
   {
     viskores::Float32 minRadius = baseRadius - baseRadius * this->Internals->PointDelta;
     viskores::Float32 maxRadius = baseRadius + baseRadius * this->Internals->PointDelta;
@@ -202,7 +264,7 @@ void MapperPoint::RenderCellsImpl(const viskores::cont::UnknownCellSet& cellset,
     }
   }
 
-  if (sphereExtractor.GetNumberOfSpheres() > 0)
+  if (!levelOfDetail && sphereExtractor.GetNumberOfSpheres() > 0)
   {
     auto sphereIntersector = std::make_shared<raytracing::SphereIntersector>();
     sphereIntersector->SetData(coords, sphereExtractor.GetPointIds(), sphereExtractor.GetRadii());
@@ -217,6 +279,7 @@ void MapperPoint::RenderCellsImpl(const viskores::cont::UnknownCellSet& cellset,
   viskores::Int32 height = (viskores::Int32)this->Internals->Canvas->GetHeight();
 
   this->Internals->RayCamera = camera.CreateRaytracingCamera(width, height);
+  this->Internals->RayCamera.SetPixelSelection(this->Internals->Canvas->GetPixelSelection());
 
   this->Internals->RayCamera.CreateRays(this->Internals->Rays, shapeBounds);
   this->Internals->Rays.Buffers.at(0).InitConst(0.f);
@@ -224,7 +287,7 @@ void MapperPoint::RenderCellsImpl(const viskores::cont::UnknownCellSet& cellset,
                                              camera.CreateRaytracingCamera(width, height),
                                              this->Internals->Canvas->GetDepthBuffer());
 
-  this->Internals->Tracer.SetField(scalarField, scalarRange);
+  this->Internals->Tracer.SetField(renderField, scalarRange);
   this->Internals->Tracer.GetCamera() = this->Internals->RayCamera;
   this->Internals->Tracer.SetColorMap(this->ColorMap);
   this->Internals->Tracer.Render(this->Internals->Rays);
@@ -244,6 +307,34 @@ void MapperPoint::RenderCellsImpl(const viskores::cont::UnknownCellSet& cellset,
   logger->CloseLogEntry(time);
 }
 
+void MapperPoint::SetLevelOfDetail(bool on)
+{
+  this->Internals->LevelOfDetail = on;
+  if (!on)
+  {
+    this->Internals->Hierarchy.Clear();
+  }
+}
+
+bool MapperPoint::GetLevelOfDetail() const
+{
+  return this->Internals->LevelOfDetail;
+}
+
+void MapperPoint::SetLevelOfDetailPixelSize(viskores::Float32 size)
+{
+  if (!(size > 0.f))
+  {
+    throw viskores::cont::ErrorBadValue("MapperPoint: level of detail pixel size must be positive");
+  }
+  this->Internals->LevelOfDetailPixelSize = size;
+}
+
+viskores::Float32 MapperPoint::GetLevelOfDetailPixelSize() const
+{
+  return this->Internals->LevelOfDetailPixelSize;
+}
+
 void MapperPoint::SetCompositeBackground(bool on)
 {
   this->Internals->CompositeBackground = on;
@@ -75,6 +75,26 @@ public:
   /// of base +/- base * 0.5.
   void SetRadiusDelta(const viskores::Float32& delta);
 
+  /// @brief Render a level of detail of the points suited to the view.
+  ///
+  /// When on, the mapper builds a hierarchy of point aggregates on the first render
+  /// (see `raytracing::PointHierarchy`). Each render then draws, in place of the points,
+  /// the coarsest aggregates that are at most `SetLevelOfDetailPixelSize()` pixels across.
+  /// Aggregates are spheres that bound the points they stand for, colored by the average
+  /// of their scalars. The hierarchy is reused as long as the coordinate and field arrays
+  /// are the same arrays and the radius settings do not change. Only applies to points
+  /// (see `SetUsePoints()`). Off by default.
+  void SetLevelOfDetail(bool on);
+  /// @copydoc SetLevelOfDetail
+  bool GetLevelOfDetail() const;
+
+  /// @brief The largest size in pixels of the point aggregates drawn with level of detail.
+  ///
+  /// The default is 2.
+  void SetLevelOfDetailPixelSize(viskores::Float32 size);
+  /// @copydoc SetLevelOfDetailPixelSize
+  viskores::Float32 GetLevelOfDetailPixelSize() const;
+
   void SetCompositeBackground(bool on);
   viskores::rendering::Mapper* NewCopy() const override;
 
@@ -9,6 +9,7 @@
 
 #include <viskores/rendering/MapperRayTracer.h>
 
+#include <viskores/cont/ArrayHandleConstant.h>
 #include <viskores/cont/BoundsCompute.h>
 #include <viskores/cont/Timer.h>
 #include <viskores/cont/TryExecute.h>
@@ -28,6 +29,34 @@ namespace viskores
 namespace rendering
 {
 
+namespace
+{
+
+// Returns whether two ghost arrays are the same array. The constant arrays made for data
+// sets without ghost cells are new for every render, so those are compared by value.
+bool SameGhostArray(const viskores::cont::UnknownArrayHandle& ghosts1,
+                    const viskores::cont::UnknownArrayHandle& ghosts2)
+{
+  using ConstantType = viskores::cont::ArrayHandleConstant<viskores::UInt8>;
+  using BasicType = viskores::cont::ArrayHandle<viskores::UInt8>;
+  if (ghosts1.GetNumberOfValues() != ghosts2.GetNumberOfValues())
+  {
+    return false;
+  }
+  if (ghosts1.IsType<ConstantType>() && ghosts2.IsType<ConstantType>())
+  {
+    return ghosts1.AsArrayHandle<ConstantType>().GetValue() ==
+      ghosts2.AsArrayHandle<ConstantType>().GetValue();
+  }
+  if (ghosts1.IsType<BasicType>() && ghosts2.IsType<BasicType>())
+  {
+    return ghosts1.AsArrayHandle<BasicType>() == ghosts2.AsArrayHandle<BasicType>();
+  }
+  return false;
+}
+
+} // anonymous namespace
+
 struct MapperRayTracer::InternalsType
 {
   viskores::rendering::CanvasRayTracer* Canvas;
@@ -36,11 +65,29 @@ struct MapperRayTracer::InternalsType
   viskores::rendering::raytracing::Ray<viskores::Float32> Rays;
   bool CompositeBackground;
   bool Shade;
+  viskores::rendering::raytracing::BVHBuilderType BVHBuilder;
+  bool RefitBVH;
+  viskores::IdComponent RayPacketSize;
+  bool Shadows;
+  viskores::IdComponent AmbientOcclusionSamples;
+  viskores::Float32 AmbientOcclusionDistance;
+  // Triangles of the last render and what they were extracted from, kept for refitting.
+  std::shared_ptr<viskores::rendering::raytracing::TriangleIntersector> Triangles;
+  viskores::cont::UnknownCellSet TrianglesCellSet;
+  viskores::cont::Field TrianglesGhostField;
+  viskores::Id TrianglesNumberOfPoints;
   VISKORES_CONT
   InternalsType()
     : Canvas(nullptr)
     , CompositeBackground(true)
     , Shade(true)
+    , BVHBuilder(viskores::rendering::raytracing::BVHBuilderType::Morton)
+    , RefitBVH(false)
+    , RayPacketSize(1)
+    , Shadows(false)
+    , AmbientOcclusionSamples(0)
+    , AmbientOcclusionDistance(0.f)
+    , TrianglesNumberOfPoints(-1)
   {
   }
 };
@@ -96,16 +143,54 @@ void MapperRayTracer::RenderCellsImpl(const viskores::cont::UnknownCellSet& cell
   // Add supported shapes
   //
   viskores::Bounds shapeBounds;
-  raytracing::TriangleExtractor triExtractor;
-  triExtractor.ExtractCells(cellset, ghostField);
+  timer.Start();
+  auto& triIntersector = this->Internals->Triangles;
+  // Only the points may change between refits. The cell set is compared by identity, as
+  // other cells with the same counts need other triangles.
+  const bool refit = this->Internals->RefitBVH && triIntersector &&
+    triIntersector->GetBVHBuilder() == this->Internals->BVHBuilder &&
+    cellset.GetCellSetBase() == this->Internals->TrianglesCellSet.GetCellSetBase() &&
+    cellset.GetNumberOfCells() == this->Internals->TrianglesCellSet.GetNumberOfCells() &&
+    coords.GetNumberOfPoints() == this->Internals->TrianglesNumberOfPoints &&
+    SameGhostArray(ghostField.GetData(), this->Internals->TrianglesGhostField.GetData());
+  if (refit)
+  {
+    triIntersector->SetCoordinates(coords);
+    // The points moved, so the occlusion of previous renders no longer applies.
+    this->Internals->Tracer.ResetAccumulation();
+    logger->AddLogData("bvh_refit", timer.GetElapsedTime());
+  }
+  else
+  {
+    triIntersector.reset();
+    raytracing::TriangleExtractor triExtractor;
+    triExtractor.ExtractCells(cellset, ghostField);
 
-  if (triExtractor.GetNumberOfTriangles() > 0)
+    if (triExtractor.GetNumberOfTriangles() > 0)
+    {
+      triIntersector = std::make_shared<raytracing::TriangleIntersector>();
+      triIntersector->SetBVHBuilder(this->Internals->BVHBuilder);
+      triIntersector->SetData(coords, triExtractor.GetTriangles());
+      this->Internals->TrianglesCellSet = cellset;
+      this->Internals->TrianglesGhostField = ghostField;
+      this->Internals->TrianglesNumberOfPoints = coords.GetNumberOfPoints();
+    }
+    logger->AddLogData("bvh_build", timer.GetElapsedTime());
+  }
+
+  if (triIntersector)
   {
-    auto triIntersector = std::make_shared<raytracing::TriangleIntersector>();
-    triIntersector->SetData(coords, triExtractor.GetTriangles());
+    triIntersector->SetRayPacketSize(this->Internals->RayPacketSize);
     this->Internals->Tracer.AddShapeIntersector(triIntersector);
     shapeBounds.Include(triIntersector->GetShapeBounds());
   }
+  if (!this->Internals->RefitBVH)
+  {
+    // Only hold on to the triangles when they may be refit.
+    triIntersector.reset();
+    this->Internals->TrianglesCellSet = viskores::cont::UnknownCellSet();
+    this->Internals->TrianglesGhostField = viskores::cont::Field();
+  }
 
   //
   // Create rays
@@ -114,6 +199,7 @@ void MapperRayTracer::RenderCellsImpl(const viskores::cont::UnknownCellSet& cell
   viskores::Int32 height = (viskores::Int32)this->Internals->Canvas->GetHeight();
 
   this->Internals->RayCamera = camera.CreateRaytracingCamera(width, height);
+  this->Internals->RayCamera.SetPixelSelection(this->Internals->Canvas->GetPixelSelection());
 
   this->Internals->RayCamera.CreateRays(this->Internals->Rays, shapeBounds);
   this->Internals->Tracer.GetCamera() = this->Internals->RayCamera;
@@ -126,6 +212,9 @@ void MapperRayTracer::RenderCellsImpl(const viskores::cont::UnknownCellSet& cell
 
   this->Internals->Tracer.SetColorMap(this->ColorMap);
   this->Internals->Tracer.SetShadingOn(this->Internals->Shade);
+  this->Internals->Tracer.SetShadowsOn(this->Internals->Shadows);
+  this->Internals->Tracer.SetAmbientOcclusionSamples(this->Internals->AmbientOcclusionSamples);
+  this->Internals->Tracer.SetAmbientOcclusionDistance(this->Internals->AmbientOcclusionDistance);
   this->Internals->Tracer.Render(this->Internals->Rays);
 
   timer.Start();
@@ -153,6 +242,89 @@ void MapperRayTracer::SetShadingOn(bool on)
   this->Internals->Shade = on;
 }
 
+void MapperRayTracer::SetBVHBuilder(viskores::rendering::raytracing::BVHBuilderType builder)
+{
+  this->Internals->BVHBuilder = builder;
+}
+
+viskores::rendering::raytracing::BVHBuilderType MapperRayTracer::GetBVHBuilder() const
+{
+  return this->Internals->BVHBuilder;
+}
+
+void MapperRayTracer::SetRayPacketSize(viskores::IdComponent packetSize)
+{
+  if (packetSize != 1 && packetSize != 4 && packetSize != 8)
+  {
+    throw viskores::cont::ErrorBadValue("Ray packet size must be 1, 4, or 8.");
+  }
+  this->Internals->RayPacketSize = packetSize;
+}
+
+viskores::IdComponent MapperRayTracer::GetRayPacketSize() const
+{
+  return this->Internals->RayPacketSize;
+}
+
+void MapperRayTracer::SetRefitBVH(bool on)
+{
+  this->Internals->RefitBVH = on;
+  if (!on)
+  {
+    this->Internals->Triangles.reset();
+    this->Internals->TrianglesCellSet = viskores::cont::UnknownCellSet();
+    this->Internals->TrianglesGhostField = viskores::cont::Field();
+  }
+}
+
+bool MapperRayTracer::GetRefitBVH() const
+{
+  return this->Internals->RefitBVH;
+}
+
+void MapperRayTracer::SetShadowsOn(bool on)
+{
+  this->Internals->Shadows = on;
+}
+
+bool MapperRayTracer::GetShadowsOn() const
+{
+  return this->Internals->Shadows;
+}
+
+void MapperRayTracer::SetAmbientOcclusionSamples(viskores::IdComponent samples)
+{
+  if (samples < 0)
+  {
+    throw viskores::cont::ErrorBadValue("Ambient occlusion samples must not be negative.");
+  }
+  this->Internals->AmbientOcclusionSamples = samples;
+}
+
+viskores::IdComponent MapperRayTracer::GetAmbientOcclusionSamples() const
+{
+  return this->Internals->AmbientOcclusionSamples;
+}
+
+void MapperRayTracer::SetAmbientOcclusionDistance(viskores::Float32 distance)
+{
+  if (distance < 0.f)
+  {
+    throw viskores::cont::ErrorBadValue("Ambient occlusion distance must not be negative.");
+  }
+  this->Internals->AmbientOcclusionDistance = distance;
+}
+
+viskores::Float32 MapperRayTracer::GetAmbientOcclusionDistance() const
+{
+  return this->Internals->AmbientOcclusionDistance;
+}
+
+void MapperRayTracer::ResetAccumulation()
+{
+  this->Internals->Tracer.ResetAccumulation();
+}
+
 viskores::rendering::Mapper* MapperRayTracer::NewCopy() const
 {
   return new viskores::rendering::MapperRayTracer(*this);
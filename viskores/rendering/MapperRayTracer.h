@@ -12,6 +12,7 @@
 #include <viskores/cont/ColorTable.h>
 #include <viskores/rendering/Camera.h>
 #include <viskores/rendering/Mapper.h>
+#include <viskores/rendering/raytracing/BoundingVolumeHierarchy.h>
 
 #include <memory>
 
@@ -38,6 +39,72 @@ public:
   viskores::rendering::Mapper* NewCopy() const override;
   void SetShadingOn(bool on);
 
+  /// @brief Specifies how the bounding volume hierarchy over the triangles is built.
+  ///
+  /// The default Morton builder is the fastest to build. The SAH builder takes longer
+  /// but produces a tree that is faster to traverse, which pays off when the same
+  /// geometry is rendered many times (e.g., with `SetRefitBVH()`).
+  void SetBVHBuilder(viskores::rendering::raytracing::BVHBuilderType builder);
+  /// @copydoc SetBVHBuilder
+  viskores::rendering::raytracing::BVHBuilderType GetBVHBuilder() const;
+
+  /// @brief Specifies how many rays are traced through the BVH together: 1 for single
+  /// rays, or packets of 4 or 8.
+  ///
+  /// Packets share the walk through the BVH among neighboring rays. This is faster on
+  /// CPU devices when the triangles each cover several pixels, and slower when rays that
+  /// are next to each other hit different triangles. The image is the same either way.
+  /// The default is 1.
+  void SetRayPacketSize(viskores::IdComponent packetSize);
+  /// @copydoc SetRayPacketSize
+  viskores::IdComponent GetRayPacketSize() const;
+
+  /// @brief Reuses the triangles and the BVH of the previous render when only the
+  /// point coordinates change.
+  ///
+  /// When on, the mapper keeps the triangles as long as it renders the same cell set
+  /// and ghost array as the previous render with the same number of points. The BVH is
+  /// then refit to the new coordinates instead of being rebuilt. Turn this on only for
+  /// meshes whose topology is fixed, such as time-varying deforming surfaces. Modifying
+  /// a cell set in place is not detected. Off by default.
+  void SetRefitBVH(bool on);
+  /// @copydoc SetRefitBVH
+  bool GetRefitBVH() const;
+
+  /// @brief Darkens the surfaces that the light does not reach.
+  ///
+  /// A ray is traced from each visible surface point toward the light. Shadows are
+  /// only drawn when shading is on. Off by default.
+  void SetShadowsOn(bool on);
+  /// @copydoc SetShadowsOn
+  bool GetShadowsOn() const;
+
+  /// @brief Specifies how many ambient occlusion rays are traced from each visible
+  /// surface point per render. 0, the default, turns ambient occlusion off.
+  ///
+  /// Ambient occlusion darkens creases and cavities by the fraction of rays that hit the
+  /// surface within `SetAmbientOcclusionDistance()`. While the camera, the canvas size,
+  /// and the bounds of the data stay the same, the samples of consecutive renders are
+  /// accumulated, so 1 or 2 samples per render keep the cost of a frame low and still
+  /// converge over several frames. Ambient occlusion is only drawn when shading is on.
+  void SetAmbientOcclusionSamples(viskores::IdComponent samples);
+  /// @copydoc SetAmbientOcclusionSamples
+  viskores::IdComponent GetAmbientOcclusionSamples() const;
+
+  /// @brief Specifies how far away the surface occludes a point.
+  ///
+  /// 0, the default, uses a tenth of the diagonal of the bounds of the data.
+  void SetAmbientOcclusionDistance(viskores::Float32 distance);
+  /// @copydoc SetAmbientOcclusionDistance
+  viskores::Float32 GetAmbientOcclusionDistance() const;
+
+  /// @brief Discards the ambient occlusion and shadows accumulated by previous renders.
+  ///
+  /// The accumulation restarts on its own when the camera, the canvas size, or the bounds
+  /// of the data change, and when the BVH is refit. Call this when the data changes
+  /// without changing its bounds.
+  void ResetAccumulation();
+
 private:
   struct InternalsType;
   std::shared_ptr<InternalsType> Internals;
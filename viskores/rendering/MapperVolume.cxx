@@ -32,12 +32,16 @@ struct MapperVolume::InternalsType
   viskores::rendering::CanvasRayTracer* Canvas;
   viskores::Float32 SampleDistance;
   bool CompositeBackground;
+  bool EmptySpaceSkipping;
+  viskores::Float32 RayTerminationOpacity;
 
   VISKORES_CONT
   InternalsType()
     : Canvas(nullptr)
     , SampleDistance(DEFAULT_SAMPLE_DISTANCE)
     , CompositeBackground(true)
+    , EmptySpaceSkipping(true)
+    , RayTerminationOpacity(1.f)
   {
   }
 };
@@ -101,6 +105,7 @@ void MapperVolume::RenderCellsImpl(const viskores::cont::UnknownCellSet& cellset
     viskores::Int32 height = (viskores::Int32)this->Internals->Canvas->GetHeight();
     viskores::rendering::raytracing::Camera rayCamera =
       camera.CreateRaytracingCamera(width, height);
+    rayCamera.SetPixelSelection(this->Internals->Canvas->GetPixelSelection());
 
     viskores::rendering::raytracing::Ray<viskores::Float32> rays;
     rayCamera.CreateRays(rays, coords.GetBounds());
@@ -115,6 +120,8 @@ void MapperVolume::RenderCellsImpl(const viskores::cont::UnknownCellSet& cellset
       tracer.SetSampleDistance(this->Internals->SampleDistance);
     }
 
+    tracer.SetEmptySpaceSkipping(this->Internals->EmptySpaceSkipping);
+    tracer.SetRayTerminationOpacity(this->Internals->RayTerminationOpacity);
     tracer.SetData(
       coords, scalarField, cellset.AsCellSet<viskores::cont::CellSetStructured<3>>(), scalarRange);
     tracer.SetColorMap(this->ColorMap);
@@ -149,5 +156,17 @@ void MapperVolume::SetCompositeBackground(const bool compositeBackground)
 {
   this->Internals->CompositeBackground = compositeBackground;
 }
+
+void MapperVolume::SetEmptySpaceSkipping(bool enable)
+{
+  this->Internals->EmptySpaceSkipping = enable;
+}
+
+void MapperVolume::SetRayTerminationOpacity(viskores::Float32 opacity)
+{
+  if (opacity <= 0.f || opacity > 1.f)
+    throw viskores::cont::ErrorBadValue("Ray termination opacity must be in (0, 1].");
+  this->Internals->RayTerminationOpacity = opacity;
+}
 }
 } // namespace viskores::rendering
@@ -38,6 +38,16 @@ public:
   void SetSampleDistance(const viskores::Float32 distance);
   void SetCompositeBackground(const bool compositeBackground);
 
+  /// @brief Specify whether rays skip regions that the color table makes fully transparent.
+  ///
+  /// Only the samples that would add nothing to the image are skipped. On by default.
+  void SetEmptySpaceSkipping(bool enable);
+
+  /// @brief Specify the accumulated opacity at which rays stop sampling the volume.
+  ///
+  /// The default of 1 stops rays only once they are fully opaque.
+  void SetRayTerminationOpacity(viskores::Float32 opacity);
+
 private:
   struct InternalsType;
   std::shared_ptr<InternalsType> Internals;
@@ -7,13 +7,99 @@
 //============================================================================
 
 
+#include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/ErrorBadValue.h>
+#include <viskores/cont/Invoker.h>
+#include <viskores/cont/Logging.h>
+#include <viskores/cont/Timer.h>
+#include <viskores/rendering/CanvasRayTracer.h>
 #include <viskores/rendering/View.h>
+#include <viskores/worklet/WorkletMapField.h>
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <thread>
 
 namespace viskores
 {
 namespace rendering
 {
 
+namespace
+{
+
+// Shows the pixels rendered by the first `completedPasses` progressive passes, filling
+// each pixel not rendered yet with the pixel rendered for the smallest block holding it.
+class FillProgressiveImage : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature =
+    void(FieldIn, WholeArrayIn, WholeArrayIn, WholeArrayIn, FieldOut, FieldOut, FieldOut);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+
+  VISKORES_CONT FillProgressiveImage(viskores::Id width,
+                                     viskores::IdComponent levels,
+                                     viskores::Id completedPasses)
+    : Width(width)
+    , Levels(levels)
+    , CompletedPasses(completedPasses)
+  {
+  }
+
+  template <typename ColorPortal, typename DepthPortal>
+  VISKORES_EXEC void operator()(viskores::Id pixel,
+                                const ColorPortal& colors,
+                                const DepthPortal& depths,
+                                const DepthPortal& distances,
+                                viskores::Vec4f_32& color,
+                                viskores::Float32& depth,
+                                viskores::Float32& distance) const
+  {
+    const viskores::Id x = pixel % this->Width;
+    const viskores::Id y = pixel / this->Width;
+
+    // The passes of each level render the corners of the blocks of the previous level
+    // in the order (h, 0), (0, h), (h, h), where h is half the block size.
+    const viskores::Id blockSize = viskores::Id(1) << this->Levels;
+    viskores::Id sourceX = x - x % blockSize;
+    viskores::Id sourceY = y - y % blockSize;
+    viskores::Id pass = 1;
+    for (viskores::Id size = blockSize; size > 1; size /= 2, pass += 3)
+    {
+      const viskores::Id half = size / 2;
+      const viskores::Id cornerX = x - x % half;
+      const viskores::Id cornerY = y - y % half;
+      const bool offsetX = (cornerX % size) != 0;
+      const bool offsetY = (cornerY % size) != 0;
+      if (!offsetX && !offsetY)
+      {
+        continue;
+      }
+      const viskores::Id cornerPass = pass + (offsetY ? (offsetX ? 2 : 1) : 0);
+      if (cornerPass >= this->CompletedPasses)
+      {
+        break;
+      }
+      sourceX = cornerX;
+      sourceY = cornerY;
+    }
+
+    const viskores::Id source = sourceY * this->Width + sourceX;
+    color = colors.Get(source);
+    depth = depths.Get(source);
+    distance = distances.Get(source);
+  }
+
+private:
+  viskores::Id Width;
+  viskores::IdComponent Levels;
+  viskores::Id CompletedPasses;
+};
+
+} // anonymous namespace
+
 struct View::InternalData
 {
   ~InternalData()
@@ -29,6 +115,92 @@ struct View::InternalData
   std::vector<std::unique_ptr<viskores::rendering::TextAnnotation>> TextAnnotations;
   std::vector<std::function<void(void)>> AdditionalAnnotations;
   viskores::rendering::Camera Camera;
+
+  RenderMode Mode = RenderMode::Full;
+  viskores::IdComponent ProgressiveLevels = 3;
+  viskores::Id TileSize = 64;
+  viskores::Float64 FrameTimeBudget = 1.0 / 30.0;
+
+  // The passes of the image being rendered, which are empty when no image is started,
+  // and what the image was started with.
+  std::vector<viskores::rendering::raytracing::PixelSelection> Passes;
+  std::size_t NextPass = 0;
+  viskores::Matrix<viskores::Float32, 4, 4> ViewMatrix;
+  viskores::Matrix<viskores::Float32, 4, 4> ProjectionMatrix;
+  viskores::Bounds Viewport;
+  viskores::Id Width = 0;
+  viskores::Id Height = 0;
+
+  // Progressive passes render into this copy of the canvas, which only holds the pixels
+  // rendered so far, and the canvas shows it with the missing pixels filled in.
+  std::unique_ptr<viskores::rendering::CanvasRayTracer> ProgressiveCanvas;
+
+  bool IsSameView(const viskores::rendering::Canvas& canvas) const
+  {
+    return !this->Passes.empty() && this->Width == canvas.GetWidth() &&
+      this->Height == canvas.GetHeight() && this->Viewport == this->Camera.GetViewport() &&
+      this->ViewMatrix == this->Camera.CreateViewMatrix() &&
+      this->ProjectionMatrix ==
+      this->Camera.CreateProjectionMatrix(canvas.GetWidth(), canvas.GetHeight());
+  }
+
+  void StartImage(const viskores::rendering::Canvas& canvas)
+  {
+    this->Width = canvas.GetWidth();
+    this->Height = canvas.GetHeight();
+    this->Viewport = this->Camera.GetViewport();
+    this->ViewMatrix = this->Camera.CreateViewMatrix();
+    this->ProjectionMatrix = this->Camera.CreateProjectionMatrix(this->Width, this->Height);
+    this->NextPass = 0;
+    this->Passes.clear();
+
+    using PixelSelection = viskores::rendering::raytracing::PixelSelection;
+    if (this->Mode == RenderMode::Progressive)
+    {
+      const viskores::Int32 blockSize = viskores::Int32(1) << this->ProgressiveLevels;
+      PixelSelection pass;
+      pass.Stride = blockSize;
+      this->Passes.push_back(pass);
+      for (viskores::Int32 size = blockSize; size > 1; size /= 2)
+      {
+        const viskores::Int32 half = size / 2;
+        pass.Stride = size;
+        for (viskores::Vec2i_32 offset : { viskores::Vec2i_32(half, 0),
+                                           viskores::Vec2i_32(0, half),
+                                           viskores::Vec2i_32(half, half) })
+        {
+          pass.Offset = offset;
+          this->Passes.push_back(pass);
+        }
+      }
+    }
+    else
+    {
+      const viskores::Int32 tileSize = static_cast<viskores::Int32>(this->TileSize);
+      for (viskores::Int32 y = 0; y < static_cast<viskores::Int32>(this->Height); y += tileSize)
+      {
+        for (viskores::Int32 x = 0; x < static_cast<viskores::Int32>(this->Width); x += tileSize)
+        {
+          PixelSelection tile;
+          tile.Min = viskores::Vec2i_32(x, y);
+          tile.Max = viskores::Vec2i_32(x + tileSize, y + tileSize);
+          this->Passes.push_back(tile);
+        }
+      }
+      // Twice the distance of the tile center from the image center.
+      const auto distance = [this](const PixelSelection& tile)
+      {
+        const viskores::Vec2i_32 center = tile.Min + tile.Max;
+        const viskores::Float64 dx = center[0] - static_cast<viskores::Float64>(this->Width);
+        const viskores::Float64 dy = center[1] - static_cast<viskores::Float64>(this->Height);
+        return dx * dx + dy * dy;
+      };
+      std::stable_sort(this->Passes.begin(),
+                       this->Passes.end(),
+                       [&](const PixelSelection& a, const PixelSelection& b)
+                       { return distance(a) < distance(b); });
+    }
+  }
 };
 
 View::View(const viskores::rendering::Scene& scene,
@@ -91,6 +263,7 @@ viskores::rendering::Scene& View::GetScene()
 void View::SetScene(const viskores::rendering::Scene& scene)
 {
   this->Internal->Scene = scene;
+  this->ResetRefinement();
 }
 
 const viskores::rendering::Mapper& View::GetMapper() const
@@ -141,6 +314,7 @@ const viskores::rendering::Color& View::GetBackgroundColor() const
 void View::SetBackgroundColor(const viskores::rendering::Color& color)
 {
   this->Internal->CanvasPointer->SetBackgroundColor(color);
+  this->ResetRefinement();
 }
 
 void View::SetForegroundColor(const viskores::rendering::Color& color)
@@ -148,11 +322,156 @@ void View::SetForegroundColor(const viskores::rendering::Color& color)
   this->Internal->CanvasPointer->SetForegroundColor(color);
 }
 
+void View::SetRenderMode(RenderMode mode)
+{
+  this->Internal->Mode = mode;
+  this->ResetRefinement();
+}
+
+View::RenderMode View::GetRenderMode() const
+{
+  return this->Internal->Mode;
+}
+
+void View::SetProgressiveLevels(viskores::IdComponent levels)
+{
+  if (levels < 0 || levels > 15)
+  {
+    throw viskores::cont::ErrorBadValue("Progressive levels must be between 0 and 15.");
+  }
+  this->Internal->ProgressiveLevels = levels;
+  this->ResetRefinement();
+}
+
+viskores::IdComponent View::GetProgressiveLevels() const
+{
+  return this->Internal->ProgressiveLevels;
+}
+
+void View::SetTileSize(viskores::Id size)
+{
+  if (size < 1)
+  {
+    throw viskores::cont::ErrorBadValue("Tile size must be positive.");
+  }
+  this->Internal->TileSize = size;
+  this->ResetRefinement();
+}
+
+viskores::Id View::GetTileSize() const
+{
+  return this->Internal->TileSize;
+}
+
+void View::SetFrameTimeBudget(viskores::Float64 seconds)
+{
+  this->Internal->FrameTimeBudget = seconds;
+}
+
+viskores::Float64 View::GetFrameTimeBudget() const
+{
+  return this->Internal->FrameTimeBudget;
+}
+
+bool View::IsImageComplete() const
+{
+  return this->Internal->Mode == RenderMode::Full ||
+    (!this->Internal->Passes.empty() &&
+     this->Internal->NextPass == this->Internal->Passes.size());
+}
+
+void View::ResetRefinement()
+{
+  this->Internal->Passes.clear();
+  this->Internal->NextPass = 0;
+  this->Internal->ProgressiveCanvas.reset();
+}
+
 void View::SaveAs(const std::string& fileName) const
 {
   this->GetCanvas().SaveAs(fileName);
 }
 
+void View::RenderBatch(const std::vector<BatchImage>& images, viskores::IdComponent numWriters)
+{
+  if (numWriters < 0)
+  {
+    throw viskores::cont::ErrorBadValue("Number of image writers must not be negative.");
+  }
+  const std::size_t maxWriters = numWriters > 0
+    ? static_cast<std::size_t>(numWriters)
+    : std::max(std::thread::hardware_concurrency(), 1u);
+
+  VISKORES_LOG_SCOPE(viskores::cont::LogLevel::Perf, "View::RenderBatch");
+  const RenderMode mode = this->Internal->Mode;
+  this->Internal->Mode = RenderMode::Full;
+
+  std::deque<std::future<void>> writers;
+  std::exception_ptr error;
+  const auto finishWriter = [&]()
+  {
+    try
+    {
+      writers.front().get();
+    }
+    catch (...)
+    {
+      if (!error)
+      {
+        error = std::current_exception();
+      }
+    }
+    writers.pop_front();
+  };
+
+  try
+  {
+    for (const BatchImage& image : images)
+    {
+      if (image.Prepare)
+      {
+        image.Prepare(*this);
+      }
+      this->Internal->Camera = image.Camera;
+      this->Paint();
+      if (image.FileName.empty())
+      {
+        continue;
+      }
+
+      // Save a copy of the image so the next one can render into the canvas.
+      const viskores::rendering::Canvas& canvas = this->GetCanvas();
+      canvas.RefreshColorBuffer();
+      auto snapshot = std::make_shared<viskores::rendering::Canvas>(canvas.GetWidth(),
+                                                                    canvas.GetHeight());
+      viskores::cont::ArrayCopy(canvas.GetColorBuffer(), snapshot->GetColorBuffer());
+      if (writers.size() == maxWriters)
+      {
+        finishWriter();
+      }
+      writers.push_back(std::async(std::launch::async,
+                                   [snapshot, fileName = image.FileName]()
+                                   { snapshot->SaveAs(fileName); }));
+    }
+  }
+  catch (...)
+  {
+    // A failed render matters more than a failed save.
+    error = std::current_exception();
+  }
+
+  this->Internal->Mode = mode;
+  this->ResetRefinement();
+  while (!writers.empty())
+  {
+    finishWriter();
+  }
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
 void View::SetAxisColor(viskores::rendering::Color c)
 {
   this->AxisColor = c;
@@ -205,6 +524,84 @@ void View::RenderAnnotations()
   }
 }
 
+void View::RenderScene(const std::function<void()>& startImage)
+{
+  auto& internal = *this->Internal;
+  if (internal.Mode == RenderMode::Full)
+  {
+    startImage();
+    internal.Scene.Render(*internal.MapperPointer, *internal.CanvasPointer, internal.Camera);
+    return;
+  }
+
+  auto* canvas = dynamic_cast<viskores::rendering::CanvasRayTracer*>(internal.CanvasPointer);
+  if (canvas == nullptr)
+  {
+    throw viskores::cont::ErrorBadValue(
+      "Progressive and tiled rendering need a CanvasRayTracer.");
+  }
+
+  const bool progressive = internal.Mode == RenderMode::Progressive;
+  if (!internal.IsSameView(*canvas))
+  {
+    startImage();
+    internal.StartImage(*canvas);
+    if (progressive)
+    {
+      // Copy the buffers so the passes do not render into those of the canvas.
+      internal.ProgressiveCanvas.reset(
+        static_cast<viskores::rendering::CanvasRayTracer*>(canvas->NewCopy()));
+      Canvas::ColorBufferType colors;
+      Canvas::DepthBufferType depths;
+      Canvas::DepthBufferType distances;
+      viskores::cont::ArrayCopy(canvas->GetColorBuffer(), colors);
+      viskores::cont::ArrayCopy(canvas->GetDepthBuffer(), depths);
+      viskores::cont::ArrayCopy(canvas->GetDistancesToCamera(), distances);
+      internal.ProgressiveCanvas->GetColorBuffer() = colors;
+      internal.ProgressiveCanvas->GetDepthBuffer() = depths;
+      internal.ProgressiveCanvas->GetDistancesToCamera() = distances;
+    }
+  }
+  else if (internal.NextPass == internal.Passes.size())
+  {
+    return;
+  }
+
+  VISKORES_LOG_SCOPE(viskores::cont::LogLevel::Perf, "View::RenderScene");
+  viskores::rendering::CanvasRayTracer& target =
+    progressive ? *internal.ProgressiveCanvas : *canvas;
+  viskores::cont::Timer timer;
+  timer.Start();
+  viskores::Float64 passes = 0;
+  do
+  {
+    target.SetPixelSelection(internal.Passes[internal.NextPass++]);
+    internal.Scene.Render(*internal.MapperPointer, target, internal.Camera);
+    passes += 1;
+  } while (internal.NextPass < internal.Passes.size() &&
+           timer.GetElapsedTime() * (passes + 1) / passes <= internal.FrameTimeBudget);
+  target.SetPixelSelection(viskores::rendering::raytracing::PixelSelection{});
+
+  if (progressive)
+  {
+    viskores::cont::Invoker invoke;
+    invoke(FillProgressiveImage{ canvas->GetWidth(),
+                                 internal.ProgressiveLevels,
+                                 static_cast<viskores::Id>(internal.NextPass) },
+           viskores::cont::ArrayHandleIndex(canvas->GetWidth() * canvas->GetHeight()),
+           internal.ProgressiveCanvas->GetColorBuffer(),
+           internal.ProgressiveCanvas->GetDepthBuffer(),
+           internal.ProgressiveCanvas->GetDistancesToCamera(),
+           canvas->GetColorBuffer(),
+           canvas->GetDepthBuffer(),
+           canvas->GetDistancesToCamera());
+    if (internal.NextPass == internal.Passes.size())
+    {
+      internal.ProgressiveCanvas.reset();
+    }
+  }
+}
+
 void View::SetupForWorldSpace(bool viewportClip)
 {
   this->GetCanvas().SetViewToWorldSpace(this->Internal->Camera, viewportClip);
@@ -20,6 +20,8 @@
 
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace viskores
 {
@@ -32,6 +34,41 @@ class VISKORES_RENDERING_EXPORT View
   struct InternalData;
 
 public:
+  /// @brief How `Paint()` renders the scene.
+  ///
+  /// `Progressive` and `Tiled` spread the rendering of an image over several calls to
+  /// `Paint()`, each of which renders for about `GetFrameTimeBudget()` seconds, so an
+  /// interactive application can keep handling input while a large scene renders. They
+  /// require a `CanvasRayTracer`, and only mappers that ray trace (all but
+  /// `MapperWireframer`) render part of the image per call; other mappers render the
+  /// whole image every time.
+  enum struct RenderMode
+  {
+    /// Renders the whole image on every call.
+    Full,
+    /// First renders one pixel in each block of 2^`GetProgressiveLevels()` pixels
+    /// squared and fills the block with its color, then renders the remaining pixels in
+    /// passes that halve the blocks until every pixel is rendered. No pixel is rendered
+    /// twice, so the complete image costs the same as with `Full`.
+    Progressive,
+    /// Renders the image in square tiles of `GetTileSize()` pixels, starting with those
+    /// nearest the center of the image. Tiles not yet rendered show the background.
+    Tiled
+  };
+
+  /// @brief One image of a batch rendered by `RenderBatch()`.
+  struct BatchImage
+  {
+    /// The camera to render the image from.
+    viskores::rendering::Camera Camera;
+    /// The file to save the image to, as with `SaveAs()`. The image is not saved when
+    /// this is empty.
+    std::string FileName;
+    /// Called before the image is rendered to change anything besides the camera, such
+    /// as replacing the scene with the contours of another isovalue. Optional.
+    std::function<void(View&)> Prepare;
+  };
+
   View(const viskores::rendering::Scene& scene,
        const viskores::rendering::Mapper& mapper,
        const viskores::rendering::Canvas& canvas,
@@ -107,6 +144,44 @@ public:
   VISKORES_CONT void SetRenderAnnotationsEnabled(bool val) { this->RenderAnnotationsEnabled = val; }
   VISKORES_CONT bool GetRenderAnnotationsEnabled() const { return this->RenderAnnotationsEnabled; }
 
+  /// @brief Specify how `Paint()` renders the scene. The default is `Full`.
+  VISKORES_CONT void SetRenderMode(RenderMode mode);
+  /// @copydoc SetRenderMode
+  VISKORES_CONT RenderMode GetRenderMode() const;
+
+  /// @brief Specify the number of times `Progressive` rendering halves the blocks of
+  /// pixels of its first pass. The default is 3, so the first pass renders 1 pixel in 64.
+  VISKORES_CONT void SetProgressiveLevels(viskores::IdComponent levels);
+  /// @copydoc SetProgressiveLevels
+  VISKORES_CONT viskores::IdComponent GetProgressiveLevels() const;
+
+  /// @brief Specify the width and height in pixels of the tiles of `Tiled` rendering.
+  /// The default is 64.
+  VISKORES_CONT void SetTileSize(viskores::Id size);
+  /// @copydoc SetTileSize
+  VISKORES_CONT viskores::Id GetTileSize() const;
+
+  /// @brief Specify the time in seconds a call to `Paint()` may spend rendering the
+  /// scene in `Progressive` and `Tiled` modes.
+  ///
+  /// `Paint()` renders passes or tiles while it expects the next one to finish within
+  /// the budget, and always renders at least one. The default is 1/30 of a second.
+  VISKORES_CONT void SetFrameTimeBudget(viskores::Float64 seconds);
+  /// @copydoc SetFrameTimeBudget
+  VISKORES_CONT viskores::Float64 GetFrameTimeBudget() const;
+
+  /// @brief Returns whether the last call to `Paint()` finished the image.
+  ///
+  /// Always true in `Full` mode. Once the image is finished, `Paint()` does nothing until
+  /// the camera or the canvas size changes or `ResetRefinement()` is called.
+  VISKORES_CONT bool IsImageComplete() const;
+
+  /// @brief Makes the next call to `Paint()` start a new image.
+  ///
+  /// Changes to the camera and canvas size are detected, but changes made to the scene,
+  /// mapper or annotations through their references are not, so call this after them.
+  VISKORES_CONT void ResetRefinement();
+
   /// @brief Render a scene and store the result in the canvas' buffers.
   virtual void Paint() = 0;
   virtual void RenderScreenAnnotations() = 0;
@@ -117,6 +192,21 @@ public:
   /// @copydoc viskores::rendering::Canvas::SaveAs
   void SaveAs(const std::string& fileName) const;
 
+  /// @brief Renders and saves a batch of images, such as an image database of a scene
+  /// seen from many cameras.
+  ///
+  /// The images are rendered in order with `Paint()` in `Full` mode, into the canvas and
+  /// with the mapper of this view. The mapper keeps what it can between renders (see, for
+  /// example, `MapperRayTracer::SetRefitBVH()`), so acceleration structures are not
+  /// rebuilt for images that only differ in their camera. While the next images render,
+  /// each image is saved on a background thread, using at most `numWriters` threads, or
+  /// one per hardware thread when `numWriters` is 0.
+  ///
+  /// When this returns, all images are saved, and the view holds the camera and canvas of
+  /// the last image. If saving an image fails, the error is thrown once the other images
+  /// are done.
+  void RenderBatch(const std::vector<BatchImage>& images, viskores::IdComponent numWriters = 0);
+
   VISKORES_CONT
   void SetAxisColor(viskores::rendering::Color c);
 
@@ -137,6 +227,12 @@ protected:
 
   void SetupForScreenSpace(bool viewportClip = false);
 
+  /// @brief Renders the scene into the canvas according to the render mode.
+  ///
+  /// `startImage` is called whenever a new image is started, before any of the scene is
+  /// rendered, to clear the canvas and draw what lies behind the scene.
+  void RenderScene(const std::function<void()>& startImage);
+
 
   viskores::rendering::Color AxisColor = viskores::rendering::Color::white;
   bool WorldAnnotationsEnabled = true;
@@ -37,11 +37,14 @@ View1D::View1D(const viskores::rendering::Scene& scene,
 
 void View1D::Paint()
 {
-  this->GetCanvas().Clear();
   this->UpdateCameraProperties();
   this->AddAdditionalAnnotation([&]() { this->RenderColorLegendAnnotations(); });
-  this->RenderAnnotations();
-  this->GetScene().Render(this->GetMapper(), this->GetCanvas(), this->GetCamera());
+  this->RenderScene(
+    [this]()
+    {
+      this->GetCanvas().Clear();
+      this->RenderAnnotations();
+    });
 }
 
 void View1D::RenderScreenAnnotations()
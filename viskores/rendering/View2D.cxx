@@ -35,10 +35,13 @@ View2D::View2D(const viskores::rendering::Scene& scene,
 
 void View2D::Paint()
 {
-  this->GetCanvas().Clear();
   this->UpdateCameraProperties();
-  this->RenderAnnotations();
-  this->GetScene().Render(this->GetMapper(), this->GetCanvas(), this->GetCamera());
+  this->RenderScene(
+    [this]()
+    {
+      this->GetCanvas().Clear();
+      this->RenderAnnotations();
+    });
 }
 
 void View2D::RenderScreenAnnotations()
@@ -35,9 +35,12 @@ View3D::View3D(const viskores::rendering::Scene& scene,
 
 void View3D::Paint()
 {
-  this->GetCanvas().Clear();
-  this->RenderAnnotations();
-  this->GetScene().Render(this->GetMapper(), this->GetCanvas(), this->GetCamera());
+  this->RenderScene(
+    [this]()
+    {
+      this->GetCanvas().Clear();
+      this->RenderAnnotations();
+    });
 }
 
 void View3D::RenderScreenAnnotations()
@@ -13,6 +13,8 @@
 #include <viskores/rendering/raytracing/Ray.h>
 #include <viskores/rendering/raytracing/RayTracingTypeDefs.h>
 
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/Invoker.h>
 #include <viskores/worklet/DispatcherMapField.h>
 #include <viskores/worklet/WorkletMapField.h>
 
@@ -74,9 +76,23 @@ VISKORES_EXEC inline bool IntersectAABB(const BVHPortalType& bvh,
   return (min0 > min1);
 }
 
+template <typename Precision>
+VISKORES_EXEC inline Precision SafeReciprocal(Precision f)
+{
+  return Precision(1) / ((viskores::Abs(f) < 1e-8f) ? Precision(1e-8f) : f);
+}
+
 class BVHTraverser
 {
 public:
+  /// `packetSize` is the number of rays each invocation traces together. A size of 1
+  /// traces every ray on its own, 4 and 8 use `PacketIntersector`.
+  VISKORES_CONT
+  explicit BVHTraverser(viskores::IdComponent packetSize = 1)
+    : PacketSize(packetSize)
+  {
+  }
+
   class Intersector : public viskores::worklet::WorkletMapField
   {
   private:
@@ -221,12 +237,308 @@ public:
   };
 
 
+  /// Traces a packet of consecutive rays through the BVH together.
+  ///
+  /// The packet visits a node when any of its rays hits the node's box and keeps, for
+  /// every node on the stack, which rays hit it, so each ray is only tested against the
+  /// leaves whose boxes it hits. A node is fetched once per packet rather than once per
+  /// ray, and the box tests of the rays are independent work the compiler can vectorize.
+  /// This pays off on CPU devices when neighboring rays visit the same nodes, as primary
+  /// rays do for shapes that cover several pixels. The closest hit of every ray is the
+  /// same as with `Intersector`.
+  template <viskores::IdComponent PacketWidth>
+  class PacketIntersector : public viskores::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn packet,
+                                  WholeArrayIn dirs,
+                                  WholeArrayIn origins,
+                                  WholeArrayOut distances,
+                                  WholeArrayIn minDistances,
+                                  WholeArrayIn maxDistances,
+                                  WholeArrayOut us,
+                                  WholeArrayOut vs,
+                                  WholeArrayOut hitIndices,
+                                  WholeArrayIn points,
+                                  ExecObject leafIntersector,
+                                  WholeArrayIn flatBVH,
+                                  WholeArrayIn leafs);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13);
+    using InputDomain = _1;
+
+    template <typename DirPortalType,
+              typename OriginPortalType,
+              typename DistancePortalType,
+              typename MinDistancePortalType,
+              typename MaxDistancePortalType,
+              typename UVPortalType,
+              typename HitPortalType,
+              typename PointPortalType,
+              typename LeafType,
+              typename InnerNodePortalType,
+              typename LeafPortalType>
+    VISKORES_EXEC void operator()(const viskores::Id& packet,
+                                  const DirPortalType& dirs,
+                                  const OriginPortalType& origins,
+                                  const DistancePortalType& distances,
+                                  const MinDistancePortalType& minDistances,
+                                  const MaxDistancePortalType& maxDistances,
+                                  const UVPortalType& us,
+                                  const UVPortalType& vs,
+                                  const HitPortalType& hitIndices,
+                                  const PointPortalType& points,
+                                  LeafType& leafIntersector,
+                                  const InnerNodePortalType& flatBVH,
+                                  const LeafPortalType& leafs) const
+    {
+      using Precision = typename DistancePortalType::ValueType;
+      using Vec3 = viskores::Vec<Precision, 3>;
+      using LaneMask = viskores::UInt32;
+
+      const viskores::Id first = packet * PacketWidth;
+      const viskores::Id remaining = dirs.GetNumberOfValues() - first;
+      const viskores::IdComponent numLanes = static_cast<viskores::IdComponent>(
+        remaining < PacketWidth ? remaining : static_cast<viskores::Id>(PacketWidth));
+
+      Vec3 dir[PacketWidth];
+      Vec3 origin[PacketWidth];
+      // The box test inputs are kept per component so the lane loop reads contiguous values.
+      Precision invDir[3][PacketWidth];
+      Precision originDir[3][PacketWidth];
+      Precision minDistance[PacketWidth];
+      Precision closestDistance[PacketWidth];
+      Precision minU[PacketWidth];
+      Precision minV[PacketWidth];
+      viskores::Id hitIndex[PacketWidth];
+      for (viskores::IdComponent lane = numLanes; lane < PacketWidth; lane++)
+      {
+        // Lanes past the last ray never hit anything, so the box tests can run on every
+        // lane without branching on which lanes are active.
+        for (viskores::IdComponent d = 0; d < 3; d++)
+        {
+          invDir[d][lane] = 1;
+          originDir[d][lane] = 0;
+        }
+        minDistance[lane] = 0;
+        closestDistance[lane] = -1;
+      }
+      for (viskores::IdComponent lane = 0; lane < numLanes; lane++)
+      {
+        dir[lane] = dirs.Get(first + lane);
+        origin[lane] = origins.Get(first + lane);
+        for (viskores::IdComponent d = 0; d < 3; d++)
+        {
+          invDir[d][lane] = SafeReciprocal(dir[lane][d]);
+          originDir[d][lane] = origin[lane][d] * invDir[d][lane];
+        }
+        minDistance[lane] = minDistances.Get(first + lane);
+        closestDistance[lane] = maxDistances.Get(first + lane);
+        minU[lane] = 0;
+        minV[lane] = 0;
+        hitIndex[lane] = -1;
+      }
+
+      // The stack holds nodes still to visit with the lanes whose rays hit them.
+      viskores::Int32 todo[64];
+      LaneMask todoLanes[64];
+      viskores::Int32 stackptr = 0;
+      const viskores::Int32 barrier = (viskores::Int32)END_FLAG;
+      todo[stackptr] = barrier;
+      todoLanes[stackptr] = 0;
+
+      viskores::Int32 currentNode = 0;
+      LaneMask lanes = (LaneMask(1) << numLanes) - 1;
+      while (currentNode != END_FLAG)
+      {
+        if (currentNode > -1)
+        {
+          const viskores::Vec4f_32 first4 = flatBVH.Get(currentNode);
+          const viskores::Vec4f_32 second4 = flatBVH.Get(currentNode + 1);
+          const viskores::Vec4f_32 third4 = flatBVH.Get(currentNode + 2);
+
+          // The same slab test as `IntersectAABB`, written out over the lanes so it
+          // has no calls or branches and the compiler can vectorize it.
+          bool hitLeft[PacketWidth];
+          bool hitRight[PacketWidth];
+          bool rightFirst[PacketWidth];
+          for (viskores::IdComponent lane = 0; lane < PacketWidth; lane++)
+          {
+            const Precision xmin0 = first4[0] * invDir[0][lane] - originDir[0][lane];
+            const Precision ymin0 = first4[1] * invDir[1][lane] - originDir[1][lane];
+            const Precision zmin0 = first4[2] * invDir[2][lane] - originDir[2][lane];
+            const Precision xmax0 = first4[3] * invDir[0][lane] - originDir[0][lane];
+            const Precision ymax0 = second4[0] * invDir[1][lane] - originDir[1][lane];
+            const Precision zmax0 = second4[1] * invDir[2][lane] - originDir[2][lane];
+            const Precision min0 = viskores::Max(
+              viskores::Max(
+                viskores::Max(viskores::Min(ymin0, ymax0), viskores::Min(xmin0, xmax0)),
+                viskores::Min(zmin0, zmax0)),
+              minDistance[lane]);
+            const Precision max0 = viskores::Min(
+              viskores::Min(
+                viskores::Min(viskores::Max(ymin0, ymax0), viskores::Max(xmin0, xmax0)),
+                viskores::Max(zmin0, zmax0)),
+              closestDistance[lane]);
+
+            const Precision xmin1 = second4[2] * invDir[0][lane] - originDir[0][lane];
+            const Precision ymin1 = second4[3] * invDir[1][lane] - originDir[1][lane];
+            const Precision zmin1 = third4[0] * invDir[2][lane] - originDir[2][lane];
+            const Precision xmax1 = third4[1] * invDir[0][lane] - originDir[0][lane];
+            const Precision ymax1 = third4[2] * invDir[1][lane] - originDir[1][lane];
+            const Precision zmax1 = third4[3] * invDir[2][lane] - originDir[2][lane];
+            const Precision min1 = viskores::Max(
+              viskores::Max(
+                viskores::Max(viskores::Min(ymin1, ymax1), viskores::Min(xmin1, xmax1)),
+                viskores::Min(zmin1, zmax1)),
+              minDistance[lane]);
+            const Precision max1 = viskores::Min(
+              viskores::Min(
+                viskores::Min(viskores::Max(ymin1, ymax1), viskores::Max(xmin1, xmax1)),
+                viskores::Max(zmin1, zmax1)),
+              closestDistance[lane]);
+
+            hitLeft[lane] = max0 >= min0;
+            hitRight[lane] = max1 >= min1;
+            rightFirst[lane] = hitRight[lane] & (!hitLeft[lane] | (min0 > min1));
+          }
+          LaneMask leftLanes = 0;
+          LaneMask rightLanes = 0;
+          LaneMask rightFirstLanes = 0;
+          for (viskores::IdComponent lane = 0; lane < PacketWidth; lane++)
+          {
+            leftLanes |= LaneMask(hitLeft[lane]) << lane;
+            rightLanes |= LaneMask(hitRight[lane]) << lane;
+            rightFirstLanes |= LaneMask(rightFirst[lane]) << lane;
+          }
+          leftLanes &= lanes;
+          rightLanes &= lanes;
+          rightFirstLanes &= lanes;
+          const viskores::Int32 rightCloserVotes = 2 * viskores::CountSetBits(rightFirstLanes) -
+            viskores::CountSetBits(leftLanes | rightLanes);
+
+          if (leftLanes == 0 && rightLanes == 0)
+          {
+            currentNode = todo[stackptr];
+            lanes = todoLanes[stackptr];
+            stackptr--;
+          }
+          else
+          {
+            viskores::Vec4f_32 children = flatBVH.Get(currentNode + 3);
+            viskores::Int32 leftChild;
+            memcpy(&leftChild, &children[0], 4);
+            viskores::Int32 rightChild;
+            memcpy(&rightChild, &children[1], 4);
+            if (leftLanes != 0 && rightLanes != 0)
+            {
+              // Visit first the child that is closer for most of the rays.
+              stackptr++;
+              if (rightCloserVotes > 0)
+              {
+                currentNode = rightChild;
+                lanes = rightLanes;
+                todo[stackptr] = leftChild;
+                todoLanes[stackptr] = leftLanes;
+              }
+              else
+              {
+                currentNode = leftChild;
+                lanes = leftLanes;
+                todo[stackptr] = rightChild;
+                todoLanes[stackptr] = rightLanes;
+              }
+            }
+            else
+            {
+              currentNode = (leftLanes != 0) ? leftChild : rightChild;
+              lanes = leftLanes | rightLanes;
+            }
+          }
+        } // if inner node
+
+        if (currentNode < 0 && currentNode != barrier)
+        {
+          const viskores::Int32 leaf = -currentNode - 1;
+          for (viskores::IdComponent lane = 0; lane < numLanes; lane++)
+          {
+            if ((lanes >> lane) & 1)
+            {
+              leafIntersector.IntersectLeaf(leaf,
+                                            origin[lane],
+                                            dir[lane],
+                                            points,
+                                            hitIndex[lane],
+                                            closestDistance[lane],
+                                            minU[lane],
+                                            minV[lane],
+                                            leafs,
+                                            minDistance[lane]);
+            }
+          }
+          currentNode = todo[stackptr];
+          lanes = todoLanes[stackptr];
+          stackptr--;
+        } // if leaf node
+      }   //while
+
+      for (viskores::IdComponent lane = 0; lane < numLanes; lane++)
+      {
+        // Without a hit, the distance is the maximum distance, as with `Intersector`.
+        distances.Set(first + lane, closestDistance[lane]);
+        us.Set(first + lane, minU[lane]);
+        vs.Set(first + lane, minV[lane]);
+        hitIndices.Set(first + lane, hitIndex[lane]);
+      }
+    } // ()
+  };
+
   template <typename Precision, typename LeafIntersectorType>
   VISKORES_CONT void IntersectRays(Ray<Precision>& rays,
                                    LinearBVH& bvh,
                                    LeafIntersectorType& leafIntersector,
                                    viskores::cont::CoordinateSystem& coordsHandle)
   {
+    const viskores::IdComponent packetSize = this->PacketSize;
+    if (packetSize == 4 || packetSize == 8)
+    {
+      // Unlike field outputs, whole array outputs are not allocated by the invocation.
+      rays.U.Allocate(rays.NumRays);
+      rays.V.Allocate(rays.NumRays);
+      viskores::cont::Invoker invoke;
+      viskores::cont::ArrayHandleIndex packets((rays.NumRays + packetSize - 1) / packetSize);
+      if (packetSize == 4)
+        invoke(PacketIntersector<4>{},
+               packets,
+               rays.Dir,
+               rays.Origin,
+               rays.Distance,
+               rays.MinDistance,
+               rays.MaxDistance,
+               rays.U,
+               rays.V,
+               rays.HitIdx,
+               coordsHandle,
+               leafIntersector,
+               bvh.FlatBVH,
+               bvh.Leafs);
+      else
+        invoke(PacketIntersector<8>{},
+               packets,
+               rays.Dir,
+               rays.Origin,
+               rays.Distance,
+               rays.MinDistance,
+               rays.MaxDistance,
+               rays.U,
+               rays.V,
+               rays.HitIdx,
+               coordsHandle,
+               leafIntersector,
+               bvh.FlatBVH,
+               bvh.Leafs);
+      return;
+    }
+
     viskores::worklet::DispatcherMapField<Intersector> intersectDispatch;
     intersectDispatch.Invoke(rays.Dir,
                              rays.Origin,
@@ -241,6 +553,9 @@ public:
                              bvh.FlatBVH,
                              bvh.Leafs);
   }
+
+private:
+  viskores::IdComponent PacketSize;
 }; // BVHTraverser
 #undef END_FLAG
 }
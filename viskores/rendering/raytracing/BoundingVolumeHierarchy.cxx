@@ -9,6 +9,9 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <viskores/Math.h>
 #include <viskores/VectorAnalysis.h>
 
@@ -57,11 +60,19 @@ public:
   VISKORES_CONT
   LinearBVHBuilder() {}
 
-  VISKORES_CONT void SortAABBS(BVHData& bvh, bool);
+  VISKORES_CONT void SortAABBS(BVHData& bvh, viskores::cont::ArrayHandle<viskores::Id>& iterator);
+
+  VISKORES_CONT void SplitSAH(BVHData& bvh, viskores::cont::ArrayHandle<viskores::Id>& iterator);
+
+  VISKORES_CONT void GatherAABBs(BVHData& bvh,
+                                 viskores::cont::ArrayHandle<viskores::Id>& iterator,
+                                 bool singleAABB);
 
-  VISKORES_CONT void BuildHierarchy(BVHData& bvh);
+  VISKORES_CONT void PropagateBounds(LinearBVH& linearBVH);
 
   VISKORES_CONT void Build(LinearBVH& linearBVH);
+
+  VISKORES_CONT void Refit(LinearBVH& linearBVH, AABBs& aabbs);
 }; // class LinearBVHBuilder
 
 class LinearBVHBuilder::CountingIterator : public viskores::worklet::WorkletMapField
@@ -474,10 +485,94 @@ public:
   }
 }; // class TreeBuilder
 
-VISKORES_CONT void LinearBVHBuilder::SortAABBS(BVHData& bvh, bool singleAABB)
+namespace
+{
+
+void PermuteAABBs(const viskores::cont::ArrayHandle<viskores::Id>& ids, AABBs& aabbs)
+{
+  viskores::worklet::DispatcherMapField<LinearBVHBuilder::GatherFloat32> gatherDispatcher;
+  auto gather = [&](viskores::cont::ArrayHandle<viskores::Float32>& values)
+  {
+    viskores::cont::ArrayHandle<viskores::Float32> gathered;
+    gathered.Allocate(ids.GetNumberOfValues());
+    gatherDispatcher.Invoke(ids, values, gathered);
+    values = gathered;
+  };
+  gather(aabbs.xmins);
+  gather(aabbs.ymins);
+  gather(aabbs.zmins);
+  gather(aabbs.xmaxs);
+  gather(aabbs.ymaxs);
+  gather(aabbs.zmaxs);
+}
+
+void ComputeExtent(AABBs& aabbs, viskores::Vec3f_32& minExtent, viskores::Vec3f_32& maxExtent)
+{
+  minExtent =
+    viskores::Vec3f_32(viskores::Infinity32(), viskores::Infinity32(), viskores::Infinity32());
+  maxExtent = viskores::Vec3f_32(
+    viskores::NegativeInfinity32(), viskores::NegativeInfinity32(), viskores::NegativeInfinity32());
+  maxExtent[0] = viskores::cont::Algorithm::Reduce(aabbs.xmaxs, maxExtent[0], MaxValue());
+  maxExtent[1] = viskores::cont::Algorithm::Reduce(aabbs.ymaxs, maxExtent[1], MaxValue());
+  maxExtent[2] = viskores::cont::Algorithm::Reduce(aabbs.zmaxs, maxExtent[2], MaxValue());
+  minExtent[0] = viskores::cont::Algorithm::Reduce(aabbs.xmins, minExtent[0], MinValue());
+  minExtent[1] = viskores::cont::Algorithm::Reduce(aabbs.ymins, minExtent[1], MinValue());
+  minExtent[2] = viskores::cont::Algorithm::Reduce(aabbs.zmins, minExtent[2], MinValue());
+}
+
+void SetTotalBounds(LinearBVH& linearBVH,
+                    const viskores::Vec3f_32& minExtent,
+                    const viskores::Vec3f_32& maxExtent)
+{
+  linearBVH.TotalBounds.X.Min = minExtent[0];
+  linearBVH.TotalBounds.X.Max = maxExtent[0];
+  linearBVH.TotalBounds.Y.Min = minExtent[1];
+  linearBVH.TotalBounds.Y.Max = maxExtent[1];
+  linearBVH.TotalBounds.Z.Min = minExtent[2];
+  linearBVH.TotalBounds.Z.Max = maxExtent[2];
+}
+
+// Axis aligned box used while splitting on the host.
+struct SAHBox
+{
+  viskores::Vec3f_32 Min{ viskores::Infinity32() };
+  viskores::Vec3f_32 Max{ viskores::NegativeInfinity32() };
+
+  void Include(const viskores::Vec3f_32& point)
+  {
+    for (viskores::IdComponent i = 0; i < 3; ++i)
+    {
+      this->Min[i] = viskores::Min(this->Min[i], point[i]);
+      this->Max[i] = viskores::Max(this->Max[i], point[i]);
+    }
+  }
+
+  void Include(const SAHBox& other)
+  {
+    this->Include(other.Min);
+    this->Include(other.Max);
+  }
+
+  viskores::Float32 SurfaceArea() const
+  {
+    if (this->Min[0] > this->Max[0])
+      return 0.f;
+    viskores::Vec3f_32 d = this->Max - this->Min;
+    return 2.f * (d[0] * d[1] + d[1] * d[2] + d[2] * d[0]);
+  }
+};
+
+// The traversal stack holds 64 entries, so subtrees switch to median splits before
+// the tree can get deeper than this.
+constexpr viskores::Int32 SAHMaxDepth = 56;
+constexpr viskores::Int32 SAHNumberOfBins = 16;
+
+} // anonymous namespace
+
+VISKORES_CONT void LinearBVHBuilder::SortAABBS(BVHData& bvh,
+                                               viskores::cont::ArrayHandle<viskores::Id>& iterator)
 {
   //create array of indexes to be sorted with morton codes
-  viskores::cont::ArrayHandle<viskores::Id> iterator;
   iterator.Allocate(bvh.GetNumberOfPrimitives());
 
   viskores::worklet::DispatcherMapField<CountingIterator> iterDispatcher;
@@ -486,50 +581,187 @@ VISKORES_CONT void LinearBVHBuilder::SortAABBS(BVHData& bvh, bool singleAABB)
   //sort the morton codes
 
   viskores::cont::Algorithm::SortByKey(bvh.mortonCodes, iterator);
+} // method SortAABB
+
+VISKORES_CONT void LinearBVHBuilder::SplitSAH(BVHData& bvh,
+                                              viskores::cont::ArrayHandle<viskores::Id>& iterator)
+{
+  const viskores::Id numPrimitives = bvh.GetNumberOfPrimitives();
+  const viskores::Id innerCount = bvh.GetNumberOfInnerNodes();
 
+  std::vector<SAHBox> boxes(static_cast<std::size_t>(numPrimitives));
+  std::vector<viskores::Vec3f_32> centroids(boxes.size());
+  {
+    auto xmins = bvh.AABB.xmins.ReadPortal();
+    auto ymins = bvh.AABB.ymins.ReadPortal();
+    auto zmins = bvh.AABB.zmins.ReadPortal();
+    auto xmaxs = bvh.AABB.xmaxs.ReadPortal();
+    auto ymaxs = bvh.AABB.ymaxs.ReadPortal();
+    auto zmaxs = bvh.AABB.zmaxs.ReadPortal();
+    for (viskores::Id i = 0; i < numPrimitives; ++i)
+    {
+      auto& box = boxes[static_cast<std::size_t>(i)];
+      box.Min = viskores::Vec3f_32(xmins.Get(i), ymins.Get(i), zmins.Get(i));
+      box.Max = viskores::Vec3f_32(xmaxs.Get(i), ymaxs.Get(i), zmaxs.Get(i));
+      centroids[static_cast<std::size_t>(i)] = (box.Min + box.Max) * 0.5f;
+    }
+  }
+
+  std::vector<viskores::Id> order(boxes.size());
+  for (std::size_t i = 0; i < order.size(); ++i)
+    order[i] = static_cast<viskores::Id>(i);
+
+  auto parents = bvh.parent.WritePortal();
+  auto leftChildren = bvh.leftChild.WritePortal();
+  auto rightChildren = bvh.rightChild.WritePortal();
+  parents.Set(0, 0);
+
+  // Finds where to split order[begin, end). Returns the first index of the right half.
+  auto split = [&](std::size_t begin, std::size_t end, viskores::Int32 depth) -> std::size_t
+  {
+    const std::size_t count = end - begin;
+    SAHBox centroidBox;
+    for (std::size_t i = begin; i < end; ++i)
+      centroidBox.Include(centroids[static_cast<std::size_t>(order[i])]);
+    const viskores::Vec3f_32 extent = centroidBox.Max - centroidBox.Min;
+    viskores::IdComponent axis = 0;
+    if (extent[1] > extent[axis])
+      axis = 1;
+    if (extent[2] > extent[axis])
+      axis = 2;
+    if (!(extent[axis] > 0.f))
+      return begin + count / 2;
+
+    auto binOf = [&](viskores::Id prim, viskores::IdComponent a)
+    {
+      const auto c = centroids[static_cast<std::size_t>(prim)][a];
+      auto bin =
+        static_cast<viskores::Int32>(SAHNumberOfBins * (c - centroidBox.Min[a]) / extent[a]);
+      return viskores::Min(bin, SAHNumberOfBins - 1);
+    };
+
+    viskores::Int32 treeDepth = 0;
+    for (std::size_t n = 1; n < count; n *= 2)
+      ++treeDepth;
+    if (depth + treeDepth < SAHMaxDepth)
+    {
+      viskores::Float32 bestCost = viskores::Infinity32();
+      viskores::IdComponent bestAxis = -1;
+      viskores::Int32 bestBin = 0;
+      for (viskores::IdComponent a = 0; a < 3; ++a)
+      {
+        if (!(extent[a] > 0.f))
+          continue;
+        SAHBox bins[SAHNumberOfBins];
+        viskores::Id counts[SAHNumberOfBins] = {};
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          const auto bin = binOf(order[i], a);
+          bins[bin].Include(boxes[static_cast<std::size_t>(order[i])]);
+          ++counts[bin];
+        }
+
+        // Cost of splitting after bin k: area(left) * count(left) + area(right) * count(right)
+        viskores::Float32 leftCosts[SAHNumberOfBins];
+        SAHBox left;
+        viskores::Id leftCount = 0;
+        for (viskores::Int32 k = 0; k < SAHNumberOfBins - 1; ++k)
+        {
+          left.Include(bins[k]);
+          leftCount += counts[k];
+          leftCosts[k] = left.SurfaceArea() * static_cast<viskores::Float32>(leftCount);
+        }
+        SAHBox right;
+        viskores::Id rightCount = 0;
+        for (viskores::Int32 k = SAHNumberOfBins - 2; k >= 0; --k)
+        {
+          right.Include(bins[k + 1]);
+          rightCount += counts[k + 1];
+          if (rightCount == 0 || rightCount == static_cast<viskores::Id>(count))
+            continue;
+          const viskores::Float32 cost =
+            leftCosts[k] + right.SurfaceArea() * static_cast<viskores::Float32>(rightCount);
+          if (cost < bestCost)
+          {
+            bestCost = cost;
+            bestAxis = a;
+            bestBin = k;
+          }
+        }
+      }
+
+      if (bestAxis >= 0)
+      {
+        auto inLeft = [&](viskores::Id prim) { return binOf(prim, bestAxis) <= bestBin; };
+        auto mid = std::partition(order.begin() + static_cast<std::ptrdiff_t>(begin),
+                                  order.begin() + static_cast<std::ptrdiff_t>(end),
+                                  inLeft);
+        return static_cast<std::size_t>(mid - order.begin());
+      }
+    }
+
+    // Too deep or no useful split: split at the object median of the longest axis.
+    const std::size_t mid = begin + count / 2;
+    std::nth_element(order.begin() + static_cast<std::ptrdiff_t>(begin),
+                     order.begin() + static_cast<std::ptrdiff_t>(mid),
+                     order.begin() + static_cast<std::ptrdiff_t>(end),
+                     [&](viskores::Id a, viskores::Id b)
+                     {
+                       return centroids[static_cast<std::size_t>(a)][axis] <
+                         centroids[static_cast<std::size_t>(b)][axis];
+                     });
+    return mid;
+  };
+
+  // Inner nodes are numbered in the order they are created with the root at 0. The leaf
+  // at sorted position i is node innerCount + i, as in the Morton builder.
+  struct Task
+  {
+    std::size_t Begin;
+    std::size_t End;
+    viskores::Id Node;
+    viskores::Int32 Depth;
+  };
+  std::vector<Task> todo;
+  todo.push_back({ 0, order.size(), 0, 0 });
+  viskores::Id nextInner = 1;
+  while (!todo.empty())
+  {
+    const Task task = todo.back();
+    todo.pop_back();
+    const std::size_t mid = split(task.Begin, task.End, task.Depth);
+
+    viskores::Id children[2];
+    const std::size_t ranges[3] = { task.Begin, mid, task.End };
+    for (int side = 0; side < 2; ++side)
+    {
+      const std::size_t begin = ranges[side];
+      const std::size_t end = ranges[side + 1];
+      if (end - begin == 1)
+      {
+        children[side] = innerCount + static_cast<viskores::Id>(begin);
+      }
+      else
+      {
+        children[side] = nextInner++;
+        todo.push_back({ begin, end, children[side], task.Depth + 1 });
+      }
+      parents.Set(children[side], task.Node);
+    }
+    leftChildren.Set(task.Node, children[0]);
+    rightChildren.Set(task.Node, children[1]);
+  }
+
+  iterator = viskores::cont::make_ArrayHandleMove(std::move(order));
+} // method SplitSAH
+
+VISKORES_CONT void LinearBVHBuilder::GatherAABBs(
+  BVHData& bvh,
+  viskores::cont::ArrayHandle<viskores::Id>& iterator,
+  bool singleAABB)
+{
   viskores::Id arraySize = bvh.GetNumberOfPrimitives();
-  viskores::cont::ArrayHandle<viskores::Float32> temp1;
-  viskores::cont::ArrayHandle<viskores::Float32> temp2;
-  temp1.Allocate(arraySize);
-
-  viskores::worklet::DispatcherMapField<GatherFloat32> gatherDispatcher;
-
-  //xmins
-  gatherDispatcher.Invoke(iterator, bvh.AABB.xmins, temp1);
-
-  temp2 = bvh.AABB.xmins;
-  bvh.AABB.xmins = temp1;
-  temp1 = temp2;
-  //ymins
-  gatherDispatcher.Invoke(iterator, bvh.AABB.ymins, temp1);
-
-  temp2 = bvh.AABB.ymins;
-  bvh.AABB.ymins = temp1;
-  temp1 = temp2;
-  //zmins
-  gatherDispatcher.Invoke(iterator, bvh.AABB.zmins, temp1);
-
-  temp2 = bvh.AABB.zmins;
-  bvh.AABB.zmins = temp1;
-  temp1 = temp2;
-  //xmaxs
-  gatherDispatcher.Invoke(iterator, bvh.AABB.xmaxs, temp1);
-
-  temp2 = bvh.AABB.xmaxs;
-  bvh.AABB.xmaxs = temp1;
-  temp1 = temp2;
-  //ymaxs
-  gatherDispatcher.Invoke(iterator, bvh.AABB.ymaxs, temp1);
-
-  temp2 = bvh.AABB.ymaxs;
-  bvh.AABB.ymaxs = temp1;
-  temp1 = temp2;
-  //zmaxs
-  gatherDispatcher.Invoke(iterator, bvh.AABB.zmaxs, temp1);
-
-  temp2 = bvh.AABB.zmaxs;
-  bvh.AABB.zmaxs = temp1;
-  temp1 = temp2;
+  PermuteAABBs(iterator, bvh.AABB);
 
   // Create the leaf references
   bvh.leafs.Allocate(arraySize * 2);
@@ -547,8 +779,32 @@ VISKORES_CONT void LinearBVHBuilder::SortAABBS(BVHData& bvh, bool singleAABB)
 
   viskores::worklet::DispatcherMapField<CreateLeafs> leafDispatcher;
   leafDispatcher.Invoke(iterator, bvh.leafs);
+} // method GatherAABBs
 
-} // method SortAABB
+VISKORES_CONT void LinearBVHBuilder::PropagateBounds(LinearBVH& linearBVH)
+{
+  const viskores::Int32 primitiveCount = viskores::Int32(linearBVH.LeafCount);
+
+  viskores::cont::ArrayHandle<viskores::Int32> counters;
+  viskores::cont::ArrayHandleConstant<viskores::Int32> zero(0, linearBVH.LeafCount - 1);
+  viskores::cont::Algorithm::Copy(zero, counters);
+
+  viskores::worklet::DispatcherMapField<PropagateAABBs> propDispatch(
+    PropagateAABBs{ primitiveCount });
+
+  propDispatch.Invoke(linearBVH.AABB.xmins,
+                      linearBVH.AABB.ymins,
+                      linearBVH.AABB.zmins,
+                      linearBVH.AABB.xmaxs,
+                      linearBVH.AABB.ymaxs,
+                      linearBVH.AABB.zmaxs,
+                      viskores::cont::ArrayHandleCounting<viskores::Id>(0, 2, linearBVH.LeafCount),
+                      linearBVH.Parents,
+                      linearBVH.LeftChildren,
+                      linearBVH.RightChildren,
+                      counters,
+                      linearBVH.FlatBVH);
+}
 
 VISKORES_CONT void LinearBVHBuilder::Build(LinearBVH& linearBVH)
 {
@@ -559,6 +815,7 @@ VISKORES_CONT void LinearBVHBuilder::Build(LinearBVH& linearBVH)
   //
   bool singleAABB = false;
   viskores::Id numberOfAABBs = linearBVH.GetNumberOfAABBs();
+  linearBVH.NumberOfPrimitives = numberOfAABBs;
   if (numberOfAABBs == 1)
   {
     numberOfAABBs = 2;
@@ -593,86 +850,95 @@ VISKORES_CONT void LinearBVHBuilder::Build(LinearBVH& linearBVH)
 
 
   // Find the extent of all bounding boxes to generate normalization for morton codes
-  viskores::Vec3f_32 minExtent(
-    viskores::Infinity32(), viskores::Infinity32(), viskores::Infinity32());
-  viskores::Vec3f_32 maxExtent(
-    viskores::NegativeInfinity32(), viskores::NegativeInfinity32(), viskores::NegativeInfinity32());
-  maxExtent[0] = viskores::cont::Algorithm::Reduce(bvh.AABB.xmaxs, maxExtent[0], MaxValue());
-  maxExtent[1] = viskores::cont::Algorithm::Reduce(bvh.AABB.ymaxs, maxExtent[1], MaxValue());
-  maxExtent[2] = viskores::cont::Algorithm::Reduce(bvh.AABB.zmaxs, maxExtent[2], MaxValue());
-  minExtent[0] = viskores::cont::Algorithm::Reduce(bvh.AABB.xmins, minExtent[0], MinValue());
-  minExtent[1] = viskores::cont::Algorithm::Reduce(bvh.AABB.ymins, minExtent[1], MinValue());
-  minExtent[2] = viskores::cont::Algorithm::Reduce(bvh.AABB.zmins, minExtent[2], MinValue());
+  viskores::Vec3f_32 minExtent;
+  viskores::Vec3f_32 maxExtent;
+  ComputeExtent(bvh.AABB, minExtent, maxExtent);
+  SetTotalBounds(linearBVH, minExtent, maxExtent);
 
-  linearBVH.TotalBounds.X.Min = minExtent[0];
-  linearBVH.TotalBounds.X.Max = maxExtent[0];
-  linearBVH.TotalBounds.Y.Min = minExtent[1];
-  linearBVH.TotalBounds.Y.Max = maxExtent[1];
-  linearBVH.TotalBounds.Z.Min = minExtent[2];
-  linearBVH.TotalBounds.Z.Max = maxExtent[2];
+  linearBVH.Allocate(bvh.GetNumberOfPrimitives());
 
-  viskores::Vec3f_32 deltaExtent = maxExtent - minExtent;
-  viskores::Vec3f_32 inverseExtent;
-  for (int i = 0; i < 3; ++i)
+  viskores::cont::ArrayHandle<viskores::Id> iterator;
+  if (linearBVH.Builder == BVHBuilderType::SAH)
   {
-    inverseExtent[i] = (deltaExtent[i] == 0.f) ? 0 : 1.f / deltaExtent[i];
+    SplitSAH(bvh, iterator);
+    GatherAABBs(bvh, iterator, singleAABB);
   }
+  else
+  {
+    viskores::Vec3f_32 deltaExtent = maxExtent - minExtent;
+    viskores::Vec3f_32 inverseExtent;
+    for (int i = 0; i < 3; ++i)
+    {
+      inverseExtent[i] = (deltaExtent[i] == 0.f) ? 0 : 1.f / deltaExtent[i];
+    }
 
-  //Generate the morton codes
-  viskores::worklet::DispatcherMapField<MortonCodeAABB> mortonDispatch(
-    MortonCodeAABB(inverseExtent, minExtent));
-  mortonDispatch.Invoke(bvh.AABB.xmins,
-                        bvh.AABB.ymins,
-                        bvh.AABB.zmins,
-                        bvh.AABB.xmaxs,
-                        bvh.AABB.ymaxs,
-                        bvh.AABB.zmaxs,
-                        bvh.mortonCodes);
-  linearBVH.Allocate(bvh.GetNumberOfPrimitives());
-
-  SortAABBS(bvh, singleAABB);
-
-  viskores::worklet::DispatcherMapField<TreeBuilder> treeDispatch(
-    TreeBuilder(bvh.GetNumberOfPrimitives()));
-  treeDispatch.Invoke(bvh.leftChild, bvh.rightChild, bvh.mortonCodes, bvh.parent);
-
-  const viskores::Int32 primitiveCount = viskores::Int32(bvh.GetNumberOfPrimitives());
+    //Generate the morton codes
+    viskores::worklet::DispatcherMapField<MortonCodeAABB> mortonDispatch(
+      MortonCodeAABB(inverseExtent, minExtent));
+    mortonDispatch.Invoke(bvh.AABB.xmins,
+                          bvh.AABB.ymins,
+                          bvh.AABB.zmins,
+                          bvh.AABB.xmaxs,
+                          bvh.AABB.ymaxs,
+                          bvh.AABB.zmaxs,
+                          bvh.mortonCodes);
+
+    SortAABBS(bvh, iterator);
+    GatherAABBs(bvh, iterator, singleAABB);
+
+    viskores::worklet::DispatcherMapField<TreeBuilder> treeDispatch(
+      TreeBuilder(bvh.GetNumberOfPrimitives()));
+    treeDispatch.Invoke(bvh.leftChild, bvh.rightChild, bvh.mortonCodes, bvh.parent);
+  }
 
-  viskores::cont::ArrayHandle<viskores::Int32> counters;
-  counters.Allocate(bvh.GetNumberOfPrimitives() - 1);
+  linearBVH.Parents = bvh.parent;
+  linearBVH.LeftChildren = bvh.leftChild;
+  linearBVH.RightChildren = bvh.rightChild;
+  linearBVH.PrimitiveIds = iterator;
+  PropagateBounds(linearBVH);
 
-  viskores::cont::ArrayHandleConstant<viskores::Int32> zero(0, bvh.GetNumberOfPrimitives() - 1);
-  viskores::cont::Algorithm::Copy(zero, counters);
+  linearBVH.Leafs = bvh.leafs;
+}
 
-  viskores::worklet::DispatcherMapField<PropagateAABBs> propDispatch(
-    PropagateAABBs{ primitiveCount });
+VISKORES_CONT void LinearBVHBuilder::Refit(LinearBVH& linearBVH, AABBs& aabbs)
+{
+  // Put the new boxes in leaf order. Build stores a single box twice, so both of its
+  // leaves take the one new box.
+  viskores::cont::ArrayHandle<viskores::Id> leafOrder;
+  if (linearBVH.NumberOfPrimitives == 1)
+  {
+    leafOrder.AllocateAndFill(2, 0);
+  }
+  else
+  {
+    leafOrder = linearBVH.PrimitiveIds;
+  }
+  AABBs sorted = aabbs;
+  PermuteAABBs(leafOrder, sorted);
 
-  propDispatch.Invoke(bvh.AABB.xmins,
-                      bvh.AABB.ymins,
-                      bvh.AABB.zmins,
-                      bvh.AABB.xmaxs,
-                      bvh.AABB.ymaxs,
-                      bvh.AABB.zmaxs,
-                      bvh.leafOffsets,
-                      bvh.parent,
-                      bvh.leftChild,
-                      bvh.rightChild,
-                      counters,
-                      linearBVH.FlatBVH);
+  viskores::Vec3f_32 minExtent;
+  viskores::Vec3f_32 maxExtent;
+  ComputeExtent(sorted, minExtent, maxExtent);
+  SetTotalBounds(linearBVH, minExtent, maxExtent);
 
-  linearBVH.Leafs = bvh.leafs;
+  linearBVH.AABB = sorted;
+  PropagateBounds(linearBVH);
 }
 } //namespace detail
 
 LinearBVH::LinearBVH()
   : IsConstructed(false)
-  , CanConstruct(false){};
+  , CanConstruct(false)
+  , Builder(BVHBuilderType::Morton)
+  , NumberOfPrimitives(0){};
 
 VISKORES_CONT
 LinearBVH::LinearBVH(AABBs& aabbs)
   : AABB(aabbs)
   , IsConstructed(false)
   , CanConstruct(true)
+  , Builder(BVHBuilderType::Morton)
+  , NumberOfPrimitives(0)
 {
 }
 
@@ -681,9 +947,16 @@ LinearBVH::LinearBVH(const LinearBVH& other)
   : AABB(other.AABB)
   , FlatBVH(other.FlatBVH)
   , Leafs(other.Leafs)
+  , TotalBounds(other.TotalBounds)
   , LeafCount(other.LeafCount)
   , IsConstructed(other.IsConstructed)
   , CanConstruct(other.CanConstruct)
+  , Builder(other.Builder)
+  , Parents(other.Parents)
+  , LeftChildren(other.LeftChildren)
+  , RightChildren(other.RightChildren)
+  , PrimitiveIds(other.PrimitiveIds)
+  , NumberOfPrimitives(other.NumberOfPrimitives)
 {
 }
 
@@ -703,6 +976,7 @@ void LinearBVH::Construct()
 
   detail::LinearBVHBuilder builder;
   builder.Build(*this);
+  IsConstructed = true;
 }
 
 VISKORES_CONT
@@ -713,6 +987,33 @@ void LinearBVH::SetData(AABBs& aabbs)
   CanConstruct = true;
 }
 
+VISKORES_CONT
+void LinearBVH::SetBuilder(BVHBuilderType builder)
+{
+  if (builder != Builder)
+    IsConstructed = false;
+  Builder = builder;
+}
+
+VISKORES_CONT
+BVHBuilderType LinearBVH::GetBuilder() const
+{
+  return Builder;
+}
+
+VISKORES_CONT
+void LinearBVH::Refit(AABBs& aabbs)
+{
+  if (!IsConstructed)
+    throw viskores::cont::ErrorBadValue("Linear BVH: construct must be called before refit!");
+  if (aabbs.xmins.GetNumberOfValues() != NumberOfPrimitives)
+    throw viskores::cont::ErrorBadValue(
+      "Linear BVH: refit requires the same number of primitives as the last construct!");
+
+  detail::LinearBVHBuilder builder;
+  builder.Refit(*this, aabbs);
+}
+
 // explicitly export
 //template VISKORES_RENDERING_RAYTRACING_EXPORT void LinearBVH::ConstructOnDevice<
 //  viskores::cont::DeviceAdapterTagSerial>(viskores::cont::DeviceAdapterTagSerial);
@@ -30,6 +30,22 @@ struct AABBs
   viskores::cont::ArrayHandle<viskores::Float32> zmaxs;
 };
 
+/// How `LinearBVH::Construct()` organizes the hierarchy.
+enum struct BVHBuilderType
+{
+  /// Sorts the primitives along a Morton curve and builds the tree in parallel.
+  /// Fast to build, which suits data that changes every frame.
+  Morton,
+  /// Splits the primitives top-down with a binned surface area heuristic. Slower to
+  /// build, but the tree is faster to traverse when it is reused for many rays.
+  SAH
+};
+
+namespace detail
+{
+class LinearBVHBuilder;
+}
+
 //
 // This is the data structure that is passed to the ray tracer.
 //
@@ -47,6 +63,14 @@ public:
 protected:
   bool IsConstructed;
   bool CanConstruct;
+  BVHBuilderType Builder;
+  // Tree topology, kept so that Refit() can update the node bounds in place.
+  // Leaf i of the tree holds primitive PrimitiveIds[i].
+  viskores::cont::ArrayHandle<viskores::Id> Parents;
+  viskores::cont::ArrayHandle<viskores::Id> LeftChildren;
+  viskores::cont::ArrayHandle<viskores::Id> RightChildren;
+  viskores::cont::ArrayHandle<viskores::Id> PrimitiveIds;
+  viskores::Id NumberOfPrimitives;
 
 public:
   LinearBVH();
@@ -65,6 +89,20 @@ public:
   VISKORES_CONT
   void SetData(AABBs& aabbs);
 
+  /// Selects the algorithm used by `Construct()`. The default is `BVHBuilderType::Morton`.
+  VISKORES_CONT
+  void SetBuilder(BVHBuilderType builder);
+
+  VISKORES_CONT
+  BVHBuilderType GetBuilder() const;
+
+  /// Updates the bounds of every node for primitives that moved without changing
+  /// their number or order, keeping the tree structure of the last `Construct()`.
+  /// This is much cheaper than a rebuild, but the tree degrades if the primitives
+  /// move far from where they were when it was built.
+  VISKORES_CONT
+  void Refit(AABBs& aabbs);
+
   VISKORES_CONT
   AABBs& GetAABBs();
 
@@ -72,6 +110,8 @@ public:
   bool GetIsConstructed() const;
 
   viskores::Id GetNumberOfAABBs() const;
+
+  friend class detail::LinearBVHBuilder;
 }; // class LinearBVH
 }
 }
@@ -236,6 +236,8 @@ public:
   viskores::Int32 Minx;
   viskores::Int32 Miny;
   viskores::Int32 SubsetWidth;
+  viskores::Int32 Stride;
+  viskores::Vec2i_32 ViewportMin;
   viskores::Vec3f_32 PixelDelta;
   viskores::Vec3f_32 StartOffset;
 
@@ -246,6 +248,7 @@ public:
     , Minx(camera.GetSubsetMinX())
     , Miny(camera.GetSubsetMinY())
     , SubsetWidth(camera.GetSubsetWidth())
+    , Stride(camera.GetSubsetStride())
   {
     auto& camera2d = camera.GetCamera2D();
     viskores::Float32 left = camera2d.Left;
@@ -257,6 +260,12 @@ public:
     camera.GetViewport(vl, vr, vb, vt);
     viskores::Float32 _w = static_cast<viskores::Float32>(this->w) * (vr - vl) / 2.f;
     viskores::Float32 _h = static_cast<viskores::Float32>(this->h) * (vt - vb) / 2.f;
+    // the pixel the viewport starts at, which the pixel selection may have moved
+    // the subset away from
+    ViewportMin[0] = static_cast<viskores::Int32>(static_cast<viskores::Float32>(this->w) *
+                                                  (1.f + vl) / 2.f);
+    ViewportMin[1] = static_cast<viskores::Int32>(static_cast<viskores::Float32>(this->h) *
+                                                  (1.f + vb) / 2.f);
     viskores::Vec2f_32 minPoint(left, bottom);
     viskores::Vec2f_32 maxPoint(right, top);
 
@@ -302,18 +311,18 @@ public:
     // not where the rays might intersect data like
     // the perspective ray gen
     //
-    int i = viskores::Int32(idx) % SubsetWidth;
-    int j = viskores::Int32(idx) / SubsetWidth;
+    int i = (viskores::Int32(idx) % SubsetWidth) * Stride + Minx;
+    int j = (viskores::Int32(idx) / SubsetWidth) * Stride + Miny;
 
-    viskores::Vec3f_32 pos{ viskores::Float32(i), viskores::Float32(j), 0.f };
+    viskores::Vec3f_32 pos{ viskores::Float32(i - ViewportMin[0]),
+                            viskores::Float32(j - ViewportMin[1]),
+                            0.f };
 
     viskores::Vec3f_32 origin = StartOffset + pos * PixelDelta;
     rayOriginX = origin[0];
     rayOriginY = origin[1];
     rayOriginZ = origin[2];
 
-    i += Minx;
-    j += Miny;
     pixelIndex = static_cast<viskores::Id>(j * w + i);
   }
 
@@ -333,6 +342,7 @@ public:
   viskores::Int32 Minx;
   viskores::Int32 Miny;
   viskores::Int32 SubsetWidth;
+  viskores::Int32 Stride;
   viskores::Vec3f_32 nlook; // normalized look
   viskores::Vec3f_32 delta_x;
   viskores::Vec3f_32 delta_y;
@@ -352,7 +362,8 @@ public:
                     viskores::Float32 viewportTop,
                     viskores::Int32 subsetWidth,
                     viskores::Int32 minx,
-                    viskores::Int32 miny)
+                    viskores::Int32 miny,
+                    viskores::Int32 stride)
     : w(width)
     , h(height)
     , panX(panx)
@@ -364,6 +375,7 @@ public:
     , Minx(minx)
     , Miny(miny)
     , SubsetWidth(subsetWidth)
+    , Stride(stride)
   {
     viskores::Float32 thy = tanf((fovY * viskores::Pi_180f()) * .5f);
     viskores::Float32 thx = (aspect > 0.f) ? thy * aspect : (thy * width) / height;
@@ -403,8 +415,8 @@ public:
                                 Precision& rayDirZ,
                                 viskores::Id& pixelIndex) const
   {
-    auto i = viskores::Int32(idx) % SubsetWidth;
-    auto j = viskores::Int32(idx) / SubsetWidth;
+    auto i = (viskores::Int32(idx) % SubsetWidth) * Stride;
+    auto j = (viskores::Int32(idx) / SubsetWidth) * Stride;
     i += Minx;
     j += Miny;
     // Write out the global pixelId
@@ -582,6 +594,21 @@ VISKORES_CONT viskores::Int32 Camera::GetSubsetMinY() const
   return this->SubsetMinY;
 }
 
+VISKORES_CONT
+void Camera::SetPixelSelection(const PixelSelection& selection)
+{
+  if (selection.Stride < 1)
+  {
+    throw viskores::cont::ErrorBadValue("Pixel selection stride must be at least one.");
+  }
+  if (selection.Offset[0] < 0 || selection.Offset[0] >= selection.Stride ||
+      selection.Offset[1] < 0 || selection.Offset[1] >= selection.Stride)
+  {
+    throw viskores::cont::ErrorBadValue("Pixel selection offset must be less than the stride.");
+  }
+  this->Selection = selection;
+}
+
 VISKORES_CONT
 void Camera::SetZoom(const viskores::Float32& zoom)
 {
@@ -822,7 +849,8 @@ VISKORES_CONT void Camera::CreateRaysImpl(Ray<Precision>& rays, const viskores::
                               vt,
                               this->SubsetWidth,
                               this->SubsetMinX,
-                              this->SubsetMinY },
+                              this->SubsetMinY,
+                              this->SubsetStride },
            rays.DirX,
            rays.DirY,
            rays.DirZ,
@@ -941,6 +969,31 @@ void Camera::FindSubset(const viskores::Bounds& bounds)
   logger->AddLogData("subset_height", dy);
 }
 
+VISKORES_CONT
+void Camera::ApplyPixelSelection()
+{
+  // Clip the subset to the selected rectangle and snap it to the selected pixels, after
+  // which SubsetWidth and SubsetHeight count rays rather than pixels.
+  const viskores::Int32 stride = this->Selection.Stride;
+  viskores::Vec2i_32 first(this->SubsetMinX, this->SubsetMinY);
+  viskores::Vec2i_32 end(this->SubsetMinX + this->SubsetWidth,
+                         this->SubsetMinY + this->SubsetHeight);
+  viskores::Vec2i_32 count;
+  for (viskores::IdComponent d = 0; d < 2; ++d)
+  {
+    first[d] = viskores::Max(first[d], this->Selection.Min[d]);
+    end[d] = viskores::Min(end[d], this->Selection.Max[d]);
+    first[d] += ((this->Selection.Offset[d] - first[d]) % stride + stride) % stride;
+    count[d] = (end[d] > first[d]) ? (end[d] - first[d] + stride - 1) / stride : 0;
+  }
+
+  this->SubsetMinX = first[0];
+  this->SubsetMinY = first[1];
+  this->SubsetWidth = count[0];
+  this->SubsetHeight = count[1];
+  this->SubsetStride = stride;
+}
+
 template <typename Precision>
 VISKORES_CONT void Camera::UpdateDimensions(Ray<Precision>& rays,
                                             const viskores::Bounds& boundingBox)
@@ -986,6 +1039,8 @@ VISKORES_CONT void Camera::UpdateDimensions(Ray<Precision>& rays,
     this->SubsetMinX = 0;
   }
 
+  this->ApplyPixelSelection();
+
   // resize rays and buffers
   viskores::Id subsetSize =
     static_cast<viskores::Id>(SubsetWidth) * static_cast<viskores::Id>(SubsetHeight);
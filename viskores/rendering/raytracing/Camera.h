@@ -13,6 +13,8 @@
 #include <viskores/cont/CoordinateSystem.h>
 #include <viskores/rendering/raytracing/Ray.h>
 
+#include <limits>
+
 namespace viskores
 {
 namespace rendering
@@ -88,6 +90,21 @@ public:
   viskores::Float32 Zoom;
 };
 
+/// @brief Selects the pixels of an image that rays are cast through.
+///
+/// A pixel (x, y) is selected when it lies in the rectangle from `Min` (inclusive) to
+/// `Max` (exclusive) and `x % Stride == Offset[0]` and `y % Stride == Offset[1]`. The
+/// default selects every pixel. Views use it to render an image in tiles or in
+/// interleaved passes.
+struct PixelSelection
+{
+  viskores::Vec2i_32 Min{ 0, 0 };
+  viskores::Vec2i_32 Max{ std::numeric_limits<viskores::Int32>::max(),
+                          std::numeric_limits<viskores::Int32>::max() };
+  viskores::Int32 Stride = 1;
+  viskores::Vec2i_32 Offset{ 0, 0 };
+};
+
 class VISKORES_RENDERING_RAYTRACING_EXPORT Camera
 {
 private:
@@ -97,6 +114,8 @@ private:
   viskores::Int32 SubsetHeight = 500;
   viskores::Int32 SubsetMinX = 0;
   viskores::Int32 SubsetMinY = 0;
+  viskores::Int32 SubsetStride = 1;
+  PixelSelection Selection;
   bool IsViewDirty = true;
 
   bool IsOrthogonalProjection = false;
@@ -136,6 +155,13 @@ public:
 
   VISKORES_CONT viskores::Int32 GetSubsetMinX() const;
   VISKORES_CONT viskores::Int32 GetSubsetMinY() const;
+  /// Distance in pixels between neighboring rays of the subset.
+  VISKORES_CONT viskores::Int32 GetSubsetStride() const { return this->SubsetStride; }
+
+  /// @brief Restricts `CreateRays()` to the selected pixels.
+  VISKORES_CONT void SetPixelSelection(const PixelSelection& selection);
+  /// @copydoc SetPixelSelection
+  VISKORES_CONT const PixelSelection& GetPixelSelection() const { return this->Selection; }
 
   VISKORES_CONT
   void SetPan(const viskores::Float32& xpan, const viskores::Float32& ypan)
@@ -286,6 +312,9 @@ private:
   VISKORES_CONT
   void FindSubset(const viskores::Bounds& bounds);
 
+  VISKORES_CONT
+  void ApplyPixelSelection();
+
   VISKORES_CONT
   void WriteSettingsToLog();
 
@@ -147,6 +147,19 @@ void RayTracking<FloatType>::Swap()
   ExitDist = tmpPtr;
 }
 
+// Returns whether two coordinate systems hold the same array. The multiplexer adds a
+// buffer of its own, so the buffers of the arrays it holds are compared.
+bool SameCoordinateArray(const viskores::cont::CoordinateSystem& coords1,
+                         const viskores::cont::CoordinateSystem& coords2)
+{
+  auto getBuffers = [](const viskores::cont::CoordinateSystem& coords)
+  {
+    return coords.GetDataAsMultiplexer().GetArrayHandleVariant().CastAndCall(
+      [](const auto& array) { return array.GetBuffers(); });
+  };
+  return getBuffers(coords1) == getBuffers(coords2);
+}
+
 } //namespace detail
 
 void ConnectivityTracer::Init()
@@ -201,13 +214,10 @@ void ConnectivityTracer::SetVolumeData(const viskores::cont::Field& scalarField,
                                        const viskores::cont::CoordinateSystem& coords,
                                        const viskores::cont::Field& ghostField)
 {
-  //TODO: Need a way to tell if we have been updated
+  this->UpdateMesh(cellSet, coords);
   ScalarField = scalarField;
   GhostField = ghostField;
   ScalarBounds = scalarBounds;
-  CellSet = cellSet;
-  Coords = coords;
-  MeshConnIsConstructed = false;
 
   const bool isSupportedField = ScalarField.IsCellField() || ScalarField.IsPointField();
   if (!isSupportedField)
@@ -217,17 +227,6 @@ void ConnectivityTracer::SetVolumeData(const viskores::cont::Field& scalarField,
   FieldAssocPoints = ScalarField.IsPointField();
 
   this->Integrator = Volume;
-
-  if (MeshContainer == nullptr)
-  {
-    delete MeshContainer;
-  }
-  MeshConnectivityBuilder builder;
-  MeshContainer = builder.BuildConnectivity(cellSet, coords);
-
-  Locator.SetCellSet(this->CellSet);
-  Locator.SetCoordinates(this->Coords);
-  Locator.Update();
 }
 
 void ConnectivityTracer::SetEnergyData(const viskores::cont::Field& absorption,
@@ -240,10 +239,8 @@ void ConnectivityTracer::SetEnergyData(const viskores::cont::Field& absorption,
   if (!isSupportedField)
     throw viskores::cont::ErrorBadValue("Absorption Field '" + absorption.GetName() +
                                         "' not associated with cells");
+  this->UpdateMesh(cellSet, coords);
   ScalarField = absorption;
-  CellSet = cellSet;
-  Coords = coords;
-  MeshConnIsConstructed = false;
   // Check for emission
   HasEmission = false;
 
@@ -282,19 +279,43 @@ void ConnectivityTracer::SetEnergyData(const viskores::cont::Field& absorption,
       throw viskores::cont::ErrorBadValue(message.str());
     }
   }
-  //TODO: Need a way to tell if we have been updated
   this->Integrator = Energy;
+}
 
-  if (MeshContainer == nullptr)
+void ConnectivityTracer::UpdateMesh(const viskores::cont::UnknownCellSet& cellSet,
+                                    const viskores::cont::CoordinateSystem& coords)
+{
+  const viskores::Bounds bounds = coords.GetBounds();
+  if (MeshConnIsConstructed && cellSet.GetCellSetBase() == this->CellSet.GetCellSetBase() &&
+      cellSet.GetNumberOfCells() == this->CellSet.GetNumberOfCells() &&
+      coords.GetNumberOfPoints() == this->MeshNumberOfPoints && bounds == this->MeshBounds &&
+      detail::SameCoordinateArray(coords, this->Coords))
   {
-    delete MeshContainer;
+    // Keep the coordinates current in case only their name changed.
+    Coords = coords;
+    return;
   }
 
+  CellSet = cellSet;
+  Coords = coords;
+
+  viskores::cont::Timer timer;
+  timer.Start();
   MeshConnectivityBuilder builder;
-  MeshContainer = builder.BuildConnectivity(cellSet, coords);
+  MeshContainer.reset(builder.BuildConnectivity(cellSet, coords));
   Locator.SetCellSet(this->CellSet);
   Locator.SetCoordinates(this->Coords);
   Locator.Update();
+  MeshNumberOfPoints = coords.GetNumberOfPoints();
+  MeshBounds = bounds;
+  MeshConnIsConstructed = true;
+  Logger::GetInstance()->AddLogData("build_mesh_connectivity", timer.GetElapsedTime());
+}
+
+void ConnectivityTracer::ResetMesh()
+{
+  MeshContainer.reset();
+  MeshConnIsConstructed = false;
 }
 
 void ConnectivityTracer::SetBackgroundColor(const viskores::Vec4f_32& backgroundColor)
@@ -1162,7 +1183,7 @@ void ConnectivityTracer::IntersectCell(Ray<FloatType>& rays,
                         tracker.ExitFace,
                         rays.Status,
                         rays.Origin,
-                        MeshContainer);
+                        MeshContainer.get());
 
   if (this->CountRayStatus)
     RaysLost = RayOperations::GetStatusCount(rays, RAY_LOST);
@@ -1193,7 +1214,7 @@ void ConnectivityTracer::FindLostRays(Ray<FloatType>& rays, detail::RayTracking<
                       rays.Status,
                       rays.Origin,
                       rays.Dir,
-                      MeshContainer,
+                      MeshContainer.get(),
                       &this->Locator);
 
   this->LostRayTime += timer.GetElapsedTime();
@@ -1224,7 +1245,7 @@ void ConnectivityTracer::SampleCells(Ray<FloatType>& rays, detail::RayTracking<F
                       rays.Dir,
                       rays.Status,
                       rays.Origin,
-                      MeshContainer,
+                      MeshContainer.get(),
                       this->ColorMap,
                       rays.Buffers.at(0).Buffer,
                       rays.MaxDistance);
@@ -17,6 +17,7 @@
 #include <viskores/rendering/raytracing/MeshConnectivityContainers.h>
 #include <viskores/rendering/raytracing/PartialComposite.h>
 
+#include <memory>
 
 namespace viskores
 {
@@ -71,27 +72,27 @@ class VISKORES_RENDERING_RAYTRACING_EXPORT ConnectivityTracer
 {
 public:
   ConnectivityTracer()
-    : MeshContainer(nullptr)
+    : MeshNumberOfPoints(0)
     , BumpEpsilon(1e-3)
     , CountRayStatus(false)
+    , MeshConnIsConstructed(false)
     , UnitScalar(1.f)
   {
   }
 
-  ~ConnectivityTracer()
-  {
-    if (MeshContainer != nullptr)
-    {
-      delete MeshContainer;
-    }
-  }
-
   enum IntegrationMode
   {
     Volume,
     Energy
   };
 
+  ///
+  /// Sets the mesh and fields to trace through. The mesh connectivity, its external
+  /// faces, and the cell locator are only built when the cell set or the coordinates
+  /// differ from those of the previous call, so a tracer that is kept across frames
+  /// only pays for them once. The cell set is compared by identity and the
+  /// coordinates by number of points and bounds.
+  ///
   void SetVolumeData(const viskores::cont::Field& scalarField,
                      const viskores::Range& scalarBounds,
                      const viskores::cont::UnknownCellSet& cellSet,
@@ -108,7 +109,14 @@ public:
   void SetSampleDistance(const viskores::Float32& distance);
   void SetColorMap(const viskores::cont::ArrayHandle<viskores::Vec4f_32>& colorMap);
 
-  MeshConnectivityContainer* GetMeshContainer() { return MeshContainer; }
+  MeshConnectivityContainer* GetMeshContainer() { return MeshContainer.get(); }
+
+  ///
+  /// Releases the mesh connectivity so that it is rebuilt by the next call to
+  /// `SetVolumeData()` or `SetEnergyData()`. Call this after changing the cell set or
+  /// the coordinates in place.
+  ///
+  void ResetMesh();
 
   void Init();
 
@@ -156,6 +164,9 @@ public:
   void FindMeshEntry(Ray<FloatType>& rays);
 
 private:
+  void UpdateMesh(const viskores::cont::UnknownCellSet& cellSet,
+                  const viskores::cont::CoordinateSystem& coords);
+
   template <typename FloatType>
   void IntersectCell(Ray<FloatType>& rays, detail::RayTracking<FloatType>& tracker);
 
@@ -194,8 +205,12 @@ protected:
   viskores::Id RaysLost;
   IntegrationMode Integrator;
 
-  MeshConnectivityContainer* MeshContainer;
+  // Shared by copies of the tracer, which trace the same mesh.
+  std::shared_ptr<MeshConnectivityContainer> MeshContainer;
   viskores::cont::CellLocatorGeneral Locator;
+  // What the mesh connectivity was built for.
+  viskores::Id MeshNumberOfPoints;
+  viskores::Bounds MeshBounds;
   viskores::Float64 BumpEpsilon;
   viskores::Float64 BumpDistance;
   //
@@ -643,7 +643,7 @@ void CylinderIntersector::IntersectRaysImp(Ray<Precision>& rays,
   detail::CylinderLeafWrapper leafIntersector(
     this->CylIds, this->Radii, this->CapMasks, this->UseCapMasks);
 
-  BVHTraverser traverser;
+  BVHTraverser traverser(this->RayPacketSize);
   traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
 
   RayOperations::UpdateRayStatus(rays);
@@ -579,7 +579,7 @@ void GlyphIntersector::IntersectRaysImp(Ray<Precision>& rays, bool viskoresNotUs
 {
   detail::GlyphLeafWrapper leafIntersector(this->PointIds, Sizes, this->GlyphType);
 
-  BVHTraverser traverser;
+  BVHTraverser traverser(this->RayPacketSize);
   traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
 
   RayOperations::UpdateRayStatus(rays);
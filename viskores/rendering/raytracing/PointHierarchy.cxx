@@ -0,0 +1,584 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#include <viskores/rendering/raytracing/PointHierarchy.h>
+
+#include <viskores/VectorAnalysis.h>
+#include <viskores/cont/Algorithm.h>
+#include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/ArrayHandleCast.h>
+#include <viskores/cont/ArrayHandleConstant.h>
+#include <viskores/cont/ArrayHandleIndex.h>
+#include <viskores/cont/ArrayHandlePermutation.h>
+#include <viskores/cont/ErrorBadValue.h>
+#include <viskores/cont/Invoker.h>
+#include <viskores/rendering/raytracing/MortonCodes.h>
+#include <viskores/worklet/Keys.h>
+#include <viskores/worklet/WorkletMapField.h>
+#include <viskores/worklet/WorkletReduceByKey.h>
+
+namespace viskores
+{
+namespace rendering
+{
+namespace raytracing
+{
+
+namespace
+{
+
+// Morton codes have 10 bits along each axis, so there are 10 levels of octree cells below
+// the root.
+constexpr viskores::IdComponent OctreeDepth = 10;
+
+class PointMortonCodes : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn points, FieldOut codes);
+  using ExecutionSignature = void(_1, _2);
+
+  VISKORES_CONT PointMortonCodes(const viskores::Vec3f_32& minCoordinate,
+                                 const viskores::Vec3f_32& inverseExtent)
+    : MinCoordinate(minCoordinate)
+    , InverseExtent(inverseExtent)
+  {
+  }
+
+  VISKORES_EXEC void operator()(const viskores::Vec3f_32& point, viskores::UInt32& code) const
+  {
+    viskores::Vec3f_32 normalized = (point - this->MinCoordinate) * this->InverseExtent;
+    code = Morton3D(normalized[0], normalized[1], normalized[2]);
+  }
+
+private:
+  viskores::Vec3f_32 MinCoordinate;
+  viskores::Vec3f_32 InverseExtent;
+};
+
+class ShiftKeys : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn keys, FieldOut shifted);
+  using ExecutionSignature = void(_1, _2);
+
+  VISKORES_CONT explicit ShiftKeys(viskores::UInt32 shift)
+    : Shift(shift)
+  {
+  }
+
+  VISKORES_EXEC void operator()(viskores::UInt32 key, viskores::UInt32& shifted) const
+  {
+    shifted = key >> this->Shift;
+  }
+
+private:
+  viskores::UInt32 Shift;
+};
+
+// Marks the sorted keys that differ from the previous one. The inclusive sum of the marks
+// is the index of each key among the unique keys.
+class MarkNewKeys : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn index, WholeArrayIn keys, FieldOut isNew);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  template <typename KeyPortalType>
+  VISKORES_EXEC void operator()(viskores::Id index,
+                                const KeyPortalType& keys,
+                                viskores::Id& isNew) const
+  {
+    isNew = (index > 0 && keys.Get(index) != keys.Get(index - 1)) ? 1 : 0;
+  }
+};
+
+// Merges the nodes of an octree cell into one representative at their centroid, with a
+// sphere that bounds theirs and their average value.
+class AggregateNodes : public viskores::worklet::WorkletReduceByKey
+{
+public:
+  using ControlSignature = void(KeysIn keys,
+                                ValuesIn centers,
+                                ValuesIn radii,
+                                ValuesIn counts,
+                                ValuesIn values,
+                                ReducedValuesOut center,
+                                ReducedValuesOut radius,
+                                ReducedValuesOut count,
+                                ReducedValuesOut value);
+  using ExecutionSignature = void(_2, _3, _4, _5, _6, _7, _8, _9);
+  using InputDomain = _1;
+
+  template <typename CenterVecType,
+            typename RadiusVecType,
+            typename CountVecType,
+            typename ValueVecType,
+            typename ValueType>
+  VISKORES_EXEC void operator()(const CenterVecType& centers,
+                                const RadiusVecType& radii,
+                                const CountVecType& counts,
+                                const ValueVecType& values,
+                                viskores::Vec3f_32& center,
+                                viskores::Float32& radius,
+                                viskores::Id& count,
+                                ValueType& value) const
+  {
+    const viskores::IdComponent numNodes = centers.GetNumberOfComponents();
+    count = 0;
+    for (viskores::IdComponent i = 0; i < numNodes; ++i)
+    {
+      count += counts[i];
+    }
+
+    center = viskores::Vec3f_32(0.f);
+    value = ValueType(0.f);
+    for (viskores::IdComponent i = 0; i < numNodes; ++i)
+    {
+      const viskores::Float32 weight =
+        static_cast<viskores::Float32>(counts[i]) / static_cast<viskores::Float32>(count);
+      center = center + centers[i] * weight;
+      value = value + static_cast<ValueType>(values[i]) * weight;
+    }
+
+    radius = 0.f;
+    for (viskores::IdComponent i = 0; i < numNodes; ++i)
+    {
+      radius = viskores::Max(radius, viskores::Magnitude(centers[i] - center) + radii[i]);
+    }
+  }
+};
+
+// Chooses the nodes of a level to render. A node is open when it is visible, all of its
+// ancestors are open, and it is too large on screen, in which case its children are
+// considered in the next level instead.
+class SelectNodes : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn centers,
+                                FieldIn radii,
+                                FieldIn parents,
+                                WholeArrayIn parentOpen,
+                                FieldOut open,
+                                FieldOut selected);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6);
+
+  VISKORES_CONT SelectNodes(const viskores::Matrix<viskores::Float32, 4, 4>& worldToClip,
+                            viskores::Id imageHeight,
+                            viskores::Float32 pixelSize,
+                            bool finestLevel)
+    : FinestLevel(finestLevel)
+  {
+    // The side planes of the view frustum, normalized so the plane equation gives the
+    // distance to the plane.
+    const auto row0 = viskores::MatrixGetRow(worldToClip, 0);
+    const auto row1 = viskores::MatrixGetRow(worldToClip, 1);
+    const auto row3 = viskores::MatrixGetRow(worldToClip, 3);
+    const viskores::Vec4f_32 planes[4] = { row3 + row0, row3 - row0, row3 + row1, row3 - row1 };
+    for (viskores::IdComponent i = 0; i < 4; ++i)
+    {
+      const viskores::Float32 length =
+        viskores::Magnitude(viskores::Vec3f_32(planes[i][0], planes[i][1], planes[i][2]));
+      this->Planes[i] = length > 0.f ? planes[i] / length : viskores::Vec4f_32(0.f);
+    }
+    this->Depth = row3;
+    this->DepthScale = viskores::Magnitude(viskores::Vec3f_32(row3[0], row3[1], row3[2]));
+    // A sphere of radius r at clip depth w covers r * PixelScale / w pixels across.
+    this->PixelScale = viskores::Magnitude(viskores::Vec3f_32(row1[0], row1[1], row1[2])) *
+      static_cast<viskores::Float32>(imageHeight);
+    this->PixelSize = pixelSize;
+  }
+
+  template <typename OpenPortalType>
+  VISKORES_EXEC void operator()(const viskores::Vec3f_32& center,
+                                viskores::Float32 radius,
+                                viskores::Id parent,
+                                const OpenPortalType& parentOpen,
+                                viskores::UInt8& open,
+                                viskores::UInt8& selected) const
+  {
+    open = 0;
+    selected = 0;
+    if (!parentOpen.Get(parent))
+    {
+      return;
+    }
+    for (viskores::IdComponent i = 0; i < 4; ++i)
+    {
+      const auto& plane = this->Planes[i];
+      if (plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3] <
+          -radius)
+      {
+        return;
+      }
+    }
+
+    const viskores::Float32 w = this->Depth[0] * center[0] + this->Depth[1] * center[1] +
+      this->Depth[2] * center[2] + this->Depth[3];
+    const bool smallEnough =
+      w > radius * this->DepthScale && radius * this->PixelScale <= this->PixelSize * w;
+    if (smallEnough || this->FinestLevel)
+    {
+      selected = 1;
+    }
+    else
+    {
+      open = 1;
+    }
+  }
+
+private:
+  viskores::Vec4f_32 Planes[4];
+  viskores::Vec4f_32 Depth;
+  viskores::Float32 DepthScale;
+  viskores::Float32 PixelScale;
+  viskores::Float32 PixelSize;
+  bool FinestLevel;
+};
+
+template <typename T>
+struct LevelArrays
+{
+  viskores::cont::ArrayHandle<viskores::Vec3f_32> Centers;
+  viskores::cont::ArrayHandle<viskores::Float32> Radii;
+  viskores::cont::ArrayHandle<T> Values;
+  viskores::cont::ArrayHandle<viskores::Id> Parents;
+};
+
+// Builds the levels above the points, which are given sorted by their Morton codes.
+// Returns the levels from the points up to the root.
+template <typename T>
+std::vector<LevelArrays<T>> BuildLevels(const viskores::cont::ArrayHandle<viskores::UInt32>& codes,
+                                        LevelArrays<T> points)
+{
+  viskores::cont::Invoker invoke;
+  std::vector<LevelArrays<T>> levels;
+  levels.push_back(points);
+
+  viskores::cont::ArrayHandle<viskores::UInt32> childKeys = codes;
+  viskores::cont::ArrayHandle<viskores::Id> childCounts;
+  viskores::cont::ArrayCopy(
+    viskores::cont::make_ArrayHandleConstant<viskores::Id>(1, codes.GetNumberOfValues()),
+    childCounts);
+
+  for (viskores::IdComponent depth = OctreeDepth; depth >= 0; --depth)
+  {
+    // The points are grouped by their full code, and each coarser level by one bit less
+    // along each axis.
+    viskores::cont::ArrayHandle<viskores::UInt32> parentKeys;
+    invoke(ShiftKeys{ depth == OctreeDepth ? 0u : 3u }, childKeys, parentKeys);
+
+    viskores::worklet::Keys<viskores::UInt32> keys(parentKeys);
+    LevelArrays<T> parent;
+    viskores::cont::ArrayHandle<viskores::Id> parentCounts;
+    auto& child = levels.back();
+    invoke(AggregateNodes{},
+           keys,
+           child.Centers,
+           child.Radii,
+           childCounts,
+           child.Values,
+           parent.Centers,
+           parent.Radii,
+           parentCounts,
+           parent.Values);
+
+    viskores::cont::ArrayHandle<viskores::Id> isNew;
+    invoke(MarkNewKeys{},
+           viskores::cont::ArrayHandleIndex(parentKeys.GetNumberOfValues()),
+           parentKeys,
+           isNew);
+    viskores::cont::Algorithm::ScanInclusive(isNew, child.Parents);
+
+    childKeys = keys.GetUniqueKeys();
+    childCounts = parentCounts;
+    levels.push_back(parent);
+  }
+
+  // The root has no parent. It refers to the single open entry that starts a selection.
+  viskores::cont::ArrayCopy(viskores::cont::make_ArrayHandleConstant<viskores::Id>(0, 1),
+                            levels.back().Parents);
+  return levels;
+}
+
+template <typename T>
+void AppendSelected(const viskores::cont::ArrayHandle<viskores::Vec3f_32>& centers,
+                    const viskores::cont::ArrayHandle<viskores::Float32>& radii,
+                    const viskores::cont::ArrayHandle<T>& values,
+                    const viskores::cont::ArrayHandle<viskores::UInt8>& selected,
+                    std::vector<viskores::cont::ArrayHandle<viskores::Vec3f_32>>& outCenters,
+                    std::vector<viskores::cont::ArrayHandle<viskores::Float32>>& outRadii,
+                    std::vector<viskores::cont::UnknownArrayHandle>& outValues)
+{
+  viskores::cont::ArrayHandle<viskores::Vec3f_32> selectedCenters;
+  viskores::cont::ArrayHandle<viskores::Float32> selectedRadii;
+  viskores::cont::ArrayHandle<T> selectedValues;
+  viskores::cont::Algorithm::CopyIf(centers, selected, selectedCenters);
+  viskores::cont::Algorithm::CopyIf(radii, selected, selectedRadii);
+  viskores::cont::Algorithm::CopyIf(values, selected, selectedValues);
+  outCenters.push_back(selectedCenters);
+  outRadii.push_back(selectedRadii);
+  outValues.push_back(selectedValues);
+}
+
+template <typename T>
+viskores::cont::ArrayHandle<T> Concatenate(const std::vector<viskores::cont::ArrayHandle<T>>& parts)
+{
+  viskores::Id total = 0;
+  for (const auto& part : parts)
+  {
+    total += part.GetNumberOfValues();
+  }
+  viskores::cont::ArrayHandle<T> result;
+  result.Allocate(total);
+  viskores::Id offset = 0;
+  for (const auto& part : parts)
+  {
+    viskores::cont::Algorithm::CopySubRange(part, 0, part.GetNumberOfValues(), result, offset);
+    offset += part.GetNumberOfValues();
+  }
+  return result;
+}
+
+template <typename T>
+viskores::cont::ArrayHandle<T> ConcatenateValues(
+  const std::vector<viskores::cont::UnknownArrayHandle>& parts)
+{
+  std::vector<viskores::cont::ArrayHandle<T>> typedParts;
+  for (const auto& part : parts)
+  {
+    typedParts.push_back(part.AsArrayHandle<viskores::cont::ArrayHandle<T>>());
+  }
+  return Concatenate(typedParts);
+}
+
+// Returns the buffers of the points and the field. Holding on to them keeps later arrays
+// from reusing their memory, so equal buffers mean the same arrays.
+std::vector<viskores::cont::internal::Buffer> GetSourceBuffers(
+  const viskores::cont::CoordinateSystem& coords,
+  const viskores::cont::Field& field)
+{
+  std::vector<viskores::cont::internal::Buffer> buffers;
+  auto append = [&buffers](const auto& array)
+  {
+    const auto& arrayBuffers = array.GetBuffers();
+    buffers.insert(buffers.end(), arrayBuffers.begin(), arrayBuffers.end());
+  };
+  // The multiplexer adds a buffer of its own, so take the buffers of the array it holds.
+  coords.GetDataAsMultiplexer().GetArrayHandleVariant().CastAndCall(append);
+  // The components of most arrays are extracted without a copy. Arrays that have to be
+  // copied never match.
+  field.GetData().CastAndCallWithExtractedArray(
+    [&append](const auto& components)
+    {
+      for (viskores::IdComponent i = 0; i < components.GetNumberOfComponents(); ++i)
+      {
+        append(components.GetComponentArray(i).GetBasicArray());
+      }
+    });
+  return buffers;
+}
+
+} // anonymous namespace
+
+void PointHierarchy::Build(const viskores::cont::CoordinateSystem& coords,
+                           const viskores::cont::ArrayHandle<viskores::Float32>& radii,
+                           const viskores::cont::Field& field)
+{
+  if (radii.GetNumberOfValues() != coords.GetNumberOfPoints())
+  {
+    throw viskores::cont::ErrorBadValue("PointHierarchy: need one radius per point.");
+  }
+  this->BuildImpl(coords, radii, field);
+}
+
+void PointHierarchy::Build(const viskores::cont::CoordinateSystem& coords,
+                           viskores::Float32 radius,
+                           const viskores::cont::Field& field)
+{
+  this->BuildImpl(
+    coords, viskores::cont::make_ArrayHandleConstant(radius, coords.GetNumberOfPoints()), field);
+}
+
+template <typename RadiiArrayType>
+void PointHierarchy::BuildImpl(const viskores::cont::CoordinateSystem& coords,
+                               const RadiiArrayType& radii,
+                               const viskores::cont::Field& field)
+{
+  this->Clear();
+  const viskores::Id numPoints = coords.GetNumberOfPoints();
+  if (!field.IsPointField() || field.GetNumberOfValues() != numPoints)
+  {
+    throw viskores::cont::ErrorBadValue("PointHierarchy: field must be a point field.");
+  }
+  const viskores::IdComponent numComponents = field.GetData().GetNumberOfComponentsFlat();
+  if (numComponents != 1 && numComponents != 3)
+  {
+    throw viskores::cont::ErrorBadValue("PointHierarchy: field must have 1 or 3 components.");
+  }
+  this->FieldName = field.GetName();
+  this->SourceBuffers = GetSourceBuffers(coords, field);
+  if (numPoints == 0)
+  {
+    return;
+  }
+
+  viskores::cont::ArrayHandle<viskores::Vec3f_32> positions;
+  viskores::cont::ArrayCopyShallowIfPossible(coords.GetData(), positions);
+
+  const viskores::Bounds bounds = coords.GetBounds();
+  const viskores::Vec3f_32 minCoordinate(static_cast<viskores::Float32>(bounds.X.Min),
+                                         static_cast<viskores::Float32>(bounds.Y.Min),
+                                         static_cast<viskores::Float32>(bounds.Z.Min));
+  const viskores::Range ranges[3] = { bounds.X, bounds.Y, bounds.Z };
+  viskores::Vec3f_32 inverseExtent;
+  for (viskores::IdComponent i = 0; i < 3; ++i)
+  {
+    const viskores::Float64 length = ranges[i].Length();
+    inverseExtent[i] = length > 0. ? static_cast<viskores::Float32>(1. / length) : 1.f;
+  }
+
+  viskores::cont::Invoker invoke;
+  viskores::cont::ArrayHandle<viskores::UInt32> codes;
+  invoke(PointMortonCodes{ minCoordinate, inverseExtent }, positions, codes);
+  viskores::cont::ArrayHandle<viskores::Id> order;
+  viskores::cont::ArrayCopy(viskores::cont::ArrayHandleIndex(numPoints), order);
+  viskores::cont::Algorithm::SortByKey(codes, order);
+
+  auto build = [&](auto valueType) {
+    using T = decltype(valueType);
+    viskores::cont::ArrayHandle<T> values;
+    viskores::cont::ArrayCopyShallowIfPossible(field.GetData(), values);
+
+    LevelArrays<T> points;
+    viskores::cont::ArrayCopy(viskores::cont::make_ArrayHandlePermutation(order, positions),
+                              points.Centers);
+    viskores::cont::ArrayCopy(viskores::cont::make_ArrayHandlePermutation(order, radii),
+                              points.Radii);
+    viskores::cont::ArrayCopy(viskores::cont::make_ArrayHandlePermutation(order, values),
+                              points.Values);
+
+    auto levels = BuildLevels(codes, points);
+    for (auto level = levels.rbegin(); level != levels.rend(); ++level)
+    {
+      this->Levels.push_back({ level->Centers, level->Radii, level->Values, level->Parents });
+    }
+  };
+  if (numComponents == 1)
+  {
+    build(viskores::Float32{});
+  }
+  else
+  {
+    build(viskores::Vec3f_32{});
+  }
+}
+
+void PointHierarchy::Select(const viskores::Matrix<viskores::Float32, 4, 4>& worldToClip,
+                            viskores::Id imageHeight,
+                            viskores::Float32 pixelSize,
+                            viskores::cont::CoordinateSystem& points,
+                            viskores::cont::ArrayHandle<viskores::Float32>& radii,
+                            viskores::cont::Field& field) const
+{
+  std::vector<viskores::cont::ArrayHandle<viskores::Vec3f_32>> selectedCenters;
+  std::vector<viskores::cont::ArrayHandle<viskores::Float32>> selectedRadii;
+  std::vector<viskores::cont::UnknownArrayHandle> selectedValues;
+
+  viskores::cont::Invoker invoke;
+  viskores::cont::ArrayHandle<viskores::UInt8> parentOpen;
+  viskores::cont::ArrayCopy(viskores::cont::make_ArrayHandleConstant<viskores::UInt8>(1, 1),
+                            parentOpen);
+  const bool isScalar = !this->Levels.empty() &&
+    this->Levels.front().Values.IsType<viskores::cont::ArrayHandle<viskores::Float32>>();
+  for (std::size_t l = 0; l < this->Levels.size(); ++l)
+  {
+    const Level& level = this->Levels[l];
+    const bool finestLevel = l + 1 == this->Levels.size();
+    viskores::cont::ArrayHandle<viskores::UInt8> open;
+    viskores::cont::ArrayHandle<viskores::UInt8> selected;
+    invoke(SelectNodes{ worldToClip, imageHeight, pixelSize, finestLevel },
+           level.Centers,
+           level.Radii,
+           level.Parents,
+           parentOpen,
+           open,
+           selected);
+
+    if (isScalar)
+    {
+      AppendSelected(level.Centers,
+                     level.Radii,
+                     level.Values.AsArrayHandle<viskores::cont::ArrayHandle<viskores::Float32>>(),
+                     selected,
+                     selectedCenters,
+                     selectedRadii,
+                     selectedValues);
+    }
+    else
+    {
+      AppendSelected(level.Centers,
+                     level.Radii,
+                     level.Values.AsArrayHandle<viskores::cont::ArrayHandle<viskores::Vec3f_32>>(),
+                     selected,
+                     selectedCenters,
+                     selectedRadii,
+                     selectedValues);
+    }
+
+    const viskores::Id numOpen = viskores::cont::Algorithm::Reduce(
+      viskores::cont::make_ArrayHandleCast<viskores::Id>(open), viskores::Id(0));
+    if (numOpen == 0)
+    {
+      break;
+    }
+    parentOpen = open;
+  }
+
+  points = viskores::cont::CoordinateSystem("coords", Concatenate(selectedCenters));
+  radii = Concatenate(selectedRadii);
+  if (isScalar)
+  {
+    field = viskores::cont::Field(this->FieldName,
+                                  viskores::cont::Field::Association::Points,
+                                  ConcatenateValues<viskores::Float32>(selectedValues));
+  }
+  else
+  {
+    field = viskores::cont::Field(this->FieldName,
+                                  viskores::cont::Field::Association::Points,
+                                  ConcatenateValues<viskores::Vec3f_32>(selectedValues));
+  }
+}
+
+bool PointHierarchy::IsBuiltFrom(const viskores::cont::CoordinateSystem& coords,
+                                 const viskores::cont::Field& field) const
+{
+  return !this->SourceBuffers.empty() && field.GetName() == this->FieldName &&
+    coords.GetNumberOfPoints() == this->GetNumberOfPoints() &&
+    GetSourceBuffers(coords, field) == this->SourceBuffers;
+}
+
+viskores::Id PointHierarchy::GetNumberOfPoints() const
+{
+  return this->Levels.empty() ? 0 : this->Levels.back().Centers.GetNumberOfValues();
+}
+
+viskores::IdComponent PointHierarchy::GetNumberOfLevels() const
+{
+  return static_cast<viskores::IdComponent>(this->Levels.size());
+}
+
+void PointHierarchy::Clear()
+{
+  this->Levels.clear();
+  this->FieldName.clear();
+  this->SourceBuffers.clear();
+}
+}
+}
+} //namespace viskores::rendering::raytracing
@@ -0,0 +1,107 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+#ifndef viskores_rendering_raytracing_PointHierarchy_h
+#define viskores_rendering_raytracing_PointHierarchy_h
+
+#include <viskores/Matrix.h>
+#include <viskores/cont/CoordinateSystem.h>
+#include <viskores/cont/Field.h>
+#include <viskores/rendering/raytracing/viskores_rendering_raytracing_export.h>
+
+#include <string>
+#include <vector>
+
+namespace viskores
+{
+namespace rendering
+{
+namespace raytracing
+{
+
+/// @brief A hierarchy of point aggregates for rendering large point sets with level of detail.
+///
+/// The points are binned in an octree over their bounds, down to 1024 cells along each axis.
+/// Every octree cell that holds points has a representative point at the centroid of the
+/// points in it, with a radius that bounds the spheres of those points and the average of
+/// their field values. The points themselves form the finest level.
+///
+/// The hierarchy is built once. `Select()` then picks, for a view, the coarsest
+/// representatives whose projected size is at most a given number of pixels, so the number
+/// of primitives rendered follows the size of the image rather than the number of points.
+class VISKORES_RENDERING_RAYTRACING_EXPORT PointHierarchy
+{
+public:
+  /// @brief Builds the hierarchy over points with a radius each and a point field.
+  ///
+  /// The field must have one or three components. Representatives take the average value
+  /// of the points they stand for.
+  void Build(const viskores::cont::CoordinateSystem& coords,
+             const viskores::cont::ArrayHandle<viskores::Float32>& radii,
+             const viskores::cont::Field& field);
+
+  /// @brief Builds the hierarchy over points that all have the same radius.
+  void Build(const viskores::cont::CoordinateSystem& coords,
+             viskores::Float32 radius,
+             const viskores::cont::Field& field);
+
+  /// @brief Selects the representatives to render for a view.
+  ///
+  /// `worldToClip` is the view projection matrix of the camera and `imageHeight` the height
+  /// of the image in pixels. A representative is chosen when its projected diameter is at
+  /// most `pixelSize` pixels and none of its ancestors is. Representatives outside of the
+  /// view are skipped. The selected points, their radii, and their field values are
+  /// returned.
+  void Select(const viskores::Matrix<viskores::Float32, 4, 4>& worldToClip,
+              viskores::Id imageHeight,
+              viskores::Float32 pixelSize,
+              viskores::cont::CoordinateSystem& points,
+              viskores::cont::ArrayHandle<viskores::Float32>& radii,
+              viskores::cont::Field& field) const;
+
+  /// @brief Returns whether the hierarchy was built over these points and field.
+  ///
+  /// The arrays are compared by identity, that is by the memory they reference. Other
+  /// arrays with the same size and bounds do not match.
+  bool IsBuiltFrom(const viskores::cont::CoordinateSystem& coords,
+                   const viskores::cont::Field& field) const;
+
+  /// @brief Returns the number of points the hierarchy was built over.
+  viskores::Id GetNumberOfPoints() const;
+
+  /// @brief Returns the number of levels, including the level of the points.
+  viskores::IdComponent GetNumberOfLevels() const;
+
+  /// @brief Releases the hierarchy.
+  void Clear();
+
+private:
+  struct Level
+  {
+    viskores::cont::ArrayHandle<viskores::Vec3f_32> Centers;
+    viskores::cont::ArrayHandle<viskores::Float32> Radii;
+    // The average field values, of `Float32` or `Vec3f_32`.
+    viskores::cont::UnknownArrayHandle Values;
+    // The index of the parent of each node in the previous level.
+    viskores::cont::ArrayHandle<viskores::Id> Parents;
+  };
+
+  template <typename RadiiArrayType>
+  void BuildImpl(const viskores::cont::CoordinateSystem& coords,
+                 const RadiiArrayType& radii,
+                 const viskores::cont::Field& field);
+
+  // Levels from the root to the points.
+  std::vector<Level> Levels;
+  std::string FieldName;
+  // The memory of the points and the field the hierarchy was built from.
+  std::vector<viskores::cont::internal::Buffer> SourceBuffers;
+};
+}
+}
+} //namespace viskores::rendering::raytracing
+#endif //viskores_rendering_raytracing_PointHierarchy_h
@@ -489,7 +489,7 @@ void QuadIntersector::IntersectRaysImp(Ray<Precision>& rays, bool viskoresNotUse
 
   detail::QuadExecWrapper leafIntersector(this->QuadIds);
 
-  BVHTraverser traverser;
+  BVHTraverser traverser(this->RayPacketSize);
   traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
 
   RayOperations::UpdateRayStatus(rays);
@@ -10,6 +10,8 @@
 #define viskores_rendering_raytracing_Ray_Operations_h
 
 #include <viskores/Matrix.h>
+#include <viskores/cont/Algorithm.h>
+#include <viskores/cont/ArrayHandleIndex.h>
 #include <viskores/rendering/raytracing/Camera.h>
 #include <viskores/rendering/raytracing/ChannelBufferOperations.h>
 #include <viskores/rendering/raytracing/Ray.h>
@@ -286,6 +288,17 @@ public:
     return masks;
   }
 
+  /// Returns the indices of the rays whose mask is set. Secondary rays are generated only
+  /// for these, so rays that missed the shapes cost nothing in later passes.
+  VISKORES_CONT static viskores::cont::ArrayHandle<viskores::Id> GetMaskedIndices(
+    const viskores::cont::ArrayHandle<viskores::UInt8>& masks)
+  {
+    viskores::cont::ArrayHandle<viskores::Id> indices;
+    viskores::cont::Algorithm::CopyIf(
+      viskores::cont::ArrayHandleIndex(masks.GetNumberOfValues()), masks, indices);
+    return indices;
+  }
+
   template <typename T>
   static void Resize(Ray<T>& rays, const viskores::Int32 newSize)
   {
@@ -13,10 +13,12 @@
 #include <stdio.h>
 #include <viskores/cont/ArrayHandleUniformPointCoordinates.h>
 #include <viskores/cont/ColorTable.h>
+#include <viskores/cont/ErrorBadValue.h>
 #include <viskores/cont/Timer.h>
 
 #include <viskores/rendering/raytracing/Camera.h>
 #include <viskores/rendering/raytracing/Logger.h>
+#include <viskores/rendering/raytracing/RayOperations.h>
 #include <viskores/rendering/raytracing/RayTracingTypeDefs.h>
 #include <viskores/worklet/DispatcherMapField.h>
 #include <viskores/worklet/WorkletMapField.h>
@@ -31,6 +33,246 @@ namespace raytracing
 namespace detail
 {
 
+// Pixels stop tracing ambient occlusion rays once this many samples are accumulated.
+constexpr viskores::Float32 MaximumOcclusionSamples = 256.f;
+
+VISKORES_CONT inline viskores::Vec3f_32 LightPosition(
+  const viskores::rendering::raytracing::Camera& camera)
+{
+  // TODO: support light positions
+  viskores::Vec3f_32 scale(2, 2, 2);
+  return camera.GetPosition() + scale * camera.GetUp();
+}
+
+// PCG hash, used to draw reproducible random numbers for each pixel and sample.
+VISKORES_EXEC inline viskores::UInt32 HashSample(viskores::UInt32 value)
+{
+  const viskores::UInt32 state = value * 747796405u + 2891336453u;
+  const viskores::UInt32 word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+  return (word >> 22u) ^ word;
+}
+
+class OcclusionMask : public viskores::worklet::WorkletMapField
+{
+private:
+  bool AmbientOcclusion;
+  bool Shadows;
+
+public:
+  VISKORES_CONT
+  OcclusionMask(bool ambientOcclusion, bool shadows)
+    : AmbientOcclusion(ambientOcclusion)
+    , Shadows(shadows)
+  {
+  }
+
+  using ControlSignature = void(FieldIn, FieldIn, WholeArrayIn, FieldOut, FieldOut);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5);
+
+  template <typename OcclusionPortalType>
+  VISKORES_EXEC void operator()(const viskores::Id& hitIdx,
+                                const viskores::Id& pixelIdx,
+                                const OcclusionPortalType& occlusion,
+                                viskores::UInt8& ambientMask,
+                                viskores::UInt8& shadowMask) const
+  {
+    ambientMask = 0;
+    shadowMask = 0;
+    if (hitIdx < 0)
+    {
+      return;
+    }
+    const viskores::Vec3f_32 state = occlusion.Get(pixelIdx);
+    if (AmbientOcclusion && state[1] < MaximumOcclusionSamples)
+    {
+      ambientMask = 1;
+    }
+    if (Shadows && state[2] < 0.f)
+    {
+      shadowMask = 1;
+    }
+  }
+}; //class OcclusionMask
+
+// Generates the ambient occlusion rays of the compacted hits followed by their shadow rays.
+class GenerateOcclusionRays : public viskores::worklet::WorkletMapField
+{
+private:
+  viskores::Id NumberOfAmbientRays;
+  viskores::IdComponent Samples;
+  viskores::Float32 AmbientDistance;
+  viskores::Float32 Offset;
+  viskores::Vec3f_32 LightPosition;
+
+public:
+  VISKORES_CONT
+  GenerateOcclusionRays(viskores::Id numberOfAmbientRays,
+                        viskores::IdComponent samples,
+                        viskores::Float32 ambientDistance,
+                        viskores::Float32 offset,
+                        const viskores::Vec3f_32& lightPosition)
+    : NumberOfAmbientRays(numberOfAmbientRays)
+    , Samples(samples)
+    , AmbientDistance(ambientDistance)
+    , Offset(offset)
+    , LightPosition(lightPosition)
+  {
+  }
+
+  using ControlSignature = void(FieldIn,
+                                FieldOut,
+                                FieldOut,
+                                FieldOut,
+                                FieldOut,
+                                WholeArrayIn,
+                                WholeArrayIn,
+                                WholeArrayIn,
+                                WholeArrayIn,
+                                WholeArrayIn,
+                                WholeArrayIn,
+                                WholeArrayIn);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12);
+
+  template <typename Precision,
+            typename IndexPortalType,
+            typename PointPortalType,
+            typename PixelPortalType,
+            typename OcclusionPortalType>
+  VISKORES_EXEC void operator()(const viskores::Id& rayIdx,
+                                viskores::Vec<Precision, 3>& origin,
+                                viskores::Vec<Precision, 3>& dir,
+                                Precision& minDistance,
+                                Precision& maxDistance,
+                                const IndexPortalType& ambientIndices,
+                                const IndexPortalType& shadowIndices,
+                                const PointPortalType& intersections,
+                                const PointPortalType& normals,
+                                const PointPortalType& primaryDirs,
+                                const PixelPortalType& pixels,
+                                const OcclusionPortalType& occlusion) const
+  {
+    const bool ambient = rayIdx < NumberOfAmbientRays;
+    const viskores::Id primaryIdx = ambient ? ambientIndices.Get(rayIdx / Samples)
+                                            : shadowIndices.Get(rayIdx - NumberOfAmbientRays);
+
+    // Offset the origin from the surface, on the side facing the viewer, so the ray does
+    // not hit the shape it starts on.
+    viskores::Vec<Precision, 3> normal = normals.Get(primaryIdx);
+    if (viskores::dot(normal, primaryDirs.Get(primaryIdx)) > 0)
+    {
+      normal = -normal;
+    }
+    origin = intersections.Get(primaryIdx) + normal * static_cast<Precision>(Offset);
+    minDistance = 0;
+
+    if (ambient)
+    {
+      // Cosine weighted direction in the hemisphere around the normal. The samples continue
+      // the sequence of the pixel, so each render adds new directions to the accumulation.
+      const viskores::Id pixelIdx = pixels.Get(primaryIdx);
+      const auto sample = static_cast<viskores::UInt32>(occlusion.Get(pixelIdx)[1]) +
+        static_cast<viskores::UInt32>(rayIdx % Samples);
+      const viskores::UInt32 hash =
+        HashSample(HashSample(static_cast<viskores::UInt32>(pixelIdx)) + sample);
+      const Precision u1 = static_cast<Precision>(hash >> 8) * Precision(1.f / 16777216.f);
+      const Precision u2 =
+        static_cast<Precision>(HashSample(hash) >> 8) * Precision(1.f / 16777216.f);
+      const Precision radius = viskores::Sqrt(u1);
+      const Precision phi = Precision(2.f) * viskores::Pi<Precision>() * u2;
+      const Precision height = viskores::Sqrt(viskores::Max(Precision(1.f) - u1, Precision(0.f)));
+
+      viskores::Vec<Precision, 3> axis(1, 0, 0);
+      if (viskores::Abs(normal[0]) > Precision(0.9f))
+      {
+        axis = viskores::Vec<Precision, 3>(0, 1, 0);
+      }
+      viskores::Vec<Precision, 3> tangent = viskores::Cross(axis, normal);
+      viskores::Normalize(tangent);
+      const viskores::Vec<Precision, 3> bitangent = viskores::Cross(normal, tangent);
+      dir = tangent * (radius * viskores::Cos(phi)) + bitangent * (radius * viskores::Sin(phi)) +
+        normal * height;
+      viskores::Normalize(dir);
+      maxDistance = static_cast<Precision>(AmbientDistance);
+    }
+    else
+    {
+      dir = viskores::Vec<Precision, 3>(LightPosition) - origin;
+      maxDistance = viskores::Magnitude(dir);
+      if (maxDistance > 0)
+      {
+        dir = dir / maxDistance;
+      }
+    }
+  }
+}; //class GenerateOcclusionRays
+
+class MarkOccluded : public viskores::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn, FieldInOut);
+  using ExecutionSignature = void(_1, _2);
+
+  VISKORES_EXEC void operator()(const viskores::Id& hitIdx, viskores::UInt8& occluded) const
+  {
+    if (hitIdx >= 0)
+    {
+      occluded = 1;
+    }
+  }
+}; //class MarkOccluded
+
+class AccumulateOcclusion : public viskores::worklet::WorkletMapField
+{
+private:
+  viskores::Id Offset;
+  viskores::IdComponent Samples;
+  bool Shadow;
+
+public:
+  VISKORES_CONT
+  AccumulateOcclusion(viskores::Id offset, viskores::IdComponent samples, bool shadow)
+    : Offset(offset)
+    , Samples(samples)
+    , Shadow(shadow)
+  {
+  }
+
+  using ControlSignature = void(FieldIn, WholeArrayIn, WholeArrayIn, WholeArrayInOut);
+  using ExecutionSignature = void(_1, _2, _3, _4, WorkIndex);
+
+  template <typename OccludedPortalType, typename PixelPortalType, typename OcclusionPortalType>
+  VISKORES_EXEC void operator()(const viskores::Id& primaryIdx,
+                                const OccludedPortalType& occluded,
+                                const PixelPortalType& pixels,
+                                OcclusionPortalType& occlusion,
+                                const viskores::Id& idx) const
+  {
+    const viskores::Id first = Offset + idx * Samples;
+    viskores::Float32 visible = 0.f;
+    for (viskores::IdComponent i = 0; i < Samples; ++i)
+    {
+      if (occluded.Get(first + i) == 0)
+      {
+        visible += 1.f;
+      }
+    }
+
+    // Each pixel has at most one primary ray, so no two instances update the same pixel.
+    const viskores::Id pixelIdx = pixels.Get(primaryIdx);
+    viskores::Vec3f_32 state = occlusion.Get(pixelIdx);
+    if (Shadow)
+    {
+      state[2] = visible;
+    }
+    else
+    {
+      state[0] += visible;
+      state[1] += static_cast<viskores::Float32>(Samples);
+    }
+    occlusion.Set(pixelIdx, state);
+  }
+}; //class AccumulateOcclusion
+
 class SurfaceColor
 {
 public:
@@ -44,15 +286,21 @@ public:
     viskores::Float32 SpecularExponent;
     viskores::Vec3f_32 CameraPosition;
     viskores::Vec3f_32 LookAt;
+    bool AmbientOcclusion;
+    bool Shadows;
 
   public:
     VISKORES_CONT
     Shade(const viskores::Vec3f_32& lightPosition,
           const viskores::Vec3f_32& cameraPosition,
-          const viskores::Vec3f_32& lookAt)
+          const viskores::Vec3f_32& lookAt,
+          bool ambientOcclusion,
+          bool shadows)
       : LightPosition(lightPosition)
       , CameraPosition(cameraPosition)
       , LookAt(lookAt)
+      , AmbientOcclusion(ambientOcclusion)
+      , Shadows(shadows)
     {
       //Set up some default lighting parameters for now
       LightAbmient[0] = .5f;
@@ -67,17 +315,28 @@ public:
       SpecularExponent = 20.f;
     }
 
-    using ControlSignature =
-      void(FieldIn, FieldIn, FieldIn, FieldIn, WholeArrayInOut, WholeArrayIn);
-    using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, WorkIndex);
-
-    template <typename ColorPortalType, typename Precision, typename ColorMapPortalType>
+    using ControlSignature = void(FieldIn,
+                                  FieldIn,
+                                  FieldIn,
+                                  FieldIn,
+                                  FieldIn,
+                                  WholeArrayInOut,
+                                  WholeArrayIn,
+                                  WholeArrayIn);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, WorkIndex);
+
+    template <typename ColorPortalType,
+              typename Precision,
+              typename ColorMapPortalType,
+              typename OcclusionPortalType>
     VISKORES_EXEC void operator()(const viskores::Id& hitIdx,
                                   const Precision& scalar,
                                   const viskores::Vec<Precision, 3>& normal,
                                   const viskores::Vec<Precision, 3>& intersection,
+                                  const viskores::Id& pixelIdx,
                                   ColorPortalType& colors,
                                   ColorMapPortalType colorMap,
+                                  const OcclusionPortalType& occlusion,
                                   const viskores::Id& idx) const
     {
       viskores::Vec<Precision, 4> color;
@@ -118,12 +377,30 @@ public:
       colorIdx = viskores::Min(colorMapSize - 1, colorIdx);
       color = colorMap.Get(colorIdx);
 
-      color[0] *= viskores::Min(
-        LightAbmient[0] + LightDiffuse[0] * cosTheta + LightSpecular[0] * specularConstant, one);
-      color[1] *= viskores::Min(
-        LightAbmient[1] + LightDiffuse[1] * cosTheta + LightSpecular[1] * specularConstant, one);
-      color[2] *= viskores::Min(
-        LightAbmient[2] + LightDiffuse[2] * cosTheta + LightSpecular[2] * specularConstant, one);
+      // Ambient occlusion dims the ambient light, shadows the diffuse and specular light.
+      Precision ambient = one;
+      Precision direct = one;
+      if (AmbientOcclusion || Shadows)
+      {
+        const viskores::Vec3f_32 state = occlusion.Get(pixelIdx);
+        if (AmbientOcclusion && state[1] > 0.f)
+        {
+          ambient = static_cast<Precision>(state[0] / state[1]);
+        }
+        if (Shadows && state[2] >= 0.f)
+        {
+          direct = static_cast<Precision>(state[2]);
+        }
+      }
+
+      for (viskores::IdComponent i = 0; i < 3; ++i)
+      {
+        color[i] *= viskores::Min(LightAbmient[i] * ambient +
+                                    (LightDiffuse[i] * cosTheta +
+                                     LightSpecular[i] * specularConstant) *
+                                      direct,
+                                  one);
+      }
 
       colors.Set(offset + 0, color[0]);
       colors.Set(offset + 1, color[1]);
@@ -178,21 +455,26 @@ public:
   VISKORES_CONT void run(Ray<Precision>& rays,
                          viskores::cont::ArrayHandle<viskores::Vec4f_32>& colorMap,
                          const viskores::rendering::raytracing::Camera& camera,
-                         bool shade)
+                         bool shade,
+                         const viskores::cont::ArrayHandle<viskores::Vec3f_32>& occlusion,
+                         bool ambientOcclusion,
+                         bool shadows)
   {
     if (shade)
     {
-      // TODO: support light positions
-      viskores::Vec3f_32 scale(2, 2, 2);
-      viskores::Vec3f_32 lightPosition = camera.GetPosition() + scale * camera.GetUp();
-      viskores::worklet::DispatcherMapField<Shade>(
-        Shade(lightPosition, camera.GetPosition(), camera.GetLookAt()))
+      viskores::worklet::DispatcherMapField<Shade>(Shade(LightPosition(camera),
+                                                         camera.GetPosition(),
+                                                         camera.GetLookAt(),
+                                                         ambientOcclusion,
+                                                         shadows))
         .Invoke(rays.HitIdx,
                 rays.Scalar,
                 rays.Normal,
                 rays.Intersection,
+                rays.PixelIdx,
                 rays.Buffers.at(0).Buffer,
-                colorMap);
+                colorMap,
+                occlusion);
     }
     else
     {
@@ -207,6 +489,10 @@ public:
 RayTracer::RayTracer()
   : NumberOfShapes(0)
   , Shade(true)
+  , Shadows(false)
+  , AmbientOcclusionSamples(0)
+  , AmbientOcclusionDistance(0.f)
+  , OcclusionNumberOfShapes(0)
 {
 }
 
@@ -254,6 +540,61 @@ void RayTracer::SetShadingOn(bool on)
   Shade = on;
 }
 
+void RayTracer::SetShadowsOn(bool on)
+{
+  if (on != Shadows)
+  {
+    Shadows = on;
+    ResetAccumulation();
+  }
+}
+
+bool RayTracer::GetShadowsOn() const
+{
+  return Shadows;
+}
+
+void RayTracer::SetAmbientOcclusionSamples(viskores::IdComponent samples)
+{
+  if (samples < 0)
+  {
+    throw viskores::cont::ErrorBadValue("Ambient occlusion samples must not be negative.");
+  }
+  if (samples != AmbientOcclusionSamples)
+  {
+    AmbientOcclusionSamples = samples;
+    ResetAccumulation();
+  }
+}
+
+viskores::IdComponent RayTracer::GetAmbientOcclusionSamples() const
+{
+  return AmbientOcclusionSamples;
+}
+
+void RayTracer::SetAmbientOcclusionDistance(viskores::Float32 distance)
+{
+  if (distance < 0.f)
+  {
+    throw viskores::cont::ErrorBadValue("Ambient occlusion distance must not be negative.");
+  }
+  if (distance != AmbientOcclusionDistance)
+  {
+    AmbientOcclusionDistance = distance;
+    ResetAccumulation();
+  }
+}
+
+viskores::Float32 RayTracer::GetAmbientOcclusionDistance() const
+{
+  return AmbientOcclusionDistance;
+}
+
+void RayTracer::ResetAccumulation()
+{
+  Occlusion.ReleaseResources();
+}
+
 viskores::Id RayTracer::GetNumberOfShapes() const
 {
   return NumberOfShapes;
@@ -262,6 +603,7 @@ viskores::Id RayTracer::GetNumberOfShapes() const
 void RayTracer::Clear()
 {
   Intersectors.clear();
+  NumberOfShapes = 0;
 }
 
 template <typename Precision>
@@ -297,9 +639,19 @@ void RayTracer::RenderOnDevice(Ray<Precision>& rays)
       logger->AddLogData("intersection_data", time);
       timer.Start();
 
+      const bool ambientOcclusion = this->Shade && AmbientOcclusionSamples > 0;
+      const bool shadows = this->Shade && Shadows;
+      if (ambientOcclusion || shadows)
+      {
+        ComputeOcclusion(rays);
+        time = timer.GetElapsedTime();
+        logger->AddLogData("occlusion", time);
+        timer.Start();
+      }
+
       // Calculate the color at the intersection  point
       detail::SurfaceColor surfaceColor;
-      surfaceColor.run(rays, ColorMap, camera, this->Shade);
+      surfaceColor.run(rays, ColorMap, camera, this->Shade, Occlusion, ambientOcclusion, shadows);
 
       time = timer.GetElapsedTime();
       logger->AddLogData("shade", time);
@@ -309,6 +661,102 @@ void RayTracer::RenderOnDevice(Ray<Precision>& rays)
   time = renderTimer.GetElapsedTime();
   logger->CloseLogEntry(time);
 } // RenderOnDevice
+
+template <typename Precision>
+void RayTracer::ComputeOcclusion(Ray<Precision>& rays)
+{
+  viskores::Bounds bounds;
+  for (auto&& intersector : Intersectors)
+  {
+    bounds.Include(intersector->GetShapeBounds());
+  }
+
+  // Keep accumulating only while the pixels show the same surface points.
+  const viskores::Id numPixels =
+    static_cast<viskores::Id>(camera.GetWidth()) * static_cast<viskores::Id>(camera.GetHeight());
+  const viskores::Matrix<viskores::Float32, 4, 4>& viewProjection =
+    camera.GetViewProjectionMatrix();
+  if (Occlusion.GetNumberOfValues() != numPixels || !(viewProjection == OcclusionViewProjection) ||
+      !(bounds == OcclusionBounds) || NumberOfShapes != OcclusionNumberOfShapes)
+  {
+    Occlusion.AllocateAndFill(numPixels, viskores::Vec3f_32(0.f, 0.f, -1.f));
+    OcclusionViewProjection = viewProjection;
+    OcclusionBounds = bounds;
+    OcclusionNumberOfShapes = NumberOfShapes;
+  }
+
+  // Only the hits that still need samples spawn secondary rays.
+  const bool ambientOcclusion = AmbientOcclusionSamples > 0;
+  viskores::cont::ArrayHandle<viskores::UInt8> ambientMask;
+  viskores::cont::ArrayHandle<viskores::UInt8> shadowMask;
+  viskores::worklet::DispatcherMapField<detail::OcclusionMask>(
+    detail::OcclusionMask(ambientOcclusion, Shadows))
+    .Invoke(rays.HitIdx, rays.PixelIdx, Occlusion, ambientMask, shadowMask);
+  viskores::cont::ArrayHandle<viskores::Id> ambientIndices =
+    RayOperations::GetMaskedIndices(ambientMask);
+  viskores::cont::ArrayHandle<viskores::Id> shadowIndices =
+    RayOperations::GetMaskedIndices(shadowMask);
+
+  const viskores::IdComponent samples = viskores::Max(AmbientOcclusionSamples, 1);
+  const viskores::Id numAmbientRays = ambientIndices.GetNumberOfValues() * samples;
+  const viskores::Id numRays = numAmbientRays + shadowIndices.GetNumberOfValues();
+  Logger::GetInstance()->AddLogData("occlusion_rays", numRays);
+  if (numRays == 0)
+  {
+    return;
+  }
+
+  const viskores::Float64 diagonal = viskores::Sqrt(bounds.X.Length() * bounds.X.Length() +
+                                                    bounds.Y.Length() * bounds.Y.Length() +
+                                                    bounds.Z.Length() * bounds.Z.Length());
+  const viskores::Float32 ambientDistance = AmbientOcclusionDistance > 0.f
+    ? AmbientOcclusionDistance
+    : static_cast<viskores::Float32>(0.1 * diagonal);
+  const auto offset = static_cast<viskores::Float32>(1e-4 * diagonal);
+
+  Ray<Precision> occlusionRays;
+  occlusionRays.Buffers.clear();
+  RayOperations::Resize(occlusionRays, static_cast<viskores::Int32>(numRays));
+  viskores::worklet::DispatcherMapField<detail::GenerateOcclusionRays>(
+    detail::GenerateOcclusionRays(
+      numAmbientRays, samples, ambientDistance, offset, detail::LightPosition(camera)))
+    .Invoke(viskores::cont::ArrayHandleIndex(numRays),
+            occlusionRays.Origin,
+            occlusionRays.Dir,
+            occlusionRays.MinDistance,
+            occlusionRays.MaxDistance,
+            ambientIndices,
+            shadowIndices,
+            rays.Intersection,
+            rays.Normal,
+            rays.Dir,
+            rays.PixelIdx,
+            Occlusion);
+  RayOperations::ResetStatus(occlusionRays, RAY_ACTIVE);
+
+  // Any hit closer than the maximum distance occludes, whichever shape it is on.
+  viskores::cont::ArrayHandle<viskores::UInt8> occluded;
+  occluded.AllocateAndFill(numRays, 0);
+  for (auto&& intersector : Intersectors)
+  {
+    intersector->IntersectRays(occlusionRays);
+    viskores::worklet::DispatcherMapField<detail::MarkOccluded>().Invoke(occlusionRays.HitIdx,
+                                                                         occluded);
+  }
+
+  if (numAmbientRays > 0)
+  {
+    viskores::worklet::DispatcherMapField<detail::AccumulateOcclusion>(
+      detail::AccumulateOcclusion(0, samples, false))
+      .Invoke(ambientIndices, occluded, rays.PixelIdx, Occlusion);
+  }
+  if (shadowIndices.GetNumberOfValues() > 0)
+  {
+    viskores::worklet::DispatcherMapField<detail::AccumulateOcclusion>(
+      detail::AccumulateOcclusion(numAmbientRays, 1, true))
+      .Invoke(shadowIndices, occluded, rays.PixelIdx, Occlusion);
+  }
+} // ComputeOcclusion
 }
 }
 } // namespace viskores::rendering::raytracing
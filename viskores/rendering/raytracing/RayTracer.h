@@ -12,6 +12,8 @@
 #include <memory>
 #include <vector>
 
+#include <viskores/Bounds.h>
+#include <viskores/Matrix.h>
 #include <viskores/cont/DataSet.h>
 
 #include <viskores/rendering/raytracing/Camera.h>
@@ -33,10 +35,22 @@ protected:
   viskores::cont::ArrayHandle<viskores::Vec4f_32> ColorMap;
   viskores::Range ScalarRange;
   bool Shade;
+  bool Shadows;
+  viskores::IdComponent AmbientOcclusionSamples;
+  viskores::Float32 AmbientOcclusionDistance;
+  // Occlusion accumulated per pixel: the ambient occlusion samples that were not occluded,
+  // the samples traced, and the visibility of the light (negative until it is traced).
+  viskores::cont::ArrayHandle<viskores::Vec3f_32> Occlusion;
+  viskores::Matrix<viskores::Float32, 4, 4> OcclusionViewProjection;
+  viskores::Bounds OcclusionBounds;
+  viskores::Id OcclusionNumberOfShapes;
 
   template <typename Precision>
   void RenderOnDevice(Ray<Precision>& rays);
 
+  template <typename Precision>
+  void ComputeOcclusion(Ray<Precision>& rays);
+
 public:
   VISKORES_CONT
   RayTracer();
@@ -58,6 +72,47 @@ public:
   VISKORES_CONT
   void SetShadingOn(bool on);
 
+  /// @brief Darkens the surfaces that the light does not reach.
+  ///
+  /// A ray is traced from each visible surface point toward the light. Shadows are only
+  /// drawn when shading is on. Off by default.
+  VISKORES_CONT
+  void SetShadowsOn(bool on);
+  /// @copydoc SetShadowsOn
+  VISKORES_CONT
+  bool GetShadowsOn() const;
+
+  /// @brief Specifies how many ambient occlusion rays are traced from each visible surface
+  /// point per render. 0, the default, turns ambient occlusion off.
+  ///
+  /// Ambient occlusion darkens creases and cavities by the fraction of rays that hit a
+  /// shape within `SetAmbientOcclusionDistance()`. While the camera, the image size, and
+  /// the bounds of the shapes stay the same, the samples of consecutive renders are
+  /// accumulated, so a few samples per render converge over several frames. Pixels stop
+  /// tracing new samples once enough have been accumulated. Ambient occlusion is only
+  /// drawn when shading is on.
+  VISKORES_CONT
+  void SetAmbientOcclusionSamples(viskores::IdComponent samples);
+  /// @copydoc SetAmbientOcclusionSamples
+  VISKORES_CONT
+  viskores::IdComponent GetAmbientOcclusionSamples() const;
+
+  /// @brief Specifies how far away a shape occludes a surface point.
+  ///
+  /// 0, the default, uses a tenth of the diagonal of the bounds of the shapes.
+  VISKORES_CONT
+  void SetAmbientOcclusionDistance(viskores::Float32 distance);
+  /// @copydoc SetAmbientOcclusionDistance
+  VISKORES_CONT
+  viskores::Float32 GetAmbientOcclusionDistance() const;
+
+  /// @brief Discards the occlusion accumulated by previous renders.
+  ///
+  /// The accumulation restarts on its own when the camera, the image size, or the bounds
+  /// of the shapes change. Call this when the shapes change in any other way.
+  VISKORES_CONT
+  void ResetAccumulation();
+
   VISKORES_CONT
   void Render(viskores::rendering::raytracing::Ray<viskores::Float32>& rays);
 
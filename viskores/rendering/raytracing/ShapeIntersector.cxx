@@ -6,6 +6,7 @@
 //  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
 //============================================================================
 
+#include <viskores/cont/ErrorBadValue.h>
 #include <viskores/rendering/raytracing/ShapeIntersector.h>
 #include <viskores/worklet/WorkletMapField.h>
 
@@ -92,6 +93,36 @@ void ShapeIntersector::SetAABBs(AABBs& aabbs)
   this->BVH.Construct();
   this->ShapeBounds = this->BVH.TotalBounds;
 }
+
+void ShapeIntersector::RefitAABBs(AABBs& aabbs)
+{
+  this->BVH.Refit(aabbs);
+  this->ShapeBounds = this->BVH.TotalBounds;
+}
+
+void ShapeIntersector::SetBVHBuilder(BVHBuilderType builder)
+{
+  this->BVH.SetBuilder(builder);
+}
+
+BVHBuilderType ShapeIntersector::GetBVHBuilder() const
+{
+  return this->BVH.GetBuilder();
+}
+
+void ShapeIntersector::SetRayPacketSize(viskores::IdComponent packetSize)
+{
+  if (packetSize != 1 && packetSize != 4 && packetSize != 8)
+  {
+    throw viskores::cont::ErrorBadValue("Ray packet size must be 1, 4, or 8.");
+  }
+  this->RayPacketSize = packetSize;
+}
+
+viskores::IdComponent ShapeIntersector::GetRayPacketSize() const
+{
+  return this->RayPacketSize;
+}
 }
 }
 } //namespace viskores::rendering::raytracing
@@ -24,14 +24,33 @@ class VISKORES_RENDERING_RAYTRACING_EXPORT ShapeIntersector
 {
 protected:
   LinearBVH BVH;
+  viskores::IdComponent RayPacketSize = 1;
   viskores::cont::CoordinateSystem CoordsHandle;
   viskores::Bounds ShapeBounds;
   void SetAABBs(AABBs& aabbs);
+  // Updates the BVH for shapes that moved; see LinearBVH::Refit.
+  void RefitAABBs(AABBs& aabbs);
 
 public:
   ShapeIntersector();
   virtual ~ShapeIntersector();
 
+  //
+  // Selects how the BVH over the shapes is built. Must be called before the
+  // shapes are set to take effect.
+  //
+  void SetBVHBuilder(BVHBuilderType builder);
+  BVHBuilderType GetBVHBuilder() const;
+
+  //
+  // Selects how many rays each invocation traces through the BVH together:
+  // 1 (the default) for single rays, or packets of 4 or 8. Packets pay off on CPU
+  // devices when neighboring rays hit the same leaves, i.e., when the shapes cover
+  // several pixels each.
+  //
+  void SetRayPacketSize(viskores::IdComponent packetSize);
+  viskores::IdComponent GetRayPacketSize() const;
+
   //
   //  Intersect Rays finds the nearest intersection shape contained in the derived
   //  class in between min and max distances. HitIdx will be set to the local
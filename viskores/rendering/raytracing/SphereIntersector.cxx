@@ -339,7 +339,7 @@ void SphereIntersector::IntersectRaysImp(Ray<Precision>& rays,
 
   detail::SphereLeafWrapper leafIntersector(this->PointIds, Radii);
 
-  BVHTraverser traverser;
+  BVHTraverser traverser(this->RayPacketSize);
   traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
 
   RayOperations::UpdateRayStatus(rays);
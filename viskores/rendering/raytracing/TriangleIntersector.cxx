@@ -482,17 +482,30 @@ void TriangleIntersector::SetData(const viskores::cont::CoordinateSystem& coords
   Triangles = triangles;
 
   viskores::rendering::raytracing::AABBs AABB;
+  this->FindAABBs(AABB);
+  this->SetAABBs(AABB);
+}
+
+void TriangleIntersector::SetCoordinates(const viskores::cont::CoordinateSystem& coords)
+{
+  CoordsHandle = coords;
+
+  viskores::rendering::raytracing::AABBs AABB;
+  this->FindAABBs(AABB);
+  this->RefitAABBs(AABB);
+}
+
+void TriangleIntersector::FindAABBs(AABBs& aabbs)
+{
   viskores::worklet::DispatcherMapField<detail::FindTriangleAABBs>(detail::FindTriangleAABBs())
     .Invoke(Triangles,
-            AABB.xmins,
-            AABB.ymins,
-            AABB.zmins,
-            AABB.xmaxs,
-            AABB.ymaxs,
-            AABB.zmaxs,
+            aabbs.xmins,
+            aabbs.ymins,
+            aabbs.zmins,
+            aabbs.xmaxs,
+            aabbs.ymaxs,
+            aabbs.zmaxs,
             CoordsHandle);
-
-  this->SetAABBs(AABB);
 }
 
 viskores::cont::ArrayHandle<viskores::Id4> TriangleIntersector::GetTriangles()
@@ -521,14 +534,14 @@ VISKORES_CONT void TriangleIntersector::IntersectRaysImp(Ray<Precision>& rays, b
   if (UseWaterTight)
   {
     detail::WaterTightExecWrapper leafIntersector(this->Triangles);
-    BVHTraverser traverser;
+    BVHTraverser traverser(this->RayPacketSize);
     traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
   }
   else
   {
     detail::MollerExecWrapper leafIntersector(this->Triangles);
 
-    BVHTraverser traverser;
+    BVHTraverser traverser(this->RayPacketSize);
     traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
   }
   // Normally we return the index of the triangle hit,
@@ -27,6 +27,8 @@ protected:
   viskores::cont::ArrayHandle<viskores::Id4> Triangles;
   bool UseWaterTight;
 
+  void FindAABBs(AABBs& aabbs);
+
 public:
   TriangleIntersector();
 
@@ -35,6 +37,10 @@ public:
   void SetData(const viskores::cont::CoordinateSystem& coords,
                viskores::cont::ArrayHandle<viskores::Id4> triangles);
 
+  // Moves the triangles to new point coordinates without changing the triangles
+  // themselves. The BVH is refit rather than rebuilt.
+  void SetCoordinates(const viskores::cont::CoordinateSystem& coords);
+
   viskores::cont::ArrayHandle<viskores::Id4> GetTriangles();
   viskores::Id GetNumberOfShapes() const override;
 
@@ -12,12 +12,14 @@
 #include <typeinfo>
 #include <viskores/cont/Algorithm.h>
 #include <viskores/cont/ArrayHandleCounting.h>
+#include <viskores/cont/ArrayHandleIndex.h>
 #include <viskores/cont/CellSetPermutation.h>
 #include <viskores/cont/DataSet.h>
 #include <viskores/cont/UncertainCellSet.h>
 #include <viskores/rendering/raytracing/MeshConnectivityBuilder.h>
 #include <viskores/worklet/DispatcherMapField.h>
 #include <viskores/worklet/DispatcherMapTopology.h>
+#include <viskores/worklet/MaskIndices.h>
 #include <viskores/worklet/ScatterUniform.h>
 #include <viskores/worklet/WorkletMapField.h>
 #include <viskores/worklet/WorkletMapTopology.h>
@@ -330,7 +332,9 @@ public:
     VISKORES_CONT
     Triangulate() {}
     using ControlSignature = void(CellSetIn cellset, FieldInCell, WholeArrayOut);
-    using ExecutionSignature = void(_2, CellShape, PointIndices, WorkIndex, _3);
+    using ExecutionSignature = void(_2, CellShape, PointIndices, InputIndex, _3);
+    // Ghost cells have no triangles and are skipped.
+    using MaskType = viskores::worklet::MaskIndices;
 
     template <typename VecType, typename OutputPortal>
     VISKORES_EXEC void operator()(const viskores::Id& triangleOffset,
@@ -780,7 +784,13 @@ public:
       viskores::cont::Algorithm::ScanExclusive(trianglesPerCell, cellOffsets);
       outputIndices.Allocate(totalTriangles);
 
-      viskores::worklet::DispatcherMapTopology<Triangulate>(Triangulate())
+      viskores::cont::ArrayHandle<viskores::Id> cellsWithTriangles;
+      viskores::cont::Algorithm::CopyIf(
+        viskores::cont::ArrayHandleIndex(trianglesPerCell.GetNumberOfValues()),
+        trianglesPerCell,
+        cellsWithTriangles);
+      viskores::worklet::DispatcherMapTopology<Triangulate>(
+        Triangulate(), viskores::worklet::MaskIndices(cellsWithTriangles))
         .Invoke(cellSetUnstructured, cellOffsets, outputIndices);
 
       outputTriangles = totalTriangles;
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <viskores/cont/ArrayHandleCartesianProduct.h>
 #include <viskores/cont/ArrayHandleCounting.h>
+#include <viskores/cont/ArrayHandleIndex.h>
 #include <viskores/cont/ArrayHandleUniformPointCoordinates.h>
 #include <viskores/cont/CellLocatorRectilinearGrid.h>
 #include <viskores/cont/CellLocatorUniformGrid.h>
@@ -187,6 +188,188 @@ public:
   }
 }; // class UniformLocatorAdapter
 
+// Lets rays step over macro cells, blocks of MacroCellSize^3 cells, whose scalars all
+// map to zero opacity. A default-constructed skipper never skips.
+class MacroCellSkipper
+{
+  static constexpr viskores::IdComponent Size = VolumeRendererStructured::MacroCellSize;
+  using EmptyPortalType = viskores::cont::ArrayHandle<viskores::UInt8>::ReadPortalType;
+
+  EmptyPortalType Empty;
+  viskores::Id3 MacroCellDimensions{ 0, 0, 0 };
+  viskores::Id3 MaxPoint{ 0, 0, 0 };
+  bool Enabled = false;
+
+public:
+  MacroCellSkipper() = default;
+
+  template <typename Device>
+  MacroCellSkipper(const viskores::cont::ArrayHandle<viskores::UInt8>& empty,
+                   const viskores::Id3& macroCellDimensions,
+                   const viskores::Id3& pointDimensions,
+                   Device,
+                   viskores::cont::Token& token)
+    : Empty(empty.PrepareForInput(Device(), token))
+    , MacroCellDimensions(macroCellDimensions)
+    , MaxPoint(pointDimensions - viskores::Id3(1))
+    , Enabled(true)
+  {
+  }
+
+  VISKORES_EXEC
+  bool IsEmpty(const viskores::Id3& cell) const
+  {
+    if (!this->Enabled)
+      return false;
+    const viskores::Id index =
+      ((cell[2] / Size) * this->MacroCellDimensions[1] + cell[1] / Size) *
+        this->MacroCellDimensions[0] +
+      cell[0] / Size;
+    return this->Empty.Get(index) != 0;
+  }
+
+  // Returns how many steps of `sampleDistance` take a ray at `location` to its first
+  // sample past the macro cell containing `cell`.
+  template <typename LocatorType>
+  VISKORES_EXEC viskores::Id NumberOfSteps(const viskores::Id3& cell,
+                                               const viskores::Vec3f_32& location,
+                                               const viskores::Vec3f_32& rayDir,
+                                               viskores::Float32 sampleDistance,
+                                               const LocatorType& locator) const
+  {
+    viskores::Id3 minPoint;
+    viskores::Id3 maxPoint;
+    for (viskores::IdComponent c = 0; c < 3; c++)
+    {
+      minPoint[c] = (cell[c] / Size) * Size;
+      maxPoint[c] = viskores::Min(minPoint[c] + Size, this->MaxPoint[c]);
+    }
+    viskores::Vec3f_32 boxMin;
+    viskores::Vec3f_32 boxMax;
+    locator.GetMinPoint(minPoint, boxMin);
+    locator.GetMinPoint(maxPoint, boxMax);
+
+    viskores::Float32 exitDistance = viskores::Infinity32();
+    for (viskores::IdComponent c = 0; c < 3; c++)
+    {
+      if (rayDir[c] > 0.f)
+        exitDistance = viskores::Min(exitDistance, (boxMax[c] - location[c]) / rayDir[c]);
+      else if (rayDir[c] < 0.f)
+        exitDistance = viskores::Min(exitDistance, (boxMin[c] - location[c]) / rayDir[c]);
+    }
+    const viskores::Float32 steps = viskores::Ceil(exitDistance / sampleDistance);
+    return static_cast<viskores::Id>(viskores::Min(viskores::Max(steps, 1.f), 1e9f));
+  }
+}; // class MacroCellSkipper
+
+// Finds the range of the scalars that the cells of each macro cell interpolate.
+class FindMacroCellRanges : public viskores::worklet::WorkletMapField
+{
+  static constexpr viskores::IdComponent Size = VolumeRendererStructured::MacroCellSize;
+
+  viskores::Id3 MacroCellDimensions;
+  viskores::Id3 FieldDimensions;
+  viskores::IdComponent Overlap;
+
+public:
+  VISKORES_CONT
+  FindMacroCellRanges(const viskores::Id3& macroCellDimensions,
+                      const viskores::Id3& fieldDimensions,
+                      bool isPointField)
+    : MacroCellDimensions(macroCellDimensions)
+    , FieldDimensions(fieldDimensions)
+    , Overlap(isPointField ? 1 : 0)
+  {
+  }
+
+  using ControlSignature = void(FieldIn, FieldOut, WholeArrayIn);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  template <typename ScalarPortalType>
+  VISKORES_EXEC void operator()(const viskores::Id& index,
+                                viskores::Vec2f_32& range,
+                                const ScalarPortalType& scalars) const
+  {
+    const viskores::Id3 macroCell(index % this->MacroCellDimensions[0],
+                                  (index / this->MacroCellDimensions[0]) %
+                                    this->MacroCellDimensions[1],
+                                  index /
+                                    (this->MacroCellDimensions[0] * this->MacroCellDimensions[1]));
+    viskores::Id3 begin;
+    viskores::Id3 end;
+    for (viskores::IdComponent c = 0; c < 3; c++)
+    {
+      begin[c] = macroCell[c] * Size;
+      end[c] = viskores::Min(begin[c] + Size + this->Overlap, this->FieldDimensions[c]);
+    }
+
+    range = viskores::Vec2f_32(viskores::Infinity32(), viskores::NegativeInfinity32());
+    for (viskores::Id k = begin[2]; k < end[2]; k++)
+      for (viskores::Id j = begin[1]; j < end[1]; j++)
+        for (viskores::Id i = begin[0]; i < end[0]; i++)
+        {
+          const auto value = static_cast<viskores::Float32>(
+            scalars.Get((k * this->FieldDimensions[1] + j) * this->FieldDimensions[0] + i));
+          range[0] = viskores::Min(range[0], value);
+          range[1] = viskores::Max(range[1], value);
+        }
+  }
+}; // class FindMacroCellRanges
+
+// Flags the macro cells whose scalar range maps to zero opacity everywhere.
+class FindEmptyMacroCellsWorklet : public viskores::worklet::WorkletMapField
+{
+  viskores::Float32 MinScalar;
+  viskores::Float32 InverseDeltaScalar;
+  viskores::Id ColorMapSize;
+
+public:
+  VISKORES_CONT
+  FindEmptyMacroCellsWorklet(const viskores::Range& scalarRange, viskores::Id colorMapSize)
+    : MinScalar(static_cast<viskores::Float32>(scalarRange.Min))
+    , InverseDeltaScalar(MinScalar)
+    , ColorMapSize(colorMapSize - 1)
+  {
+    // Normalize the same way the samplers do.
+    const auto maxScalar = static_cast<viskores::Float32>(scalarRange.Max);
+    if ((maxScalar - this->MinScalar) != 0.f)
+      this->InverseDeltaScalar = 1.f / (maxScalar - this->MinScalar);
+  }
+
+  using ControlSignature = void(FieldIn, FieldOut, WholeArrayIn);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  template <typename ColorMapPortalType>
+  VISKORES_EXEC void operator()(const viskores::Vec2f_32& range,
+                                viskores::UInt8& empty,
+                                const ColorMapPortalType& colorMap) const
+  {
+    empty = 0;
+    if (!(range[0] <= range[1]))
+      return;
+
+    // Widen by one entry in case interpolation rounds just outside of the range.
+    const viskores::Id first = viskores::Max(this->ColorIndex(range[0]) - 1, viskores::Id(0));
+    const viskores::Id last = viskores::Min(this->ColorIndex(range[1]) + 1, this->ColorMapSize);
+    for (viskores::Id i = first; i <= last; i++)
+    {
+      if (colorMap.Get(i)[3] > 0.f)
+        return;
+    }
+    empty = 1;
+  }
+
+private:
+  VISKORES_EXEC
+  viskores::Id ColorIndex(viskores::Float32 scalar) const
+  {
+    const viskores::Float32 normalized = (scalar - this->MinScalar) * this->InverseDeltaScalar;
+    const auto maxIndex = static_cast<viskores::Float32>(this->ColorMapSize);
+    return static_cast<viskores::Id>(
+      viskores::Min(viskores::Max(normalized * maxIndex, 0.f), maxIndex));
+  }
+}; // class FindEmptyMacroCellsWorklet
+
 } //namespace
 
 
@@ -203,6 +386,8 @@ private:
   viskores::Float32 InverseDeltaScalar;
   LocatorType Locator;
   viskores::Float32 MeshEpsilon;
+  MacroCellSkipper Skipper;
+  viskores::Float32 TerminationOpacity;
 
 public:
   VISKORES_CONT
@@ -212,6 +397,8 @@ public:
           const viskores::Float32& sampleDistance,
           const LocatorType& locator,
           const viskores::Float32& meshEpsilon,
+          const MacroCellSkipper& skipper,
+          const viskores::Float32& terminationOpacity,
           viskores::cont::Token& token)
     : ColorMap(colorMap.PrepareForInput(DeviceAdapterTag(), token))
     , MinScalar(minScalar)
@@ -219,6 +406,8 @@ public:
     , InverseDeltaScalar(minScalar)
     , Locator(locator)
     , MeshEpsilon(meshEpsilon)
+    , Skipper(skipper)
+    , TerminationOpacity(terminationOpacity)
   {
     ColorMapSize = colorMap.GetNumberOfValues() - 1;
     if ((maxScalar - minScalar) != 0.f)
@@ -305,6 +494,18 @@ public:
       {
         viskores::Vec<viskores::Id, 8> cellIndices;
         Locator.LocateCell(cell, sampleLocation, invSpacing, parametric);
+        if (Skipper.IsEmpty(cell))
+        {
+          // Step the same way as below so that the samples taken are the same.
+          viskores::Id steps =
+            Skipper.NumberOfSteps(cell, sampleLocation, rayDir, SampleDistance, Locator);
+          for (; steps > 0 && distance < maxDistance; steps--)
+          {
+            distance += SampleDistance;
+            sampleLocation = sampleLocation + SampleDistance * rayDir;
+          }
+          continue;
+        }
         Locator.GetCellIndices(cell, cellIndices);
         Locator.GetPoint(cellIndices[0], bottomLeft);
 
@@ -354,8 +555,8 @@ public:
       color[2] = color[2] + sampleColor[2] * alpha;
       color[3] = alpha + color[3];
 
-      // terminate the ray early if it became completely opaque.
-      if (color[3] >= 1.f)
+      // terminate the ray early once it is opaque enough.
+      if (color[3] >= TerminationOpacity)
         break;
 
       //advance
@@ -394,6 +595,8 @@ private:
   viskores::Float32 InverseDeltaScalar;
   LocatorType Locator;
   viskores::Float32 MeshEpsilon;
+  MacroCellSkipper Skipper;
+  viskores::Float32 TerminationOpacity;
 
 public:
   VISKORES_CONT
@@ -403,6 +606,8 @@ public:
                    const viskores::Float32& sampleDistance,
                    const LocatorType& locator,
                    const viskores::Float32& meshEpsilon,
+                   const MacroCellSkipper& skipper,
+                   const viskores::Float32& terminationOpacity,
                    viskores::cont::Token& token)
     : ColorMap(colorMap.PrepareForInput(DeviceAdapterTag(), token))
     , MinScalar(minScalar)
@@ -410,6 +615,8 @@ public:
     , InverseDeltaScalar(minScalar)
     , Locator(locator)
     , MeshEpsilon(meshEpsilon)
+    , Skipper(skipper)
+    , TerminationOpacity(terminationOpacity)
   {
     ColorMapSize = colorMap.GetNumberOfValues() - 1;
     if ((maxScalar - minScalar) != 0.f)
@@ -487,6 +694,18 @@ public:
       if (newCell)
       {
         Locator.LocateCell(cell, sampleLocation, invSpacing, parametric);
+        if (Skipper.IsEmpty(cell))
+        {
+          // Step the same way as below so that the samples taken are the same.
+          viskores::Id steps =
+            Skipper.NumberOfSteps(cell, sampleLocation, rayDir, SampleDistance, Locator);
+          for (; steps > 0 && distance < maxDistance; steps--)
+          {
+            distance += SampleDistance;
+            sampleLocation = sampleLocation + SampleDistance * rayDir;
+          }
+          continue;
+        }
         viskores::Id cellId = Locator.GetCellIndex(cell);
         Locator.GetMinPoint(cell, bottomLeft);
 
@@ -511,8 +730,8 @@ public:
       color[2] = color[2] + sampleColor[2] * alpha;
       color[3] = alpha + color[3];
 
-      // terminate the ray early if it became completely opaque.
-      if (color[3] >= 1.f)
+      // terminate the ray early once it is opaque enough.
+      if (color[3] >= TerminationOpacity)
         break;
 
       //advance
@@ -704,6 +923,22 @@ void VolumeRendererStructured::RenderOnDevice(viskores::rendering::raytracing::R
   }
   const bool isAssocPoints = ScalarField->IsPointField();
 
+  this->FindEmptyMacroCells();
+  time = timer.GetElapsedTime();
+  logger->AddLogData("find_empty_macro_cells", time);
+  timer.Start();
+
+  auto makeSkipper = [this](viskores::cont::Token& token)
+  {
+    if (!this->EmptySpaceSkipping)
+      return MacroCellSkipper{};
+    return MacroCellSkipper(this->EmptyMacroCells,
+                            this->MacroCellDimensions,
+                            this->Cellset.GetPointDimensions(),
+                            Device(),
+                            token);
+  };
+
   if (IsUniformDataSet)
   {
     viskores::cont::Token token;
@@ -714,6 +949,7 @@ void VolumeRendererStructured::RenderOnDevice(viskores::rendering::raytracing::R
     uniLocator.SetCellSet(this->Cellset);
     uniLocator.SetCoordinates(this->Coordinates);
     UniformLocatorAdapter<Device> locator(vertices, this->Cellset, uniLocator, token);
+    MacroCellSkipper skipper = makeSkipper(token);
 
     if (isAssocPoints)
     {
@@ -724,6 +960,8 @@ void VolumeRendererStructured::RenderOnDevice(viskores::rendering::raytracing::R
                                                        SampleDistance,
                                                        locator,
                                                        meshEpsilon,
+                                                       skipper,
+                                                       this->RayTerminationOpacity,
                                                        token);
       invoke(sampler,
              rays.Dir,
@@ -742,6 +980,8 @@ void VolumeRendererStructured::RenderOnDevice(viskores::rendering::raytracing::R
                                                                 SampleDistance,
                                                                 locator,
                                                                 meshEpsilon,
+                                                                skipper,
+                                                                this->RayTerminationOpacity,
                                                                 token);
       invoke(sampler,
              rays.Dir,
@@ -761,6 +1001,7 @@ void VolumeRendererStructured::RenderOnDevice(viskores::rendering::raytracing::R
     rectLocator.SetCellSet(this->Cellset);
     rectLocator.SetCoordinates(this->Coordinates);
     RectilinearLocatorAdapter<Device> locator(vertices, Cellset, rectLocator, token);
+    MacroCellSkipper skipper = makeSkipper(token);
 
     if (isAssocPoints)
     {
@@ -771,6 +1012,8 @@ void VolumeRendererStructured::RenderOnDevice(viskores::rendering::raytracing::R
                                                            SampleDistance,
                                                            locator,
                                                            meshEpsilon,
+                                                           skipper,
+                                                           this->RayTerminationOpacity,
                                                            token);
       invoke(sampler,
              rays.Dir,
@@ -789,6 +1032,8 @@ void VolumeRendererStructured::RenderOnDevice(viskores::rendering::raytracing::R
         SampleDistance,
         locator,
         meshEpsilon,
+        skipper,
+        this->RayTerminationOpacity,
         token);
       invoke(sampler,
              rays.Dir,
@@ -813,6 +1058,51 @@ void VolumeRendererStructured::SetSampleDistance(const viskores::Float32& distan
     throw viskores::cont::ErrorBadValue("Sample distance must be positive.");
   SampleDistance = distance;
 }
+
+void VolumeRendererStructured::SetEmptySpaceSkipping(bool enable)
+{
+  this->EmptySpaceSkipping = enable;
+}
+
+void VolumeRendererStructured::SetRayTerminationOpacity(viskores::Float32 opacity)
+{
+  if (opacity <= 0.f || opacity > 1.f)
+    throw viskores::cont::ErrorBadValue("Ray termination opacity must be in (0, 1].");
+  this->RayTerminationOpacity = opacity;
+}
+
+void VolumeRendererStructured::FindEmptyMacroCells()
+{
+  if (!this->EmptySpaceSkipping)
+    return;
+
+  viskores::cont::Invoker invoke;
+
+  // The scalar ranges only depend on the data, so they are kept until SetData.
+  if (this->IsSceneDirty || this->MacroCellRanges.GetNumberOfValues() == 0)
+  {
+    const viskores::Id3 cellDimensions = this->Cellset.GetCellDimensions();
+    for (viskores::IdComponent c = 0; c < 3; c++)
+      this->MacroCellDimensions[c] = (cellDimensions[c] + MacroCellSize - 1) / MacroCellSize;
+
+    const bool isPointField = this->ScalarField->IsPointField();
+    const viskores::Id3 fieldDimensions =
+      isPointField ? this->Cellset.GetPointDimensions() : cellDimensions;
+    const viskores::Id numMacroCells = this->MacroCellDimensions[0] *
+      this->MacroCellDimensions[1] * this->MacroCellDimensions[2];
+    invoke(FindMacroCellRanges{ this->MacroCellDimensions, fieldDimensions, isPointField },
+           viskores::cont::ArrayHandleIndex(numMacroCells),
+           this->MacroCellRanges,
+           viskores::rendering::raytracing::GetScalarFieldArray(*this->ScalarField));
+    this->IsSceneDirty = false;
+  }
+
+  // The color map may change between renders, so the flags are always recomputed.
+  invoke(FindEmptyMacroCellsWorklet{ this->ScalarRange, this->ColorMap.GetNumberOfValues() },
+         this->MacroCellRanges,
+         this->EmptyMacroCells,
+         this->ColorMap);
+}
 }
 }
 } //namespace viskores::rendering::raytracing
@@ -43,10 +43,35 @@ public:
   VISKORES_CONT
   void SetSampleDistance(const viskores::Float32& distance);
 
+  /// @brief Specifies whether rays skip regions that the color map makes fully transparent.
+  ///
+  /// The volume is divided into blocks of `MacroCellSize` cells on a side. Before
+  /// marching, the range of scalars in each block is looked up in the color map, and
+  /// rays step over the blocks whose whole range maps to zero opacity. The samples
+  /// taken elsewhere are unchanged. On by default.
+  VISKORES_CONT
+  void SetEmptySpaceSkipping(bool enable);
+  VISKORES_CONT
+  bool GetEmptySpaceSkipping() const { return this->EmptySpaceSkipping; }
+
+  /// @brief Specifies the accumulated opacity at which a ray stops marching.
+  ///
+  /// The default of 1 only stops rays that became fully opaque. Lower values, such as
+  /// 0.95, end rays sooner at the cost of dropping what little of the volume behind
+  /// would still show.
+  VISKORES_CONT
+  void SetRayTerminationOpacity(viskores::Float32 opacity);
+  VISKORES_CONT
+  viskores::Float32 GetRayTerminationOpacity() const { return this->RayTerminationOpacity; }
+
+  static constexpr viskores::IdComponent MacroCellSize = 8;
+
 protected:
   template <typename Precision, typename Device>
   VISKORES_CONT void RenderOnDevice(viskores::rendering::raytracing::Ray<Precision>& rays, Device);
 
+  VISKORES_CONT void FindEmptyMacroCells();
+
   bool IsSceneDirty = false;
   bool IsUniformDataSet = true;
   viskores::Bounds SpatialExtent;
@@ -56,6 +81,11 @@ protected:
   viskores::cont::ArrayHandle<viskores::Vec4f_32> ColorMap;
   viskores::Float32 SampleDistance = -1.f;
   viskores::Range ScalarRange;
+  bool EmptySpaceSkipping = true;
+  viskores::Float32 RayTerminationOpacity = 1.f;
+  viskores::Id3 MacroCellDimensions{ 0, 0, 0 };
+  viskores::cont::ArrayHandle<viskores::Vec2f_32> MacroCellRanges;
+  viskores::cont::ArrayHandle<viskores::UInt8> EmptyMacroCells;
 };
 }
 }
@@ -0,0 +1,191 @@
+//============================================================================
+//  The contents of this file are covered by the Viskores license. See
+//  LICENSE.txt for details.
+//
+//  By contributing to this file, all contributors agree to the Developer
+//  Certificate of Origin Version 1.1 (DCO 1.1) as stated in DCO.txt.
+//============================================================================
+
+#include <viskores/cont/EnvironmentTracker.h>
+#include <viskores/cont/testing/Testing.h>
+#include <viskores/rendering/Canvas.h>
+#include <viskores/rendering/Compositor.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+constexpr viskores::Id Width = 37;
+constexpr viskores::Id Height = 11;
+
+// The image that rank `rank` contributes. Every seventh pixel is empty on even ranks,
+// and the depth order of the ranks changes from pixel to pixel.
+viskores::Float32 PixelDepth(int rank, viskores::Id pixel)
+{
+  return static_cast<viskores::Float32>((pixel * (rank + 1)) % 13) +
+    0.01f * static_cast<viskores::Float32>(rank);
+}
+
+viskores::Vec4f_32 PixelColor(int rank, viskores::Id pixel)
+{
+  if (rank % 2 == 0 && pixel % 7 == 0)
+    return viskores::Vec4f_32(0.f);
+  const viskores::Float32 alpha = 0.25f + 0.1f * static_cast<viskores::Float32>(rank % 5);
+  viskores::Vec4f_32 color(static_cast<viskores::Float32>(rank % 3) / 2.f,
+                           static_cast<viskores::Float32>(pixel % 5) / 4.f,
+                           0.5f,
+                           1.f);
+  return color * alpha;
+}
+
+void FillCanvas(viskores::rendering::Canvas& canvas, int rank)
+{
+  auto colorPortal = canvas.GetColorBuffer().WritePortal();
+  auto depthPortal = canvas.GetDepthBuffer().WritePortal();
+  for (viskores::Id i = 0; i < Width * Height; i++)
+  {
+    colorPortal.Set(i, PixelColor(rank, i));
+    depthPortal.Set(i, PixelDepth(rank, i));
+  }
+}
+
+// Blends the contributions of all ranks to a pixel in the given order of the ranks.
+viskores::Vec4f_32 BlendInOrder(std::vector<int> ranks, viskores::Id pixel)
+{
+  std::sort(ranks.begin(),
+            ranks.end(),
+            [pixel](int a, int b) { return PixelDepth(a, pixel) < PixelDepth(b, pixel); });
+  viskores::Vec4f_32 result(0.f);
+  for (int rank : ranks)
+    result = result + PixelColor(rank, pixel) * (1.f - result[3]);
+  return result;
+}
+
+void TestCanvasComposite(viskores::rendering::Compositor& compositor)
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  const bool ordered =
+    compositor.GetBlendMode() == viskores::rendering::Compositor::BlendMode::Ordered;
+
+  viskores::rendering::Canvas canvas(Width, Height);
+  FillCanvas(canvas, comm.rank());
+  compositor.Composite(canvas);
+
+  if (comm.rank() != 0)
+    return;
+
+  std::vector<int> ranks(static_cast<std::size_t>(comm.size()));
+  for (int r = 0; r < comm.size(); r++)
+    ranks[static_cast<std::size_t>(r)] = r;
+
+  auto colorPortal = canvas.GetColorBuffer().ReadPortal();
+  auto depthPortal = canvas.GetDepthBuffer().ReadPortal();
+  for (viskores::Id i = 0; i < Width * Height; i++)
+  {
+    int closest = 0;
+    for (int r = 1; r < comm.size(); r++)
+      if (PixelDepth(r, i) < PixelDepth(closest, i))
+        closest = r;
+
+    const auto expected = ordered ? BlendInOrder(ranks, i) : PixelColor(closest, i);
+    VISKORES_TEST_ASSERT(test_equal(colorPortal.Get(i), expected), "Wrong color at pixel ", i);
+    VISKORES_TEST_ASSERT(test_equal(depthPortal.Get(i), PixelDepth(closest, i)),
+                         "Wrong depth at pixel ",
+                         i);
+  }
+}
+
+void TestPartialComposite(viskores::rendering::Compositor& compositor)
+{
+  auto comm = viskores::cont::EnvironmentTracker::GetCommunicator();
+  const int rank = comm.rank();
+
+  // Each rank covers every pixel but those its index divides, split between two
+  // partials as if the rank held two data sets.
+  std::vector<viskores::rendering::raytracing::PartialComposite<viskores::Float32>> partials(2);
+  std::vector<viskores::Id> pixels[2];
+  for (viskores::Id i = 0; i < Width * Height; i++)
+    if (rank == 0 || i % (rank + 1) != 0)
+      pixels[i % 2].push_back(i);
+  for (std::size_t p = 0; p < 2; p++)
+  {
+    auto& partial = partials[p];
+    const viskores::Id size = static_cast<viskores::Id>(pixels[p].size());
+    partial.PixelIds = viskores::cont::make_ArrayHandle(pixels[p], viskores::CopyFlag::On);
+    partial.Distances.Allocate(size);
+    partial.Buffer = viskores::rendering::raytracing::ChannelBuffer<viskores::Float32>(4, size);
+    auto distancePortal = partial.Distances.WritePortal();
+    auto bufferPortal = partial.Buffer.Buffer.WritePortal();
+    for (viskores::Id j = 0; j < size; j++)
+    {
+      const viskores::Id pixel = pixels[p][static_cast<std::size_t>(j)];
+      distancePortal.Set(j, PixelDepth(rank, pixel));
+      const auto color = PixelColor(rank, pixel);
+      for (viskores::IdComponent c = 0; c < 4; c++)
+        bufferPortal.Set(4 * j + c, color[c]);
+    }
+  }
+
+  // The composited partials go in front of what is already in the canvas.
+  const viskores::Vec4f_32 background(0.f, 0.f, 0.25f, 0.25f);
+  viskores::rendering::Canvas canvas(Width, Height);
+  canvas.GetColorBuffer().Fill(background);
+  compositor.Composite(partials, canvas);
+
+  if (rank != 0)
+    return;
+
+  auto colorPortal = canvas.GetColorBuffer().ReadPortal();
+  for (viskores::Id i = 0; i < Width * Height; i++)
+  {
+    std::vector<int> ranks;
+    for (int r = 0; r < comm.size(); r++)
+      if (r == 0 || i % (r + 1) != 0)
+        ranks.push_back(r);
+    const auto front = BlendInOrder(ranks, i);
+    const auto expected = front + background * (1.f - front[3]);
+    VISKORES_TEST_ASSERT(test_equal(colorPortal.Get(i), expected), "Wrong color at pixel ", i);
+  }
+}
+
+void TestCompositor()
+{
+  using Compositor = viskores::rendering::Compositor;
+
+  for (auto mode : { Compositor::BlendMode::Depth, Compositor::BlendMode::Ordered })
+  {
+    Compositor compositor;
+    compositor.SetBlendMode(mode);
+
+    std::cout << "Testing binary-swap, "
+              << (mode == Compositor::BlendMode::Depth ? "depth" : "ordered") << " blending"
+              << std::endl;
+    compositor.SetAlgorithm(Compositor::CompositeAlgorithm::BinarySwap);
+    TestCanvasComposite(compositor);
+
+    compositor.SetAlgorithm(Compositor::CompositeAlgorithm::RadixK);
+    for (viskores::IdComponent radix : { 3, 8 })
+    {
+      std::cout << "Testing radix-" << radix << ", "
+                << (mode == Compositor::BlendMode::Depth ? "depth" : "ordered") << " blending"
+                << std::endl;
+      compositor.SetRadix(radix);
+      TestCanvasComposite(compositor);
+    }
+  }
+
+  std::cout << "Testing partial composites" << std::endl;
+  Compositor compositor;
+  TestPartialComposite(compositor);
+  compositor.SetAlgorithm(Compositor::CompositeAlgorithm::BinarySwap);
+  TestPartialComposite(compositor);
+}
+
+} // anonymous namespace
+
+int UnitTestCompositorMPI(int argc, char* argv[])
+{
+  return viskores::cont::testing::Testing::Run(TestCompositor, argc, argv);
+}
@@ -7,6 +7,7 @@
 //============================================================================
 
 
+#include <viskores/cont/ArrayCopy.h>
 #include <viskores/cont/testing/MakeTestDataSet.h>
 #include <viskores/cont/testing/Testing.h>
 #include <viskores/rendering/Actor.h>
@@ -15,12 +16,186 @@
 #include <viskores/rendering/MapperConnectivity.h>
 #include <viskores/rendering/Scene.h>
 #include <viskores/rendering/View3D.h>
+#include <viskores/rendering/raytracing/ConnectivityTracer.h>
 #include <viskores/rendering/raytracing/Logger.h>
 #include <viskores/rendering/testing/RenderTest.h>
 
 namespace
 {
 
+void TestRefinement()
+{
+  using View = viskores::rendering::View;
+  viskores::cont::testing::MakeTestDataSet maker;
+  viskores::cont::DataSet dataSet = maker.Make3DExplicitDataSetZoo();
+
+  viskores::rendering::Scene scene;
+  scene.AddActor(viskores::rendering::Actor(dataSet.GetCellSet(),
+                                            dataSet.GetCoordinateSystem(),
+                                            dataSet.GetField("pointvar"),
+                                            viskores::cont::ColorTable::Preset::Inferno));
+  viskores::rendering::View3D view(
+    scene, viskores::rendering::MapperConnectivity(), viskores::rendering::CanvasRayTracer(61, 47));
+  view.GetCamera().Azimuth(30.f);
+  view.GetCamera().Elevation(20.f);
+
+  view.Paint();
+  VISKORES_TEST_ASSERT(view.IsImageComplete(), "Full rendering must finish in one call");
+  viskores::rendering::Canvas::ColorBufferType reference;
+  viskores::cont::ArrayCopy(view.GetCanvas().GetColorBuffer(), reference);
+
+  auto paintAll = [&view]()
+  {
+    viskores::Id numPaints = 0;
+    do
+    {
+      view.Paint();
+      numPaints++;
+    } while (!view.IsImageComplete());
+    return numPaints;
+  };
+
+  auto checkImage = [&](const std::string& mode)
+  {
+    auto expected = reference.ReadPortal();
+    auto actual = view.GetCanvas().GetColorBuffer().ReadPortal();
+    for (viskores::Id i = 0; i < expected.GetNumberOfValues(); i++)
+    {
+      VISKORES_TEST_ASSERT(
+        test_equal(actual.Get(i), expected.Get(i)), mode, " rendering changed pixel ", i);
+    }
+  };
+
+  // With no time budget, every call renders one pass or tile.
+  view.SetFrameTimeBudget(0.);
+
+  std::cout << "Testing progressive rendering" << std::endl;
+  view.SetRenderMode(View::RenderMode::Progressive);
+  view.SetProgressiveLevels(2);
+  VISKORES_TEST_ASSERT(paintAll() == 7, "Wrong number of progressive passes");
+  checkImage("Progressive");
+  view.Paint();
+  VISKORES_TEST_ASSERT(view.IsImageComplete(), "A finished image should not be rendered again");
+
+  std::cout << "Testing tiled rendering" << std::endl;
+  view.SetRenderMode(View::RenderMode::Tiled);
+  view.SetTileSize(32);
+  VISKORES_TEST_ASSERT(paintAll() == 4, "Wrong number of tiles");
+  checkImage("Tiled");
+
+  // Moving the camera starts a new image.
+  view.GetCamera().Azimuth(10.f);
+  view.Paint();
+  VISKORES_TEST_ASSERT(!view.IsImageComplete(), "Moving the camera should restart the image");
+}
+
+viskores::cont::ArrayHandle<viskores::Vec4f_32> Render(
+  viskores::rendering::MapperConnectivity& mapper,
+  const viskores::cont::DataSet& dataSet,
+  const std::string& fieldName,
+  const viskores::rendering::Camera& camera)
+{
+  viskores::rendering::CanvasRayTracer canvas(64, 64);
+  canvas.Clear();
+  viskores::cont::ColorTable colorTable(viskores::cont::ColorTable::Preset::Inferno);
+  mapper.SetCanvas(&canvas);
+  mapper.SetActiveColorTable(colorTable);
+  const auto& field = dataSet.GetField(fieldName);
+  mapper.RenderCells(dataSet.GetCellSet(),
+                     dataSet.GetCoordinateSystem(),
+                     field,
+                     colorTable,
+                     camera,
+                     field.GetRange().ReadPortal().Get(0));
+
+  viskores::cont::ArrayHandle<viskores::Vec4f_32> colors;
+  viskores::cont::ArrayCopy(canvas.GetColorBuffer(), colors);
+  return colors;
+}
+
+void TestMeshReuse()
+{
+  std::cout << "Testing mesh connectivity reuse" << std::endl;
+
+  viskores::cont::testing::MakeTestDataSet maker;
+  viskores::cont::DataSet dataSet = maker.Make3DExplicitDataSetZoo();
+  const viskores::cont::Field& pointField = dataSet.GetField("pointvar");
+  const viskores::Range range = pointField.GetRange().ReadPortal().Get(0);
+
+  viskores::rendering::raytracing::ConnectivityTracer tracer;
+  tracer.SetVolumeData(pointField,
+                       range,
+                       dataSet.GetCellSet(),
+                       dataSet.GetCoordinateSystem(),
+                       dataSet.GetGhostCellField());
+  auto mesh = tracer.GetMeshContainer();
+  tracer.SetVolumeData(dataSet.GetField("cellvar"),
+                       range,
+                       dataSet.GetCellSet(),
+                       dataSet.GetCoordinateSystem(),
+                       dataSet.GetGhostCellField());
+  VISKORES_TEST_ASSERT(tracer.GetMeshContainer() == mesh, "Mesh should be reused");
+
+  // A different cell set, even with the same cells, needs a new mesh.
+  viskores::cont::UnknownCellSet cellSetCopy = dataSet.GetCellSet().NewInstance();
+  cellSetCopy.DeepCopyFrom(dataSet.GetCellSet().GetCellSetBase());
+  tracer.SetVolumeData(pointField,
+                       range,
+                       cellSetCopy,
+                       dataSet.GetCoordinateSystem(),
+                       dataSet.GetGhostCellField());
+  VISKORES_TEST_ASSERT(tracer.GetMeshContainer() != mesh, "Mesh should be rebuilt");
+
+  // So do different coordinates, even with the same points.
+  mesh = tracer.GetMeshContainer();
+  viskores::cont::ArrayHandle<viskores::Vec3f> pointsCopy;
+  viskores::cont::ArrayCopy(dataSet.GetCoordinateSystem().GetData(), pointsCopy);
+  tracer.SetVolumeData(pointField,
+                       range,
+                       cellSetCopy,
+                       viskores::cont::CoordinateSystem("coords", pointsCopy),
+                       dataSet.GetGhostCellField());
+  VISKORES_TEST_ASSERT(tracer.GetMeshContainer() != mesh, "Mesh should be rebuilt");
+  tracer.ResetMesh();
+  VISKORES_TEST_ASSERT(tracer.GetMeshContainer() == nullptr, "Mesh should be released");
+
+  // Renders of an orbit with one mapper match renders with a new mapper each frame, also
+  // when the field changes between frames.
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  viskores::rendering::MapperConnectivity mapper;
+  for (int frame = 0; frame < 4; ++frame)
+  {
+    camera.Azimuth(90.f);
+    const std::string fieldName = (frame == 2) ? "pointvar2" : "pointvar";
+    if (!dataSet.HasField(fieldName))
+    {
+      viskores::cont::ArrayHandle<viskores::Float32> values;
+      viskores::cont::ArrayCopy(pointField.GetData(), values);
+      auto portal = values.WritePortal();
+      for (viskores::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+      {
+        portal.Set(i, range.Max - portal.Get(i));
+      }
+      dataSet.AddPointField(fieldName, values);
+    }
+
+    viskores::rendering::MapperConnectivity fresh;
+    auto expected = Render(fresh, dataSet, fieldName, camera);
+    auto actual = Render(mapper, dataSet, fieldName, camera);
+    auto expectedPortal = expected.ReadPortal();
+    auto actualPortal = actual.ReadPortal();
+    for (viskores::Id i = 0; i < expectedPortal.GetNumberOfValues(); ++i)
+    {
+      VISKORES_TEST_ASSERT(test_equal(actualPortal.Get(i), expectedPortal.Get(i)),
+                           "Frame ",
+                           frame,
+                           " changed pixel ",
+                           i);
+    }
+  }
+}
+
 void RenderTests()
 {
   viskores::cont::testing::MakeTestDataSet maker;
@@ -40,6 +215,9 @@ void RenderTests()
                                            "pointvar",
                                            "rendering/connectivity/explicit3D.png",
                                            testOptions);
+
+  TestRefinement();
+  TestMeshReuse();
 }
 
 } //namespace
@@ -7,6 +7,9 @@
 //============================================================================
 
 
+#include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/ArrayHandleReverse.h>
+#include <viskores/cont/ErrorBadValue.h>
 #include <viskores/cont/testing/MakeTestDataSet.h>
 #include <viskores/cont/testing/Testing.h>
 #include <viskores/rendering/Actor.h>
@@ -14,6 +17,7 @@
 #include <viskores/rendering/MapperPoint.h>
 #include <viskores/rendering/Scene.h>
 #include <viskores/rendering/View3D.h>
+#include <viskores/rendering/raytracing/PointHierarchy.h>
 #include <viskores/rendering/testing/RenderTest.h>
 
 namespace
@@ -47,9 +51,204 @@ void RenderTests()
     maker.Make3DExplicitDataSet7(), "cellvar", "rendering/point/cells.png", options);
 }
 
+void HierarchyTests()
+{
+  std::cout << "Testing point hierarchy" << std::endl;
+
+  constexpr viskores::Id dim = 8;
+  std::vector<viskores::Vec3f_32> points;
+  std::vector<viskores::Float32> values;
+  for (viskores::Id k = 0; k < dim; ++k)
+  {
+    for (viskores::Id j = 0; j < dim; ++j)
+    {
+      for (viskores::Id i = 0; i < dim; ++i)
+      {
+        points.push_back(viskores::Vec3f_32(viskores::Vec3i_32(i, j, k)) / dim);
+        values.push_back(static_cast<viskores::Float32>(i));
+      }
+    }
+  }
+  const viskores::Id numPoints = static_cast<viskores::Id>(points.size());
+  viskores::cont::CoordinateSystem coords(
+    "coords", viskores::cont::make_ArrayHandle(points, viskores::CopyFlag::Off));
+  viskores::cont::Field field("values",
+                              viskores::cont::Field::Association::Points,
+                              viskores::cont::make_ArrayHandle(values, viskores::CopyFlag::Off));
+  constexpr viskores::Float32 radius = 0.01f;
+
+  viskores::rendering::raytracing::PointHierarchy hierarchy;
+  hierarchy.Build(coords, radius, field);
+  VISKORES_TEST_ASSERT(hierarchy.GetNumberOfPoints() == numPoints, "Wrong number of points");
+
+  // The hierarchy belongs to the arrays it was built from, not to equal copies of them.
+  VISKORES_TEST_ASSERT(hierarchy.IsBuiltFrom(coords, field), "Should match its own arrays");
+  viskores::cont::ArrayHandle<viskores::Vec3f_32> pointsCopy;
+  viskores::cont::ArrayCopy(coords.GetData(), pointsCopy);
+  VISKORES_TEST_ASSERT(
+    !hierarchy.IsBuiltFrom(viskores::cont::CoordinateSystem("coords", pointsCopy), field),
+    "Should not match other points");
+  viskores::cont::ArrayHandle<viskores::Float32> valuesCopy;
+  viskores::cont::ArrayCopy(field.GetData(), valuesCopy);
+  VISKORES_TEST_ASSERT(
+    !hierarchy.IsBuiltFrom(
+      coords,
+      viskores::cont::Field("values", viskores::cont::Field::Association::Points, valuesCopy)),
+    "Should not match other values");
+
+  viskores::Matrix<viskores::Float32, 4, 4> worldToClip;
+  viskores::MatrixIdentity(worldToClip);
+  viskores::cont::CoordinateSystem selected;
+  viskores::cont::ArrayHandle<viskores::Float32> radii;
+  viskores::cont::Field selectedField;
+
+  // A large enough pixel size selects the root, which averages all the values.
+  hierarchy.Select(worldToClip, 100, 1000.f, selected, radii, selectedField);
+  VISKORES_TEST_ASSERT(selected.GetNumberOfPoints() == 1, "Expected only the root");
+  viskores::cont::ArrayHandle<viskores::Float32> selectedValues;
+  viskores::cont::ArrayCopyShallowIfPossible(selectedField.GetData(), selectedValues);
+  VISKORES_TEST_ASSERT(test_equal(selectedValues.ReadPortal().Get(0), 3.5f), "Bad root value");
+  VISKORES_TEST_ASSERT(selectedField.GetName() == "values", "Bad field name");
+
+  // A tiny pixel size selects all the points.
+  hierarchy.Select(worldToClip, 100, 1e-3f, selected, radii, selectedField);
+  VISKORES_TEST_ASSERT(selected.GetNumberOfPoints() == numPoints, "Expected all the points");
+
+  // Aggregates bound the points they stand for and are no bigger than asked for.
+  constexpr viskores::Float32 pixelSize = 30.f;
+  hierarchy.Select(worldToClip, 100, pixelSize, selected, radii, selectedField);
+  const viskores::Id numSelected = selected.GetNumberOfPoints();
+  VISKORES_TEST_ASSERT(numSelected > 1 && numSelected < numPoints, "Expected aggregates");
+  viskores::cont::ArrayHandle<viskores::Vec3f_32> centers;
+  viskores::cont::ArrayCopyShallowIfPossible(selected.GetData(), centers);
+  auto centersPortal = centers.ReadPortal();
+  auto radiiPortal = radii.ReadPortal();
+  for (const viskores::Vec3f_32& point : points)
+  {
+    bool covered = false;
+    for (viskores::Id s = 0; s < numSelected && !covered; ++s)
+    {
+      VISKORES_TEST_ASSERT(radiiPortal.Get(s) * 100 <= pixelSize, "Aggregate too large");
+      covered = viskores::Magnitude(point - centersPortal.Get(s)) + radius <=
+        radiiPortal.Get(s) + 1e-5f;
+    }
+    VISKORES_TEST_ASSERT(covered, "Point ", point, " not covered");
+  }
+
+  // Points out of view are culled.
+  worldToClip[0][3] = 0.5f;
+  hierarchy.Select(worldToClip, 100, 1e-3f, selected, radii, selectedField);
+  VISKORES_TEST_ASSERT(selected.GetNumberOfPoints() < numPoints, "Expected culled points");
+}
+
+viskores::cont::ArrayHandle<viskores::Vec4f_32> Render(viskores::rendering::MapperPoint& mapper,
+                                                       const viskores::cont::DataSet& dataSet,
+                                                       const viskores::rendering::Camera& camera)
+{
+  viskores::rendering::CanvasRayTracer canvas(64, 64);
+  canvas.Clear();
+  viskores::cont::ColorTable colorTable(viskores::cont::ColorTable::Preset::Inferno);
+  mapper.SetCanvas(&canvas);
+  mapper.SetActiveColorTable(colorTable);
+  const auto& field = dataSet.GetField("pointvar");
+  mapper.RenderCells(dataSet.GetCellSet(),
+                     dataSet.GetCoordinateSystem(),
+                     field,
+                     colorTable,
+                     camera,
+                     field.GetRange().ReadPortal().Get(0));
+  mapper.SetCanvas(nullptr);
+
+  viskores::cont::ArrayHandle<viskores::Vec4f_32> colors;
+  viskores::cont::ArrayCopy(canvas.GetColorBuffer(), colors);
+  return colors;
+}
+
+void LevelOfDetailTests()
+{
+  std::cout << "Testing point level of detail" << std::endl;
+
+  viskores::cont::testing::MakeTestDataSet maker;
+  viskores::cont::DataSet dataSet = maker.Make3DUniformDataSet1();
+
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.0f);
+  camera.Elevation(20.0f);
+
+  viskores::rendering::MapperPoint points;
+  points.SetRadius(0.25f);
+  auto expected = Render(points, dataSet, camera);
+
+  // With a tiny pixel size every point is drawn.
+  viskores::rendering::MapperPoint lod;
+  lod.SetRadius(0.25f);
+  lod.SetLevelOfDetail(true);
+  lod.SetLevelOfDetailPixelSize(1e-3f);
+  auto actual = Render(lod, dataSet, camera);
+  auto expectedPortal = expected.ReadPortal();
+  auto actualPortal = actual.ReadPortal();
+  for (viskores::Id i = 0; i < expectedPortal.GetNumberOfValues(); ++i)
+  {
+    VISKORES_TEST_ASSERT(test_equal(expectedPortal.Get(i), actualPortal.Get(i), 0.01),
+                         "Images differ at pixel ",
+                         i);
+  }
+
+  // New values with the same size and range rebuild the hierarchy.
+  viskores::cont::DataSet reversed = dataSet;
+  viskores::cont::ArrayHandle<viskores::Float32> pointvar;
+  dataSet.GetField("pointvar").GetData().AsArrayHandle(pointvar);
+  viskores::cont::ArrayHandle<viskores::Float32> reversedPointvar;
+  viskores::cont::ArrayCopy(viskores::cont::make_ArrayHandleReverse(pointvar), reversedPointvar);
+  reversed.AddPointField("pointvar", reversedPointvar);
+  auto expectedReversed = Render(points, reversed, camera);
+  auto actualReversed = Render(lod, reversed, camera);
+  auto expectedReversedPortal = expectedReversed.ReadPortal();
+  auto actualReversedPortal = actualReversed.ReadPortal();
+  for (viskores::Id i = 0; i < expectedReversedPortal.GetNumberOfValues(); ++i)
+  {
+    VISKORES_TEST_ASSERT(
+      test_equal(expectedReversedPortal.Get(i), actualReversedPortal.Get(i), 0.01),
+      "Images of new values differ at pixel ",
+      i);
+  }
+
+  // Coarser levels still cover the points.
+  lod.SetLevelOfDetailPixelSize(16.f);
+  actual = Render(lod, dataSet, camera);
+  actualPortal = actual.ReadPortal();
+  for (viskores::Id i = 0; i < expectedPortal.GetNumberOfValues(); ++i)
+  {
+    if (expectedPortal.Get(i)[3] > 0.f)
+    {
+      VISKORES_TEST_ASSERT(actualPortal.Get(i)[3] > 0.f, "Pixel ", i, " not covered");
+    }
+  }
+
+  VISKORES_TEST_ASSERT(!points.GetLevelOfDetail(), "Level of detail should be off by default");
+  bool threw = false;
+  try
+  {
+    lod.SetLevelOfDetailPixelSize(0.f);
+  }
+  catch (const viskores::cont::ErrorBadValue&)
+  {
+    threw = true;
+  }
+  VISKORES_TEST_ASSERT(threw, "Bad pixel size not rejected");
+}
+
+void TestMapperPoints()
+{
+  RenderTests();
+  HierarchyTests();
+  LevelOfDetailTests();
+}
+
 } //namespace
 
 int UnitTestMapperPoints(int argc, char* argv[])
 {
-  return viskores::cont::testing::Testing::Run(RenderTests, argc, argv);
+  return viskores::cont::testing::Testing::Run(TestMapperPoints, argc, argv);
 }
@@ -7,6 +7,10 @@
 //============================================================================
 
 
+#include <viskores/CellClassification.h>
+#include <viskores/cont/ArrayCopy.h>
+#include <viskores/cont/DataSetBuilderExplicit.h>
+#include <viskores/cont/ErrorBadValue.h>
 #include <viskores/cont/testing/MakeTestDataSet.h>
 #include <viskores/cont/testing/Testing.h>
 #include <viskores/rendering/Actor.h>
@@ -16,6 +20,9 @@
 #include <viskores/rendering/View3D.h>
 #include <viskores/rendering/testing/RenderTest.h>
 
+#include <fstream>
+#include <iterator>
+
 namespace
 {
 
@@ -47,9 +54,379 @@ void RenderTests()
     maker.Make2DUniformDataSet1(), "pointvar", "rendering/raytracer/uniform2D.png", options);
 }
 
+viskores::cont::ArrayHandle<viskores::Vec4f_32> Render(viskores::rendering::MapperRayTracer& mapper,
+                                                       const viskores::cont::DataSet& dataSet,
+                                                       const viskores::rendering::Camera& camera)
+{
+  viskores::rendering::CanvasRayTracer canvas(64, 64);
+  canvas.Clear();
+  viskores::cont::ColorTable colorTable(viskores::cont::ColorTable::Preset::Inferno);
+  mapper.SetCanvas(&canvas);
+  mapper.SetActiveColorTable(colorTable);
+  const auto& field = dataSet.GetField("pointvar");
+  mapper.RenderCells(dataSet.GetCellSet(),
+                     dataSet.GetCoordinateSystem(),
+                     field,
+                     colorTable,
+                     camera,
+                     field.GetRange().ReadPortal().Get(0),
+                     dataSet.GetGhostCellField());
+  mapper.SetCanvas(nullptr);
+
+  viskores::cont::ArrayHandle<viskores::Vec4f_32> colors;
+  viskores::cont::ArrayCopy(canvas.GetColorBuffer(), colors);
+  return colors;
+}
+
+void CheckSameImage(const viskores::cont::ArrayHandle<viskores::Vec4f_32>& expected,
+                    const viskores::cont::ArrayHandle<viskores::Vec4f_32>& actual)
+{
+  auto expectedPortal = expected.ReadPortal();
+  auto actualPortal = actual.ReadPortal();
+  viskores::Id numDifferent = 0;
+  for (viskores::Id i = 0; i < expectedPortal.GetNumberOfValues(); ++i)
+  {
+    if (!test_equal(expectedPortal.Get(i), actualPortal.Get(i), 0.01))
+    {
+      ++numDifferent;
+    }
+  }
+  // Triangles that are hit at the same distance may resolve differently.
+  VISKORES_TEST_ASSERT(numDifferent <= expectedPortal.GetNumberOfValues() / 100,
+                       "Images differ in ",
+                       numDifferent,
+                       " pixels");
+}
+
+void CheckBVHBuilders(const viskores::cont::DataSet& dataSet)
+{
+  // The same mesh moved and stretched.
+  viskores::cont::DataSet moved = dataSet;
+  {
+    viskores::cont::ArrayHandle<viskores::Vec3f> points;
+    viskores::cont::ArrayCopy(dataSet.GetCoordinateSystem().GetData(), points);
+    auto portal = points.WritePortal();
+    for (viskores::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+    {
+      viskores::Vec3f p = portal.Get(i);
+      portal.Set(i, viskores::Vec3f(p[0] * 1.5f + 0.1f, p[1] + 0.05f, p[2]));
+    }
+    moved.AddCoordinateSystem(
+      viskores::cont::CoordinateSystem(dataSet.GetCoordinateSystem().GetName(), points));
+  }
+
+  viskores::Bounds bounds = dataSet.GetCoordinateSystem().GetBounds();
+  bounds.Include(moved.GetCoordinateSystem().GetBounds());
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(bounds);
+  camera.Azimuth(30.0f);
+  camera.Elevation(20.0f);
+
+  viskores::rendering::MapperRayTracer morton;
+  auto expected = Render(morton, dataSet, camera);
+  auto expectedMoved = Render(morton, moved, camera);
+
+  viskores::rendering::MapperRayTracer sah;
+  sah.SetBVHBuilder(viskores::rendering::raytracing::BVHBuilderType::SAH);
+  CheckSameImage(expected, Render(sah, dataSet, camera));
+
+  for (auto builder : { viskores::rendering::raytracing::BVHBuilderType::Morton,
+                        viskores::rendering::raytracing::BVHBuilderType::SAH })
+  {
+    viskores::rendering::MapperRayTracer refit;
+    refit.SetBVHBuilder(builder);
+    refit.SetRefitBVH(true);
+    CheckSameImage(expected, Render(refit, dataSet, camera));
+    CheckSameImage(expectedMoved, Render(refit, moved, camera));
+    CheckSameImage(expected, Render(refit, dataSet, camera));
+  }
+}
+
+void BVHTests()
+{
+  std::cout << "Testing BVH builders and refit" << std::endl;
+
+  viskores::cont::testing::MakeTestDataSet maker;
+  CheckBVHBuilders(maker.Make3DExplicitDataSetCowNose());
+
+  // A single primitive is stored twice so that the tree has two leaves.
+  viskores::cont::DataSetBuilderExplicit builder;
+  viskores::cont::DataSet triangle =
+    builder.Create(std::vector<viskores::Vec3f>{ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0.5f } },
+                   std::vector<viskores::UInt8>{ viskores::CELL_SHAPE_TRIANGLE },
+                   std::vector<viskores::IdComponent>{ 3 },
+                   std::vector<viskores::Id>{ 0, 1, 2 });
+  triangle.AddPointField("pointvar", std::vector<viskores::Float32>{ 0, 1, 2 });
+  CheckBVHBuilders(triangle);
+
+  // Other cells or ghost cells with the same counts are not refit, as a mapper that draws
+  // several actors of the same size would see.
+  viskores::cont::DataSet dataSet = maker.Make3DExplicitDataSetCowNose();
+  const viskores::Id numPoints = dataSet.GetNumberOfPoints();
+  viskores::cont::DataSet shifted = dataSet;
+  {
+    viskores::cont::CellSetSingleType<> cells;
+    dataSet.GetCellSet().AsCellSet(cells);
+    viskores::cont::ArrayHandle<viskores::Id> connectivity;
+    viskores::cont::ArrayCopy(cells.GetConnectivityArray(viskores::TopologyElementTagCell{},
+                                                         viskores::TopologyElementTagPoint{}),
+                              connectivity);
+    auto portal = connectivity.WritePortal();
+    for (viskores::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+    {
+      portal.Set(i, (portal.Get(i) + 1) % numPoints);
+    }
+    viskores::cont::CellSetSingleType<> shiftedCells;
+    shiftedCells.Fill(numPoints, viskores::CELL_SHAPE_TRIANGLE, 3, connectivity);
+    shifted.SetCellSet(shiftedCells);
+  }
+  viskores::cont::DataSet ghosted = dataSet;
+  {
+    viskores::cont::ArrayHandle<viskores::UInt8> ghosts;
+    ghosts.AllocateAndFill(dataSet.GetNumberOfCells(), 0);
+    auto portal = ghosts.WritePortal();
+    for (viskores::Id i = 0; i < portal.GetNumberOfValues(); i += 2)
+    {
+      portal.Set(i, viskores::CellClassification::Ghost);
+    }
+    ghosted.SetGhostCellField(ghosts);
+  }
+
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.0f);
+  camera.Elevation(20.0f);
+  viskores::rendering::MapperRayTracer fresh;
+  viskores::rendering::MapperRayTracer refit;
+  refit.SetRefitBVH(true);
+  for (const auto& actor : { dataSet, shifted, ghosted, dataSet })
+  {
+    CheckSameImage(Render(fresh, actor, camera), Render(refit, actor, camera));
+  }
+}
+
+void PacketTests()
+{
+  std::cout << "Testing ray packets" << std::endl;
+
+  viskores::cont::testing::MakeTestDataSet maker;
+  viskores::cont::DataSet dataSet = maker.Make3DExplicitDataSetCowNose();
+
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.0f);
+  camera.Elevation(20.0f);
+
+  viskores::rendering::MapperRayTracer single;
+  auto expected = Render(single, dataSet, camera);
+
+  for (viskores::IdComponent packetSize : { 4, 8 })
+  {
+    viskores::rendering::MapperRayTracer packets;
+    packets.SetRayPacketSize(packetSize);
+    CheckSameImage(expected, Render(packets, dataSet, camera));
+  }
+
+  viskores::rendering::MapperRayTracer mapper;
+  VISKORES_TEST_ASSERT(mapper.GetRayPacketSize() == 1, "Wrong default packet size");
+  bool threw = false;
+  try
+  {
+    mapper.SetRayPacketSize(3);
+  }
+  catch (const viskores::cont::ErrorBadValue&)
+  {
+    threw = true;
+  }
+  VISKORES_TEST_ASSERT(threw, "Bad packet size not rejected");
+}
+
+// A large square with a smaller one floating above it, which occludes and shadows it.
+viskores::cont::DataSet MakeOccludedDataSet()
+{
+  std::vector<viskores::Vec3f_32> points = { { -1.f, -1.f, 0.f },    { 1.f, -1.f, 0.f },
+                                             { 1.f, 1.f, 0.f },      { -1.f, 1.f, 0.f },
+                                             { -0.4f, -0.4f, 0.3f }, { 0.4f, -0.4f, 0.3f },
+                                             { 0.4f, 0.4f, 0.3f },   { -0.4f, 0.4f, 0.3f } };
+  std::vector<viskores::UInt8> shapes = { viskores::CELL_SHAPE_QUAD, viskores::CELL_SHAPE_QUAD };
+  std::vector<viskores::IdComponent> numIndices = { 4, 4 };
+  std::vector<viskores::Id> connectivity = { 0, 1, 2, 3, 4, 5, 6, 7 };
+  viskores::cont::DataSet dataSet =
+    viskores::cont::DataSetBuilderExplicit::Create(points, shapes, numIndices, connectivity);
+  dataSet.AddPointField("pointvar", std::vector<viskores::Float32>{ 0, 1, 2, 3, 4, 5, 6, 7 });
+  return dataSet;
+}
+
+// Checks that no pixel of the image is brighter than in the reference and returns how many
+// are darker.
+viskores::Id CountDarkerPixels(const viskores::cont::ArrayHandle<viskores::Vec4f_32>& reference,
+                               const viskores::cont::ArrayHandle<viskores::Vec4f_32>& image)
+{
+  auto referencePortal = reference.ReadPortal();
+  auto imagePortal = image.ReadPortal();
+  viskores::Id numDarker = 0;
+  for (viskores::Id i = 0; i < referencePortal.GetNumberOfValues(); ++i)
+  {
+    const viskores::Vec4f_32 expected = referencePortal.Get(i);
+    const viskores::Vec4f_32 actual = imagePortal.Get(i);
+    bool darker = false;
+    for (viskores::IdComponent c = 0; c < 3; ++c)
+    {
+      VISKORES_TEST_ASSERT(actual[c] <= expected[c] + 0.001f, "Occlusion brightened pixel ", i);
+      darker |= actual[c] < expected[c] - 0.02f;
+    }
+    numDarker += darker ? 1 : 0;
+  }
+  return numDarker;
+}
+
+void OcclusionTests()
+{
+  std::cout << "Testing ambient occlusion and shadows" << std::endl;
+
+  viskores::cont::DataSet dataSet = MakeOccludedDataSet();
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Elevation(-40.0f);
+
+  viskores::rendering::MapperRayTracer plain;
+  auto reference = Render(plain, dataSet, camera);
+
+  viskores::rendering::MapperRayTracer shadows;
+  shadows.SetShadowsOn(true);
+  auto shadowed = Render(shadows, dataSet, camera);
+  VISKORES_TEST_ASSERT(CountDarkerPixels(reference, shadowed) > 0, "No shadow drawn");
+  // Shadows do not depend on the number of renders.
+  CheckSameImage(shadowed, Render(shadows, dataSet, camera));
+
+  viskores::rendering::MapperRayTracer occlusion;
+  occlusion.SetAmbientOcclusionSamples(4);
+  occlusion.SetAmbientOcclusionDistance(1.0f);
+  auto firstFrame = Render(occlusion, dataSet, camera);
+  const viskores::Id numOccluded = CountDarkerPixels(reference, firstFrame);
+  VISKORES_TEST_ASSERT(numOccluded > 0, "No ambient occlusion drawn");
+
+  // Further renders of the same view add samples, which changes the occlusion.
+  auto secondFrame = Render(occlusion, dataSet, camera);
+  CountDarkerPixels(reference, secondFrame);
+  VISKORES_TEST_ASSERT(!test_equal_ArrayHandles(firstFrame, secondFrame),
+                       "Samples were not accumulated");
+
+  // The samples are reproducible, so starting over gives the first frame again.
+  occlusion.ResetAccumulation();
+  CheckSameImage(firstFrame, Render(occlusion, dataSet, camera));
+  viskores::rendering::MapperRayTracer other;
+  other.SetAmbientOcclusionSamples(4);
+  other.SetAmbientOcclusionDistance(1.0f);
+  CheckSameImage(firstFrame, Render(other, dataSet, camera));
+
+  // Moving the camera starts a new accumulation.
+  viskores::rendering::Camera moved = camera;
+  moved.Azimuth(10.0f);
+  Render(occlusion, dataSet, moved);
+  CheckSameImage(firstFrame, Render(occlusion, dataSet, camera));
+
+  // Without shading there is nothing to occlude.
+  occlusion.SetShadingOn(false);
+  plain.SetShadingOn(false);
+  CheckSameImage(Render(plain, dataSet, camera), Render(occlusion, dataSet, camera));
+
+  VISKORES_TEST_ASSERT(plain.GetAmbientOcclusionSamples() == 0, "Wrong default samples");
+  VISKORES_TEST_ASSERT(!plain.GetShadowsOn(), "Wrong default shadows");
+  bool threw = false;
+  try
+  {
+    plain.SetAmbientOcclusionSamples(-1);
+  }
+  catch (const viskores::cont::ErrorBadValue&)
+  {
+    threw = true;
+  }
+  VISKORES_TEST_ASSERT(threw, "Bad sample count not rejected");
+}
+
+std::vector<char> ReadFile(const std::string& fileName)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  VISKORES_TEST_ASSERT(file.good(), "Could not read ", fileName);
+  return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+}
+
+void BatchTests()
+{
+  std::cout << "Testing batch rendering" << std::endl;
+
+  viskores::cont::testing::MakeTestDataSet maker;
+  viskores::cont::DataSet dataSet = maker.Make3DExplicitDataSetCowNose();
+  viskores::rendering::Scene scene;
+  scene.AddActor(viskores::rendering::Actor(dataSet.GetCellSet(),
+                                            dataSet.GetCoordinateSystem(),
+                                            dataSet.GetField("pointvar"),
+                                            viskores::cont::ColorTable::Preset::Inferno));
+  viskores::rendering::MapperRayTracer mapper;
+  mapper.SetRefitBVH(true);
+  viskores::rendering::View3D view(scene, mapper, viskores::rendering::CanvasRayTracer(64, 64));
+
+  std::vector<viskores::rendering::View::BatchImage> images;
+  viskores::rendering::Camera camera = view.GetCamera();
+  int numPrepared = 0;
+  for (int i = 0; i < 6; ++i)
+  {
+    camera.Azimuth(60.f);
+    viskores::rendering::View::BatchImage image;
+    image.Camera = camera;
+    image.FileName = viskores::cont::testing::Testing::WriteDirPath(
+      "batch-" + std::to_string(i) + (i % 2 == 0 ? ".png" : ".pnm"));
+    image.Prepare = [&numPrepared](viskores::rendering::View&) { ++numPrepared; };
+    images.push_back(image);
+  }
+  images.back().FileName.clear();
+
+  view.SetRenderMode(viskores::rendering::View::RenderMode::Tiled);
+  view.RenderBatch(images, 2);
+  VISKORES_TEST_ASSERT(numPrepared == 6, "Every image should be prepared");
+  VISKORES_TEST_ASSERT(view.GetRenderMode() == viskores::rendering::View::RenderMode::Tiled,
+                       "Render mode should be restored");
+
+  // Each saved image matches the image rendered on its own.
+  viskores::rendering::View3D single(
+    scene, viskores::rendering::MapperRayTracer(), viskores::rendering::CanvasRayTracer(64, 64));
+  for (std::size_t i = 0; i + 1 < images.size(); ++i)
+  {
+    single.SetCamera(images[i].Camera);
+    single.Paint();
+    const std::string expected = viskores::cont::testing::Testing::WriteDirPath(
+      "batch-expected" + images[i].FileName.substr(images[i].FileName.size() - 4));
+    single.SaveAs(expected);
+    VISKORES_TEST_ASSERT(ReadFile(images[i].FileName) == ReadFile(expected),
+                         "Batch image ",
+                         i,
+                         " differs");
+  }
+
+  // The view is left with the last image.
+  single.SetCamera(images.back().Camera);
+  single.Paint();
+  auto expected = single.GetCanvas().GetColorBuffer().ReadPortal();
+  auto actual = view.GetCanvas().GetColorBuffer().ReadPortal();
+  for (viskores::Id i = 0; i < expected.GetNumberOfValues(); ++i)
+  {
+    VISKORES_TEST_ASSERT(test_equal(expected.Get(i), actual.Get(i)), "Last image differs");
+  }
+}
+
+void TestMapperRayTracer()
+{
+  RenderTests();
+  BVHTests();
+  PacketTests();
+  OcclusionTests();
+  BatchTests();
+}
+
 } //namespace
 
 int UnitTestMapperRayTracer(int argc, char* argv[])
 {
-  return viskores::cont::testing::Testing::Run(RenderTests, argc, argv);
+  return viskores::cont::testing::Testing::Run(TestMapperRayTracer, argc, argv);
 }
@@ -222,11 +222,86 @@ void TestUniformGrid()
     tangleAvg, "tangle_avg", "rendering/volume/uniform_cell.png", options);
 }
 
+void TestSkipping()
+{
+  // Most of the scalar range is transparent, as in sparse data.
+  viskores::cont::ColorTable colorTable = viskores::cont::ColorTable::Preset::Inferno;
+  colorTable.AddPointAlpha(0.0, 0.0f);
+  colorTable.AddPointAlpha(0.6, 0.0f);
+  colorTable.AddPointAlpha(0.7, 0.3f);
+  colorTable.AddPointAlpha(1.0, 0.6f);
+
+  viskores::source::Tangle tangle;
+  tangle.SetPointDimensions({ 50, 50, 50 });
+  viskores::cont::DataSet tangleData = tangle.Execute();
+  viskores::filter::field_conversion::CellAverage cellAverage;
+  cellAverage.SetActiveField("tangle");
+  cellAverage.SetOutputFieldName("tangle_avg");
+  tangleData = cellAverage.Execute(tangleData);
+
+  viskores::rendering::Camera camera;
+  camera.ResetToBounds(tangleData.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.0f);
+  camera.Elevation(20.0f);
+
+  auto render = [&](const std::string& fieldName, bool skipping, viskores::Float32 opacity)
+  {
+    const viskores::cont::Field field = tangleData.GetField(fieldName);
+    viskores::Range range;
+    field.GetRange(&range);
+
+    viskores::rendering::CanvasRayTracer canvas(64, 64);
+    canvas.Clear();
+    viskores::rendering::MapperVolume mapper;
+    mapper.SetActiveColorTable(colorTable);
+    mapper.SetCompositeBackground(false);
+    mapper.SetEmptySpaceSkipping(skipping);
+    mapper.SetRayTerminationOpacity(opacity);
+    mapper.SetCanvas(&canvas);
+    mapper.RenderCells(
+      tangleData.GetCellSet(), tangleData.GetCoordinateSystem(), field, colorTable, camera, range);
+    return canvas.GetColorBuffer();
+  };
+
+  for (const std::string fieldName : { "tangle", "tangle_avg" })
+  {
+    std::cout << "Testing empty space skipping with " << fieldName << std::endl;
+    auto referenceColors = render(fieldName, false, 1.f);
+    auto skippedColors = render(fieldName, true, 1.f);
+    auto terminatedColors = render(fieldName, true, 0.9f);
+    auto reference = referenceColors.ReadPortal();
+    auto skipped = skippedColors.ReadPortal();
+    auto terminated = terminatedColors.ReadPortal();
+
+    viskores::Id numCovered = 0;
+    for (viskores::Id i = 0; i < reference.GetNumberOfValues(); i++)
+    {
+      // Skipping only leaves out samples that add nothing.
+      VISKORES_TEST_ASSERT(test_equal(skipped.Get(i), reference.Get(i)),
+                           "Empty space skipping changed pixel ",
+                           i);
+      // Terminating early can only leave out what is behind 90% opacity.
+      for (viskores::IdComponent c = 0; c < 4; c++)
+      {
+        VISKORES_TEST_ASSERT(terminated.Get(i)[c] <= reference.Get(i)[c] + 1e-3f &&
+                               terminated.Get(i)[c] >= reference.Get(i)[c] - 0.1f,
+                             "Early termination changed pixel ",
+                             i,
+                             " too much");
+      }
+      if (reference.Get(i)[3] > 0.f)
+        numCovered++;
+    }
+    VISKORES_TEST_ASSERT(numCovered > 0, "Nothing was rendered");
+  }
+}
+
 void RenderTests()
 {
   TestVolumeRenderOccludesAnnotations();
   TestRectilinear();
   TestUniformGrid();
+  TestSkipping();
 }
 
 } //namespace
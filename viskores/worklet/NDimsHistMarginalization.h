@@ -17,6 +17,7 @@
 #include <viskores/cont/ArrayHandleCounting.h>
 #include <viskores/cont/DataSet.h>
 #include <viskores/filter/density_estimate/worklet/histogram/ComputeNDHistogram.h>
+#include <viskores/filter/density_estimate/worklet/histogram/HashAggregateBins.h>
 #include <viskores/filter/density_estimate/worklet/histogram/MarginalizeNDHistogram.h>
 #include <viskores/worklet/DispatcherMapField.h>
 #include <viskores/worklet/WorkletMapField.h>
@@ -69,6 +70,7 @@ public:
     viskores::cont::ArrayHandle<viskores::Id> freqs;
     viskores::cont::ArrayCopy(freqsIn, freqs);
     viskores::Id numMarginalVariables = 0; //count num of marginal variables
+    viskores::Id numMarginalBins = 1; //bounded by the number of values
     const auto marginalPortal = marginalVariables.ReadPortal();
     const auto numBinsPortal = numberOfBins.ReadPortal();
     for (viskores::Id i = 0; i < numOfVariable; i++)
@@ -78,6 +80,9 @@ public:
         // Worklet to calculate 1D index for marginal variables
         numMarginalVariables++;
         const viskores::Id nFieldBins = numBinsPortal.Get(i);
+        numMarginalBins = (numMarginalBins > numberOfValues / nFieldBins)
+          ? numberOfValues
+          : numMarginalBins * nFieldBins;
         viskores::worklet::histogram::To1DIndex binWorklet(nFieldBins);
         viskores::worklet::DispatcherMapField<viskores::worklet::histogram::To1DIndex>
           to1DIndexDispatcher(binWorklet);
@@ -101,19 +106,11 @@ public:
     }
 
 
-    // Sort the freq array for counting by key(1DIndex)
-    viskores::cont::Algorithm::SortByKey(bin1DIndex, freqs);
-
-    // Add frequency within same 1d index bin (this get a nonSparse representation)
-    viskores::cont::ArrayHandle<viskores::Id> nonSparseMarginalFreqs;
-    viskores::cont::Algorithm::ReduceByKey(
-      bin1DIndex, freqs, bin1DIndex, nonSparseMarginalFreqs, viskores::Add());
-
-    // Convert to sparse representation(remove all zero freqncy entities)
+    // Add frequency within same 1d index bin directly on the sparse representation
+    // (entities that do not meet the condition have zero frequency and are dropped)
     viskores::cont::ArrayHandle<viskores::Id> sparseMarginal1DBinId;
-    viskores::cont::Algorithm::CopyIf(bin1DIndex, nonSparseMarginalFreqs, sparseMarginal1DBinId);
-    viskores::cont::Algorithm::CopyIf(
-      nonSparseMarginalFreqs, nonSparseMarginalFreqs, marginalFreqs);
+    viskores::worklet::histogram::HashAggregateBins(
+      bin1DIndex, freqs, numMarginalBins, sparseMarginal1DBinId, marginalFreqs);
 
     //convert back to multi variate binId
     marginalBinId.resize(static_cast<size_t>(numMarginalVariables));
@@ -151,9 +148,8 @@ public:
     viskores::cont::ArrayHandle<viskores::Id> bin1DIndex;
     viskores::cont::ArrayCopy(constant0Array, bin1DIndex);
 
-    viskores::cont::ArrayHandle<viskores::Id> freqs;
-    viskores::cont::ArrayCopy(freqsIn, freqs);
     viskores::Id numMarginalVariables = 0; //count num of marginal variables
+    viskores::Id numMarginalBins = 1; //bounded by the number of values
     const auto marginalPortal = marginalVariables.ReadPortal();
     const auto numBinsPortal = numberOfBins.ReadPortal();
     for (viskores::Id i = 0; i < numOfVariable; i++)
@@ -163,6 +159,9 @@ public:
         // Worklet to calculate 1D index for marginal variables
         numMarginalVariables++;
         const viskores::Id nFieldBins = numBinsPortal.Get(i);
+        numMarginalBins = (numMarginalBins > numberOfValues / nFieldBins)
+          ? numberOfValues
+          : numMarginalBins * nFieldBins;
         viskores::worklet::histogram::To1DIndex binWorklet(nFieldBins);
         viskores::worklet::DispatcherMapField<viskores::worklet::histogram::To1DIndex>
           to1DIndexDispatcher(binWorklet);
@@ -171,12 +170,10 @@ public:
       }
     }
 
-    // Sort the freq array for counting by key (1DIndex)
-    viskores::cont::Algorithm::SortByKey(bin1DIndex, freqs);
-
-    // Add frequency within same 1d index bin
-    viskores::cont::Algorithm::ReduceByKey(
-      bin1DIndex, freqs, bin1DIndex, marginalFreqs, viskores::Add());
+    // Add frequency within same 1d index bin directly on the sparse representation
+    viskores::cont::ArrayHandle<viskores::Id> sparseMarginal1DBinId;
+    viskores::worklet::histogram::HashAggregateBins(
+      bin1DIndex, freqsIn, numMarginalBins, sparseMarginal1DBinId, marginalFreqs);
 
     //convert back to multi variate binId
     marginalBinId.resize(static_cast<size_t>(numMarginalVariables));
@@ -190,7 +187,8 @@ public:
         viskores::worklet::DispatcherMapField<viskores::worklet::histogram::ConvertHistBinToND>
           convertHistBinToNDDispatcher(binWorklet);
         size_t vecIndex = static_cast<size_t>(marginalVarIdx);
-        convertHistBinToNDDispatcher.Invoke(bin1DIndex, bin1DIndex, marginalBinId[vecIndex]);
+        convertHistBinToNDDispatcher.Invoke(
+          sparseMarginal1DBinId, sparseMarginal1DBinId, marginalBinId[vecIndex]);
         marginalVarIdx--;
       }
     }